@@ -1,9 +1,17 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <memory>
 #include <string>
 #include <fstream>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <queue>
 #include <functional>
 
@@ -20,8 +28,11 @@ public:
         int sampleRate = 44100;
         int channels = 2;
         Format format = Format::WAV_32BIT_FLOAT;
+        bool dither = false;    // TPDF dither when writing integer samples
     };
     
+    static constexpr size_t stagingSize = 256 * 1024;   // Bytes per file write
+    
 private:
     std::string filename;
     AudioFormat format;
@@ -29,6 +40,13 @@ private:
     bool isOpen = false;
     int64_t samplesWritten = 0;
     
+    // Samples are converted a block at a time into the staging buffer,
+    // which reaches the file in one large write when full
+    std::vector<char> staging;
+    size_t stagingUsed = 0;
+    std::vector<float> scaled;
+    uint32_t ditherState = 0x12345678u;
+    
     // WAV header structure
     struct WAVHeader {
         char riff[4] = {'R', 'I', 'F', 'F'};
@@ -85,6 +103,8 @@ public:
         
         file.write(reinterpret_cast<const char*>(&header), sizeof(header));
         
+        staging.resize(std::max<size_t>(stagingSize, sizeof(float) * 1024 * format.channels));
+        stagingUsed = 0;
         isOpen = true;
         samplesWritten = 0;
         return true;
@@ -93,26 +113,50 @@ public:
     void writeInterleavedSamples(const float* samples, int numFrames) {
         if (!isOpen || !samples) return;
         
-        for (int i = 0; i < numFrames * format.channels; ++i) {
-            float sample = std::clamp(samples[i], -1.0f, 1.0f);
+        const int bytesPerSample = getBytesPerSample();
+        const int blockSamples = 1024 * format.channels;
+        int total = numFrames * format.channels;
+        int done = 0;
+        
+        while (done < total) {
+            int count = std::min(blockSamples, total - done);
+            if (stagingUsed + static_cast<size_t>(count) * bytesPerSample > staging.size()) {
+                flushStaging();
+            }
             
-            switch (format.format) {
-                case Format::WAV_16BIT: {
-                    int16_t intSample = static_cast<int16_t>(sample * 32767.0f);
-                    file.write(reinterpret_cast<const char*>(&intSample), sizeof(intSample));
-                    break;
+            char* dest = staging.data() + stagingUsed;
+            if (format.format == Format::WAV_32BIT_FLOAT) {
+                std::memcpy(dest, samples + done, sizeof(float) * count);
+            } else {
+                // Scale, dither and clamp the whole block, then pack it
+                const bool is16 = format.format == Format::WAV_16BIT;
+                const float fullScale = is16 ? 32768.0f : 8388608.0f;
+                scaled.resize(count);
+                for (int i = 0; i < count; ++i) {
+                    scaled[i] = samples[done + i] * fullScale;
+                }
+                if (format.dither) {
+                    addTPDFDither(scaled.data(), count);
                 }
-                case Format::WAV_24BIT: {
-                    int32_t intSample = static_cast<int32_t>(sample * 8388607.0f);
-                    // Write 24-bit (3 bytes)
-                    file.write(reinterpret_cast<const char*>(&intSample), 3);
-                    break;
+                for (int i = 0; i < count; ++i) {
+                    scaled[i] = std::clamp(std::nearbyint(scaled[i]), -fullScale, fullScale - 1.0f);
                 }
-                case Format::WAV_32BIT_FLOAT: {
-                    file.write(reinterpret_cast<const char*>(&sample), sizeof(sample));
-                    break;
+                
+                if (is16) {
+                    for (int i = 0; i < count; ++i) {
+                        int16_t value = static_cast<int16_t>(scaled[i]);
+                        std::memcpy(dest + i * 2, &value, 2);
+                    }
+                } else {
+                    for (int i = 0; i < count; ++i) {
+                        int32_t value = static_cast<int32_t>(scaled[i]);
+                        std::memcpy(dest + i * 3, &value, 3);   // Low three bytes (little-endian)
+                    }
                 }
             }
+            
+            stagingUsed += static_cast<size_t>(count) * bytesPerSample;
+            done += count;
         }
         
         samplesWritten += numFrames;
@@ -121,6 +165,8 @@ public:
     void close() {
         if (!isOpen) return;
         
+        flushStaging();
+        
         // Update WAV header with correct sizes
         int bytesPerSample = 0;
         switch (format.format) {
@@ -130,7 +176,14 @@ public:
         }
         
         uint32_t dataSize = samplesWritten * format.channels * bytesPerSample;
-        uint32_t fileSize = dataSize + sizeof(WAVHeader) - 8;
+        
+        // An odd-sized data chunk is padded to a word boundary; the pad counts
+        // in the RIFF size but not in the data size
+        const uint32_t pad = dataSize & 1u;
+        if (pad) {
+            file.put(0);
+        }
+        uint32_t fileSize = dataSize + pad + sizeof(WAVHeader) - 8;
         
         // Seek back and update header
         file.seekp(4);
@@ -144,81 +197,153 @@ public:
     
     bool getIsOpen() const { return isOpen; }
     int64_t getSamplesWritten() const { return samplesWritten; }
+    
+private:
+    int getBytesPerSample() const {
+        switch (format.format) {
+            case Format::WAV_16BIT: return 2;
+            case Format::WAV_24BIT: return 3;
+            case Format::WAV_32BIT_FLOAT: return 4;
+        }
+        return 4;
+    }
+    
+    void flushStaging() {
+        if (stagingUsed > 0) {
+            file.write(staging.data(), static_cast<std::streamsize>(stagingUsed));
+            stagingUsed = 0;
+        }
+    }
+    
+    // Triangular noise of +-1 LSB: the difference of two uniform values
+    void addTPDFDither(float* values, int count) {
+        for (int i = 0; i < count; ++i) {
+            ditherState ^= ditherState << 13;
+            ditherState ^= ditherState >> 17;
+            ditherState ^= ditherState << 5;
+            float a = static_cast<float>(ditherState >> 8) / 16777216.0f;
+            ditherState ^= ditherState << 13;
+            ditherState ^= ditherState >> 17;
+            ditherState ^= ditherState << 5;
+            float b = static_cast<float>(ditherState >> 8) / 16777216.0f;
+            values[i] += a - b;
+        }
+    }
 };
 
-// Audio recording buffer (circular buffer for real-time recording)
+// Audio recording buffer (lock-free SPSC ring for real-time recording)
+// One thread writes, one thread reads. Frames are interleaved; capacity is
+// a power of two so wrapping is a mask, and each side copies at most two
+// contiguous spans. Positions count frames ever written/read and are
+// published with release stores. A write that does not fit is refused
+// whole and counted as an overrun; a read of an empty ring as an underrun.
 class RecordingBuffer {
 private:
+    static constexpr size_t cacheLineSize = 64;
+    
     std::vector<float> buffer;
-    std::atomic<int> writePos;
-    std::atomic<int> readPos;
-    int bufferSize;
+    int bufferSize;     // Frames, power of two
+    int mask;
     int channels;
     
+    // Producer and consumer state on separate cache lines
+    alignas(cacheLineSize) std::atomic<uint64_t> writePos{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> overrunFrames{0};
+    alignas(cacheLineSize) std::atomic<uint64_t> readPos{0};
+    std::atomic<uint64_t> underruns{0};
+    
+    static int roundUpToPowerOfTwo(int frames) {
+        int size = 1;
+        while (size < frames) size <<= 1;
+        return size;
+    }
+    
 public:
     RecordingBuffer(int size, int numChannels) 
-        : bufferSize(size), channels(numChannels), writePos(0), readPos(0) {
-        buffer.resize(size * channels, 0.0f);
+        : bufferSize(roundUpToPowerOfTwo(std::max(1, size))), channels(std::max(1, numChannels)) {
+        mask = bufferSize - 1;
+        buffer.resize(static_cast<size_t>(bufferSize) * channels, 0.0f);
     }
     
-    void write(const float* samples, int numFrames) {
-        int wp = writePos.load();
+    // Producer
+    bool write(const float* samples, int numFrames) {
+        if (numFrames <= 0) return true;
         
-        for (int frame = 0; frame < numFrames; ++frame) {
-            for (int ch = 0; ch < channels; ++ch) {
-                int index = (wp * channels + ch) % buffer.size();
-                buffer[index] = samples[frame * channels + ch];
-            }
-            wp = (wp + 1) % (bufferSize);
+        uint64_t wp = writePos.load(std::memory_order_relaxed);
+        uint64_t rp = readPos.load(std::memory_order_acquire);
+        if (numFrames > bufferSize - static_cast<int>(wp - rp)) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            overrunFrames.fetch_add(numFrames, std::memory_order_relaxed);
+            return false;
         }
         
-        writePos.store(wp);
+        int start = static_cast<int>(wp & mask);
+        int first = std::min(numFrames, bufferSize - start);
+        std::memcpy(buffer.data() + static_cast<size_t>(start) * channels, samples,
+                    sizeof(float) * first * channels);
+        std::memcpy(buffer.data(), samples + static_cast<size_t>(first) * channels,
+                    sizeof(float) * (numFrames - first) * channels);
+        
+        writePos.store(wp + numFrames, std::memory_order_release);
+        return true;
+    }
+    
+    int getFreeFrames() const {
+        uint64_t wp = writePos.load(std::memory_order_relaxed);
+        uint64_t rp = readPos.load(std::memory_order_acquire);
+        return bufferSize - static_cast<int>(wp - rp);
     }
     
+    // Consumer
     int read(float* samples, int maxFrames) {
-        int rp = readPos.load();
-        int wp = writePos.load();
+        uint64_t rp = readPos.load(std::memory_order_relaxed);
+        uint64_t wp = writePos.load(std::memory_order_acquire);
         
-        int available;
-        if (wp >= rp) {
-            available = wp - rp;
-        } else {
-            available = bufferSize - rp + wp;
+        int framesToRead = std::min(maxFrames, static_cast<int>(wp - rp));
+        if (framesToRead <= 0) {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            return 0;
         }
         
-        int framesToRead = std::min(maxFrames, available);
-        
-        for (int frame = 0; frame < framesToRead; ++frame) {
-            for (int ch = 0; ch < channels; ++ch) {
-                int index = (rp * channels + ch) % buffer.size();
-                samples[frame * channels + ch] = buffer[index];
-            }
-            rp = (rp + 1) % bufferSize;
-        }
+        int start = static_cast<int>(rp & mask);
+        int first = std::min(framesToRead, bufferSize - start);
+        std::memcpy(samples, buffer.data() + static_cast<size_t>(start) * channels,
+                    sizeof(float) * first * channels);
+        std::memcpy(samples + static_cast<size_t>(first) * channels, buffer.data(),
+                    sizeof(float) * (framesToRead - first) * channels);
         
-        readPos.store(rp);
+        readPos.store(rp + framesToRead, std::memory_order_release);
         return framesToRead;
     }
     
+    int getAvailableFrames() const {
+        uint64_t wp = writePos.load(std::memory_order_acquire);
+        uint64_t rp = readPos.load(std::memory_order_relaxed);
+        return static_cast<int>(wp - rp);
+    }
+    
+    // Only while neither side is running
     void clear() {
         writePos.store(0);
         readPos.store(0);
-        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        overruns.store(0);
+        overrunFrames.store(0);
+        underruns.store(0);
     }
     
-    int getAvailableFrames() const {
-        int wp = writePos.load();
-        int rp = readPos.load();
-        
-        if (wp >= rp) {
-            return wp - rp;
-        } else {
-            return bufferSize - rp + wp;
-        }
-    }
+    int getCapacity() const { return bufferSize; }
+    int getChannels() const { return channels; }
+    uint64_t getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+    uint64_t getOverrunFrames() const { return overrunFrames.load(std::memory_order_relaxed); }
+    uint64_t getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
 };
 
-// Track recording state and management
+// Track recording state and management. processAudio() runs on the audio
+// thread and only copies into the ring and marks takes in a preallocated
+// array; a writer thread started with the recording drains the ring to the
+// file every few milliseconds, so no file I/O or allocation happens in the
+// callback. Builds without threads drain through service() instead.
 class TrackRecorder {
 public:
     enum class RecordMode {
@@ -227,6 +352,15 @@ public:
         PUNCH_IN_OUT    // Record only in specified range
     };
     
+    // One pass of a recording: where it sits on the timeline and where it starts in the file
+    struct Take {
+        double startTime = 0.0;
+        int64_t fileFrame = 0;
+    };
+    
+    static constexpr int maxTakes = 4096;          // Later passes extend the last take
+    static constexpr double ringSeconds = 2.0;     // Disk stall the ring absorbs
+    
     struct RecordingState {
         bool isArmed = false;
         bool isRecording = false;
@@ -239,18 +373,38 @@ public:
     
 private:
     int trackId;
+    int channels;
     RecordingState state;
     std::unique_ptr<RecordingBuffer> buffer;
     std::unique_ptr<AudioFileWriter> fileWriter;
     AudioFileWriter::AudioFormat audioFormat;
+    std::vector<float> flushBuffer;     // Interleaved, reused between flushes (writer side)
+    
+    // Audio thread; takes are published through takeCount
+    std::atomic<bool> capturing{false};
+    std::unique_ptr<Take[]> takes;
+    std::atomic<int> takeCount{0};
+    std::atomic<int64_t> droppedFrames{0};     // Input the full ring could not keep
+    int64_t nextSample = 0;             // Timeline sample the current take continues at
+    int64_t framesCaptured = 0;         // Frames handed to the ring so far
+    
+    // Writer thread
+    std::thread writerThread;
+    std::atomic<bool> writerRunning{false};
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
     
 public:
-    TrackRecorder(int id, int bufferSize = 8192, int channels = 2) 
-        : trackId(id) {
-        buffer = std::make_unique<RecordingBuffer>(bufferSize, channels);
+    TrackRecorder(int id, int numChannels = 2)
+        : trackId(id), channels(std::max(1, numChannels)), takes(std::make_unique<Take[]>(maxTakes)) {
         audioFormat.channels = channels;
     }
     
+    ~TrackRecorder() {
+        stopRecording();
+    }
+    
+    // Not real-time safe
     bool startRecording(const std::string& filename, double startTime) {
         if (state.isRecording || !state.isArmed) return false;
         
@@ -263,15 +417,42 @@ public:
             return false;
         }
         
+        // Everything the audio thread touches is sized here, before it sees the recording
+        const int ringFrames = static_cast<int>(std::ceil(audioFormat.sampleRate * ringSeconds));
+        if (!buffer || buffer->getCapacity() < ringFrames) {
+            buffer = std::make_unique<RecordingBuffer>(ringFrames, channels);
+        }
         buffer->clear();
+        flushBuffer.resize(static_cast<size_t>(flushFrames) * channels);
+        droppedFrames = 0;
+        takeCount = 0;
+        nextSample = 0;
+        framesCaptured = 0;
         state.isRecording = true;
         
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+        writerRunning = true;
+        writerThread = std::thread(&TrackRecorder::writerThreadMain, this);
+#endif
+        
+        capturing = true;
         return true;
     }
     
+    // Not real-time safe; a block in flight may still land in the ring, but never in the file
     void stopRecording() {
         if (!state.isRecording) return;
         
+        capturing = false;
+        if (writerThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                writerRunning = false;
+            }
+            wakeCondition.notify_one();
+            writerThread.join();
+        }
+        
         // Flush remaining buffer to file
         if (fileWriter) {
             flushBufferToFile();
@@ -282,21 +463,43 @@ public:
         state.isRecording = false;
     }
     
+    // Audio thread
     void processAudio(const float* inputSamples, int numFrames, double currentTime) {
-        if (!state.isRecording) return;
+        if (!capturing.load(std::memory_order_acquire)) return;
         
-        // Check punch in/out times for punch recording
+        // Punch boundaries fall on the exact sample inside the block
+        const double sampleRate = audioFormat.sampleRate;
+        int64_t blockStart = static_cast<int64_t>(std::llround(currentTime * sampleRate));
+        int64_t begin = blockStart;
+        int64_t end = blockStart + numFrames;
         if (state.mode == RecordMode::PUNCH_IN_OUT) {
-            if (currentTime < state.punchInTime || currentTime > state.punchOutTime) {
-                return; // Outside punch range
-            }
+            begin = std::max(begin, static_cast<int64_t>(std::llround(state.punchInTime * sampleRate)));
+            end = std::min(end, static_cast<int64_t>(std::llround(state.punchOutTime * sampleRate)));
         }
+        if (end <= begin) return; // Outside punch range
         
-        // Write to recording buffer
-        buffer->write(inputSamples, numFrames);
-        
-        // Periodically flush to file to avoid buffer overflow
-        if (buffer->getAvailableFrames() > 4096) {
+        // A jump in position (loop wrap, punch-in) starts a new take in the same file
+        int count = takeCount.load(std::memory_order_relaxed);
+        if ((count == 0 || begin != nextSample) && count < maxTakes) {
+            takes[count] = { begin / sampleRate, framesCaptured };
+            takeCount.store(count + 1, std::memory_order_release);
+        }
+        nextSample = end;
+        
+        // The writer keeps the ring well short of full; a block it cannot take
+        // is counted, and the file stays aligned with the takes
+        const float* samples = inputSamples + static_cast<size_t>(begin - blockStart) * channels;
+        const int frames = static_cast<int>(end - begin);
+        if (buffer->write(samples, frames)) {
+            framesCaptured += frames;
+        } else {
+            droppedFrames.fetch_add(frames, std::memory_order_relaxed);
+        }
+    }
+    
+    // Drains on the calling thread when there is no writer thread (single-threaded builds)
+    void service() {
+        if (capturing.load() && !writerThread.joinable()) {
             flushBufferToFile();
         }
     }
@@ -314,20 +517,42 @@ public:
     
     void setAudioFormat(const AudioFileWriter::AudioFormat& format) {
         audioFormat = format;
+        audioFormat.channels = channels;
     }
     
     const RecordingState& getState() const { return state; }
     
+    // Loop passes, all in recordingPath (not real-time safe)
+    std::vector<Take> getTakes() const {
+        const int count = takeCount.load(std::memory_order_acquire);
+        return std::vector<Take>(takes.get(), takes.get() + count);
+    }
+    int64_t getDroppedFrames() const { return droppedFrames.load(std::memory_order_relaxed); }
+    
 private:
+    static constexpr int flushFrames = 4096;
+    static constexpr auto drainInterval = std::chrono::milliseconds(5);
+    
+    void writerThreadMain() {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        while (writerRunning.load()) {
+            lock.unlock();
+            flushBufferToFile();
+            lock.lock();
+            
+            // The audio thread never signals; poll well inside the ring's capacity
+            wakeCondition.wait_for(lock, drainInterval, [this] { return !writerRunning.load(); });
+        }
+    }
+    
+    // Writer side of the ring: the writer thread, or the caller once it has stopped
     void flushBufferToFile() {
         if (!fileWriter || !buffer) return;
         
-        const int maxFrames = 1024;
-        std::vector<float> tempBuffer(maxFrames * audioFormat.channels);
-        
         int framesRead;
-        while ((framesRead = buffer->read(tempBuffer.data(), maxFrames)) > 0) {
-            fileWriter->writeInterleavedSamples(tempBuffer.data(), framesRead);
+        while (buffer->getAvailableFrames() > 0 &&
+               (framesRead = buffer->read(flushBuffer.data(), flushFrames)) > 0) {
+            fileWriter->writeInterleavedSamples(flushBuffer.data(), framesRead);
         }
     }
 };
@@ -400,6 +625,13 @@ public:
         }
     }
     
+    // Single-threaded builds: call from the main loop while recording
+    void service() {
+        for (auto& recorder : trackRecorders) {
+            if (recorder) recorder->service();
+        }
+    }
+    
     // Utility functions
     void armTrack(int trackId, bool armed) {
         if (auto recorder = getTrackRecorder(trackId)) {
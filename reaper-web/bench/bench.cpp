@@ -0,0 +1,156 @@
+/*
+ * REAPER Web - DSP Benchmarks Implementation
+ * Timing loop and JSON output
+ */
+
+#include "bench.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::string EscapeJSON(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string FormatNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.4g", value);
+    return text;
+}
+
+} // anonymous namespace
+
+// BenchmarkRunner Implementation
+bool BenchmarkRunner::IsSelected(const std::string& group, const std::string& name) const {
+    return m_options.filter.empty() || (group + "/" + name).find(m_options.filter) != std::string::npos;
+}
+
+void BenchmarkRunner::Run(const std::string& group, const std::string& name, int channels, int64_t samplesPerCall,
+                          const std::function<void()>& body) {
+    if (!IsSelected(group, name) || samplesPerCall <= 0) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and lazy state, and size the repetitions from the warm-up rate
+    int64_t calls = 0;
+    const auto warmupStart = Clock::now();
+    double elapsed = 0.0;
+    do {
+        body();
+        ++calls;
+        elapsed = std::chrono::duration<double>(Clock::now() - warmupStart).count();
+    } while (elapsed < m_options.minSeconds * 0.25);
+
+    const int64_t callsPerRep = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(calls * m_options.minSeconds / elapsed)));
+
+    std::vector<double> nsPerSample;
+    for (int rep = 0; rep < std::max(1, m_options.repetitions); ++rep) {
+        const auto start = Clock::now();
+        for (int64_t call = 0; call < callsPerRep; ++call) {
+            body();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        nsPerSample.push_back(ns / (static_cast<double>(callsPerRep) * samplesPerCall));
+    }
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+
+    BenchmarkResult result;
+    result.group = group;
+    result.name = name;
+    result.channels = channels;
+    result.samplesPerCall = samplesPerCall;
+    result.calls = callsPerRep;
+    result.nsPerSample = nsPerSample[nsPerSample.size() / 2];
+    result.minNsPerSample = nsPerSample.front();
+    result.realtimeFactor = result.nsPerSample > 0.0 ? 1.0e9 / (m_options.sampleRate * result.nsPerSample) : 0.0;
+    m_results.push_back(result);
+
+    std::cerr << "  " << group << "/" << name << ": " << FormatNumber(result.nsPerSample) << " ns/sample, "
+              << FormatNumber(result.realtimeFactor) << "x realtime\n";
+}
+
+void BenchmarkRunner::RunStereo(const std::string& group, const std::string& name, const StereoProcess& process) {
+    if (!IsSelected(group, name)) {
+        return;
+    }
+
+    // A second of input, long enough that tails and modulation never see a loop in it
+    const int blockSize = m_options.blockSize;
+    const int inputBlocks = std::max(1, static_cast<int>(m_options.sampleRate) / blockSize);
+    const int64_t inputFrames = static_cast<int64_t>(inputBlocks) * blockSize;
+    std::vector<float> inputL(static_cast<size_t>(inputFrames));
+    std::vector<float> inputR(static_cast<size_t>(inputFrames));
+    TestSignal signal(m_options.seed);
+    signal.FillMusic(inputL.data(), inputFrames, m_options.sampleRate);
+    signal.FillMusic(inputR.data(), inputFrames, m_options.sampleRate);
+    std::vector<float> outputL(static_cast<size_t>(blockSize));
+    std::vector<float> outputR(static_cast<size_t>(blockSize));
+
+    int block = 0;
+    Run(group, name, 2, blockSize, [&] {
+        const size_t offset = static_cast<size_t>(block) * blockSize;
+        process(inputL.data() + offset, inputR.data() + offset, outputL.data(), outputR.data(), blockSize);
+        block = (block + 1) % inputBlocks;
+    });
+}
+
+std::string BenchmarkRunner::ToJSON() const {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"suite\": \"reaper-web-dsp\",\n";
+    json << "  \"sampleRate\": " << m_options.sampleRate << ",\n";
+    json << "  \"blockSize\": " << m_options.blockSize << ",\n";
+    json << "  \"seed\": " << m_options.seed << ",\n";
+    json << "  \"repetitions\": " << m_options.repetitions << ",\n";
+#if defined(__VERSION__)
+    json << "  \"compiler\": \"" << EscapeJSON(__VERSION__) << "\",\n";
+#endif
+#if defined(NDEBUG)
+    json << "  \"assertions\": false,\n";
+#else
+    json << "  \"assertions\": true,\n";
+#endif
+    json << "  \"results\": [";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& result = m_results[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {\"group\": \"" << EscapeJSON(result.group) << "\", \"name\": \"" << EscapeJSON(result.name)
+             << "\", \"channels\": " << result.channels
+             << ", \"samplesPerCall\": " << result.samplesPerCall
+             << ", \"calls\": " << result.calls
+             << ", \"nsPerSample\": " << FormatNumber(result.nsPerSample)
+             << ", \"minNsPerSample\": " << FormatNumber(result.minNsPerSample)
+             << ", \"realtimeFactor\": " << FormatNumber(result.realtimeFactor) << "}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+// TestSignal Implementation
+void TestSignal::FillMusic(float* dest, int64_t numSamples, double sampleRate, float amplitude) {
+    // A chord of three partials with a slow swell, and a noise floor under it
+    const double partials[] = { 110.0, 164.81, 277.18 };
+    for (int64_t i = 0; i < numSamples; ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        double value = 0.0;
+        for (double frequency : partials) {
+            value += std::sin(2.0 * kPi * frequency * t);
+        }
+        const double swell = 0.6 + 0.4 * std::sin(2.0 * kPi * 0.5 * t);
+        dest[i] = static_cast<float>(value / 3.0 * swell * 0.8 + Next() * 0.2) * amplitude;
+    }
+}
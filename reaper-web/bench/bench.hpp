@@ -0,0 +1,106 @@
+/*
+ * REAPER Web - DSP Benchmarks
+ * Shared harness: fixed-seed test signals, timing and JSON results
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * BenchmarkResult - One measured hot path
+ * A "sample" is one sample frame (all channels of one sample time), so
+ * ns/sample and the realtime factor compare directly with a device block.
+ */
+struct BenchmarkResult {
+    std::string group;                  // Suite ("audio_buffer", "jsfx", ...)
+    std::string name;
+    int channels = 2;
+    int64_t samplesPerCall = 0;         // Sample frames one call processes
+    int64_t calls = 0;                  // Calls per timed repetition
+    double nsPerSample = 0.0;           // Median over the repetitions
+    double minNsPerSample = 0.0;        // Fastest repetition
+    double realtimeFactor = 0.0;        // Seconds of audio per second of processing
+};
+
+/**
+ * BenchmarkRunner - Times a body repeatedly and collects the results
+ * Each benchmark is warmed up, then timed in repetitions of enough calls
+ * to run for at least the minimum time; the median repetition is kept so
+ * one descheduled run does not move the figure.
+ */
+class BenchmarkRunner {
+public:
+    struct Options {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double minSeconds = 0.1;        // Per repetition
+        int repetitions = 5;
+        std::string filter;             // Only "group/name" containing this; empty runs all
+        uint32_t seed = 0x5EED1234;     // Every test signal derives from this
+    };
+
+    explicit BenchmarkRunner(const Options& options) : m_options(options) {}
+
+    const Options& GetOptions() const { return m_options; }
+    bool IsSelected(const std::string& group, const std::string& name) const;
+
+    // body processes samplesPerCall sample frames of channels channels per call
+    void Run(const std::string& group, const std::string& name, int channels, int64_t samplesPerCall,
+             const std::function<void()>& body);
+
+    // Streams fixed-seed program material through a stereo processor one
+    // block per call, input and output kept apart
+    using StereoProcess = std::function<void(const float* inL, const float* inR, float* outL, float* outR, int frames)>;
+    void RunStereo(const std::string& group, const std::string& name, const StereoProcess& process);
+
+    const std::vector<BenchmarkResult>& GetResults() const { return m_results; }
+    std::string ToJSON() const;
+
+private:
+    Options m_options;
+    std::vector<BenchmarkResult> m_results;
+};
+
+/**
+ * TestSignal - Deterministic synthetic audio
+ * A small xorshift generator rather than <random> distributions, whose
+ * output differs between standard libraries: the same seed is the same
+ * audio on every machine, so results stay comparable across commits.
+ */
+class TestSignal {
+public:
+    explicit TestSignal(uint32_t seed) : m_state(seed ? seed : 1u) {}
+
+    // Uniform in [-1, 1)
+    float Next() {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return static_cast<float>(m_state) * (2.0f / 4294967296.0f) - 1.0f;
+    }
+
+    void FillNoise(float* dest, int64_t numSamples, float amplitude = 0.5f) {
+        for (int64_t i = 0; i < numSamples; ++i) {
+            dest[i] = Next() * amplitude;
+        }
+    }
+
+    // Noise under a few partials - something for filters and reverbs to ring on
+    void FillMusic(float* dest, int64_t numSamples, double sampleRate, float amplitude = 0.5f);
+
+private:
+    uint32_t m_state;
+};
+
+// Suites - each registers its benchmarks with the runner
+void RunAudioBufferBenchmarks(BenchmarkRunner& runner);
+void RunEffectBenchmarks(BenchmarkRunner& runner);
+void RunMediaBenchmarks(BenchmarkRunner& runner);
+void RunReverbDragonflyBenchmark(BenchmarkRunner& runner);
+void RunReverbHibikiBenchmark(BenchmarkRunner& runner);
+void RunReverbProGBenchmark(BenchmarkRunner& runner);
+void RunEngineBenchmarks(BenchmarkRunner& runner);
@@ -0,0 +1,57 @@
+/*
+ * REAPER Web - AudioBuffer Benchmarks
+ * Gain, mix, copy and metering kernels on one device block
+ */
+
+#include "bench.hpp"
+#include "../src/core/audio_buffer.hpp"
+
+void RunAudioBufferBenchmarks(BenchmarkRunner& runner) {
+    const BenchmarkRunner::Options& options = runner.GetOptions();
+    const int channels = 2;
+    const int blockSize = options.blockSize;
+
+    TestSignal signal(options.seed);
+    AudioBuffer source(channels, blockSize);
+    AudioBuffer dest(channels, blockSize);
+    for (int ch = 0; ch < channels; ++ch) {
+        signal.FillNoise(source.GetChannelData(ch), blockSize);
+        signal.FillNoise(dest.GetChannelData(ch), blockSize);
+    }
+
+    volatile float sink = 0.0f;
+    bool flip = false;
+
+    runner.Run("audio_buffer", "CopyFrom", channels, blockSize, [&] {
+        dest.CopyFrom(source);
+    });
+
+    // Grows by one source block per call; stays far from overflow for any run length
+    runner.Run("audio_buffer", "AddFrom", channels, blockSize, [&] {
+        dest.AddFrom(source);
+    });
+
+    // Gains alternate so the data neither decays into denormals nor overflows
+    runner.Run("audio_buffer", "AddFromWithGain", channels, blockSize, [&] {
+        flip = !flip;
+        dest.AddFromWithGain(source, flip ? 0.5f : -0.5f);
+    });
+
+    runner.Run("audio_buffer", "ApplyGain", channels, blockSize, [&] {
+        flip = !flip;
+        dest.ApplyGain(flip ? 0.5f : 2.0f);
+    });
+
+    runner.Run("audio_buffer", "ApplyGainRamp", channels, blockSize, [&] {
+        flip = !flip;
+        dest.ApplyGainRamp(flip ? 0.999f : 1.001f, flip ? 1.001f : 0.999f);
+    });
+
+    runner.Run("audio_buffer", "GetPeakLevel", channels, blockSize, [&] {
+        sink = sink + source.GetPeakLevel();
+    });
+
+    runner.Run("audio_buffer", "GetRMSLevel", channels, blockSize, [&] {
+        sink = sink + source.GetRMSLevel();
+    });
+}
@@ -0,0 +1,62 @@
+/*
+ * REAPER Web - Effect Benchmarks
+ * Each built-in JSFX script on its own, then all of them in one EffectChain
+ */
+
+#include "bench.hpp"
+#include "../src/effects/effect_chain.hpp"
+#include "../src/effects/reaper_effects.hpp"
+#include <iostream>
+
+void RunEffectBenchmarks(BenchmarkRunner& runner) {
+    const BenchmarkRunner::Options& options = runner.GetOptions();
+    const int channels = 2;
+    const int blockSize = options.blockSize;
+
+    // One input block, restored before every call so feedback and
+    // envelopes see program material rather than their own decaying output
+    TestSignal signal(options.seed);
+    AudioBuffer input(channels, blockSize);
+    input.SetSampleRate(options.sampleRate);
+    for (int ch = 0; ch < channels; ++ch) {
+        signal.FillMusic(input.GetChannelData(ch), blockSize, options.sampleRate);
+    }
+    AudioBuffer buffer(channels, blockSize);
+    buffer.SetSampleRate(options.sampleRate);
+
+    BuiltinEffectsManager effectsManager;
+    const std::vector<std::string> effectNames = effectsManager.GetAvailableEffects();
+
+    for (const std::string& effectName : effectNames) {
+        if (!runner.IsSelected("jsfx", effectName)) continue;
+
+        std::unique_ptr<JSFXEffect> effect = effectsManager.CreateEffect(effectName);
+        if (!effect) {
+            std::cerr << "  jsfx/" << effectName << ": script failed to load, skipped\n";
+            continue;
+        }
+        effect->Initialize(options.sampleRate, blockSize);
+
+        runner.Run("jsfx", effectName, channels, blockSize, [&] {
+            buffer.CopyFrom(input);
+            effect->ProcessBlock(buffer);
+        });
+    }
+
+    if (runner.IsSelected("effect_chain", "all_builtin")) {
+        EffectChain chain;
+        for (const std::string& effectName : effectNames) {
+            std::unique_ptr<JSFXEffect> effect = effectsManager.CreateEffect(effectName);
+            if (effect) {
+                effect->Initialize(options.sampleRate, blockSize);
+                chain.AddEffect(std::move(effect));
+            }
+        }
+
+        // Includes the chain's per-effect CPU metering
+        runner.Run("effect_chain", "all_builtin", channels, blockSize, [&] {
+            buffer.CopyFrom(input);
+            chain.ProcessAudio(buffer);
+        });
+    }
+}
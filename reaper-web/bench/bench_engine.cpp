@@ -0,0 +1,120 @@
+/*
+ * REAPER Web - Engine Benchmarks
+ * A whole device block through AudioEngine::ProcessBlock with 100 playing tracks
+ */
+
+#include "bench.hpp"
+#include "../src/core/audio_engine.hpp"
+#include "../src/core/track_manager.hpp"
+#include "../src/effects/effect_chain.hpp"
+#include "../src/effects/reaper_effects.hpp"
+#include "../src/media/media_item.hpp"
+#include "../src/recording/audio_file_writer.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+constexpr int kTracks = 100;
+constexpr double kItemSeconds = 10.0;
+
+// One project: kTracks tracks, each playing an item of the shared test file
+class EngineProject {
+public:
+    EngineProject(const BenchmarkRunner::Options& options, const std::string& sourcePath, const char* effectName)
+        : m_options(options) {
+        m_engine.Initialize(options.sampleRate, options.blockSize, 2);
+        m_trackManager.Initialize(&m_engine);
+        m_mediaManager.PrepareForPlayback(options.sampleRate, options.blockSize);
+
+        BuiltinEffectsManager effectsManager;
+        for (int t = 0; t < kTracks; ++t) {
+            Track* track = m_trackManager.CreateTrack("Track " + std::to_string(t + 1));
+            track->SetVolume(0.5);
+            track->SetPan((t % 9 - 4) / 4.0);
+
+            // Staggered short fades so item edges fall on different blocks
+            MediaItem* item = m_mediaManager.CreateItem(track, sourcePath, 0.0);
+            item->SetFadeIn(0.01 * (t % 10 + 1));
+            item->SetFadeOut(0.01 * (t % 10 + 1));
+
+            if (effectName) {
+                std::unique_ptr<JSFXEffect> effect = effectsManager.CreateEffect(effectName);
+                if (effect && track->GetEffectsChain()) {
+                    effect->Initialize(options.sampleRate, options.blockSize);
+                    track->GetEffectsChain()->AddEffect(std::move(effect));
+                }
+            }
+        }
+
+        m_outputData.assign(2 * static_cast<size_t>(options.blockSize), 0.0f);
+        m_outputs[0] = m_outputData.data();
+        m_outputs[1] = m_outputData.data() + options.blockSize;
+        m_engine.PrepareForTracks(kTracks);
+        m_engine.StartPlayback();
+    }
+
+    ~EngineProject() {
+        m_engine.StopPlayback();
+        m_trackManager.Shutdown();
+        m_engine.Shutdown();
+    }
+
+    void ProcessBlock() {
+        const int64_t itemEnd = static_cast<int64_t>(kItemSeconds * m_options.sampleRate);
+        if (m_position + m_options.blockSize > itemEnd) m_position = 0;
+        m_engine.ProcessBlock(nullptr, m_outputs, 2, m_options.blockSize, &m_mediaManager, &m_trackManager, m_position);
+        m_position += m_options.blockSize;
+    }
+
+private:
+    BenchmarkRunner::Options m_options;
+    AudioEngine m_engine;
+    TrackManager m_trackManager;
+    MediaItemManager m_mediaManager;
+    std::vector<float> m_outputData;
+    float* m_outputs[2] = {};
+    int64_t m_position = 0;
+};
+
+} // anonymous namespace
+
+void RunEngineBenchmarks(BenchmarkRunner& runner) {
+    const BenchmarkRunner::Options& options = runner.GetOptions();
+    if (!runner.IsSelected("engine", "100_tracks") && !runner.IsSelected("engine", "100_tracks_fx")) {
+        return;
+    }
+
+    // Every item plays the same file; its blocks are decoded once into the shared cache
+    const std::string sourcePath = (std::filesystem::temp_directory_path() / "reaper_bench_engine.wav").string();
+    {
+        const int64_t frames = static_cast<int64_t>(kItemSeconds * options.sampleRate);
+        std::vector<float> left(static_cast<size_t>(frames));
+        std::vector<float> right(static_cast<size_t>(frames));
+        TestSignal signal(options.seed);
+        signal.FillMusic(left.data(), frames, options.sampleRate);
+        signal.FillMusic(right.data(), frames, options.sampleRate);
+
+        AudioFileWriter writer;
+        const float* channels[] = { left.data(), right.data() };
+        if (!writer.Open(sourcePath, options.sampleRate, 2) || !writer.Write(channels, static_cast<int>(frames)) ||
+            !writer.Close()) {
+            std::cerr << "  engine: could not write test audio to " << sourcePath << ", skipped\n";
+            return;
+        }
+    }
+
+    if (runner.IsSelected("engine", "100_tracks")) {
+        EngineProject project(options, sourcePath, nullptr);
+        runner.Run("engine", "100_tracks", 2, options.blockSize, [&] { project.ProcessBlock(); });
+    }
+
+    // One interpreted JSFX per track on top
+    if (runner.IsSelected("engine", "100_tracks_fx")) {
+        EngineProject project(options, sourcePath, "High Pass Filter");
+        runner.Run("engine", "100_tracks_fx", 2, options.blockSize, [&] { project.ProcessBlock(); });
+    }
+
+    std::remove(sourcePath.c_str());
+}
@@ -0,0 +1,93 @@
+/*
+ * REAPER Web - DSP Benchmark Application
+ * Runs every suite and prints the results as JSON
+ *
+ * Usage: reaper_bench [--filter TEXT] [--min-time SECONDS] [--repetitions N]
+ *                     [--block-size N] [--sample-rate HZ] [--seed N] [--output FILE]
+ */
+
+#include "bench.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void PrintUsage() {
+    std::cerr << "Usage: reaper_bench [--filter TEXT] [--min-time SECONDS] [--repetitions N]\n"
+                 "                    [--block-size N] [--sample-rate HZ] [--seed N] [--output FILE]\n"
+                 "Times the DSP hot paths on fixed-seed synthetic audio. JSON goes to stdout\n"
+                 "(or FILE), progress to stderr. --filter keeps \"group/name\" containing TEXT.\n";
+}
+
+} // anonymous namespace
+
+// Main benchmark function
+int main(int argc, char** argv) {
+    BenchmarkRunner::Options options;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        }
+        if (!value) {
+            PrintUsage();
+            return 1;
+        }
+
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--min-time") {
+            options.minSeconds = std::atof(value);
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::atoi(value);
+        } else if (arg == "--block-size") {
+            options.blockSize = std::atoi(value);
+        } else if (arg == "--sample-rate") {
+            options.sampleRate = std::atof(value);
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 0));
+        } else if (arg == "--output") {
+            outputPath = value;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        ++i;
+    }
+
+    if (options.blockSize <= 0 || options.sampleRate <= 0.0 || options.minSeconds <= 0.0 || options.repetitions <= 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::cerr << "REAPER Web - DSP Benchmark\n";
+    std::cerr << "==========================\n";
+
+    BenchmarkRunner runner(options);
+    RunAudioBufferBenchmarks(runner);
+    RunEffectBenchmarks(runner);
+    RunMediaBenchmarks(runner);
+    RunReverbDragonflyBenchmark(runner);
+    RunReverbHibikiBenchmark(runner);
+    RunReverbProGBenchmark(runner);
+    RunEngineBenchmarks(runner);
+
+    const std::string json = runner.ToJSON();
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file(outputPath);
+        file << json;
+        if (!file) {
+            std::cerr << "Could not write " << outputPath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * REAPER Web - Media Benchmarks
+ * Item playback (direct mix, streamed, fades, resampled) and waveform peak generation
+ */
+
+#include "bench.hpp"
+#include "../src/core/audio_buffer.hpp"
+#include "../src/media/media_item.hpp"
+#include "../src/recording/audio_file_writer.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+constexpr double kSourceSeconds = 10.0;
+
+// Writes seconds of fixed-seed stereo test audio as a float WAV
+bool WriteTestFile(const std::string& path, double sampleRate, uint32_t seed) {
+    const int64_t frames = static_cast<int64_t>(kSourceSeconds * sampleRate);
+    std::vector<float> left(static_cast<size_t>(frames));
+    std::vector<float> right(static_cast<size_t>(frames));
+    TestSignal signal(seed);
+    signal.FillMusic(left.data(), frames, sampleRate);
+    signal.FillMusic(right.data(), frames, sampleRate);
+
+    AudioFileWriter writer;
+    if (!writer.Open(path, sampleRate, 2)) return false;
+    const float* channels[] = { left.data(), right.data() };
+    writer.Write(channels, static_cast<int>(frames));
+    return writer.Close();
+}
+
+// Plays an item block after block from its start, wrapping at its end
+void RunItemBenchmark(BenchmarkRunner& runner, const std::string& name, MediaItem& item) {
+    const BenchmarkRunner::Options& options = runner.GetOptions();
+    const int blockSize = options.blockSize;
+    const int64_t itemEnd = item.GetEndSample(options.sampleRate);
+
+    AudioBuffer buffer(2, blockSize);
+    buffer.SetSampleRate(options.sampleRate);
+    item.PrepareForPlayback(options.sampleRate, blockSize);
+
+    int64_t position = 0;
+    runner.Run("media_item", name, 2, blockSize, [&] {
+        if (position + blockSize > itemEnd) position = 0;
+        buffer.Clear();
+        item.ProcessAudio(buffer, position, blockSize);
+        position += blockSize;
+    });
+}
+
+} // anonymous namespace
+
+void RunMediaBenchmarks(BenchmarkRunner& runner) {
+    const BenchmarkRunner::Options& options = runner.GetOptions();
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string nativePath = (directory / "reaper_bench_native.wav").string();
+    const std::string otherRatePath = (directory / "reaper_bench_44100.wav").string();
+
+    if (!WriteTestFile(nativePath, options.sampleRate, options.seed) ||
+        !WriteTestFile(otherRatePath, 44100.0, options.seed)) {
+        std::cerr << "  media: could not write test audio to " << directory << ", skipped\n";
+        return;
+    }
+
+    {
+        // Sources held fully decoded, so the figures are the render path and not the disk
+        auto source = std::make_shared<AudioSource>(nativePath);
+        source->EnableCaching(false);
+
+        if (runner.IsSelected("media_item", "direct")) {
+            MediaItem item(nullptr);
+            item.AddTake(source);
+            RunItemBenchmark(runner, "direct", item);
+        }
+
+        if (runner.IsSelected("media_item", "streamed")) {
+            // The same mix read out of the block cache, every block resident
+            auto streamedSource = std::make_shared<AudioSource>(nativePath);
+            streamedSource->Prefetch(0, static_cast<int>(kSourceSeconds * options.sampleRate));
+            MediaItem item(nullptr);
+            item.AddTake(streamedSource);
+            RunItemBenchmark(runner, "streamed", item);
+        }
+
+        if (runner.IsSelected("media_item", "fades")) {
+            // Fades over the whole item: every block takes the fade path
+            MediaItem item(nullptr);
+            item.AddTake(source);
+            item.SetFadeIn(kSourceSeconds * 0.5, MediaItem::FadeType::EQUAL_POWER);
+            item.SetFadeOut(kSourceSeconds * 0.5, MediaItem::FadeType::SLOW_START_END);
+            RunItemBenchmark(runner, "fades", item);
+        }
+
+        if (runner.IsSelected("media_item", "resampled_fades")) {
+            auto otherRateSource = std::make_shared<AudioSource>(otherRatePath);
+            otherRateSource->EnableCaching(false);
+            MediaItem item(nullptr);
+            item.AddTake(otherRateSource);
+            item.SetFadeIn(kSourceSeconds * 0.5);
+            item.SetFadeOut(kSourceSeconds * 0.5);
+            RunItemBenchmark(runner, "resampled_fades", item);
+        }
+
+        // Peaks at a resolution outside the precomputed set, so every call computes them
+        const int64_t sourceFrames = static_cast<int64_t>(kSourceSeconds * options.sampleRate);
+        volatile float sink = 0.0f;
+        runner.Run("peaks", "decoded", 2, sourceFrames, [&] {
+            source->ClearCache();
+            sink = sink + source->GetPeakData(512).maxPeaks[0];
+        });
+
+        auto streamed = std::make_shared<AudioSource>(nativePath);
+        runner.Run("peaks", "streamed", 2, sourceFrames, [&] {
+            streamed->ClearCache();
+            sink = sink + streamed->GetPeakData(512).maxPeaks[0];
+        });
+    }
+
+    std::remove(nativePath.c_str());
+    std::remove(otherRatePath.c_str());
+}
@@ -0,0 +1,17 @@
+/*
+ * REAPER Web - Dragonfly Hall Reverb Benchmark
+ * Built on its own: the reverb engines each define a global clamp()
+ */
+
+#include "bench.hpp"
+#include "../../wasm-tests/cpp-reverb/reverb_engine.hpp"
+
+void RunReverbDragonflyBenchmark(BenchmarkRunner& runner) {
+    DragonflyHallReverb reverb(static_cast<float>(runner.GetOptions().sampleRate));
+    runner.RunStereo("reverb", "DragonflyHallReverb",
+                     [&](const float* inL, const float* inR, float* outL, float* outR, int frames) {
+        const float* inputs[] = { inL, inR };
+        float* outputs[] = { outL, outR };
+        reverb.run(inputs, outputs, frames);
+    });
+}
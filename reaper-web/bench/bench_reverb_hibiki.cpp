@@ -0,0 +1,15 @@
+/*
+ * REAPER Web - Hibiki Hall Reverb Benchmark
+ * Built on its own: the reverb engines each define a global clamp()
+ */
+
+#include "bench.hpp"
+#include "../../wasm-tests/hibiki-reverb/hibiki_engine.hpp"
+
+void RunReverbHibikiBenchmark(BenchmarkRunner& runner) {
+    HibikiProcessor processor(static_cast<float>(runner.GetOptions().sampleRate));
+    runner.RunStereo("reverb", "HibikiProcessor",
+                     [&](const float* inL, const float* inR, float* outL, float* outR, int frames) {
+        processor.processChannels(inL, inR, outL, outR, frames);
+    });
+}
@@ -0,0 +1,15 @@
+/*
+ * REAPER Web - ProG Room Reverb Benchmark
+ * Built on its own: the reverb engines each define a global clamp()
+ */
+
+#include "bench.hpp"
+#include "../../wasm-tests/prog-reverb/prog_engine.hpp"
+
+void RunReverbProGBenchmark(BenchmarkRunner& runner) {
+    ProGProcessor processor(static_cast<float>(runner.GetOptions().sampleRate));
+    runner.RunStereo("reverb", "ProGProcessor",
+                     [&](const float* inL, const float* inR, float* outL, float* outR, int frames) {
+        processor.processChannels(inL, inR, outL, outR, frames);
+    });
+}
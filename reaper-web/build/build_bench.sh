@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# REAPER Web Engine - Native Benchmark Build Script
+# Builds the DSP benchmark suite for the host machine and optionally runs it
+#
+# Usage: build_bench.sh [--run] [benchmark arguments...]
+#   CXX and CXXFLAGS override the compiler and flags on the first configure
+
+set -e
+
+# Configuration
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+OUTPUT_DIR="$SCRIPT_DIR/native"
+BENCH_NAME="reaper_bench"
+
+echo "Building $BENCH_NAME..." >&2
+
+cmake -S "$ROOT_DIR" -B "$OUTPUT_DIR" -DCMAKE_BUILD_TYPE=Release >&2
+cmake --build "$OUTPUT_DIR" --target "$BENCH_NAME" -j"$(nproc 2>/dev/null || echo 4)" >&2
+
+echo "Built $OUTPUT_DIR/$BENCH_NAME" >&2
+
+if [ "$1" == "--run" ]; then
+    shift
+    "$OUTPUT_DIR/$BENCH_NAME" "$@"
+fi
@@ -118,8 +118,23 @@ SOURCES=(
     # Core engine files
     "$SRC_DIR/core/reaper_engine.cpp"
     "$SRC_DIR/core/audio_engine.cpp"
+    "$SRC_DIR/core/project_manager.cpp"
+    "$SRC_DIR/core/rpp_parser.cpp"
+    "$SRC_DIR/core/mapped_file.cpp"
+    "$SRC_DIR/core/automation_envelope.cpp"
+    "$SRC_DIR/core/tempo_map.cpp"
+    "$SRC_DIR/core/metronome.cpp"
+    "$SRC_DIR/core/offline_renderer.cpp"
+    "$SRC_DIR/core/profiler.cpp"
+    "$SRC_DIR/recording/recording_buffer.cpp"
+    "$SRC_DIR/recording/audio_file_writer.cpp"
+    "$SRC_DIR/recording/track_recorder.cpp"
+    "$SRC_DIR/core/project_binary.cpp"
     "$SRC_DIR/core/track_manager.cpp"
+    "$SRC_DIR/core/undo_manager.cpp"
     "$SRC_DIR/core/audio_buffer.cpp"
+    "$SRC_DIR/core/sample_rate_converter.cpp"
+    "$SRC_DIR/core/fft.cpp"
     
     # Audio processing
     "$SRC_DIR/audio/audio_buffer.cpp"
@@ -133,6 +148,8 @@ SOURCES=(
     
     # Media handling
     "$SRC_DIR/media/media_item.cpp"
+    "$SRC_DIR/media/time_stretcher.cpp"
+    "$SRC_DIR/media/audio_block_cache.cpp"
     
     # UI components
     "$SRC_DIR/ui/timeline_view.cpp"
@@ -8,6 +8,59 @@
 #include <algorithm>
 #include <cstdlib>
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define REAPER_BUFFER_SSE 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define REAPER_BUFFER_WASM_SIMD 1
+#endif
+
+namespace {
+
+// data[i] *= gains[i]
+void MultiplyByCurve(float* data, const float* gains, int count) {
+    int i = 0;
+#if defined(REAPER_BUFFER_SSE)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+    }
+#elif defined(REAPER_BUFFER_WASM_SIMD)
+    for (; i + 4 <= count; i += 4) {
+        wasm_v128_store(data + i, wasm_f32x4_mul(wasm_v128_load(data + i), wasm_v128_load(gains + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        data[i] *= gains[i];
+    }
+}
+
+// data[i] *= startGain + i * delta (gain from the index, so long ramps do not drift)
+void MultiplyByRamp(float* data, float startGain, float delta, int count) {
+    int i = 0;
+#if defined(REAPER_BUFFER_SSE)
+    __m128 gain = _mm_add_ps(_mm_set1_ps(startGain), _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), _mm_set1_ps(delta)));
+    const __m128 step = _mm_set1_ps(4.0f * delta);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+        gain = _mm_add_ps(gain, step);
+    }
+#elif defined(REAPER_BUFFER_WASM_SIMD)
+    v128_t gain = wasm_f32x4_add(wasm_f32x4_splat(startGain),
+                                 wasm_f32x4_mul(wasm_f32x4_make(0.0f, 1.0f, 2.0f, 3.0f), wasm_f32x4_splat(delta)));
+    const v128_t step = wasm_f32x4_splat(4.0f * delta);
+    for (; i + 4 <= count; i += 4) {
+        wasm_v128_store(data + i, wasm_f32x4_mul(wasm_v128_load(data + i), gain));
+        gain = wasm_f32x4_add(gain, step);
+    }
+#endif
+    for (; i < count; ++i) {
+        data[i] *= startGain + static_cast<float>(i) * delta;
+    }
+}
+
+} // namespace
+
 // Static member initialization
 size_t AudioBuffer::s_alignment = 16; // 16-byte alignment for SIMD
 
@@ -37,6 +90,15 @@ void AudioBuffer::SetSize(int numChannels, int numSamples) {
     }
 }
 
+void AudioBuffer::Reserve(int numChannels, int numSamples) {
+    if (numChannels <= 0 || numSamples <= 0) return;
+    
+    // Same padding as AllocateMemory() so the aligned layout fits in the reservation
+    size_t totalSamples = static_cast<size_t>(numChannels) * numSamples;
+    m_data.reserve(totalSamples + (s_alignment / sizeof(float)));
+    m_channelPtrs.reserve(numChannels);
+}
+
 void AudioBuffer::Clear() {
     if (!m_data.empty()) {
         std::fill(m_data.begin(), m_data.end(), 0.0f);
@@ -106,16 +168,20 @@ void AudioBuffer::ApplyGainRamp(float startGain, float endGain, int startSample,
     
     if (samplesToProcess <= 0) return;
     
-    float gainDelta = (endGain - startGain) / static_cast<float>(samplesToProcess - 1);
+    float gainDelta = samplesToProcess > 1 ? (endGain - startGain) / static_cast<float>(samplesToProcess - 1) : 0.0f;
     
     for (int ch = 0; ch < m_numChannels; ++ch) {
-        float* channelData = m_channelPtrs[ch] + startSample;
-        float currentGain = startGain;
-        
-        for (int i = 0; i < samplesToProcess; ++i) {
-            channelData[i] *= currentGain;
-            currentGain += gainDelta;
-        }
+        MultiplyByRamp(m_channelPtrs[ch] + startSample, startGain, gainDelta, samplesToProcess);
+    }
+}
+
+void AudioBuffer::ApplyGainCurve(const float* gains, int startSample, int numSamples) {
+    if (!gains || startSample < 0 || startSample >= m_numSamples) return;
+    
+    int samplesToProcess = std::min(startSample + numSamples, m_numSamples) - startSample;
+    
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        MultiplyByCurve(m_channelPtrs[ch] + startSample, gains, samplesToProcess);
     }
 }
 
@@ -168,6 +234,27 @@ void AudioBuffer::AddFromWithGain(const AudioBuffer& source, float gain) {
     }
 }
 
+void AudioBuffer::AddFromWithGain(const AudioBuffer& source, int sourceStartSample, int destStartSample, int numSamples, float gain) {
+    if (sourceStartSample < 0 || destStartSample < 0 ||
+        sourceStartSample >= source.m_numSamples || destStartSample >= m_numSamples) {
+        return;
+    }
+    
+    int channelsToProcess = std::min(m_numChannels, source.m_numChannels);
+    int srcSamplesToProcess = std::min(numSamples, source.m_numSamples - sourceStartSample);
+    int dstSamplesToProcess = std::min(numSamples, m_numSamples - destStartSample);
+    int samplesToProcess = std::min(srcSamplesToProcess, dstSamplesToProcess);
+    
+    for (int ch = 0; ch < channelsToProcess; ++ch) {
+        const float* srcData = source.m_channelPtrs[ch] + sourceStartSample;
+        float* dstData = m_channelPtrs[ch] + destStartSample;
+        
+        for (int i = 0; i < samplesToProcess; ++i) {
+            dstData[i] += srcData[i] * gain;
+        }
+    }
+}
+
 void AudioBuffer::CopyFrom(const AudioBuffer& source) {
     int channelsToProcess = std::min(m_numChannels, source.m_numChannels);
     int samplesToProcess = std::min(m_numSamples, source.m_numSamples);
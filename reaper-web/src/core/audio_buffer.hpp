@@ -23,6 +23,7 @@ public:
     
     // Buffer management
     void SetSize(int numChannels, int numSamples);
+    void Reserve(int numChannels, int numSamples);   // Later SetSize() up to this size never allocates
     void Clear();
     void ClearRange(int startSample, int numSamples);
     
@@ -43,11 +44,13 @@ public:
     void ApplyGain(float gain, int startSample, int numSamples);
     void ApplyGainRamp(float startGain, float endGain);
     void ApplyGainRamp(float startGain, float endGain, int startSample, int numSamples);
+    void ApplyGainCurve(const float* gains, int startSample, int numSamples);  // Per-sample gains, one per frame
     
     // Mixing operations
     void AddFrom(const AudioBuffer& source);
     void AddFrom(const AudioBuffer& source, int sourceStartSample, int destStartSample, int numSamples);
     void AddFromWithGain(const AudioBuffer& source, float gain);
+    void AddFromWithGain(const AudioBuffer& source, int sourceStartSample, int destStartSample, int numSamples, float gain);
     void CopyFrom(const AudioBuffer& source);
     void CopyFrom(const AudioBuffer& source, int sourceStartSample, int destStartSample, int numSamples);
     
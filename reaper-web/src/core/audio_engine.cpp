@@ -5,22 +5,28 @@
 
 #include "audio_engine.hpp"
 #include "track_manager.hpp"
+#include "profiler.hpp"
 #include "../media/media_item.hpp"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 AudioEngine::AudioEngine() {
     // Initialize performance stats
     m_stats.cpuUsage = 0.0;
     m_stats.peakCpuUsage = 0.0;
     m_stats.dropouts = 0;
+    m_stats.deadlineMisses = 0;
     m_stats.activePlugins = 0;
     m_stats.samplesProcessed = 0;
     m_stats.latencyMs = 0.0;
     
     // Initialize buffer pool
     m_bufferPool = std::make_unique<AudioBufferPool>(32); // 32 buffer max pool
+    
+    // Dropout reports are written by the audio thread without allocating
+    m_reports = std::make_unique<ReportSlot[]>(MAX_DROPOUT_REPORTS);
 }
 
 AudioEngine::~AudioEngine() {
@@ -44,6 +50,14 @@ bool AudioEngine::Initialize(double sampleRate, int bufferSize, int maxChannels)
     // Initialize PDC system
     m_trackDelays.resize(64, 0); // Support up to 64 tracks initially
     
+    // Per-track item list is reused every block; the track lists are sized by PrepareForTracks()
+    m_itemScratch.reserve(256);
+    
+    // Block timing uses the cycle counter; its rate is measured here, not on the audio thread
+    m_ticksPerMs = CycleClock::GetTicksPerMicrosecond() * 1000.0;
+    
+    m_metronome.Prepare(sampleRate);
+    
     // Set latency calculation
     m_stats.latencyMs = (static_cast<double>(bufferSize) / sampleRate) * 1000.0;
     
@@ -77,11 +91,13 @@ void AudioEngine::StartPlayback() {
 
 void AudioEngine::StopPlayback() {
     m_isPlaying = false;
+    m_metronome.CancelCountIn();
 }
 
 void AudioEngine::PausePlayback() {
     // In REAPER, pause keeps the position
     m_isPlaying = false;
+    m_metronome.CancelCountIn();
 }
 
 void AudioEngine::StartRecording() {
@@ -97,6 +113,50 @@ void AudioEngine::SetPlayPosition(double seconds) {
     m_playPosition = std::max(0.0, seconds);
 }
 
+// Not real-time safe; call with the device stopped
+void AudioEngine::PrepareForTracks(int numTracks) {
+    const size_t capacity = static_cast<size_t>(std::max(numTracks, 0));
+    m_trackOrder.reserve(capacity);
+    m_trackTicks.reserve(capacity);
+}
+
+void AudioEngine::SetSampleRate(double rate) {
+    if (rate <= 0.0) {
+        return;
+    }
+    
+    m_settings.sampleRate = rate;
+    m_metronome.Prepare(rate);
+    m_stats.latencyMs = (static_cast<double>(m_settings.bufferSize) / rate) * 1000.0;
+}
+
+// Not real-time safe; call with the device stopped
+void AudioEngine::SetBufferSize(int size) {
+    if (size <= 0) {
+        return;
+    }
+    
+    m_settings.bufferSize = size;
+    if (m_initialized.load()) {
+        DeallocateBufferPool();
+        AllocateBufferPool();
+    }
+    m_stats.latencyMs = (static_cast<double>(size) / m_settings.sampleRate) * 1000.0;
+}
+
+void AudioEngine::SetTempoMap(std::shared_ptr<const TempoMap> tempoMap) {
+    std::atomic_store(&m_tempoMap, std::move(tempoMap));
+}
+
+void AudioEngine::StartCountIn(double startTime, int bars) {
+    std::shared_ptr<const TempoMap> tempoMap = std::atomic_load(&m_tempoMap);
+    m_metronome.StartCountIn(tempoMap ? *tempoMap : TempoMap(), startTime, bars);
+}
+
+int AudioEngine::ProcessCountIn(float** outputs, int numChannels, int numSamples) {
+    return m_metronome.RenderCountIn(outputs, numChannels, numSamples);
+}
+
 void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -157,8 +217,9 @@ void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels,
 
 void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples,
                              MediaItemManager* mediaManager, TrackManager* trackManager, 
-                             double startTime, double blockLength) {
-    auto processingStartTime = std::chrono::high_resolution_clock::now();
+                             int64_t startSample) {
+    const uint64_t processingStartTicks = CycleClock::Now();
+    ProfileScope blockScope(Profiler::Category::BLOCK, "Audio block");
     
     if (!m_initialized.load()) {
         // Output silence if not initialized
@@ -182,18 +243,26 @@ void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels,
     // Clear master buffer
     masterBuffer->Clear();
     
-    // Copy input to master buffer if monitoring
-    if (inputs && m_settings.inputMonitoring.load()) {
-        for (int ch = 0; ch < std::min(numChannels, masterBuffer->GetChannelCount()); ++ch) {
-            std::copy(inputs[ch], inputs[ch] + numSamples, masterBuffer->GetChannelData(ch));
-        }
+    // Armed tracks take the raw input before anything else touches the block
+    if (inputs && trackManager && m_isRecording.load()) {
+        trackManager->CaptureInput(inputs, numChannels, numSamples, startSample);
     }
     
-    // Process all tracks with media items
-    ProcessTracks(mediaManager, trackManager, startTime, blockLength, *masterBuffer);
+    // Process all tracks with media items; monitored tracks hear their input through their FX
+    ProcessTracks(mediaManager, trackManager, startSample, numSamples, *masterBuffer, inputs, numChannels);
     
     // Process master bus
-    ProcessMasterBus(*masterBuffer);
+    {
+        ProfileScope masterScope(Profiler::Category::MASTER, "Master");
+        ProcessMasterBus(*masterBuffer);
+        
+        // Click goes in after the master FX, on the same sample timeline as the items
+        if (mediaManager && m_metronome.IsEnabled()) {
+            std::shared_ptr<const TempoMap> tempoMap = std::atomic_load(&m_tempoMap);
+            m_metronome.Render(tempoMap.get(), startSample, numSamples,
+                               masterBuffer->GetChannelPointers(), masterBuffer->GetChannelCount());
+        }
+    }
     
     // Copy to outputs
     for (int ch = 0; ch < std::min(numChannels, masterBuffer->GetChannelCount()); ++ch) {
@@ -205,25 +274,84 @@ void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels,
     ReleaseBuffer(masterBuffer);
     
     // Update performance stats
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - processingStartTime);
-    double processingTime = duration.count() / 1000.0; // Convert to milliseconds
+    double processingTime = static_cast<double>(CycleClock::Now() - processingStartTicks) / m_ticksPerMs;
     
     UpdatePerformanceStats(processingTime);
+    CheckDeadline(startSample, numSamples, processingTime);
     
     // Update sample counter
     m_stats.samplesProcessed += numSamples;
 }
 
+void AudioEngine::ProcessTracks(AudioBuffer& masterBuffer) {
+    // Tracks registered with AddTrack() and no project: each runs silence
+    // through its FX (tails, generators) into the master bus. A block that
+    // finds the list being edited skips it rather than wait on the UI thread.
+    std::unique_lock<std::mutex> lock(m_tracksMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    
+    const double blockTime = m_playPosition.load();
+    for (Track* track : m_tracks) {
+        AudioBuffer* trackBuffer = AcquireBuffer(masterBuffer.GetChannelCount(), masterBuffer.GetSampleCount());
+        if (!trackBuffer) continue;
+        
+        trackBuffer->Clear();
+        trackBuffer->SetSampleRate(m_settings.sampleRate);
+        track->ProcessAudio(*trackBuffer, *trackBuffer, blockTime);
+        masterBuffer.AddFrom(*trackBuffer);
+        ReleaseBuffer(trackBuffer);
+    }
+}
+
 void AudioEngine::ProcessTracks(MediaItemManager* mediaManager, TrackManager* trackManager, 
-                              double startTime, double length, AudioBuffer& masterBuffer) {
-    if (!mediaManager || !trackManager) return;
+                              int64_t startSample, int numSamples, AudioBuffer& masterBuffer,
+                              float** inputs, int numInputs) {
+    m_trackOrder.clear();
+    if (!trackManager) return;
+    
+    const int numTracks = trackManager->GetTrackCount();
+    const double blockTime = static_cast<double>(startSample) / m_settings.sampleRate;
+    
+    // One tempo lookup per block; during playback the cursor answers it without searching
+    std::shared_ptr<const TempoMap> tempoMap = std::atomic_load(&m_tempoMap);
+    if (m_tempoCursor.GetMap() != tempoMap.get()) {
+        m_tempoCursor.SetMap(tempoMap.get());
+    }
+    const TempoPosition tempo = m_tempoCursor.GetPosition(blockTime);
+    
+    // Monitored tracks run first: their input arrived with this block and
+    // leaves in it, so nothing else may push them past the deadline. While
+    // stopped (no media manager) only they are processed. Two appending
+    // passes keep the order without moving entries.
+    const bool monitoring = inputs && m_settings.inputMonitoring.load();
+    if (monitoring) {
+        for (int t = 0; t < numTracks; ++t) {
+            Track* track = trackManager->GetTrack(t);
+            if (track && track->IsInputMonitoring()) {
+                m_trackOrder.push_back({ track, t });
+            }
+        }
+    }
+    const size_t numMonitored = m_trackOrder.size();
     
-    // Get all tracks
-    auto tracks = trackManager->GetAllTracks();
+    for (int t = 0; t < numTracks; ++t) {
+        Track* track = trackManager->GetTrack(t);
+        if (!track || (monitoring && track->IsInputMonitoring())) continue;
+        
+        if (mediaManager) {
+            m_trackOrder.push_back({ track, t });
+        } else {
+            // Idle this block; its meter falls
+            track->GetCpuMeter().AddBlock(0, numSamples, m_settings.sampleRate);
+        }
+    }
     
-    for (Track* track : tracks) {
-        if (!track) continue;
+    int monitorLatency = 0;
+    m_trackTicks.assign(m_trackOrder.size(), 0);
+    for (size_t t = 0; t < m_trackOrder.size(); ++t) {
+        Track* track = m_trackOrder[t].first;
+        ProfileScope trackScope(Profiler::Category::TRACK, track->GetName().c_str(), m_trackOrder[t].second);
+        const uint64_t trackStartTicks = CycleClock::Now();
         
         // Get a buffer for this track
         AudioBuffer* trackBuffer = AcquireBuffer(masterBuffer.GetChannelCount(), masterBuffer.GetSampleCount());
@@ -231,45 +359,70 @@ void AudioEngine::ProcessTracks(MediaItemManager* mediaManager, TrackManager* tr
         
         // Clear track buffer
         trackBuffer->Clear();
+        trackBuffer->SetSampleRate(m_settings.sampleRate);
         
-        // Get media items on this track
-        auto trackItems = mediaManager->GetItemsOnTrack(track);
+        // The live input goes in under the items, ahead of the track's FX
+        if (t < numMonitored) {
+            CopyTrackInput(track, inputs, numInputs, *trackBuffer);
+            monitorLatency = std::max(monitorLatency, track->GetLatencySamples());
+        }
         
-        // Process each media item
-        for (MediaItem* item : trackItems) {
-            if (!item) continue;
+        if (mediaManager) {
+            // Get media items on this track (no allocation once the scratch list has grown)
+            mediaManager->GetItemsOnTrack(track, m_itemScratch);
             
-            // Check if item overlaps with current time range
-            if (item->OverlapsTimeRange(startTime, startTime + length)) {
-                // Process audio from this media item
-                item->ProcessAudio(*trackBuffer, startTime, length);
+            // Process each media item - items clip themselves to the block
+            for (size_t i = 0; i < m_itemScratch.size(); ++i) {
+                MediaItem* item = m_itemScratch[i];
+                if (!item) continue;
+                ProfileScope itemScope(Profiler::Category::ITEM_READ, item->GetName().c_str(), static_cast<int>(i));
+                item->ProcessAudio(*trackBuffer, startSample, numSamples);
             }
         }
         
-        // Apply track volume, pan, mute, solo, and effects
-        // (Track processing would be implemented here)
+        // Apply track volume, pan, mute, and effects with automation at this block's time
+        track->ProcessAudio(*trackBuffer, *trackBuffer, blockTime, &tempo);
         
         // Mix track into master buffer
-        masterBuffer.AddFrom(*trackBuffer);
+        {
+            ProfileScope mixScope(Profiler::Category::MIX, "Mix", m_trackOrder[t].second);
+            masterBuffer.AddFrom(*trackBuffer);
+        }
         
         // Release track buffer
         ReleaseBuffer(trackBuffer);
+        m_trackTicks[t] = CycleClock::Now() - trackStartTicks;
+        track->GetCpuMeter().AddBlock(m_trackTicks[t], numSamples, m_settings.sampleRate);
     }
+    
+    // Input to output takes one device buffer; monitored plugins that report
+    // a delay add theirs on top (the slowest monitored track sets the figure)
+    m_stats.latencyMs = (m_settings.bufferSize + monitorLatency) * 1000.0 / m_settings.sampleRate;
 }
-        
-        // Mix into master buffer
-        masterBuffer.AddFrom(*trackBuffer, 1.0f);
-        
-        ReleaseBuffer(trackBuffer);
+
+void AudioEngine::CopyTrackInput(const Track* track, float** inputs, int numInputs, AudioBuffer& trackBuffer) {
+    int firstInput = 0;
+    int numChannels = 1;
+    TrackManager::DecodeInputChannel(track->GetInputChannel(), firstInput, numChannels);
+    
+    // A mono input feeds every channel of the track (pan places it); a stereo
+    // pair feeds the first two. Inputs the device does not have stay silent.
+    const int numSamples = trackBuffer.GetSampleCount();
+    const int channels = numChannels == 2 ? std::min(2, trackBuffer.GetChannelCount()) : trackBuffer.GetChannelCount();
+    for (int ch = 0; ch < channels; ++ch) {
+        const int input = firstInput + (numChannels == 2 ? ch : 0);
+        if (input < numInputs && inputs[input]) {
+            CopyBuffer(trackBuffer.GetChannelData(ch), inputs[input], numSamples);
+        }
     }
 }
 
 void AudioEngine::ProcessMasterBus(AudioBuffer& buffer) {
-    if (!buffer.isValid) return;
+    if (buffer.GetChannelCount() == 0) return;
     
     // Apply master volume
     float masterVol = m_masterVolume.load();
-    bool masterMute = m_realtimeSettings.masterMute.load();
+    bool masterMute = m_masterMute.load();
     
     if (masterMute) {
         buffer.Clear();
@@ -277,24 +430,15 @@ void AudioEngine::ProcessMasterBus(AudioBuffer& buffer) {
     }
     
     if (masterVol != 1.0f) {
-        for (int ch = 0; ch < buffer.numChannels; ++ch) {
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[ch][i] *= masterVol;
-            }
-        }
+        buffer.ApplyGain(masterVol);
     }
     
     // Apply master pan (for stereo)
-    if (buffer.numChannels >= 2) {
+    if (buffer.GetChannelCount() >= 2) {
         float pan = m_masterPan.load();
         if (pan != 0.0f) {
-            float leftGain = PanToGainLeft(pan);
-            float rightGain = PanToGainRight(pan);
-            
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[0][i] *= leftGain;
-                buffer.channels[1][i] *= rightGain;
-            }
+            buffer.ApplyChannelGain(0, PanToGainLeft(pan));
+            buffer.ApplyChannelGain(1, PanToGainRight(pan));
         }
     }
 }
@@ -328,20 +472,17 @@ void AudioEngine::ReleaseBuffer(AudioBuffer* buffer) {
 void AudioEngine::AllocateBufferPool() {
     std::lock_guard<std::mutex> lock(m_bufferMutex);
     
-    // Allocate a pool of buffers for real-time use
+    // Master and track buffers for a full device block, so the first
+    // callbacks do not allocate
     const int poolSize = 16; // Number of buffers in pool
-    
-    for (int i = 0; i < poolSize; ++i) {
-        auto buffer = std::make_unique<AudioBuffer>(m_settings.maxChannels, m_settings.bufferSize * 2);
-        m_availableBuffers.push_back(buffer.get());
-        m_bufferPool.push_back(std::move(buffer));
-    }
+    m_bufferPool->PreallocateBuffers(m_settings.outputChannels, m_settings.bufferSize, poolSize);
+    m_bufferPool->ReleaseAll();
 }
 
 void AudioEngine::DeallocateBufferPool() {
     std::lock_guard<std::mutex> lock(m_bufferMutex);
-    m_availableBuffers.clear();
-    m_bufferPool.clear();
+    m_bufferPool->ReleaseAll();
+    m_bufferPool->ClearUnusedBuffers();
 }
 
 void AudioEngine::UpdatePerformanceStats(double processingTime) {
@@ -366,6 +507,138 @@ void AudioEngine::UpdatePerformanceStats(double processingTime) {
     }
 }
 
+void AudioEngine::CheckDeadline(int64_t startSample, int numSamples, double processingTime) {
+    // Every block goes into the history; a report copies it out
+    const double deadline = static_cast<double>(numSamples) * 1000.0 / m_settings.sampleRate;
+    m_blockHistory[m_historyPos] = { startSample, numSamples, static_cast<float>(processingTime),
+                                     static_cast<float>(deadline) };
+    m_historyPos = (m_historyPos + 1) % HISTORY_BLOCKS;
+    m_historyCount = std::min(m_historyCount + 1, HISTORY_BLOCKS);
+    
+    if (processingTime <= deadline) {
+        return;
+    }
+    
+    // The block took longer than it plays for: the device ran dry. Dropouts
+    // count only blocks the engine itself silenced, so the two stay apart.
+    m_stats.deadlineMisses++;
+    
+    const uint64_t sequence = m_reportCount.load(std::memory_order_relaxed) + 1;
+    DropoutReport& report = m_reportScratch;
+    report.sequence = sequence;
+    report.numBlocks = m_historyCount;
+    for (int i = 0; i < m_historyCount; ++i) {
+        report.blocks[i] = m_blockHistory[(m_historyPos - m_historyCount + i + HISTORY_BLOCKS) % HISTORY_BLOCKS];
+    }
+    report.numTracks = std::min(static_cast<int>(m_trackOrder.size()), MAX_REPORT_TRACKS);
+    for (int i = 0; i < report.numTracks; ++i) {
+        report.tracks[i] = { m_trackOrder[i].second, static_cast<float>(m_trackTicks[i] / m_ticksPerMs) };
+    }
+    
+    // Seqlock write into the slot after the last published report
+    ReportSlot& slot = m_reports[sequence % MAX_DROPOUT_REPORTS];
+    uint32_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&report);
+    for (size_t i = 0; i < REPORT_WORDS; ++i) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i * sizeof(word), std::min(sizeof(word), sizeof(report) - i * sizeof(word)));
+        slot.words[i].store(word, std::memory_order_relaxed);
+    }
+    
+    slot.version.store(version + 2, std::memory_order_release);
+    m_reportCount.store(sequence, std::memory_order_release);
+}
+
+bool AudioEngine::GetLastDropoutReport(DropoutReport& report) const {
+    // The audio thread only overwrites a slot after MAX_DROPOUT_REPORTS more
+    // misses, so a torn copy is rare; retry it against the newest report
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint64_t sequence = m_reportCount.load(std::memory_order_acquire);
+        if (sequence <= m_reportBase.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        
+        const ReportSlot& slot = m_reports[sequence % MAX_DROPOUT_REPORTS];
+        uint32_t version = slot.version.load(std::memory_order_acquire);
+        if ((version & 1u) != 0) continue;
+        
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(&report);
+        for (size_t i = 0; i < REPORT_WORDS; ++i) {
+            const uint64_t word = slot.words[i].load(std::memory_order_relaxed);
+            std::memcpy(bytes + i * sizeof(word), &word, std::min(sizeof(word), sizeof(report) - i * sizeof(word)));
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == version) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioEngine::ResetPerformanceStats() {
+    m_stats.peakCpuUsage = 0.0;
+    m_stats.dropouts = 0;
+    m_stats.deadlineMisses = 0;
+    m_reportBase = m_reportCount.load();
+}
+
+void AudioEngine::SetupSampleRateConversion(double inputRate, double outputRate) {
+    if (inputRate <= 0.0 || outputRate <= 0.0 || inputRate == outputRate) {
+        m_srcConverter.reset();
+        m_inputSrcConverter.reset();
+        return;
+    }
+    
+    // Size for the largest device block that can arrive at the input rate
+    int maxInputBlock = static_cast<int>(std::ceil(m_settings.bufferSize * std::max(1.0, inputRate / outputRate))) + 1;
+    
+    auto converter = std::make_unique<SampleRateConverter>();
+    if (converter->Prepare(inputRate, outputRate, m_settings.outputChannels, maxInputBlock,
+                           m_settings.resampleQuality)) {
+        m_srcConverter = std::move(converter);
+    }
+    
+    // Device input comes back the other way, a device block at a time
+    int maxDeviceBlock = static_cast<int>(std::ceil(m_settings.bufferSize * std::max(1.0, outputRate / inputRate))) + 1;
+    
+    auto inputConverter = std::make_unique<SampleRateConverter>();
+    if (inputConverter->Prepare(outputRate, inputRate, m_settings.outputChannels, maxDeviceBlock,
+                                m_settings.resampleQuality)) {
+        m_inputSrcConverter = std::move(inputConverter);
+    }
+}
+
+int AudioEngine::ConvertSampleRate(const float* const* input, int numInputFrames, float** output, int maxOutputFrames) {
+    if (!m_srcConverter) {
+        // No conversion configured - pass through
+        int frames = std::min(numInputFrames, maxOutputFrames);
+        for (int ch = 0; ch < m_settings.outputChannels; ++ch) {
+            CopyBuffer(output[ch], input[ch], frames);
+        }
+        return frames;
+    }
+    
+    return m_srcConverter->Process(input, numInputFrames, output, maxOutputFrames);
+}
+
+int AudioEngine::ConvertInputSampleRate(const float* const* input, int numInputFrames, float** output,
+                                        int maxOutputFrames, int* inputFramesConsumed) {
+    if (!m_inputSrcConverter) {
+        int frames = std::min(numInputFrames, maxOutputFrames);
+        for (int ch = 0; ch < m_settings.outputChannels; ++ch) {
+            CopyBuffer(output[ch], input[ch], frames);
+        }
+        *inputFramesConsumed = frames;
+        return frames;
+    }
+    
+    return m_inputSrcConverter->Process(input, numInputFrames, output, maxOutputFrames, inputFramesConsumed);
+}
+
 bool AudioEngine::IsRealtimeThread() const {
     return std::this_thread::get_id() == m_realtimeThreadId;
 }
@@ -399,4 +672,8 @@ void AudioEngine::ApplyFade(float* buffer, int samples, float startGain, float e
         buffer[i] *= currentGain;
         currentGain += gainStep;
     }
-}
\ No newline at end of file
+}
+
+void AudioEngine::CopyBuffer(float* dest, const float* src, int samples) {
+    std::copy(src, src + samples, dest);
+}
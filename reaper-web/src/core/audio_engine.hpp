@@ -7,16 +7,22 @@
 #pragma once
 
 #include "audio_buffer.hpp"
+#include "sample_rate_converter.hpp"
+#include "tempo_map.hpp"
+#include "metronome.hpp"
 #include <memory>
+#include <cstdint>
 #include <vector>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <utility>
+#include <type_traits>
 
 // Forward declarations
 class Track;
 class EffectsChain;
-class AudioDevice;
+class MediaItem;
 class MediaItemManager;
 class TrackManager;
 
@@ -41,16 +47,44 @@ public:
         bool enablePDC = true;          // Plugin Delay Compensation
         int maxPDCDelay = 8192;         // samples
         ProcessingMode mode = ProcessingMode::REALTIME;
-        std::atomic<bool> inputMonitoring{true};
+        SampleRateConverter::Quality resampleQuality = SampleRateConverter::Quality::STANDARD;
+        std::atomic<bool> inputMonitoring{true};   // Master switch for per-track input monitoring
+    };
+
+    // Deadline-miss forensics: the blocks leading up to a miss and where
+    // the missed block spent its time
+    static constexpr int HISTORY_BLOCKS = 32;
+    static constexpr int MAX_REPORT_TRACKS = 256;
+    static constexpr int MAX_DROPOUT_REPORTS = 4;
+
+    struct BlockTiming {
+        int64_t startSample = 0;
+        int numSamples = 0;
+        float processingMs = 0.0f;
+        float deadlineMs = 0.0f;                    // numSamples at the engine rate
+    };
+
+    struct TrackTiming {
+        int trackIndex = -1;
+        float processingMs = 0.0f;                  // Items, volume/pan, FX and mix
+    };
+
+    struct DropoutReport {
+        uint64_t sequence = 0;                      // Miss number since the engine started
+        int numBlocks = 0;
+        BlockTiming blocks[HISTORY_BLOCKS];         // Oldest first; the last one missed
+        int numTracks = 0;
+        TrackTiming tracks[MAX_REPORT_TRACKS];      // The missed block, in processing order
     };
 
     struct PerformanceStats {
         std::atomic<double> cpuUsage{0.0};
         std::atomic<double> peakCpuUsage{0.0};
-        std::atomic<int> dropouts{0};
+        std::atomic<int> dropouts{0};               // Blocks output as silence for lack of a buffer
+        std::atomic<int> deadlineMisses{0};         // Blocks that took longer than they play for
         std::atomic<int> activePlugins{0};
         std::atomic<long long> samplesProcessed{0};
-        std::atomic<double> latencyMs{0.0};
+        std::atomic<double> latencyMs{0.0};         // Monitoring round trip: one device buffer plus monitored FX delay
     };
 
 public:
@@ -78,6 +112,19 @@ public:
     // Position control
     void SetPlayPosition(double seconds);
     double GetPlayPosition() const { return m_playPosition.load(); }
+    
+    // Tempo map for plugin transport info; swapped whole, read once per block
+    void SetTempoMap(std::shared_ptr<const TempoMap> tempoMap);
+    
+    // Metronome - clicks are mixed after the master bus while playing
+    Metronome& GetMetronome() { return m_metronome; }
+    void StartCountIn(double startTime, int bars);  // Bars of clicks before startTime
+    bool IsCountingIn() const { return m_metronome.IsCountingIn(); }
+    int ProcessCountIn(float** outputs, int numChannels, int numSamples);   // Samples of count-in written
+
+    // Sizes the per-block track lists for numTracks; not real-time safe, call
+    // before starting the transport as with MediaItemManager::PrepareForPlayback
+    void PrepareForTracks(int numTracks);
 
     // Settings
     void SetSampleRate(double rate);
@@ -89,9 +136,10 @@ public:
     void ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples);
     void ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples,
                      MediaItemManager* mediaManager, TrackManager* trackManager, 
-                     double startTime, double blockLength);
+                     int64_t startSample);
     void ProcessTracks(MediaItemManager* mediaManager, TrackManager* trackManager, 
-                      double startTime, double length, AudioBuffer& masterBuffer);
+                      int64_t startSample, int numSamples, AudioBuffer& masterBuffer,
+                      float** inputs = nullptr, int numInputs = 0);
     
     // Track management for audio routing
     void AddTrack(Track* track);
@@ -111,6 +159,7 @@ public:
     // Performance monitoring
     const PerformanceStats& GetPerformanceStats() const { return m_stats; }
     void ResetPerformanceStats();
+    bool GetLastDropoutReport(DropoutReport& report) const;    // Any thread; false if no miss since the last reset
     
     // Thread safety for real-time audio
     void SetRealtimeThreadId(std::thread::id id) { m_realtimeThreadId = id; }
@@ -128,8 +177,14 @@ public:
     static float PanToGainRight(float pan);
     static void ApplyFade(float* buffer, int samples, float startGain, float endGain);
     
-    // Sample rate conversion (for different device rates)
+    // Sample rate conversion (for different device rates); input converts back
+    // from the output rate to the input rate and reports the frames it took
     void SetupSampleRateConversion(double inputRate, double outputRate);
+    int ConvertSampleRate(const float* const* input, int numInputFrames, float** output, int maxOutputFrames);
+    int ConvertInputSampleRate(const float* const* input, int numInputFrames, float** output, int maxOutputFrames,
+                               int* inputFramesConsumed);
+    bool IsSampleRateConversionActive() const { return m_srcConverter && !m_srcConverter->IsPassthrough(); }
+    void SetResampleQuality(SampleRateConverter::Quality quality) { m_settings.resampleQuality = quality; }
     
 private:
     AudioSettings m_settings;
@@ -149,9 +204,13 @@ private:
     // Track management
     std::vector<Track*> m_tracks;
     mutable std::mutex m_tracksMutex;
+    std::vector<MediaItem*> m_itemScratch;     // Reused per-track item list (audio thread only)
+    std::vector<std::pair<Track*, int>> m_trackOrder;  // This block's tracks and their indices, monitored first (audio thread only)
     
-    // Audio device
-    std::unique_ptr<AudioDevice> m_audioDevice;
+    // Tempo
+    std::shared_ptr<const TempoMap> m_tempoMap;     // Accessed with std::atomic_load/atomic_store
+    TempoMap::Cursor m_tempoCursor;                 // Audio thread only
+    Metronome m_metronome;
     
     // Buffer management for real-time processing
     std::unique_ptr<AudioBufferPool> m_bufferPool;
@@ -168,17 +227,38 @@ private:
     std::chrono::high_resolution_clock::time_point m_lastStatsUpdate;
     double m_processingTimeAccumulator = 0.0;
     int m_processCallCount = 0;
+    double m_ticksPerMs = 1.0e6;                    // CycleClock rate, measured in Initialize()
+    
+    // Deadline forensics (history and per-track ticks are audio thread only).
+    // Reports are assembled in m_reportScratch and published as words with
+    // relaxed atomic stores, so a reader racing the writer is not a data race.
+    static constexpr size_t REPORT_WORDS = (sizeof(DropoutReport) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    struct ReportSlot {
+        std::atomic<uint32_t> version{0};           // Seqlock; odd while the report is written
+        std::atomic<uint64_t> words[REPORT_WORDS];  // The report's bytes
+    };
+    static_assert(std::is_trivially_copyable<DropoutReport>::value, "reports are published as raw words");
+    DropoutReport m_reportScratch;
+    BlockTiming m_blockHistory[HISTORY_BLOCKS];
+    int m_historyPos = 0;
+    int m_historyCount = 0;
+    std::vector<uint64_t> m_trackTicks;             // Per m_trackOrder entry, this block
+    std::unique_ptr<ReportSlot[]> m_reports;
+    std::atomic<uint64_t> m_reportCount{0};
+    std::atomic<uint64_t> m_reportBase{0};          // Reports up to here predate the last reset
     
     // Internal processing methods
     void ProcessTracks(AudioBuffer& masterBuffer);
     void ProcessMasterBus(AudioBuffer& buffer);
+    void CopyTrackInput(const Track* track, float** inputs, int numInputs, AudioBuffer& trackBuffer);
     void UpdatePerformanceStats(double processingTime);
+    void CheckDeadline(int64_t startSample, int numSamples, double processingTime);
     void AllocateBufferPool();
     void DeallocateBufferPool();
     
-    // Sample rate conversion
-    class SampleRateConverter;
+    // Sample rate conversion between device and engine rates
     std::unique_ptr<SampleRateConverter> m_srcConverter;
+    std::unique_ptr<SampleRateConverter> m_inputSrcConverter;
     
     // Zero-allocation helpers for real-time thread
     void ClearBuffer(float* buffer, int samples);
@@ -0,0 +1,186 @@
+/*
+ * REAPER Web - Automation Envelopes Implementation
+ */
+
+#include "automation_envelope.hpp"
+#include <algorithm>
+#include <cmath>
+
+void AutomationEnvelope::SetPoints(const std::vector<EnvelopePoint>& points) {
+    m_points = points;
+    std::stable_sort(m_points.begin(), m_points.end(),
+                     [](const EnvelopePoint& a, const EnvelopePoint& b) { return a.time < b.time; });
+    ResetCursor();
+}
+
+void AutomationEnvelope::SetPoints(const std::vector<std::pair<double, double>>& points) {
+    std::vector<EnvelopePoint> converted;
+    converted.reserve(points.size());
+    for (const auto& point : points) {
+        EnvelopePoint p;
+        p.time = point.first;
+        p.value = point.second;
+        converted.push_back(p);
+    }
+    SetPoints(converted);
+}
+
+void AutomationEnvelope::AddPoint(const EnvelopePoint& point) {
+    auto it = std::upper_bound(m_points.begin(), m_points.end(), point.time,
+                               [](double time, const EnvelopePoint& p) { return time < p.time; });
+    m_points.insert(it, point);
+    ResetCursor();
+}
+
+void AutomationEnvelope::Clear() {
+    m_points.clear();
+    ResetCursor();
+}
+
+double AutomationEnvelope::Evaluate(double time) const {
+    if (m_points.empty()) {
+        return 0.0;
+    }
+    return SegmentValue(FindSegment(time), time);
+}
+
+bool AutomationEnvelope::RenderBlock(double startTime, double sampleRate, int numSamples, float* out, double& value) {
+    if (m_points.empty() || numSamples <= 0 || sampleRate <= 0.0) {
+        value = m_points.empty() ? 0.0 : m_points.front().value;
+        return false;
+    }
+    
+    const size_t count = m_points.size();
+    const double step = 1.0 / sampleRate;
+    const double endTime = startTime + (numSamples - 1) * step;
+    size_t segment = SeekCursor(startTime);
+    
+    size_t endSegment = segment;
+    while (endSegment < count && m_points[endSegment].time <= endTime) {
+        ++endSegment;
+    }
+    
+    m_cursor = endSegment;
+    m_cursorTime = startTime + numSamples * step;
+    
+    // No point inside the block and nothing moving: one value covers it
+    if (endSegment == segment && IsSegmentFlat(segment)) {
+        value = SegmentValue(segment, startTime);
+        return false;
+    }
+    
+    int position = 0;
+    while (position < numSamples) {
+        int run = numSamples - position;
+        if (segment < count) {
+            // Samples before the next point belong to this segment
+            double untilPoint = std::ceil((m_points[segment].time - startTime) * sampleRate) - position;
+            run = static_cast<int>(std::max(0.0, std::min(static_cast<double>(run), untilPoint)));
+        }
+        
+        if (run > 0) {
+            RenderSegment(segment, startTime + position * step, step, run, out + position);
+            position += run;
+        } else {
+            ++segment;
+        }
+    }
+    
+    value = out[numSamples - 1];
+    return true;
+}
+
+size_t AutomationEnvelope::FindSegment(double time) const {
+    auto it = std::upper_bound(m_points.begin(), m_points.end(), time,
+                               [](double t, const EnvelopePoint& p) { return t < p.time; });
+    return static_cast<size_t>(it - m_points.begin());
+}
+
+size_t AutomationEnvelope::SeekCursor(double time) {
+    // Contiguous playback continues from the last block; anything else searches
+    if (m_cursorTime < 0.0 || time < m_cursorTime - 1e-9 || m_cursor > m_points.size() ||
+        (m_cursor > 0 && m_points[m_cursor - 1].time > time)) {
+        m_cursor = FindSegment(time);
+        return m_cursor;
+    }
+    
+    while (m_cursor < m_points.size() && m_points[m_cursor].time <= time) {
+        ++m_cursor;
+    }
+    return m_cursor;
+}
+
+double AutomationEnvelope::SegmentValue(size_t index, double time) const {
+    // Segment i runs from point i - 1 to point i; the ends hold their point
+    if (index == 0) {
+        return m_points.front().value;
+    }
+    if (index >= m_points.size()) {
+        return m_points.back().value;
+    }
+    
+    const EnvelopePoint& from = m_points[index - 1];
+    const EnvelopePoint& to = m_points[index];
+    if (from.shape == EnvelopeShape::SQUARE) {
+        return from.value;
+    }
+    
+    const double length = to.time - from.time;
+    if (length <= 0.0) {
+        return to.value;
+    }
+    
+    double x = std::clamp((time - from.time) / length, 0.0, 1.0);
+    if (from.shape == EnvelopeShape::BEZIER) {
+        x = BezierPosition(x, from.tension);
+    }
+    return from.value + (to.value - from.value) * x;
+}
+
+bool AutomationEnvelope::IsSegmentFlat(size_t index) const {
+    if (index == 0 || index >= m_points.size()) {
+        return true;
+    }
+    
+    const EnvelopePoint& from = m_points[index - 1];
+    return from.shape == EnvelopeShape::SQUARE || from.value == m_points[index].value;
+}
+
+void AutomationEnvelope::RenderSegment(size_t index, double startTime, double step, int count, float* out) const {
+    if (IsSegmentFlat(index)) {
+        std::fill(out, out + count, static_cast<float>(SegmentValue(index, startTime)));
+        return;
+    }
+    
+    const EnvelopePoint& from = m_points[index - 1];
+    const EnvelopePoint& to = m_points[index];
+    if (from.shape == EnvelopeShape::LINEAR && to.time > from.time) {
+        // Straight line: one add per sample
+        double value = SegmentValue(index, startTime);
+        const double delta = (to.value - from.value) * step / (to.time - from.time);
+        for (int i = 0; i < count; ++i) {
+            out[i] = static_cast<float>(value);
+            value += delta;
+        }
+        return;
+    }
+    
+    for (int i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(SegmentValue(index, startTime + i * step));
+    }
+}
+
+double AutomationEnvelope::BezierPosition(double x, double tension) {
+    // Quadratic Bezier from (0,0) to (1,1); tension pulls the control point
+    // towards (0,1) (fast start) or (1,0) (slow start). Solve x(u) for u.
+    tension = std::clamp(tension, -1.0, 1.0);
+    const double cx = 0.5 - 0.5 * tension;
+    const double cy = 0.5 + 0.5 * tension;
+    const double a = 1.0 - 2.0 * cx;
+    
+    double u = x;
+    if (std::abs(a) > 1e-9) {
+        u = (-cx + std::sqrt(std::max(0.0, cx * cx + a * x))) / a;
+    }
+    return u * u * (1.0 - 2.0 * cy) + 2.0 * cy * u;
+}
@@ -0,0 +1,71 @@
+/*
+ * REAPER Web - Automation Envelopes
+ * Sample-accurate evaluation of volume, pan and FX parameter envelopes
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Values match REAPER's PT shape field
+enum class EnvelopeShape : uint8_t {
+    LINEAR = 0,
+    SQUARE = 1,         // Holds the value until the next point
+    BEZIER = 5          // Curved by the point's tension
+};
+
+struct EnvelopePoint {
+    double time = 0.0;              // Seconds
+    double value = 0.0;
+    EnvelopeShape shape = EnvelopeShape::LINEAR;   // Shape of the segment to the next point
+    double tension = 0.0;           // -1..1, BEZIER only
+};
+
+/**
+ * AutomationEnvelope - Breakpoint envelope rendered block by block
+ * A cursor remembers the segment the last block ended in, so playback walks
+ * forward without searching; only a jump (seek, loop) falls back to a
+ * binary search. Blocks over which the envelope is flat are reported as a
+ * single value and never rendered per sample.
+ *
+ *   double value;
+ *   if (envelope.RenderBlock(time, sampleRate, numSamples, ramp, value)) {
+ *       // ramp[0..numSamples) holds one value per sample
+ *   } else {
+ *       // value holds for the whole block
+ *   }
+ */
+class AutomationEnvelope {
+public:
+    // Editing (not real-time safe; resets the cursor)
+    void SetPoints(const std::vector<EnvelopePoint>& points);
+    void SetPoints(const std::vector<std::pair<double, double>>& points);   // Linear
+    void AddPoint(const EnvelopePoint& point);
+    void Clear();
+
+    const std::vector<EnvelopePoint>& GetPoints() const { return m_points; }
+    bool IsEmpty() const { return m_points.empty(); }
+
+    // Random access (binary search); for UI and one-off lookups
+    double Evaluate(double time) const;
+
+    // Playback: false if the block is flat (out untouched, value set)
+    bool RenderBlock(double startTime, double sampleRate, int numSamples, float* out, double& value);
+    void ResetCursor() { m_cursor = 0; m_cursorTime = -1.0; }
+
+private:
+    std::vector<EnvelopePoint> m_points;    // Sorted by time
+    size_t m_cursor = 0;                    // Segment index: last point at or before m_cursorTime
+    double m_cursorTime = -1.0;             // End of the last rendered block
+
+    size_t FindSegment(double time) const;
+    size_t SeekCursor(double time);
+    double SegmentValue(size_t index, double time) const;
+    bool IsSegmentFlat(size_t index) const;
+    void RenderSegment(size_t index, double startTime, double step, int count, float* out) const;
+
+    static double BezierPosition(double x, double tension);
+};
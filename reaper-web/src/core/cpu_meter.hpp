@@ -0,0 +1,51 @@
+/*
+ * REAPER Web - CPU Meter
+ * Decayed average and peak processing load of one track or effect
+ */
+
+#pragma once
+
+#include "profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * CpuMeter - Per-block load as a fraction of real time
+ * The audio thread adds each block's CycleClock ticks; load is the time
+ * spent over the time the block plays for (1.0 = a whole core). The
+ * average and the held peak decay with time constants in seconds, so they
+ * mean the same at any block size. Both are single atomics: the UI reads
+ * them without locks and never sees a torn value.
+ */
+class CpuMeter {
+public:
+    static constexpr double AVERAGE_SECONDS = 0.3;      // Time constant of the average
+    static constexpr double PEAK_SECONDS = 2.0;         // Time constant of the peak's fall
+
+    // Audio thread - once per processed block (0 ticks for a block skipped or bypassed)
+    void AddBlock(uint64_t ticks, int numSamples, double sampleRate) {
+        if (numSamples <= 0 || sampleRate <= 0.0) return;
+
+        const double seconds = numSamples / sampleRate;
+        const double load = static_cast<double>(ticks) / (seconds * 1.0e6 * CycleClock::GetTicksPerMicrosecond());
+        const double average = m_average.load(std::memory_order_relaxed);
+        const double peak = m_peak.load(std::memory_order_relaxed);
+        m_average.store(static_cast<float>(average + (load - average) * seconds / (AVERAGE_SECONDS + seconds)),
+                        std::memory_order_relaxed);
+        m_peak.store(static_cast<float>(std::max(load, peak * PEAK_SECONDS / (PEAK_SECONDS + seconds))),
+                     std::memory_order_relaxed);
+    }
+
+    // Any thread
+    double GetAverage() const { return m_average.load(std::memory_order_relaxed); }
+    double GetPeak() const { return m_peak.load(std::memory_order_relaxed); }
+    void Reset() {
+        m_average.store(0.0f, std::memory_order_relaxed);
+        m_peak.store(0.0f, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<float> m_average{0.0f};
+    std::atomic<float> m_peak{0.0f};
+};
@@ -0,0 +1,127 @@
+/*
+ * REAPER Web - FFT Implementation
+ * Iterative radix-2 transform with a real-input split step
+ */
+
+#include "fft.hpp"
+#include <cmath>
+
+FFT::FFT() = default;
+
+FFT::FFT(int size) {
+    Prepare(size);
+}
+
+FFT::~FFT() = default;
+
+int FFT::NextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool FFT::Prepare(int size) {
+    if (size < 4 || !IsPowerOfTwo(size)) {
+        return false;
+    }
+
+    if (size == m_size) {
+        return true;
+    }
+
+    m_size = size;
+    m_halfSize = size / 2;
+
+    m_twiddles.resize(m_halfSize / 2);
+    for (int k = 0; k < m_halfSize / 2; ++k) {
+        double angle = -2.0 * M_PI * k / m_halfSize;
+        m_twiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    m_splitTwiddles.resize(m_halfSize + 1);
+    for (int k = 0; k <= m_halfSize; ++k) {
+        double angle = -2.0 * M_PI * k / m_size;
+        m_splitTwiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    m_bitReverse.resize(m_halfSize);
+    int bits = 0;
+    while ((1 << bits) < m_halfSize) ++bits;
+    for (int i = 0; i < m_halfSize; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    m_work.assign(m_halfSize, std::complex<float>());
+    return true;
+}
+
+void FFT::PerformRealForward(const float* input, std::complex<float>* spectrum) const {
+    if (m_size == 0) return;
+
+    // Pack even/odd samples as real/imaginary parts of a half-size sequence
+    for (int n = 0; n < m_halfSize; ++n) {
+        m_work[m_bitReverse[n]] = std::complex<float>(input[2 * n], input[2 * n + 1]);
+    }
+
+    PerformComplex(m_work.data(), false);
+
+    // Split into the spectra of the even and odd samples and recombine
+    const std::complex<float> minusI(0.0f, -1.0f);
+    for (int k = 0; k <= m_halfSize; ++k) {
+        std::complex<float> z = m_work[k % m_halfSize];
+        std::complex<float> zMirror = std::conj(m_work[(m_halfSize - k) % m_halfSize]);
+
+        std::complex<float> even = 0.5f * (z + zMirror);
+        std::complex<float> odd = 0.5f * minusI * (z - zMirror);
+        spectrum[k] = even + m_splitTwiddles[k] * odd;
+    }
+}
+
+void FFT::PerformRealInverse(const std::complex<float>* spectrum, float* output) const {
+    if (m_size == 0) return;
+
+    // Rebuild the half-size sequence from the even and odd spectra
+    const std::complex<float> plusI(0.0f, 1.0f);
+    for (int k = 0; k < m_halfSize; ++k) {
+        std::complex<float> x = spectrum[k];
+        std::complex<float> xMirror = std::conj(spectrum[m_halfSize - k]);
+
+        std::complex<float> even = 0.5f * (x + xMirror);
+        std::complex<float> odd = 0.5f * (x - xMirror) * std::conj(m_splitTwiddles[k]);
+        m_work[m_bitReverse[k]] = even + plusI * odd;
+    }
+
+    PerformComplex(m_work.data(), true);
+
+    const float scale = 1.0f / static_cast<float>(m_halfSize);
+    for (int n = 0; n < m_halfSize; ++n) {
+        output[2 * n] = m_work[n].real() * scale;
+        output[2 * n + 1] = m_work[n].imag() * scale;
+    }
+}
+
+void FFT::PerformComplex(std::complex<float>* data, bool inverse) const {
+    // Input is already in bit-reversed order
+    for (int length = 2; length <= m_halfSize; length <<= 1) {
+        int half = length / 2;
+        int stride = m_halfSize / length;
+
+        for (int start = 0; start < m_halfSize; start += length) {
+            for (int k = 0; k < half; ++k) {
+                std::complex<float> w = m_twiddles[k * stride];
+                if (inverse) w = std::conj(w);
+
+                std::complex<float> u = data[start + k];
+                std::complex<float> v = data[start + k + half] * w;
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * REAPER Web - FFT
+ * Real-input radix-2 FFT for spectral processing (time stretching, analysis)
+ */
+
+#pragma once
+
+#include <complex>
+#include <vector>
+
+/**
+ * FFT - Power-of-two real FFT
+ * Real transforms run as a half-size complex FFT with a split step.
+ * Twiddle and bit-reversal tables are built once in Prepare(); transforms
+ * use internal scratch and never allocate, so one instance must not be
+ * shared between threads.
+ */
+class FFT {
+public:
+    FFT();
+    explicit FFT(int size);
+    ~FFT();
+
+    // Setup - size must be a power of two >= 4
+    bool Prepare(int size);
+    int GetSize() const { return m_size; }
+    int GetNumBins() const { return m_size / 2 + 1; }
+
+    // Transforms - spectrum holds GetNumBins() bins (DC to Nyquist)
+    void PerformRealForward(const float* input, std::complex<float>* spectrum) const;
+    void PerformRealInverse(const std::complex<float>* spectrum, float* output) const;  // Scaled by 1/size
+
+    static bool IsPowerOfTwo(int value) { return value > 0 && (value & (value - 1)) == 0; }
+    static int NextPowerOfTwo(int value);
+
+private:
+    int m_size = 0;
+    int m_halfSize = 0;
+
+    std::vector<std::complex<float>> m_twiddles;        // Half-size complex FFT
+    std::vector<std::complex<float>> m_splitTwiddles;   // e^(-2*pi*i*k/size) for the real split
+    std::vector<int> m_bitReverse;
+    mutable std::vector<std::complex<float>> m_work;
+
+    void PerformComplex(std::complex<float>* data, bool inverse) const;
+};
@@ -0,0 +1,86 @@
+/*
+ * REAPER Web - Mapped File Implementation
+ */
+
+#include "mapped_file.hpp"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define REAPER_WEB_HAVE_MMAP 1
+#endif
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+#if defined(REAPER_WEB_HAVE_MMAP) && !defined(__EMSCRIPTEN__)
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            // Parsers read front to back
+            ::madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            ::close(fd);
+            
+            m_data = static_cast<const char*>(address);
+            m_size = static_cast<size_t>(info.st_size);
+            m_mapped = true;
+            m_open = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+    
+    // Buffered fallback (also used for empty files, which cannot be mapped)
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::streamsize size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    
+    m_buffer.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (size > 0 && !file.read(m_buffer.data(), size)) {
+        m_buffer.clear();
+        return false;
+    }
+    
+    m_data = m_buffer.empty() ? nullptr : m_buffer.data();
+    m_size = m_buffer.size();
+    m_open = true;
+    return true;
+}
+
+void MappedFile::Close() {
+#if defined(REAPER_WEB_HAVE_MMAP) && !defined(__EMSCRIPTEN__)
+    if (m_mapped) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_open = false;
+}
@@ -0,0 +1,40 @@
+/*
+ * REAPER Web - Mapped File
+ * Read-only memory mapping of project files with a buffered fallback
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * MappedFile - Read-only view of a whole file
+ * Maps the file where the platform supports mmap; elsewhere (or if the
+ * mapping fails) the file is read into an owned buffer. Either way the
+ * contents stay valid until Close() or destruction.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    const char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    bool IsOpen() const { return m_open; }
+    bool IsMapped() const { return m_mapped; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;                // Also true for an empty file
+    bool m_mapped = false;
+    std::vector<char> m_buffer;         // Fallback storage
+};
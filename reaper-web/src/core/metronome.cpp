@@ -0,0 +1,175 @@
+/*
+ * REAPER Web - Metronome Implementation
+ */
+
+#include "metronome.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kClickSeconds = 0.04;
+constexpr double kAttackSeconds = 0.001;
+constexpr double kDecaySeconds = 0.008;     // Exponential decay time constant
+constexpr double kAccentFrequency = 1760.0;
+constexpr double kBeatFrequency = 880.0;
+constexpr double kBeatEpsilon = 1e-9;
+
+} // anonymous namespace
+
+void Metronome::Prepare(double sampleRate) {
+    m_sampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    RenderClick(m_accentClick, m_sampleRate, kAccentFrequency, 0.5);
+    RenderClick(m_beatClick, m_sampleRate, kBeatFrequency, 0.35);
+    
+    m_voice = Voice();
+    m_nextSample = -1;
+    m_countInRemaining = 0;
+}
+
+void Metronome::RenderClick(std::vector<float>& click, double sampleRate, double frequency, double amplitude) {
+    const int length = static_cast<int>(kClickSeconds * sampleRate);
+    const int attack = std::max(1, static_cast<int>(kAttackSeconds * sampleRate));
+    const double twoPi = 6.283185307179586;
+    
+    click.resize(length);
+    for (int i = 0; i < length; ++i) {
+        const double t = i / sampleRate;
+        double envelope = std::exp(-t / kDecaySeconds);
+        if (i < attack) {
+            envelope *= static_cast<double>(i) / attack;
+        }
+        click[i] = static_cast<float>(amplitude * envelope * std::sin(twoPi * frequency * t));
+    }
+}
+
+void Metronome::Render(const TempoMap* tempoMap, int64_t startSample, int numSamples, float** outputs, int numChannels) {
+    if (numSamples <= 0) return;
+    
+    // A jump in the timeline drops the ringing click
+    if (startSample != m_nextSample) {
+        m_voice = Voice();
+    }
+    m_nextSample = startSample + numSamples;
+    
+    const float gain = m_volume.load();
+    const int64_t endSample = startSample + numSamples;
+    int position = 0;
+    
+    if (tempoMap) {
+        if (m_cursor.GetMap() != tempoMap) {
+            m_cursor.SetMap(tempoMap);
+        }
+        
+        // Start from the beat at or before the block so a click rounding onto
+        // the first sample is not missed
+        int measure = 0;
+        double beatInBar = 0.0;
+        TimeSignature timeSig;
+        tempoMap->BeatsToMeasure(m_cursor.TimeToBeats(startSample / m_sampleRate), measure, beatInBar, &timeSig);
+        
+        double barStart = tempoMap->MeasureToBeats(measure);
+        double nextBar = tempoMap->MeasureToBeats(measure + 1);
+        int beat = static_cast<int>(std::floor(beatInBar + kBeatEpsilon));
+        
+        while (true) {
+            double beats = barStart + beat * 4.0 / timeSig.denominator;
+            
+            // A bar cut short by a time signature change ends early
+            if (beat >= timeSig.numerator || beats >= nextBar - kBeatEpsilon) {
+                ++measure;
+                timeSig = tempoMap->GetTimeSignatureAtMeasure(measure);
+                barStart = nextBar;
+                nextBar = tempoMap->MeasureToBeats(measure + 1);
+                beat = 0;
+                beats = barStart;
+            }
+            
+            const int64_t clickSample = static_cast<int64_t>(std::llround(m_cursor.BeatsToTime(beats) * m_sampleRate));
+            if (clickSample >= endSample) break;
+            
+            if (clickSample >= startSample) {
+                const int offset = static_cast<int>(clickSample - startSample);
+                MixVoice(outputs, numChannels, position, offset - position, gain);
+                position = offset;
+                Trigger(beat == 0);
+            }
+            ++beat;
+        }
+    }
+    
+    MixVoice(outputs, numChannels, position, numSamples - position, gain);
+}
+
+void Metronome::StartCountIn(const TempoMap& tempoMap, double startTime, int bars) {
+    const TempoPosition tempo = tempoMap.GetPosition(startTime);
+    const int beatsPerBar = std::max(1, tempo.timeSigNumerator);
+    
+    // Beats of the time signature's note value at the start tempo
+    m_countInBeatSamples = 60.0 / tempo.bpm * (4.0 / tempo.timeSigDenominator) * m_sampleRate;
+    m_countInBeatsPerBar = beatsPerBar;
+    m_countInLength = static_cast<int64_t>(std::llround(m_countInBeatSamples * beatsPerBar * std::max(0, bars)));
+    m_nextSample = static_cast<int64_t>(std::llround(startTime * m_sampleRate));
+    m_voice = Voice();
+    m_countInRemaining = m_countInLength;
+}
+
+int Metronome::RenderCountIn(float** outputs, int numChannels, int numSamples) {
+    const int64_t remaining = m_countInRemaining.load();
+    if (remaining <= 0 || numSamples <= 0) return 0;
+    
+    const int count = static_cast<int>(std::min<int64_t>(remaining, numSamples));
+    const int64_t start = m_countInLength - remaining;
+    const float gain = m_volume.load();
+    
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::fill(outputs[ch], outputs[ch] + count, 0.0f);
+    }
+    
+    int position = 0;
+    int64_t beat = static_cast<int64_t>(std::floor(start / m_countInBeatSamples));
+    while (true) {
+        const int64_t clickSample = static_cast<int64_t>(std::llround(beat * m_countInBeatSamples));
+        if (clickSample >= start + count) break;
+        
+        if (clickSample >= start) {
+            const int offset = static_cast<int>(clickSample - start);
+            MixVoice(outputs, numChannels, position, offset - position, gain);
+            position = offset;
+            Trigger(beat % m_countInBeatsPerBar == 0);
+        }
+        ++beat;
+    }
+    MixVoice(outputs, numChannels, position, count - position, gain);
+    
+    // The last click rings on into playback, which starts at m_nextSample
+    m_countInRemaining = remaining - count;
+    return count;
+}
+
+void Metronome::Trigger(bool accent) {
+    const std::vector<float>& click = accent ? m_accentClick : m_beatClick;
+    m_voice.click = click.data();
+    m_voice.length = static_cast<int>(click.size());
+    m_voice.position = 0;
+}
+
+void Metronome::MixVoice(float** outputs, int numChannels, int offset, int numSamples, float gain) {
+    if (!m_voice.click || numSamples <= 0) return;
+    
+    const int count = std::min(numSamples, m_voice.length - m_voice.position);
+    const float* click = m_voice.click + m_voice.position;
+    
+    // The click is mono; it goes to the first two (stereo) outputs
+    for (int ch = 0; ch < std::min(numChannels, 2); ++ch) {
+        float* out = outputs[ch] + offset;
+        for (int i = 0; i < count; ++i) {
+            out[i] += click[i] * gain;
+        }
+    }
+    
+    m_voice.position += count;
+    if (m_voice.position >= m_voice.length) {
+        m_voice = Voice();
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * REAPER Web - Metronome
+ * Sample-accurate click and count-in rendered inside the audio engine
+ */
+
+#pragma once
+
+#include "tempo_map.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Metronome - Click voice driven by the tempo map
+ * The accent (first beat of a bar) and beat clicks are rendered once in
+ * Prepare(); playback only finds where beats fall in each block and copies
+ * the click into the mix at that sample, carrying the tail into the next
+ * block. Beats follow the time signature's denominator (eighths in 7/8).
+ *
+ * Count-in runs before the transport moves: StartCountIn() fixes the bar
+ * length from the tempo at the start position, and RenderCountIn() clicks
+ * through it, returning how many samples it used so the caller can start
+ * playback on the same block at the exact sample the count-in ended.
+ */
+class Metronome {
+public:
+    Metronome() = default;
+
+    // Not real-time safe; renders the click samples
+    void Prepare(double sampleRate);
+
+    // Settings (any thread)
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled.load(); }
+    void SetVolume(float volume) { m_volume = volume; }     // Linear gain
+    float GetVolume() const { return m_volume.load(); }
+
+    // Playback: adds the clicks for [startSample, startSample + numSamples)
+    void Render(const TempoMap* tempoMap, int64_t startSample, int numSamples, float** outputs, int numChannels);
+
+    // Count-in (audio thread once started)
+    void StartCountIn(const TempoMap& tempoMap, double startTime, int bars);
+    void CancelCountIn() { m_countInRemaining = 0; }
+    bool IsCountingIn() const { return m_countInRemaining.load() > 0; }
+    int RenderCountIn(float** outputs, int numChannels, int numSamples);   // Samples of count-in written
+
+    // Pre-rendered click length
+    int GetClickLength() const { return static_cast<int>(m_beatClick.size()); }
+
+private:
+    struct Voice {
+        const float* click = nullptr;
+        int length = 0;
+        int position = 0;           // Next click sample to play
+    };
+
+    double m_sampleRate = 48000.0;
+    std::vector<float> m_accentClick;
+    std::vector<float> m_beatClick;
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_volume{0.8f};
+
+    // Audio thread state
+    Voice m_voice;
+    int64_t m_nextSample = -1;      // Where the last block ended; anything else is a seek
+    TempoMap::Cursor m_cursor;
+
+    // Count-in: constant beat grid from the tempo at the start position
+    std::atomic<int64_t> m_countInRemaining{0};
+    int64_t m_countInLength = 0;
+    double m_countInBeatSamples = 0.0;
+    int m_countInBeatsPerBar = 4;
+
+    void Trigger(bool accent);
+    void MixVoice(float** outputs, int numChannels, int offset, int numSamples, float gain);
+    static void RenderClick(std::vector<float>& click, double sampleRate, double frequency, double amplitude);
+};
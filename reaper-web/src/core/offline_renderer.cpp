@@ -0,0 +1,215 @@
+/*
+ * REAPER Web - Offline Renderer Implementation
+ */
+
+#include "offline_renderer.hpp"
+#include "reaper_engine.hpp"
+#include "project_manager.hpp"
+#include "track_manager.hpp"
+#include "../media/media_item.hpp"
+#include "../effects/effect_chain.hpp"
+#include "../effects/reaper_effects.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+OfflineRenderer::OfflineRenderer() = default;
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+OfflineRenderer::Result OfflineRenderer::Render(const std::string& projectPath, const std::string& outputPath,
+                                                const Options& options, const ProgressCallback& progress) {
+    Result result;
+    
+    if (options.sampleRate <= 0.0 || options.blockSize <= 0 || options.channels <= 0) {
+        result.error = "Invalid render settings";
+        return result;
+    }
+    
+    // A fresh engine per render: nothing carries over from a previous project
+    ReaperEngine::GlobalSettings settings;
+    settings.sampleRate = options.sampleRate;
+    settings.bufferSize = options.blockSize;
+    settings.maxChannels = options.channels;
+    settings.autoSave = false;
+    
+    m_engine = std::make_unique<ReaperEngine>();
+    if (!m_engine->Initialize(settings)) {
+        result.error = "Could not initialize the engine";
+        return result;
+    }
+    
+    if (!m_engine->LoadProject(projectPath)) {
+        result.error = "Could not load project " + projectPath;
+        return result;
+    }
+    
+    BuildPlaybackProject(projectPath, options, result);
+    
+    // Items saved without a length take their source's, so the end comes from the built items
+    MediaItemManager* items = m_engine->GetMediaItemManager();
+    double endTime = options.endTime;
+    if (endTime < 0.0) {
+        endTime = m_engine->GetProjectManager()->GetProjectLength();
+        for (int i = 0; i < items->GetItemCount(); ++i) {
+            endTime = std::max(endTime, items->GetItem(i)->GetEndPosition());
+        }
+    }
+    endTime += std::max(options.tailTime, 0.0);
+    const double startTime = std::max(options.startTime, 0.0);
+    const int64_t totalFrames = std::llround((endTime - startTime) * options.sampleRate);
+    if (totalFrames <= 0) {
+        result.error = "Nothing to render: the range is empty";
+        return result;
+    }
+    
+    AudioFileWriter writer;
+    if (!writer.Open(outputPath, options.sampleRate, options.channels, options.format, options.dither)) {
+        result.error = "Could not create " + outputPath;
+        return result;
+    }
+    
+    std::vector<float> outputData(static_cast<size_t>(options.channels) * options.blockSize, 0.0f);
+    std::vector<float*> outputs(static_cast<size_t>(options.channels));
+    for (int ch = 0; ch < options.channels; ++ch) {
+        outputs[ch] = outputData.data() + static_cast<size_t>(ch) * options.blockSize;
+    }
+    
+    m_engine->SetPlayPosition(startTime);
+    m_engine->Play();
+    
+    auto renderStart = std::chrono::steady_clock::now();
+    while (result.frames < totalFrames) {
+        const int numFrames = static_cast<int>(std::min<int64_t>(options.blockSize, totalFrames - result.frames));
+        const double blockTime = startTime + result.frames / options.sampleRate;
+        
+        // Decode what this block plays now, on this thread, rather than racing the prefetcher
+        items->PrefetchRange(blockTime, blockTime + numFrames / options.sampleRate);
+        m_engine->ProcessAudioBlock(nullptr, outputs.data(), options.channels, numFrames);
+        
+        if (!writer.Write(outputs.data(), numFrames)) {
+            result.error = "Write to " + outputPath + " failed";
+            break;
+        }
+        result.frames += numFrames;
+        
+        if (progress && !progress(static_cast<double>(result.frames) / totalFrames)) {
+            result.error = "Render cancelled";
+            break;
+        }
+    }
+    
+    m_engine->Stop();
+    result.renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+    if (result.renderSeconds > 0.0) {
+        result.realtimeFactor = (result.frames / options.sampleRate) / result.renderSeconds;
+    }
+    
+    if (!writer.Close() && result.error.empty()) {
+        result.error = "Write to " + outputPath + " failed";
+    }
+    
+    // A failed render leaves no partial file behind to be mistaken for a finished one
+    if (!result.error.empty()) {
+        std::remove(outputPath.c_str());
+        return result;
+    }
+    
+    result.success = true;
+    return result;
+}
+
+void OfflineRenderer::BuildPlaybackProject(const std::string& projectPath, const Options& options, Result& result) {
+    ProjectManager* project = m_engine->GetProjectManager();
+    TrackManager* trackManager = m_engine->GetTrackManager();
+    MediaItemManager* itemManager = m_engine->GetMediaItemManager();
+    BuiltinEffectsManager effectsManager;
+    
+    for (const auto& projectTrack : project->GetTracks()) {
+        Track* track = trackManager->CreateTrack(projectTrack.name);
+        if (!track) {
+            result.warnings.push_back("Could not create track \"" + projectTrack.name + "\"");
+            continue;
+        }
+        track->SetVolume(projectTrack.volume);
+        track->SetPan(projectTrack.pan);
+        track->SetMute(projectTrack.mute);
+        track->SetSolo(projectTrack.solo);
+        ++result.tracks;
+        
+        // Only the built-in JSFX can run here; anything else is reported and left out
+        for (const auto& effectId : projectTrack.effects) {
+            std::string effectName = effectId;
+            if (effectName.compare(0, 4, "JS: ") == 0) {
+                effectName = effectName.substr(4);
+            }
+            
+            std::unique_ptr<JSFXEffect> effect = effectsManager.CreateEffect(effectName);
+            if (!effect || !track->GetEffectsChain()) {
+                result.warnings.push_back("Track \"" + projectTrack.name + "\": effect \"" + effectId +
+                                          "\" is not available offline, skipped");
+                continue;
+            }
+            effect->Initialize(options.sampleRate, options.blockSize);
+            track->GetEffectsChain()->AddEffect(std::move(effect));
+        }
+        
+        for (const auto& projectItem : projectTrack.items) {
+            // Items without takes carry their source on the item itself
+            std::vector<ProjectManager::MediaItem::Take> takes = projectItem.takes;
+            if (takes.empty() && !projectItem.sourceFile.empty()) {
+                ProjectManager::MediaItem::Take take;
+                take.sourceFile = projectItem.sourceFile;
+                take.sourceOffset = projectItem.sourceOffset;
+                takes.push_back(take);
+            }
+            
+            MediaItem* item = itemManager->CreateEmptyItem(track, projectItem.position, projectItem.length);
+            if (!item) {
+                continue;
+            }
+            
+            for (const auto& projectTake : takes) {
+                const std::string sourcePath = ResolveSourcePath(projectTake.sourceFile, projectPath);
+                if (!std::filesystem::exists(sourcePath)) {
+                    result.warnings.push_back("Missing source " + projectTake.sourceFile);
+                }
+                
+                int takeIndex = item->AddTake(sourcePath);
+                if (MediaItem::Take* take = item->GetTake(takeIndex)) {
+                    take->sourceOffset = projectTake.sourceOffset;
+                    take->playRate = projectTake.playRate;
+                    take->pitch = projectTake.pitch;
+                    take->preservePitch = projectTake.preservePitch;
+                    item->MarkChanged();
+                }
+            }
+            
+            if (!takes.empty()) {
+                item->SetActiveTake(std::clamp(projectItem.activeTake, 0, static_cast<int>(takes.size()) - 1));
+            }
+            if (projectItem.length > 0.0) {
+                item->SetLength(projectItem.length);    // The first take sized the item to its source
+            }
+            item->SetName(projectItem.name);
+            item->SetVolume(projectItem.volume);
+            item->SetMute(projectItem.mute);
+            if (projectItem.fadeIn > 0.0) item->SetFadeIn(projectItem.fadeIn);
+            if (projectItem.fadeOut > 0.0) item->SetFadeOut(projectItem.fadeOut);
+            ++result.items;
+        }
+    }
+}
+
+std::string OfflineRenderer::ResolveSourcePath(const std::string& sourceFile, const std::string& projectPath) {
+    // Relative sources are looked up beside the project, as REAPER does
+    std::filesystem::path source(sourceFile);
+    if (source.is_absolute() || std::filesystem::exists(source)) {
+        return sourceFile;
+    }
+    
+    std::filesystem::path besideProject = std::filesystem::path(projectPath).parent_path() / source;
+    return besideProject.string();
+}
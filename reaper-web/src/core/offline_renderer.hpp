@@ -0,0 +1,65 @@
+/*
+ * REAPER Web - Offline Renderer
+ * Bounces a project to an audio file faster than realtime, without an audio device
+ */
+
+#pragma once
+
+#include "../recording/audio_file_writer.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ReaperEngine;
+
+/**
+ * OfflineRenderer - Headless project render
+ * The project loads into a private ReaperEngine; its track list is turned
+ * into playback tracks, items and built-in effects, and the engine is then
+ * pulled block after block as fast as it renders. Source blocks are decoded
+ * on the rendering thread just ahead of each block instead of being left to
+ * the realtime prefetcher, so nothing in the bounce ever reads as a dropout.
+ */
+class OfflineRenderer {
+public:
+    struct Options {
+        double sampleRate = 48000.0;
+        int blockSize = 1024;
+        int channels = 2;
+        double startTime = 0.0;         // Seconds
+        double endTime = -1.0;          // Seconds; negative renders to the end of the last item
+        double tailTime = 0.0;          // Extra seconds past the end for effect tails
+        AudioFileWriter::SampleFormat format = AudioFileWriter::SampleFormat::FLOAT_32;
+        bool dither = false;            // TPDF dither for 16/24-bit output
+    };
+
+    struct Result {
+        bool success = false;
+        std::string error;              // Why the render failed
+        std::vector<std::string> warnings;  // Missing sources, unknown effects
+        int tracks = 0;
+        int items = 0;
+        int64_t frames = 0;             // Sample frames written
+        double renderSeconds = 0.0;     // Wall-clock time spent rendering
+        double realtimeFactor = 0.0;    // Seconds of audio per second of rendering
+    };
+
+    // Called between blocks with the fraction rendered; returning false cancels
+    using ProgressCallback = std::function<bool(double fraction)>;
+
+    OfflineRenderer();
+    ~OfflineRenderer();
+
+    OfflineRenderer(const OfflineRenderer&) = delete;
+    OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+    Result Render(const std::string& projectPath, const std::string& outputPath, const Options& options,
+                  const ProgressCallback& progress = nullptr);
+
+private:
+    std::unique_ptr<ReaperEngine> m_engine;
+
+    void BuildPlaybackProject(const std::string& projectPath, const Options& options, Result& result);
+    static std::string ResolveSourcePath(const std::string& sourceFile, const std::string& projectPath);
+};
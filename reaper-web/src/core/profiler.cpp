@@ -0,0 +1,248 @@
+/*
+ * REAPER Web - Profiler Implementation
+ * Lock-free per-thread event rings drained to Chrome trace JSON
+ */
+
+#include "profiler.hpp"
+#include <algorithm>
+
+namespace {
+
+constexpr auto kDrainInterval = std::chrono::milliseconds(10);
+
+const char* CategoryName(Profiler::Category category) {
+    switch (category) {
+        case Profiler::Category::BLOCK: return "block";
+        case Profiler::Category::TRACK: return "track";
+        case Profiler::Category::EFFECT: return "effect";
+        case Profiler::Category::ITEM_READ: return "item";
+        case Profiler::Category::MIX: return "mix";
+        case Profiler::Category::MASTER: return "master";
+    }
+    return "other";
+}
+
+// Writes name as the body of a JSON string
+void WriteEscaped(FILE* file, const char* name) {
+    for (const char* c = name; *c; ++c) {
+        const unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', file);
+            std::fputc(ch, file);
+        } else if (ch < 0x20) {
+            std::fprintf(file, "\\u%04x", ch);
+        } else {
+            std::fputc(ch, file);
+        }
+    }
+}
+
+} // anonymous namespace
+
+// CycleClock Implementation
+double CycleClock::GetTicksPerMicrosecond() {
+#if defined(REAPER_CYCLE_CLOCK_TSC)
+    // The TSC runs at a constant rate on anything recent; time it once
+    static const double ticksPerMicrosecond = [] {
+        auto startTime = std::chrono::steady_clock::now();
+        uint64_t startTicks = Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t endTicks = Now();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+        return elapsed > 0.0 ? static_cast<double>(endTicks - startTicks) / elapsed : 1000.0;
+    }();
+    return ticksPerMicrosecond;
+#else
+    return 1000.0;
+#endif
+}
+
+// Profiler Implementation
+Profiler& Profiler::GetInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() {
+    m_rings = std::make_unique<Ring[]>(MAX_THREADS);
+}
+
+Profiler::~Profiler() {
+    StopCapture();
+}
+
+bool Profiler::StartCapture(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(m_exportMutex);
+    if (m_capturing) {
+        return false;
+    }
+    
+    m_file = std::fopen(filePath.c_str(), "w");
+    if (!m_file) {
+        return false;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", m_file);
+    m_firstEvent = true;
+    m_exportedEvents = 0;
+    m_ticksPerMicrosecond = CycleClock::GetTicksPerMicrosecond();
+    m_originTicks = CycleClock::Now();
+    
+    // Ring memory is only taken once profiling is first used. Events left
+    // over from the last capture (scopes that were open as it stopped) are skipped.
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        Ring& ring = m_rings[i];
+        if (!ring.events) {
+            ring.events = std::make_unique<Event[]>(RING_EVENTS);
+        }
+        ring.readPos.store(ring.writePos.load(std::memory_order_acquire), std::memory_order_release);
+        ring.dropped = 0;
+    }
+    
+    m_capturing = true;
+    m_enabled.store(true, std::memory_order_release);
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    m_readerRunning = true;
+    m_readerThread = std::thread(&Profiler::ReaderThreadMain, this);
+#endif
+    return true;
+}
+
+bool Profiler::StopCapture() {
+    m_enabled.store(false, std::memory_order_release);
+    
+    if (m_readerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_readerRunning = false;
+        }
+        m_wakeCondition.notify_one();
+        m_readerThread.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(m_exportMutex);
+    if (!m_capturing) {
+        return true;
+    }
+    
+    DrainAll();
+    
+    // Name each ring's trace thread
+    const int threads = std::min(m_claimedRings.load(), MAX_THREADS);
+    for (int i = 0; i < threads; ++i) {
+        std::fprintf(m_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Thread %d\"}}",
+                     m_firstEvent ? "\n" : ",\n", i, i);
+        m_firstEvent = false;
+    }
+    std::fputs("]}\n", m_file);
+    
+    bool written = std::ferror(m_file) == 0;
+    written = std::fclose(m_file) == 0 && written;
+    m_file = nullptr;
+    m_capturing = false;
+    return written;
+}
+
+void Profiler::Record(Category category, const char* name, int id, uint64_t start, uint64_t end) {
+    if (!m_enabled.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    Ring* ring = GetThreadRing();
+    if (!ring) {
+        return;
+    }
+    
+    // Single producer: only this thread moves writePos
+    const uint64_t write = ring->writePos.load(std::memory_order_relaxed);
+    if (write - ring->readPos.load(std::memory_order_acquire) >= RING_EVENTS) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    Event& event = ring->events[write & (RING_EVENTS - 1)];
+    event.start = start;
+    event.end = end;
+    event.id = id;
+    event.category = category;
+    int length = 0;
+    for (; name && name[length] && length < NAME_LENGTH; ++length) {
+        event.name[length] = name[length];
+    }
+    event.name[length] = '\0';
+    
+    ring->writePos.store(write + 1, std::memory_order_release);
+}
+
+void Profiler::Service() {
+    if (m_capturing && !m_readerThread.joinable()) {
+        std::lock_guard<std::mutex> lock(m_exportMutex);
+        DrainAll();
+    }
+}
+
+uint64_t Profiler::GetDroppedEvents() const {
+    uint64_t dropped = 0;
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        dropped += m_rings[i].dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+Profiler::Ring* Profiler::GetThreadRing() {
+    // Claimed on the thread's first event and kept for its lifetime; -2 when none were left
+    thread_local int slot = -1;
+    if (slot == -1) {
+        const int claimed = m_claimedRings.fetch_add(1, std::memory_order_relaxed);
+        slot = claimed < MAX_THREADS ? claimed : -2;
+    }
+    return slot >= 0 ? &m_rings[slot] : nullptr;
+}
+
+void Profiler::ReaderThreadMain() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (m_readerRunning.load()) {
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> exportLock(m_exportMutex);
+            DrainAll();
+        }
+        lock.lock();
+        
+        // Producers never signal; a ring holds far more than one interval of events
+        m_wakeCondition.wait_for(lock, kDrainInterval, [this] { return !m_readerRunning.load(); });
+    }
+}
+
+void Profiler::DrainAll() {
+    if (!m_file) {
+        return;
+    }
+    
+    const int threads = std::min(m_claimedRings.load(), MAX_THREADS);
+    for (int i = 0; i < threads; ++i) {
+        Ring& ring = m_rings[i];
+        const uint64_t write = ring.writePos.load(std::memory_order_acquire);
+        uint64_t read = ring.readPos.load(std::memory_order_relaxed);
+        for (; read < write; ++read) {
+            WriteEvent(i, ring.events[read & (RING_EVENTS - 1)]);
+        }
+        ring.readPos.store(read, std::memory_order_release);
+    }
+}
+
+void Profiler::WriteEvent(int thread, const Event& event) {
+    if (event.start < m_originTicks) {
+        return;
+    }
+    
+    // Complete events; timestamps in microseconds from the start of the capture
+    const double start = static_cast<double>(event.start - m_originTicks) / m_ticksPerMicrosecond;
+    const double duration = static_cast<double>(event.end - event.start) / m_ticksPerMicrosecond;
+    std::fputs(m_firstEvent ? "\n{\"name\":\"" : ",\n{\"name\":\"", m_file);
+    WriteEscaped(m_file, event.name);
+    std::fprintf(m_file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"id\":%d}}",
+                 CategoryName(event.category), start, duration, thread, event.id);
+    m_firstEvent = false;
+    m_exportedEvents.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,165 @@
+/*
+ * REAPER Web - Profiler
+ * Per-block timing of tracks, effects, item reads and mixing, exported as
+ * a Chrome trace (chrome://tracing, ui.perfetto.dev)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <x86intrin.h>
+#define REAPER_CYCLE_CLOCK_TSC
+#endif
+
+/**
+ * CycleClock - Cheapest monotonic tick available
+ * The time stamp counter on x86 (a few cycles to read), the steady clock
+ * in nanoseconds elsewhere. Ticks are converted to time only off the
+ * audio thread, with a rate measured against the steady clock.
+ */
+class CycleClock {
+public:
+    static inline uint64_t Now() {
+#if defined(REAPER_CYCLE_CLOCK_TSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Ticks per microsecond; measured on first use (blocks for ~10 ms on x86)
+    static double GetTicksPerMicrosecond();
+};
+
+/**
+ * Profiler - Lock-free scoped timing for the audio path
+ * Each thread that records claims one of MAX_THREADS single-producer rings
+ * the first time it records; a scope costs two clock reads and one write
+ * into the thread's own ring, with no locks and no allocation. While
+ * disabled a scope is a single relaxed load.
+ *
+ * StartCapture() enables recording and starts a reader thread that drains
+ * the rings into a Chrome trace JSON file as complete ("X") events, one
+ * trace thread per ring. A full ring drops new events and counts them
+ * rather than blocking the audio thread.
+ */
+class Profiler {
+public:
+    enum class Category : uint8_t {
+        BLOCK,          // Whole audio callback
+        TRACK,          // Track items, volume/pan and FX
+        EFFECT,         // One effect in a chain
+        ITEM_READ,      // One media item rendered into its track
+        MIX,            // Track summed into the master bus
+        MASTER          // Master bus processing
+    };
+
+    static constexpr int MAX_THREADS = 8;
+    static constexpr int RING_EVENTS = 16384;       // Per thread; power of two
+    static constexpr int NAME_LENGTH = 39;          // Longer names are cut
+
+    struct Event {
+        uint64_t start = 0;                 // CycleClock ticks
+        uint64_t end = 0;
+        int32_t id = -1;                    // Track/effect/item index, -1 if none
+        Category category = Category::BLOCK;
+        char name[NAME_LENGTH + 1] = {};
+    };
+
+public:
+    static Profiler& GetInstance();
+    ~Profiler();
+
+    // Capture control (non-realtime). The file is complete once StopCapture()
+    // returns; false if it could not be written.
+    bool StartCapture(const std::string& filePath);
+    bool StopCapture();
+    bool IsCapturing() const { return m_capturing.load(); }
+
+    // Realtime - cheap enough to test around every scope
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void Record(Category category, const char* name, int id, uint64_t start, uint64_t end);
+
+    // Without pthreads (browser main-thread builds) the caller drains from its own loop
+    void Service();
+
+    uint64_t GetDroppedEvents() const;
+    uint64_t GetExportedEvents() const { return m_exportedEvents.load(); }
+
+private:
+    Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    struct Ring {
+        std::unique_ptr<Event[]> events;
+        alignas(64) std::atomic<uint64_t> writePos{0};      // Owning thread
+        alignas(64) std::atomic<uint64_t> readPos{0};       // Reader thread
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    std::unique_ptr<Ring[]> m_rings;
+    std::atomic<int> m_claimedRings{0};
+    std::atomic<bool> m_enabled{false};
+    std::atomic<uint64_t> m_exportedEvents{0};
+
+    // Export (reader side)
+    FILE* m_file = nullptr;
+    std::atomic<bool> m_capturing{false};
+    bool m_firstEvent = true;
+    uint64_t m_originTicks = 0;
+    double m_ticksPerMicrosecond = 1.0;
+    std::mutex m_exportMutex;
+
+    // Reader thread
+    std::thread m_readerThread;
+    std::atomic<bool> m_readerRunning{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    Ring* GetThreadRing();
+    void ReaderThreadMain();
+    void DrainAll();
+    void WriteEvent(int thread, const Event& event);
+};
+
+/**
+ * ProfileScope - Records the enclosing scope as one event
+ * The name is copied when the scope ends, so it only has to outlive the scope.
+ */
+class ProfileScope {
+public:
+    ProfileScope(Profiler::Category category, const char* name, int id = -1)
+        : m_name(name), m_id(id), m_category(category), m_active(Profiler::GetInstance().IsEnabled()) {
+        if (m_active) {
+            m_start = CycleClock::Now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (m_active) {
+            Profiler::GetInstance().Record(m_category, m_name, m_id, m_start, CycleClock::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    int m_id;
+    Profiler::Category m_category;
+    bool m_active;
+    uint64_t m_start = 0;
+};
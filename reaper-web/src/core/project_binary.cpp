@@ -0,0 +1,389 @@
+/*
+ * REAPER Web - Binary Project Format Implementation
+ */
+
+#include "project_binary.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kChunkHeaderSize = 8;     // id + version, precedes each payload
+constexpr size_t kAlignment = 8;
+
+size_t AlignUp(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+} // anonymous namespace
+
+BinaryChunkWriter::BinaryChunkWriter(size_t bufferSize)
+    : m_buffer(std::max<size_t>(bufferSize, 1024)) {
+}
+
+BinaryChunkWriter::~BinaryChunkWriter() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+bool BinaryChunkWriter::Open(const std::string& filePath) {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+    
+    m_file = std::fopen(filePath.c_str(), "wb");
+    if (!m_file) {
+        return false;
+    }
+    
+    // Writes are already batched here
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    m_used = 0;
+    m_offset = 0;
+    m_inChunk = false;
+    m_error = false;
+    m_chunks.clear();
+    m_strings.assign(1, std::string());
+    m_stringIndex.clear();
+    m_stringIndex.reserve(4096);
+    
+    // Zeroed header placeholder; the real one goes in last
+    char blank[sizeof(BinaryProjectHeader)] = {};
+    Append(blank, sizeof(blank));
+    return true;
+}
+
+bool BinaryChunkWriter::Close() {
+    if (!m_file) {
+        return !m_error;
+    }
+    
+    if (m_inChunk) {
+        EndChunk();
+    }
+    
+    // String table: count, offsets (count + 1), then the concatenated text
+    BeginChunk(STRING_TABLE_CHUNK, 1);
+    WriteU32(static_cast<uint32_t>(m_strings.size()));
+    uint64_t textOffset = 0;
+    for (const auto& text : m_strings) {
+        WriteU64(textOffset);
+        textOffset += text.size();
+    }
+    WriteU64(textOffset);
+    for (const auto& text : m_strings) {
+        WriteBytes(text.data(), text.size());
+    }
+    EndChunk();
+    
+    BinaryProjectHeader header;
+    header.chunkCount = static_cast<uint32_t>(m_chunks.size());
+    header.chunkTableOffset = m_offset + m_used;
+    WriteBytes(m_chunks.data(), m_chunks.size() * sizeof(BinaryChunkEntry));
+    header.fileSize = m_offset + m_used;
+    Flush();
+    
+    if (!m_error && (std::fseek(m_file, 0, SEEK_SET) != 0 ||
+                     std::fwrite(&header, sizeof(header), 1, m_file) != 1)) {
+        m_error = true;
+    }
+    if (std::fclose(m_file) != 0) {
+        m_error = true;
+    }
+    m_file = nullptr;
+    
+    m_strings.clear();
+    m_stringIndex.clear();
+    return !m_error;
+}
+
+void BinaryChunkWriter::BeginChunk(uint32_t id, uint32_t version) {
+    if (m_inChunk) {
+        EndChunk();
+    }
+    
+    WriteU32(id);
+    WriteU32(version);
+    
+    BinaryChunkEntry entry;
+    entry.id = id;
+    entry.version = version;
+    entry.offset = m_offset + m_used;
+    m_chunks.push_back(entry);
+    m_inChunk = true;
+}
+
+void BinaryChunkWriter::EndChunk() {
+    if (!m_inChunk) {
+        return;
+    }
+    
+    BinaryChunkEntry& entry = m_chunks.back();
+    entry.size = m_offset + m_used - entry.offset;
+    m_inChunk = false;
+    Pad();
+}
+
+void BinaryChunkWriter::WriteBytes(const void* data, size_t size) {
+    if (size <= m_buffer.size() - m_used) {
+        Append(data, size);
+        return;
+    }
+    
+    // Too large to batch: flush and write straight from the caller's memory
+    Flush();
+    if (size >= m_buffer.size()) {
+        if (!m_error && m_file && std::fwrite(data, 1, size, m_file) != size) {
+            m_error = true;
+        }
+        m_offset += size;
+    } else {
+        Append(data, size);
+    }
+}
+
+uint32_t BinaryChunkWriter::InternString(std::string_view value) {
+    if (value.empty()) {
+        return 0;
+    }
+    
+    auto it = m_stringIndex.find(value);
+    if (it != m_stringIndex.end()) {
+        return it->second;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(m_strings.size());
+    m_strings.emplace_back(value);
+    m_stringIndex.emplace(m_strings.back(), index);
+    return index;
+}
+
+void BinaryChunkWriter::Append(const void* data, size_t size) {
+    if (m_buffer.size() - m_used < size) {
+        Flush();
+    }
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+}
+
+void BinaryChunkWriter::Pad() {
+    static const char zeros[kAlignment] = {};
+    size_t position = static_cast<size_t>(m_offset + m_used);
+    Append(zeros, AlignUp(position) - position);
+}
+
+void BinaryChunkWriter::Flush() {
+    if (m_used == 0) {
+        return;
+    }
+    
+    if (!m_error && m_file && std::fwrite(m_buffer.data(), 1, m_used, m_file) != m_used) {
+        m_error = true;
+    }
+    m_offset += m_used;
+    m_used = 0;
+}
+
+bool BinaryChunkReader::IsBinaryProject(const char* data, size_t size) {
+    uint32_t magic = 0;
+    if (!data || size < sizeof(BinaryProjectHeader)) {
+        return false;
+    }
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == BinaryProjectHeader::MAGIC;
+}
+
+bool BinaryChunkReader::Open(const char* data, size_t size) {
+    m_data = nullptr;
+    m_size = 0;
+    m_chunks.clear();
+    m_strings.clear();
+    
+    if (!IsBinaryProject(data, size)) {
+        return false;
+    }
+    
+    BinaryProjectHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version == 0 || header.version > BinaryProjectHeader::VERSION || header.fileSize != size) {
+        return false;
+    }
+    
+    // The table must sit entirely inside the file
+    const uint64_t tableBytes = static_cast<uint64_t>(header.chunkCount) * sizeof(BinaryChunkEntry);
+    if (header.chunkTableOffset < sizeof(BinaryProjectHeader) || header.chunkTableOffset > size ||
+        tableBytes > size - header.chunkTableOffset) {
+        return false;
+    }
+    
+    m_chunks.resize(header.chunkCount);
+    std::memcpy(m_chunks.data(), data + header.chunkTableOffset, static_cast<size_t>(tableBytes));
+    
+    const BinaryChunkEntry* stringTable = nullptr;
+    for (const auto& chunk : m_chunks) {
+        if (chunk.offset < sizeof(BinaryProjectHeader) + kChunkHeaderSize ||
+            chunk.offset > header.chunkTableOffset ||
+            chunk.size > header.chunkTableOffset - chunk.offset) {
+            m_chunks.clear();
+            return false;
+        }
+        if (chunk.id == BinaryChunkWriter::STRING_TABLE_CHUNK) {
+            stringTable = &chunk;
+        }
+    }
+    
+    m_data = data;
+    m_size = size;
+    m_version = header.version;
+    if (!stringTable || !ReadStringTable(*stringTable)) {
+        m_chunks.clear();
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+    return true;
+}
+
+std::string_view BinaryChunkReader::GetString(uint32_t index) const {
+    return index < m_strings.size() ? m_strings[index] : std::string_view();
+}
+
+bool BinaryChunkReader::ReadStringTable(const BinaryChunkEntry& chunk) {
+    BinaryCursor cursor(*this, chunk);
+    uint32_t count = cursor.ReadU32();
+    if (count == 0 || !cursor.CanRead(static_cast<uint64_t>(count) + 1, sizeof(uint64_t))) {
+        return false;
+    }
+    
+    std::vector<uint64_t> offsets(static_cast<size_t>(count) + 1);
+    for (auto& offset : offsets) {
+        offset = cursor.ReadU64();
+    }
+    
+    const size_t textStart = sizeof(uint32_t) + offsets.size() * sizeof(uint64_t);
+    const uint64_t textBytes = chunk.size - textStart;
+    if (offsets.back() > textBytes) {
+        return false;
+    }
+    
+    const char* text = GetChunkData(chunk) + textStart;
+    m_strings.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+            return false;
+        }
+        m_strings[i] = std::string_view(text + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+    }
+    return true;
+}
+
+void BinaryRecordWriter::BeginRecord(uint32_t type) {
+    if (m_inRecord) {
+        EndRecord();
+    }
+    
+    m_recordStart = m_buffer.size();
+    BinaryLogRecord header;
+    header.type = type;
+    Append(&header, sizeof(header));
+    m_inRecord = true;
+}
+
+void BinaryRecordWriter::EndRecord() {
+    if (!m_inRecord) {
+        return;
+    }
+    
+    BinaryLogRecord header;
+    std::memcpy(&header, m_buffer.data() + m_recordStart, sizeof(header));
+    const char* payload = m_buffer.data() + m_recordStart + sizeof(header);
+    header.size = m_buffer.size() - m_recordStart - sizeof(header);
+    header.checksum = Checksum(payload, static_cast<size_t>(header.size));
+    std::memcpy(m_buffer.data() + m_recordStart, &header, sizeof(header));
+    m_inRecord = false;
+}
+
+void BinaryRecordWriter::WriteString(std::string_view value) {
+    WriteU32(static_cast<uint32_t>(value.size()));
+    Append(value.data(), value.size());
+}
+
+uint32_t BinaryRecordWriter::Checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+bool BinaryLogReader::Open(const char* data, size_t size) {
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    
+    BinaryLogHeader header;
+    if (!data || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != BinaryLogHeader::MAGIC || header.version == 0 || header.version > BinaryLogHeader::VERSION) {
+        return false;
+    }
+    
+    m_data = data;
+    m_size = size;
+    m_position = sizeof(header);
+    m_generation = header.generation;
+    return true;
+}
+
+bool BinaryLogReader::Next(BinaryLogRecord& record, const char*& payload) {
+    if (!m_data || m_size - m_position < sizeof(BinaryLogRecord)) {
+        return false;
+    }
+    
+    std::memcpy(&record, m_data + m_position, sizeof(record));
+    const size_t payloadStart = m_position + sizeof(record);
+    
+    // A torn append leaves a short or mismatched tail
+    if (record.size > m_size - payloadStart ||
+        BinaryRecordWriter::Checksum(m_data + payloadStart, static_cast<size_t>(record.size)) != record.checksum) {
+        return false;
+    }
+    
+    payload = m_data + payloadStart;
+    m_position = payloadStart + static_cast<size_t>(record.size);
+    return true;
+}
+
+std::string_view BinaryCursor::ReadString() {
+    if (!m_reader) {
+        // Inline: length + bytes
+        uint32_t length = ReadU32();
+        if (m_error || length > m_size - m_position) {
+            m_error = true;
+            return std::string_view();
+        }
+        std::string_view text(m_data + m_position, length);
+        m_position += length;
+        return text;
+    }
+    
+    uint32_t index = ReadU32();
+    if (index >= m_reader->GetStringCount()) {
+        m_error = true;
+        return std::string_view();
+    }
+    return m_reader->GetString(index);
+}
+
+bool BinaryCursor::Read(void* out, size_t size) {
+    if (m_error || size > m_size - m_position) {
+        m_error = true;
+        return false;
+    }
+    std::memcpy(out, m_data + m_position, size);
+    m_position += size;
+    return true;
+}
@@ -0,0 +1,252 @@
+/*
+ * REAPER Web - Binary Project Format
+ * Versioned, chunked container used for fast project snapshots (.rpb)
+ *
+ * Layout (little-endian, chunks 8-byte aligned):
+ *   header | chunk | chunk | ... | STRS chunk | chunk table
+ * The header is written last, so a file cut short never validates.
+ *
+ * Write-ahead logs (.wal) use the same field encodings with inline strings:
+ *   log header | record | record | ...
+ * Each record carries its size and a checksum; replay stops at the first
+ * one that does not check out.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+constexpr uint32_t MakeChunkId(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+struct BinaryProjectHeader {
+    static constexpr uint32_t MAGIC = MakeChunkId('R', 'W', 'P', 'B');
+    static constexpr uint32_t VERSION = 1;     // Readers reject newer major versions
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t chunkCount = 0;
+    uint32_t reserved = 0;
+    uint64_t chunkTableOffset = 0;
+    uint64_t fileSize = 0;
+};
+static_assert(sizeof(BinaryProjectHeader) == 32, "Binary project header must stay 32 bytes");
+
+struct BinaryChunkEntry {
+    uint32_t id = 0;
+    uint32_t version = 0;           // Per-chunk layout version
+    uint64_t offset = 0;            // Payload start
+    uint64_t size = 0;              // Payload bytes
+};
+static_assert(sizeof(BinaryChunkEntry) == 24, "Binary chunk entry must stay 24 bytes");
+
+struct BinaryLogHeader {
+    static constexpr uint32_t MAGIC = MakeChunkId('R', 'W', 'A', 'L');
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint64_t generation = 0;        // Checkpoint the log applies on top of
+};
+static_assert(sizeof(BinaryLogHeader) == 16, "Binary log header must stay 16 bytes");
+
+struct BinaryLogRecord {
+    uint32_t type = 0;
+    uint32_t checksum = 0;          // FNV-1a over the payload
+    uint64_t size = 0;              // Payload bytes
+};
+static_assert(sizeof(BinaryLogRecord) == 16, "Binary log record header must stay 16 bytes");
+
+/**
+ * BinaryChunkWriter - Streams chunks to disk through a fixed buffer
+ * Strings are interned into one table (index 0 is the empty string) that
+ * is written after the last chunk. Large raw arrays bypass the buffer.
+ *
+ *   writer.BeginChunk(TRACK_CHUNK, 1);
+ *   writer.WriteString(track.name);
+ *   writer.WriteBytes(points.data(), points.size() * sizeof(points[0]));
+ *   writer.EndChunk();
+ */
+class BinaryChunkWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+    static constexpr uint32_t STRING_TABLE_CHUNK = MakeChunkId('S', 'T', 'R', 'S');
+
+    explicit BinaryChunkWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~BinaryChunkWriter();
+
+    BinaryChunkWriter(const BinaryChunkWriter&) = delete;
+    BinaryChunkWriter& operator=(const BinaryChunkWriter&) = delete;
+
+    bool Open(const std::string& filePath);
+    bool Close();                       // Writes strings, table and header; false if any write failed
+
+    // Chunks
+    void BeginChunk(uint32_t id, uint32_t version);
+    void EndChunk();
+
+    // Payload
+    void WriteU8(uint8_t value) { Append(&value, sizeof(value)); }
+    void WriteU32(uint32_t value) { Append(&value, sizeof(value)); }
+    void WriteI32(int32_t value) { Append(&value, sizeof(value)); }
+    void WriteU64(uint64_t value) { Append(&value, sizeof(value)); }
+    void WriteF64(double value) { Append(&value, sizeof(value)); }
+    void WriteBool(bool value) { WriteU8(value ? 1 : 0); }
+    void WriteString(std::string_view value) { WriteU32(InternString(value)); }
+    void WriteBytes(const void* data, size_t size);
+
+    uint32_t InternString(std::string_view value);
+
+    bool HasError() const { return m_error; }
+    uint64_t GetBytesWritten() const { return m_offset; }
+
+private:
+    FILE* m_file = nullptr;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+    uint64_t m_offset = 0;              // File position of the buffer end
+    bool m_inChunk = false;
+    bool m_error = false;
+
+    std::vector<BinaryChunkEntry> m_chunks;
+    std::deque<std::string> m_strings;  // Stable storage; the index keys view into it
+    std::unordered_map<std::string_view, uint32_t> m_stringIndex;
+
+    void Append(const void* data, size_t size);
+    void Pad();
+    void Flush();
+};
+
+/**
+ * BinaryRecordWriter - Assembles write-ahead log records in memory
+ * Field encoders match BinaryChunkWriter, except strings are written
+ * inline (length + bytes) so every record stands on its own. A batch of
+ * records is handed to the file in one write.
+ */
+class BinaryRecordWriter {
+public:
+    void BeginRecord(uint32_t type);
+    void EndRecord();                   // Fills in size and checksum
+
+    // Payload
+    void WriteU8(uint8_t value) { Append(&value, sizeof(value)); }
+    void WriteU32(uint32_t value) { Append(&value, sizeof(value)); }
+    void WriteI32(int32_t value) { Append(&value, sizeof(value)); }
+    void WriteU64(uint64_t value) { Append(&value, sizeof(value)); }
+    void WriteF64(double value) { Append(&value, sizeof(value)); }
+    void WriteBool(bool value) { WriteU8(value ? 1 : 0); }
+    void WriteString(std::string_view value);
+    void WriteBytes(const void* data, size_t size) { Append(data, size); }
+
+    const char* GetData() const { return m_buffer.data(); }
+    size_t GetSize() const { return m_buffer.size(); }
+    void Clear() { m_buffer.clear(); }
+
+    static uint32_t Checksum(const char* data, size_t size);
+
+private:
+    std::vector<char> m_buffer;
+    size_t m_recordStart = 0;
+    bool m_inRecord = false;
+
+    void Append(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+};
+
+/**
+ * BinaryLogReader - Walks the records of a write-ahead log in memory
+ */
+class BinaryLogReader {
+public:
+    bool Open(const char* data, size_t size);
+    bool Next(BinaryLogRecord& record, const char*& payload);    // False at the end or a damaged record
+
+    uint64_t GetGeneration() const { return m_generation; }
+    size_t GetOffset() const { return m_position; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_position = 0;
+    uint64_t m_generation = 0;
+};
+
+/**
+ * BinaryChunkReader - Validates and indexes a binary project in memory
+ * Works directly on the (usually mapped) file contents; strings are views
+ * into the string table, so they live as long as the data does.
+ */
+class BinaryChunkReader {
+public:
+    bool Open(const char* data, size_t size);
+
+    const std::vector<BinaryChunkEntry>& GetChunks() const { return m_chunks; }
+    const char* GetChunkData(const BinaryChunkEntry& chunk) const { return m_data + chunk.offset; }
+    std::string_view GetString(uint32_t index) const;
+    size_t GetStringCount() const { return m_strings.size(); }
+    uint32_t GetVersion() const { return m_version; }
+
+    static bool IsBinaryProject(const char* data, size_t size);
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    uint32_t m_version = 0;
+    std::vector<BinaryChunkEntry> m_chunks;
+    std::vector<std::string_view> m_strings;
+
+    bool ReadStringTable(const BinaryChunkEntry& chunk);
+};
+
+/**
+ * BinaryCursor - Bounds-checked sequential reads from one chunk or record
+ * Reading past the end yields zeros and sets the error flag, so parsers
+ * can read a whole record and check once. Chunk strings are string table
+ * indices; log record strings are inline.
+ */
+class BinaryCursor {
+public:
+    BinaryCursor(const BinaryChunkReader& reader, const BinaryChunkEntry& chunk)
+        : m_reader(&reader), m_data(reader.GetChunkData(chunk)), m_size(static_cast<size_t>(chunk.size)) {}
+    BinaryCursor(const char* data, size_t size)
+        : m_data(data), m_size(size) {}
+
+    uint8_t ReadU8() { uint8_t v = 0; Read(&v, sizeof(v)); return v; }
+    uint32_t ReadU32() { uint32_t v = 0; Read(&v, sizeof(v)); return v; }
+    int32_t ReadI32() { int32_t v = 0; Read(&v, sizeof(v)); return v; }
+    uint64_t ReadU64() { uint64_t v = 0; Read(&v, sizeof(v)); return v; }
+    double ReadF64() { double v = 0.0; Read(&v, sizeof(v)); return v; }
+    bool ReadBool() { return ReadU8() != 0; }
+    std::string_view ReadString();
+    bool ReadBytes(void* out, size_t size) { return Read(out, size); }
+
+    // Element counts are checked against the bytes left before allocating
+    bool CanRead(uint64_t count, size_t elementSize) const {
+        return elementSize == 0 || count <= (m_size - m_position) / elementSize;
+    }
+
+    bool AtEnd() const { return m_position >= m_size; }
+    bool HasError() const { return m_error; }
+
+private:
+    const BinaryChunkReader* m_reader = nullptr;
+    const char* m_data;
+    size_t m_size;
+    size_t m_position = 0;
+    bool m_error = false;
+
+    bool Read(void* out, size_t size);
+};
@@ -0,0 +1,1940 @@
+/*
+ * REAPER Web - Project Manager Implementation
+ * Streaming .rpp load/save, templates, recent projects and backups
+ */
+
+#include "project_manager.hpp"
+#include "mapped_file.hpp"
+#include "project_binary.hpp"
+#include "rpp_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <random>
+
+namespace {
+
+const char* const kTemplateDirectory = "ProjectTemplates";
+const char* const kBackupExtension = ".rpp-bak";
+const char* const kBinaryExtension = ".rpb";
+
+const char* const kLogExtension = ".wal";
+
+// Binary snapshot chunks
+constexpr uint32_t kInfoChunk = MakeChunkId('I', 'N', 'F', 'O');
+constexpr uint32_t kTrackChunk = MakeChunkId('T', 'R', 'A', 'K');
+constexpr uint32_t kCheckpointChunk = MakeChunkId('C', 'K', 'P', 'T');
+constexpr uint32_t kChunkVersion = 1;
+
+// Autosave log records; a batch takes effect at its COMMIT
+enum LogRecordType : uint32_t {
+    kLogInfo = 1,
+    kLogTrackOrder = 2,         // Track GUIDs in order
+    kLogTrack = 3,              // Track properties, item GUIDs, envelope parameters
+    kLogItem = 4,               // Track GUID, item
+    kLogEnvelope = 5,           // Track GUID, envelope
+    kLogCommit = 6
+};
+
+// Envelope points are stored as the raw (time, value) array
+using EnvelopePoint = std::pair<double, double>;
+static_assert(sizeof(EnvelopePoint) == 2 * sizeof(double), "Envelope points must be two packed doubles");
+
+// Track envelope chunks and the parameter names they load as
+struct EnvelopeBlock {
+    const char* block;
+    const char* parameter;
+};
+
+const EnvelopeBlock kEnvelopeBlocks[] = {
+    { "VOLENV2", "volume" },
+    { "PANENV2", "pan" },
+    { "WIDTHENV2", "width" },
+    { "VOLENV", "volume_prefx" },
+    { "PANENV", "pan_prefx" },
+    { "WIDTHENV", "width_prefx" },
+    { "MUTEENV", "mute" }
+};
+
+const char* EnvelopeParameterForBlock(std::string_view block) {
+    for (const auto& entry : kEnvelopeBlocks) {
+        if (block == entry.block) return entry.parameter;
+    }
+    return nullptr;
+}
+
+const char* EnvelopeBlockForParameter(const std::string& parameter) {
+    for (const auto& entry : kEnvelopeBlocks) {
+        if (parameter == entry.parameter) return entry.block;
+    }
+    return nullptr;
+}
+
+// Plugin chunks inside <FXCHAIN>; JS effects load as "JS: <path>"
+bool IsPluginBlock(std::string_view block) {
+    return block == "VST" || block == "AU" || block == "CLAP" || block == "DX" ||
+           block == "LV2" || block == "JS";
+}
+
+// FX parameter envelopes are stored as "fx<index>:<parameter>"
+std::string FXEnvelopePrefix(size_t fxIndex) {
+    return "fx" + std::to_string(fxIndex) + ":";
+}
+
+const char* SourceTypeForFile(const std::string& filePath) {
+    std::string extension = std::filesystem::path(filePath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    
+    if (extension == ".mp3") return "MP3";
+    if (extension == ".ogg") return "VORBIS";
+    if (extension == ".flac") return "FLAC";
+    return "WAVE";
+}
+
+// REAPER's REC input: 1024 flags a stereo pair
+constexpr int kStereoInputFlag = 1024;
+
+std::string ProjectStem(const std::string& projectPath) {
+    return projectPath.empty() ? "untitled" : std::filesystem::path(projectPath).stem().string();
+}
+
+// Swap a finished temp file in, so a failed save keeps the old file
+bool ReplaceFile(const std::string& tempPath, const std::string& filePath) {
+    if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        // Platforms that will not rename over an existing file
+        std::remove(filePath.c_str());
+        if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Checkpoint generations only need to differ between checkpoints, including
+// across sessions, so a stale log is never replayed onto a newer checkpoint
+uint64_t NewCheckpointGeneration() {
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    uint64_t generation = 0;
+    while (generation == 0) {
+        generation = generator();
+    }
+    return generation;
+}
+
+// Track fields without item and envelope contents, for log records
+ProjectManager::ProjectTrack TrackOutline(const ProjectManager::ProjectTrack& track) {
+    ProjectManager::ProjectTrack outline;
+    outline.guid = track.guid;
+    outline.name = track.name;
+    outline.volume = track.volume;
+    outline.pan = track.pan;
+    outline.mute = track.mute;
+    outline.solo = track.solo;
+    outline.recordArm = track.recordArm;
+    outline.inputMonitor = track.inputMonitor;
+    outline.inputChannel = track.inputChannel;
+    outline.inputDevice = track.inputDevice;
+    outline.effects = track.effects;
+    outline.sends = track.sends;
+    outline.isFolder = track.isFolder;
+    outline.folderDepth = track.folderDepth;
+    outline.folderCompact = track.folderCompact;
+    
+    outline.items.resize(track.items.size());
+    for (size_t i = 0; i < track.items.size(); ++i) {
+        outline.items[i].guid = track.items[i].guid;
+    }
+    outline.envelopes.resize(track.envelopes.size());
+    for (size_t e = 0; e < track.envelopes.size(); ++e) {
+        outline.envelopes[e].parameter = track.envelopes[e].parameter;
+    }
+    return outline;
+}
+
+ProjectManager::ProjectTrack* FindTrack(std::vector<ProjectManager::ProjectTrack>& tracks, std::string_view guid) {
+    for (auto& track : tracks) {
+        if (track.guid == guid) return &track;
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+ProjectManager::ProjectManager() = default;
+
+ProjectManager::~ProjectManager() {
+    StopWriterThread();
+}
+
+bool ProjectManager::Initialize() {
+    m_lastAutoSave = std::chrono::steady_clock::now();
+    return NewProject();
+}
+
+void ProjectManager::Shutdown() {
+    // Let a queued autosave finish before the state goes away
+    StopWriterThread();
+    m_tracks.clear();
+    m_autoSaveEnabled = false;
+}
+
+bool ProjectManager::NewProject() {
+    m_projectInfo = ProjectInfo();
+    m_tracks.clear();
+    MarkAllDirty();
+    return true;
+}
+
+bool ProjectManager::LoadProject(const std::string& filePath) {
+    if (!FileExists(filePath)) {
+        return false;
+    }
+    
+    bool loaded = IsBinaryProjectFile(filePath) ? ParseBinaryFile(filePath) : ParseRPPFile(filePath);
+    if (!loaded) {
+        return false;
+    }
+    
+    m_projectInfo.projectPath = filePath;
+    m_projectInfo.hasUnsavedChanges = false;
+    MarkAllDirty();
+    AddToRecentProjects(filePath);
+    return true;
+}
+
+bool ProjectManager::SaveProject(const std::string& filePath) {
+    std::string savePath = filePath.empty() ? m_projectInfo.projectPath : filePath;
+    if (savePath.empty()) {
+        return false;
+    }
+    
+    bool saved = GetFileExtension(savePath) == kBinaryExtension
+        ? WriteBinaryFile(savePath, m_projectInfo, m_tracks) : WriteRPPFile(savePath);
+    if (!saved) {
+        return false;
+    }
+    
+    m_projectInfo.projectPath = savePath;
+    m_projectInfo.hasUnsavedChanges = false;
+    AddToRecentProjects(savePath);
+    return true;
+}
+
+bool ProjectManager::SaveProjectAs(const std::string& filePath) {
+    return !filePath.empty() && SaveProject(filePath);
+}
+
+void ProjectManager::EnableAutoSave(bool enable, int intervalSeconds) {
+    m_autoSaveEnabled = enable;
+    m_autoSaveInterval = std::max(1, intervalSeconds);
+    m_lastAutoSave = std::chrono::steady_clock::now();
+}
+
+void ProjectManager::AutoSave() {
+    if (!m_autoSaveEnabled || !m_projectInfo.hasUnsavedChanges) {
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastAutoSave < std::chrono::seconds(m_autoSaveInterval)) {
+        return;
+    }
+    
+    WriteAutoSave();
+    m_lastAutoSave = now;
+}
+
+bool ProjectManager::WriteAutoSave() {
+    if (!CreateDirectory(GetBackupDirectory())) {
+        return false;
+    }
+    
+    const std::string checkpointPath = GetAutoSavePath();
+    bool checkpoint = m_dirty.all || checkpointPath != m_checkpointPath;
+    {
+        // Start over once replaying the log would cost a good part of a reload
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        checkpoint = checkpoint || m_autoSaveStats.logBatches >= MAX_LOG_BATCHES ||
+                     m_autoSaveStats.logBytes > m_autoSaveStats.checkpointBytes / 2;
+    }
+    
+    // Only copies happen here; encoding and disk I/O are on the writer thread
+    auto captureStart = std::chrono::steady_clock::now();
+    PendingWrite write;
+    write.filePath = checkpointPath;
+    if (checkpoint) {
+        write.kind = PendingWrite::Kind::CHECKPOINT;
+        write.state = CaptureState();
+        write.generation = m_checkpointGeneration = NewCheckpointGeneration();
+        m_checkpointPath = checkpointPath;
+        m_dirty = DirtyState();
+        m_dirty.all = false;
+    } else if (HasDirtyChanges()) {
+        write.kind = PendingWrite::Kind::LOG;
+        write.batch = CaptureLogBatch();
+        write.generation = m_checkpointGeneration;
+    } else {
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_autoSaveStats.captureMs = MillisecondsSince(captureStart);
+    }
+    QueueWrite(std::move(write));
+    return true;
+}
+
+void ProjectManager::MarkTrackDirty(int trackIndex) {
+    if (const ProjectTrack* track = GetTrack(trackIndex)) {
+        m_dirty.tracks.insert(track->guid);
+        m_projectInfo.hasUnsavedChanges = true;
+    }
+}
+
+void ProjectManager::MarkItemDirty(const std::string& itemGuid) {
+    m_dirty.items.insert(itemGuid);
+    m_projectInfo.hasUnsavedChanges = true;
+}
+
+void ProjectManager::MarkEnvelopeDirty(int trackIndex, const std::string& parameter) {
+    if (const ProjectTrack* track = GetTrack(trackIndex)) {
+        m_dirty.envelopes.emplace(track->guid, parameter);
+        m_projectInfo.hasUnsavedChanges = true;
+    }
+}
+
+void ProjectManager::MarkAllDirty() {
+    m_dirty = DirtyState();
+}
+
+std::string ProjectManager::GetAutoSavePath() const {
+    return GetBackupDirectory() + "/" + ProjectStem(m_projectInfo.projectPath) + "-autosave" + kBinaryExtension;
+}
+
+ProjectManager::AutoSaveStats ProjectManager::GetAutoSaveStats() const {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    return m_autoSaveStats;
+}
+
+std::shared_ptr<const ProjectManager::ProjectState> ProjectManager::CaptureState() const {
+    auto state = std::make_shared<ProjectState>();
+    state->info = m_projectInfo;
+    state->tracks = m_tracks;
+    return state;
+}
+
+bool ProjectManager::SaveBinarySnapshot(const std::string& filePath) {
+    return WriteBinaryFile(filePath, m_projectInfo, m_tracks);
+}
+
+bool ProjectManager::SaveBinarySnapshotAsync(const std::string& filePath) {
+    auto captureStart = std::chrono::steady_clock::now();
+    PendingWrite write;
+    write.kind = PendingWrite::Kind::SNAPSHOT;
+    write.state = CaptureState();
+    write.filePath = filePath;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_autoSaveStats.captureMs = MillisecondsSince(captureStart);
+    }
+    QueueWrite(std::move(write));
+    return true;
+}
+
+void ProjectManager::QueueWrite(PendingWrite write) {
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // No threads in this build: write in place
+    m_pendingWrites.push_back(std::move(write));
+    m_writerRunning = false;
+    lock.unlock();
+    WriterThreadMain();
+#else
+    auto pending = std::find_if(m_pendingWrites.begin(), m_pendingWrites.end(), [&](const PendingWrite& queued) {
+        return queued.kind == PendingWrite::Kind::SNAPSHOT && write.kind == PendingWrite::Kind::SNAPSHOT &&
+               queued.filePath == write.filePath;
+    });
+    if (pending != m_pendingWrites.end()) {
+        pending->state = std::move(write.state);
+    } else {
+        m_pendingWrites.push_back(std::move(write));
+    }
+    
+    if (!m_writerRunning) {
+        m_writerRunning = true;
+        m_writerThread = std::thread(&ProjectManager::WriterThreadMain, this);
+    }
+    m_writerCondition.notify_one();
+#endif
+}
+
+void ProjectManager::WaitForPendingSaves() {
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    m_writerCondition.wait(lock, [this] { return m_pendingWrites.empty() && !m_writerBusy; });
+}
+
+bool ProjectManager::IsBinaryProjectFile(const std::string& filePath) {
+    char header[sizeof(BinaryProjectHeader)] = {};
+    FILE* file = std::fopen(filePath.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    size_t bytesRead = std::fread(header, 1, sizeof(header), file);
+    std::fclose(file);
+    return BinaryChunkReader::IsBinaryProject(header, bytesRead);
+}
+
+void ProjectManager::WriterThreadMain() {
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    while (true) {
+        m_writerCondition.wait(lock, [this] { return !m_pendingWrites.empty() || !m_writerRunning; });
+        if (m_pendingWrites.empty()) {
+            return;     // Stopped with nothing left to write
+        }
+        
+        PendingWrite write = std::move(m_pendingWrites.front());
+        m_pendingWrites.pop_front();
+        m_writerBusy = true;
+        lock.unlock();
+        
+        uint64_t bytesWritten = 0;
+        bool written = false;
+        auto writeStart = std::chrono::steady_clock::now();
+        switch (write.kind) {
+            case PendingWrite::Kind::SNAPSHOT:
+                written = WriteBinaryFile(write.filePath, write.state->info, write.state->tracks, &bytesWritten);
+                break;
+            case PendingWrite::Kind::CHECKPOINT:
+                // The new checkpoint lands first; until the log is reset its old
+                // generation no longer matches, so it is ignored on restore
+                written = WriteBinaryFile(write.filePath, write.state->info, write.state->tracks, &bytesWritten,
+                                          write.generation) &&
+                          ResetLog(write.filePath + kLogExtension, write.generation);
+                break;
+            case PendingWrite::Kind::LOG:
+                written = AppendLogBatch(write.filePath + kLogExtension, *write.batch, &bytesWritten);
+                break;
+        }
+        double writeMs = MillisecondsSince(writeStart);
+        
+        lock.lock();
+        m_writerBusy = false;
+        m_autoSaveStats.writeMs = writeMs;
+        m_autoSaveStats.bytesWritten = bytesWritten;
+        if (written && write.kind == PendingWrite::Kind::CHECKPOINT) {
+            m_autoSaveStats.checkpointBytes = bytesWritten;
+            m_autoSaveStats.logBytes = 0;
+            m_autoSaveStats.logBatches = 0;
+            ++m_autoSaveStats.checkpoints;
+        } else if (written && write.kind == PendingWrite::Kind::LOG) {
+            m_autoSaveStats.logBytes += bytesWritten;
+            ++m_autoSaveStats.logBatches;
+        }
+        ++(written ? m_autoSaveStats.completedWrites : m_autoSaveStats.failedWrites);
+        m_writerCondition.notify_all();
+    }
+}
+
+void ProjectManager::StopWriterThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        if (!m_writerRunning) {
+            return;
+        }
+        m_writerRunning = false;
+    }
+    
+    m_writerCondition.notify_all();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+}
+
+void ProjectManager::SetProjectInfo(const ProjectInfo& info) {
+    m_projectInfo = info;
+    m_projectInfo.hasUnsavedChanges = true;
+    m_dirty.info = true;
+}
+
+ProjectManager::ProjectTrack* ProjectManager::GetTrack(int index) {
+    if (index < 0 || index >= static_cast<int>(m_tracks.size())) {
+        return nullptr;
+    }
+    return &m_tracks[index];
+}
+
+ProjectManager::ProjectTrack* ProjectManager::AddTrack(const std::string& name) {
+    ProjectTrack track;
+    track.guid = GenerateGUID();
+    track.name = name.empty() ? "Track " + std::to_string(m_tracks.size() + 1) : name;
+    
+    m_dirty.trackList = true;
+    m_dirty.tracks.insert(track.guid);
+    m_tracks.push_back(std::move(track));
+    m_projectInfo.hasUnsavedChanges = true;
+    return &m_tracks.back();
+}
+
+bool ProjectManager::RemoveTrack(int index) {
+    if (index < 0 || index >= static_cast<int>(m_tracks.size())) {
+        return false;
+    }
+    
+    m_tracks.erase(m_tracks.begin() + index);
+    m_dirty.trackList = true;
+    
+    // Keep item track indices in step
+    for (size_t t = index; t < m_tracks.size(); ++t) {
+        for (auto& item : m_tracks[t].items) {
+            item.trackIndex = static_cast<int>(t);
+        }
+    }
+    
+    m_projectInfo.hasUnsavedChanges = true;
+    return true;
+}
+
+bool ProjectManager::MoveTrack(int fromIndex, int toIndex) {
+    const int count = static_cast<int>(m_tracks.size());
+    if (fromIndex < 0 || fromIndex >= count || toIndex < 0 || toIndex >= count) {
+        return false;
+    }
+    if (fromIndex == toIndex) {
+        return true;
+    }
+    
+    ProjectTrack track = std::move(m_tracks[fromIndex]);
+    m_tracks.erase(m_tracks.begin() + fromIndex);
+    m_tracks.insert(m_tracks.begin() + toIndex, std::move(track));
+    m_dirty.trackList = true;
+    
+    for (size_t t = std::min(fromIndex, toIndex); t < m_tracks.size(); ++t) {
+        for (auto& item : m_tracks[t].items) {
+            item.trackIndex = static_cast<int>(t);
+        }
+    }
+    
+    m_projectInfo.hasUnsavedChanges = true;
+    return true;
+}
+
+ProjectManager::MediaItem* ProjectManager::AddMediaItem(int trackIndex, const std::string& sourceFile, double position) {
+    ProjectTrack* track = GetTrack(trackIndex);
+    if (!track) {
+        return nullptr;
+    }
+    
+    MediaItem item;
+    item.guid = GenerateGUID();
+    item.name = GetFileName(sourceFile);
+    item.position = position;
+    item.sourceFile = sourceFile;
+    item.trackIndex = trackIndex;
+    
+    MediaItem::Take take;
+    take.name = item.name;
+    take.sourceFile = sourceFile;
+    item.takes.push_back(std::move(take));
+    
+    m_dirty.tracks.insert(track->guid);
+    m_dirty.items.insert(item.guid);
+    track->items.push_back(std::move(item));
+    m_projectInfo.hasUnsavedChanges = true;
+    return &track->items.back();
+}
+
+bool ProjectManager::RemoveMediaItem(int trackIndex, const std::string& itemGuid) {
+    ProjectTrack* track = GetTrack(trackIndex);
+    if (!track) {
+        return false;
+    }
+    
+    auto it = std::find_if(track->items.begin(), track->items.end(),
+                           [&](const MediaItem& item) { return item.guid == itemGuid; });
+    if (it == track->items.end()) {
+        return false;
+    }
+    
+    track->items.erase(it);
+    m_dirty.tracks.insert(track->guid);
+    m_projectInfo.hasUnsavedChanges = true;
+    return true;
+}
+
+ProjectManager::MediaItem* ProjectManager::GetMediaItem(const std::string& guid) {
+    for (auto& track : m_tracks) {
+        for (auto& item : track.items) {
+            if (item.guid == guid) {
+                return &item;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool ProjectManager::SaveAsTemplate(const std::string& templateName) {
+    if (templateName.empty() || !CreateDirectory(GetTemplateDirectory())) {
+        return false;
+    }
+    return WriteRPPFile(GetTemplateDirectory() + "/" + templateName + ".rpp");
+}
+
+bool ProjectManager::LoadTemplate(const std::string& templateName) {
+    if (!ParseRPPFile(GetTemplateDirectory() + "/" + templateName + ".rpp")) {
+        return false;
+    }
+    
+    // A template starts an unsaved project
+    m_projectInfo.projectPath.clear();
+    m_projectInfo.hasUnsavedChanges = true;
+    MarkAllDirty();
+    return true;
+}
+
+std::vector<std::string> ProjectManager::GetAvailableTemplates() const {
+    std::vector<std::string> templates;
+    
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(GetTemplateDirectory(), error)) {
+        if (entry.path().extension() == ".rpp") {
+            templates.push_back(entry.path().stem().string());
+        }
+    }
+    
+    std::sort(templates.begin(), templates.end());
+    return templates;
+}
+
+void ProjectManager::AddToRecentProjects(const std::string& filePath) {
+    m_recentProjects.erase(std::remove(m_recentProjects.begin(), m_recentProjects.end(), filePath),
+                           m_recentProjects.end());
+    m_recentProjects.insert(m_recentProjects.begin(), filePath);
+    
+    if (m_recentProjects.size() > static_cast<size_t>(MAX_RECENT_PROJECTS)) {
+        m_recentProjects.resize(MAX_RECENT_PROJECTS);
+    }
+}
+
+std::vector<std::string> ProjectManager::GetRecentProjects() const {
+    return m_recentProjects;
+}
+
+double ProjectManager::GetProjectLength() const {
+    double length = m_projectInfo.length;
+    for (const auto& track : m_tracks) {
+        for (const auto& item : track.items) {
+            length = std::max(length, item.position + item.length);
+        }
+    }
+    return length;
+}
+
+int ProjectManager::GetMediaItemCount() const {
+    int count = 0;
+    for (const auto& track : m_tracks) {
+        count += static_cast<int>(track.items.size());
+    }
+    return count;
+}
+
+bool ProjectManager::CreateBackup(const std::string& backupPath) {
+    std::string path = backupPath;
+    if (path.empty()) {
+        if (!CreateDirectory(GetBackupDirectory())) {
+            return false;
+        }
+        
+        std::string name = ProjectStem(m_projectInfo.projectPath);
+        char stamp[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d_%H%M%S", std::localtime(&now));
+        path = GetBackupDirectory() + "/" + name + "-" + stamp + kBackupExtension;
+    }
+    
+    return WriteRPPFile(path);
+}
+
+std::vector<std::string> ProjectManager::GetAvailableBackups() const {
+    std::vector<std::string> backups;
+    
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(GetBackupDirectory(), error)) {
+        if (entry.path().extension() == kBackupExtension || entry.path().extension() == kBinaryExtension) {
+            backups.push_back(entry.path().string());
+        }
+    }
+    
+    // Timestamped names sort oldest first
+    std::sort(backups.begin(), backups.end());
+    return backups;
+}
+
+bool ProjectManager::RestoreFromBackup(const std::string& backupPath) {
+    std::string projectPath = m_projectInfo.projectPath;
+    if (IsBinaryProjectFile(backupPath)) {
+        // Checkpoint, then the committed log batches written since
+        ProjectInfo info;
+        std::vector<ProjectTrack> tracks;
+        uint64_t generation = 0;
+        if (!ReadBinaryFile(backupPath, info, tracks, &generation)) {
+            return false;
+        }
+        if (generation != 0) {
+            ReplayLog(backupPath + kLogExtension, generation, info, tracks);
+        }
+        
+        m_projectInfo = std::move(info);
+        m_tracks = std::move(tracks);
+    } else if (!ParseRPPFile(backupPath)) {
+        return false;
+    }
+    
+    // The restored state belongs to the original project and is not saved yet
+    m_projectInfo.projectPath = projectPath;
+    m_projectInfo.hasUnsavedChanges = true;
+    MarkAllDirty();
+    return true;
+}
+
+bool ProjectManager::ParseRPPFile(const std::string& filePath) {
+    MappedFile file;
+    if (!file.Open(filePath)) {
+        return false;
+    }
+    
+    RPPTokenizer tokenizer(file.GetData(), file.GetSize());
+    RPPLine line;
+    if (!tokenizer.Next(line) || line.type != RPPLine::Type::BLOCK_START || !line.Is("REAPER_PROJECT")) {
+        return false;
+    }
+    
+    // Parse into fresh state so a damaged file leaves the open project alone
+    ProjectInfo info;
+    std::vector<ProjectTrack> tracks;
+    if (!ParseProject(tokenizer, info, tracks)) {
+        return false;
+    }
+    
+    m_projectInfo = std::move(info);
+    m_tracks = std::move(tracks);
+    return true;
+}
+
+bool ProjectManager::ParseProject(RPPTokenizer& tokenizer, ProjectInfo& info, std::vector<ProjectTrack>& tracks) {
+    // Sends are stored on the receiving track (AUXRECV <source> ...)
+    std::vector<std::pair<int, ProjectTrack::Send>> receives;
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            for (auto& receive : receives) {
+                if (receive.first >= 0 && receive.first < static_cast<int>(tracks.size())) {
+                    tracks[receive.first].sends.push_back(receive.second);
+                }
+            }
+            return true;
+        }
+        
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (line.Is("TRACK")) {
+                const int trackIndex = static_cast<int>(tracks.size());
+                const size_t firstReceive = receives.size();
+                
+                tracks.emplace_back();
+                if (!ParseTrack(tokenizer, line, tracks.back(), receives)) {
+                    return false;
+                }
+                
+                for (auto& item : tracks.back().items) {
+                    item.trackIndex = trackIndex;
+                }
+                for (size_t r = firstReceive; r < receives.size(); ++r) {
+                    receives[r].second.destTrack = trackIndex;
+                }
+            } else if (line.Is("NOTES")) {
+                if (!ParseNotes(tokenizer, info.notes)) return false;
+            } else if (line.Is("TEMPOENVEX")) {
+                if (!ParseTempoEnvelope(tokenizer, info.tempoMarkers)) return false;
+            } else if (!tokenizer.SkipBlock()) {
+                return false;
+            }
+            continue;
+        }
+        
+        if (line.Is("TEMPO")) {
+            info.tempo = line.GetDouble(1, 120.0);
+            info.timeSigNumerator = line.GetInt(2, 4);
+            info.timeSigDenominator = line.GetInt(3, 4);
+        } else if (line.Is("SAMPLERATE")) {
+            info.sampleRate = line.GetDouble(1, 48000.0);
+        } else if (line.Is("MASTER_NCH")) {
+            info.channels = line.GetInt(1, 2);
+        } else if (line.Is("TITLE")) {
+            info.title = line.GetString(1);
+        } else if (line.Is("AUTHOR")) {
+            info.author = line.GetString(1);
+        }
+    }
+    
+    return false;   // Truncated file
+}
+
+bool ProjectManager::ParseNotes(RPPTokenizer& tokenizer, std::string& notes) {
+    RPPLine line;
+    notes.clear();
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (!tokenizer.SkipBlock()) return false;
+            continue;
+        }
+        
+        // Each note line is stored as "|text"
+        if (!line.text.empty() && line.text[0] == '|') {
+            if (!notes.empty()) notes += '\n';
+            notes.append(line.text.data() + 1, line.text.size() - 1);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseTrack(RPPTokenizer& tokenizer, const RPPLine& header, ProjectTrack& track,
+                                std::vector<std::pair<int, ProjectTrack::Send>>& receives) {
+    track.guid = header.GetString(1);
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (line.Is("ITEM")) {
+                track.items.emplace_back();
+                if (!ParseItem(tokenizer, track.items.back())) return false;
+            } else if (line.Is("FXCHAIN")) {
+                if (!ParseFXChain(tokenizer, track)) return false;
+            } else if (const char* parameter = EnvelopeParameterForBlock(line.Key())) {
+                track.envelopes.emplace_back();
+                track.envelopes.back().parameter = parameter;
+                if (!ParseEnvelope(tokenizer, track.envelopes.back())) return false;
+            } else if (!tokenizer.SkipBlock()) {
+                return false;
+            }
+            continue;
+        }
+        
+        if (line.Is("NAME")) {
+            track.name = line.GetString(1);
+        } else if (line.Is("TRACKID")) {
+            track.guid = line.GetString(1);
+        } else if (line.Is("VOLPAN")) {
+            track.volume = line.GetDouble(1, 1.0);
+            track.pan = line.GetDouble(2, 0.0);
+        } else if (line.Is("MUTESOLO")) {
+            track.mute = line.GetBool(1);
+            track.solo = line.GetBool(2);
+        } else if (line.Is("REC")) {
+            track.recordArm = line.GetBool(1);
+            int input = line.GetInt(2, 0);
+            track.inputChannel = (input & kStereoInputFlag) ? -1 : input;
+            track.inputMonitor = line.GetBool(3);
+        } else if (line.Is("ISBUS")) {
+            track.isFolder = line.GetInt(1) == 1;
+            track.folderDepth = line.GetInt(2);
+        } else if (line.Is("BUSCOMP")) {
+            track.folderCompact = line.GetBool(1);
+        } else if (line.Is("AUXRECV")) {
+            // AUXRECV source mode volume pan mute ... (mode 0 = post-fader)
+            ProjectTrack::Send send;
+            send.volume = line.GetDouble(3, 1.0);
+            send.pan = line.GetDouble(4, 0.0);
+            send.mute = line.GetBool(5);
+            send.postFader = line.GetInt(2) == 0;
+            receives.emplace_back(line.GetInt(1, -1), send);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseFXChain(RPPTokenizer& tokenizer, ProjectTrack& track) {
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        if (line.type != RPPLine::Type::BLOCK_START) {
+            continue;
+        }
+        
+        if (IsPluginBlock(line.Key())) {
+            // Plugin state (base64) is skipped without tokenizing
+            track.effects.push_back(line.Is("JS") ? "JS: " + line.GetString(1) : line.GetString(1));
+            if (!tokenizer.SkipBlock()) return false;
+        } else if (line.Is("PARMENV") && !track.effects.empty()) {
+            // Parameter envelopes follow the plugin they belong to
+            track.envelopes.emplace_back();
+            track.envelopes.back().parameter = FXEnvelopePrefix(track.effects.size() - 1) + line.GetString(1);
+            if (!ParseEnvelope(tokenizer, track.envelopes.back())) return false;
+        } else if (!tokenizer.SkipBlock()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseTempoEnvelope(RPPTokenizer& tokenizer, std::vector<TempoMarker>& markers) {
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (!tokenizer.SkipBlock()) return false;
+            continue;
+        }
+        
+        // PT time bpm shape [timesig] - shape 0 ramps to the next point; the
+        // time signature packs numerator + denominator * 65536
+        if (line.Is("PT")) {
+            TempoMarker marker;
+            marker.time = line.GetDouble(1);
+            marker.bpm = line.GetDouble(2, 120.0);
+            marker.ramp = line.GetInt(3, 1) == 0;
+            const int timeSig = line.GetInt(4);
+            if (timeSig > 0) {
+                marker.timeSigNumerator = timeSig & 0xFFFF;
+                marker.timeSigDenominator = timeSig >> 16;
+            }
+            markers.push_back(marker);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseEnvelope(RPPTokenizer& tokenizer, ProjectTrack::Envelope& envelope) {
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (!tokenizer.SkipBlock()) return false;
+            continue;
+        }
+        
+        // PT time value [shape tension selected]
+        if (line.Is("PT")) {
+            envelope.points.emplace_back(line.GetDouble(1), line.GetDouble(2));
+        } else if (line.Is("VIS")) {
+            envelope.visible = line.GetBool(1);
+        } else if (line.Is("ARM")) {
+            envelope.armed = line.GetBool(1);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseItem(RPPTokenizer& tokenizer, MediaItem& item) {
+    // The first take's properties sit directly in the item; each later take
+    // starts with a TAKE line ("TAKE SEL" marks the active one)
+    auto currentTake = [&item]() -> MediaItem::Take& {
+        if (item.takes.empty()) item.takes.emplace_back();
+        return item.takes.back();
+    };
+    
+    RPPLine line;
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            if (!item.takes.empty()) {
+                item.activeTake = std::clamp(item.activeTake, 0, static_cast<int>(item.takes.size()) - 1);
+                const MediaItem::Take& active = item.takes[item.activeTake];
+                item.name = active.name;
+                item.sourceFile = active.sourceFile;
+                item.sourceOffset = active.sourceOffset;
+            }
+            return true;
+        }
+        
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            if (line.Is("SOURCE")) {
+                if (!ParseSource(tokenizer, currentTake())) return false;
+            } else if (!tokenizer.SkipBlock()) {
+                return false;
+            }
+            continue;
+        }
+        
+        if (line.Is("POSITION")) {
+            item.position = line.GetDouble(1);
+        } else if (line.Is("LENGTH")) {
+            item.length = line.GetDouble(1);
+        } else if (line.Is("FADEIN")) {
+            item.fadeIn = line.GetDouble(2);
+        } else if (line.Is("FADEOUT")) {
+            item.fadeOut = line.GetDouble(2);
+        } else if (line.Is("VOLPAN")) {
+            item.volume = line.GetDouble(1, 1.0);
+        } else if (line.Is("MUTE")) {
+            item.mute = line.GetBool(1);
+        } else if (line.Is("LOCK")) {
+            item.locked = (line.GetInt(1) & 1) != 0;
+        } else if (line.Is("IGUID")) {
+            item.guid = line.GetString(1);
+        } else if (line.Is("TAKE")) {
+            currentTake();
+            item.takes.emplace_back();
+            if (line.GetToken(1) == "SEL") {
+                item.activeTake = static_cast<int>(item.takes.size()) - 1;
+            }
+        } else if (line.Is("NAME")) {
+            currentTake().name = line.GetString(1);
+        } else if (line.Is("SOFFS")) {
+            currentTake().sourceOffset = line.GetDouble(1);
+        } else if (line.Is("PLAYRATE")) {
+            // PLAYRATE rate preservePitch pitch ...
+            MediaItem::Take& take = currentTake();
+            take.playRate = line.GetDouble(1, 1.0);
+            take.preservePitch = line.GetBool(2, true);
+            take.pitch = line.GetDouble(3);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::ParseSource(RPPTokenizer& tokenizer, MediaItem::Take& take) {
+    RPPLine line;
+    
+    while (tokenizer.Next(line)) {
+        if (line.type == RPPLine::Type::BLOCK_END) {
+            return true;
+        }
+        
+        if (line.type == RPPLine::Type::BLOCK_START) {
+            // Section/reversed sources wrap the file source
+            if (line.Is("SOURCE")) {
+                if (!ParseSource(tokenizer, take)) return false;
+            } else if (!tokenizer.SkipBlock()) {
+                return false;
+            }
+            continue;
+        }
+        
+        if (line.Is("FILE")) {
+            take.sourceFile = line.GetString(1);
+        }
+    }
+    return false;
+}
+
+bool ProjectManager::WriteRPPFile(const std::string& filePath) {
+    // Write beside the target and swap in, so a failed save keeps the old file
+    const std::string tempPath = filePath + ".tmp";
+    
+    RPPWriter writer;
+    if (!writer.Open(tempPath)) {
+        return false;
+    }
+    
+    WriteRPPHeader(writer);
+    for (size_t t = 0; t < m_tracks.size(); ++t) {
+        WriteRPPTrack(writer, m_tracks[t], static_cast<int>(t));
+    }
+    writer.EndBlock();
+    
+    if (!writer.Close()) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    return ReplaceFile(tempPath, filePath);
+}
+
+void ProjectManager::WriteRPPHeader(RPPWriter& writer) {
+    writer.Block("REAPER_PROJECT").Number(0.1).String("7.0/REAPER Web").Integer(std::time(nullptr)).End();
+    
+    if (!m_projectInfo.title.empty()) {
+        writer.Key("TITLE").String(m_projectInfo.title).End();
+    }
+    if (!m_projectInfo.author.empty()) {
+        writer.Key("AUTHOR").String(m_projectInfo.author).End();
+    }
+    if (!m_projectInfo.notes.empty()) {
+        writer.Block("NOTES").Integer(0).Integer(2).End();
+        
+        size_t start = 0;
+        while (start <= m_projectInfo.notes.size()) {
+            size_t end = m_projectInfo.notes.find('\n', start);
+            if (end == std::string::npos) end = m_projectInfo.notes.size();
+            writer.Key("|" + m_projectInfo.notes.substr(start, end - start)).End();
+            start = end + 1;
+        }
+        writer.EndBlock();
+    }
+    
+    writer.Key("SAMPLERATE").Number(m_projectInfo.sampleRate).Integer(0).Integer(0).End();
+    writer.Key("TEMPO").Number(m_projectInfo.tempo)
+          .Integer(m_projectInfo.timeSigNumerator).Integer(m_projectInfo.timeSigDenominator).End();
+    writer.Key("MASTER_NCH").Integer(m_projectInfo.channels).Integer(2).End();
+    
+    if (!m_projectInfo.tempoMarkers.empty()) {
+        writer.Block("TEMPOENVEX").End();
+        for (const auto& marker : m_projectInfo.tempoMarkers) {
+            writer.Key("PT").Number(marker.time).Number(marker.bpm).Integer(marker.ramp ? 0 : 1);
+            if (marker.timeSigNumerator > 0 && marker.timeSigDenominator > 0) {
+                writer.Integer(marker.timeSigNumerator + marker.timeSigDenominator * 65536);
+            }
+            writer.End();
+        }
+        writer.EndBlock();
+    }
+}
+
+void ProjectManager::WriteRPPTrack(RPPWriter& writer, const ProjectTrack& track, int trackIndex) {
+    writer.Block("TRACK");
+    if (!track.guid.empty()) writer.Raw(track.guid);
+    writer.End();
+    
+    writer.Key("NAME").String(track.name).End();
+    if (!track.guid.empty()) {
+        writer.Key("TRACKID").Raw(track.guid).End();
+    }
+    writer.Key("VOLPAN").Number(track.volume).Number(track.pan).Integer(-1).Integer(-1).Integer(1).End();
+    writer.Key("MUTESOLO").Integer(track.mute ? 1 : 0).Integer(track.solo ? 1 : 0).Integer(0).End();
+    writer.Key("ISBUS").Integer(track.isFolder ? 1 : (track.folderDepth < 0 ? 2 : 0)).Integer(track.folderDepth).End();
+    if (track.isFolder) {
+        writer.Key("BUSCOMP").Integer(track.folderCompact ? 1 : 0).Integer(0).End();
+    }
+    writer.Key("REC").Integer(track.recordArm ? 1 : 0)
+          .Integer(track.inputChannel < 0 ? kStereoInputFlag : track.inputChannel)
+          .Integer(track.inputMonitor ? 1 : 0).Integer(0).Integer(0).End();
+    
+    // Sends into this track from the tracks that own them
+    for (size_t source = 0; source < m_tracks.size(); ++source) {
+        for (const auto& send : m_tracks[source].sends) {
+            if (send.destTrack != trackIndex) continue;
+            writer.Key("AUXRECV").Integer(static_cast<int64_t>(source)).Integer(send.postFader ? 0 : 3)
+                  .Number(send.volume).Number(send.pan).Integer(send.mute ? 1 : 0)
+                  .Integer(0).Integer(0).Integer(0).Integer(0).Raw("-1:U").Integer(0).Integer(-1).End();
+        }
+    }
+    
+    for (const auto& envelope : track.envelopes) {
+        if (const char* block = EnvelopeBlockForParameter(envelope.parameter)) {
+            writer.Block(block).End();
+            WriteRPPEnvelope(writer, envelope);
+        }
+    }
+    
+    if (!track.effects.empty()) {
+        writer.Block("FXCHAIN").End();
+        for (size_t fx = 0; fx < track.effects.size(); ++fx) {
+            const std::string& effect = track.effects[fx];
+            if (effect.compare(0, 4, "JS: ") == 0) {
+                writer.Block("JS").String(std::string_view(effect).substr(4)).String("").End();
+            } else {
+                writer.Block("VST").String(effect).String("").End();
+            }
+            writer.EndBlock();
+            
+            const std::string prefix = FXEnvelopePrefix(fx);
+            for (const auto& envelope : track.envelopes) {
+                if (envelope.parameter.compare(0, prefix.size(), prefix) != 0) continue;
+                writer.Block("PARMENV").Raw(std::string_view(envelope.parameter).substr(prefix.size()))
+                      .Integer(0).Integer(1).Integer(0).End();
+                WriteRPPEnvelope(writer, envelope);
+            }
+        }
+        writer.EndBlock();
+    }
+    
+    for (const auto& item : track.items) {
+        WriteRPPItem(writer, item);
+    }
+    
+    writer.EndBlock();
+}
+
+void ProjectManager::WriteRPPEnvelope(RPPWriter& writer, const ProjectTrack::Envelope& envelope) {
+    // Called after the envelope's block line; closes the block
+    writer.Key("ACT").Integer(1).Integer(-1).End();
+    writer.Key("VIS").Integer(envelope.visible ? 1 : 0).Integer(1).Integer(1).End();
+    writer.Key("ARM").Integer(envelope.armed ? 1 : 0).End();
+    for (const auto& point : envelope.points) {
+        writer.Key("PT").Number(point.first).Number(point.second).Integer(0).End();
+    }
+    writer.EndBlock();
+}
+
+void ProjectManager::WriteRPPItem(RPPWriter& writer, const MediaItem& item) {
+    writer.Block("ITEM").End();
+    
+    writer.Key("POSITION").Number(item.position).End();
+    writer.Key("LENGTH").Number(item.length).End();
+    writer.Key("FADEIN").Integer(1).Number(item.fadeIn).Integer(0).Integer(1).Integer(0).Integer(0).Integer(0).End();
+    writer.Key("FADEOUT").Integer(1).Number(item.fadeOut).Integer(0).Integer(1).Integer(0).Integer(0).Integer(0).End();
+    writer.Key("MUTE").Integer(item.mute ? 1 : 0).Integer(0).End();
+    if (item.locked) {
+        writer.Key("LOCK").Integer(1).End();
+    }
+    if (!item.guid.empty()) {
+        writer.Key("IGUID").Raw(item.guid).End();
+    }
+    writer.Key("VOLPAN").Number(item.volume).Integer(0).Integer(1).Integer(-1).End();
+    
+    // An item without takes still carries its source as a single take
+    MediaItem::Take implicitTake;
+    const MediaItem::Take* takes = item.takes.data();
+    size_t takeCount = item.takes.size();
+    if (takeCount == 0 && !item.sourceFile.empty()) {
+        implicitTake.name = item.name;
+        implicitTake.sourceFile = item.sourceFile;
+        implicitTake.sourceOffset = item.sourceOffset;
+        takes = &implicitTake;
+        takeCount = 1;
+    }
+    
+    for (size_t t = 0; t < takeCount; ++t) {
+        const MediaItem::Take& take = takes[t];
+        if (t > 0) {
+            writer.Key("TAKE");
+            if (static_cast<int>(t) == item.activeTake) writer.Raw("SEL");
+            writer.End();
+        }
+        writer.Key("NAME").String(take.name).End();
+        writer.Key("SOFFS").Number(take.sourceOffset).End();
+        writer.Key("PLAYRATE").Number(take.playRate).Integer(take.preservePitch ? 1 : 0)
+              .Number(take.pitch).Integer(-1).Integer(0).Number(0.0025).End();
+        WriteRPPSource(writer, take);
+    }
+    
+    writer.EndBlock();
+}
+
+void ProjectManager::WriteRPPSource(RPPWriter& writer, const MediaItem::Take& take) {
+    if (take.sourceFile.empty()) {
+        writer.Block("SOURCE").Raw("EMPTY").End();
+        writer.EndBlock();
+        return;
+    }
+    
+    writer.Block("SOURCE").Raw(SourceTypeForFile(take.sourceFile)).End();
+    writer.Key("FILE").String(take.sourceFile).End();
+    writer.EndBlock();
+}
+
+bool ProjectManager::ParseBinaryFile(const std::string& filePath) {
+    // Parse into fresh state so a damaged file leaves the open project alone
+    ProjectInfo info;
+    std::vector<ProjectTrack> tracks;
+    if (!ReadBinaryFile(filePath, info, tracks)) {
+        return false;
+    }
+    
+    m_projectInfo = std::move(info);
+    m_tracks = std::move(tracks);
+    return true;
+}
+
+bool ProjectManager::ReadBinaryFile(const std::string& filePath, ProjectInfo& info,
+                                    std::vector<ProjectTrack>& tracks, uint64_t* generation) {
+    MappedFile file;
+    BinaryChunkReader reader;
+    if (!file.Open(filePath) || !reader.Open(file.GetData(), file.GetSize())) {
+        return false;
+    }
+    
+    bool haveInfo = false;
+    
+    // Unknown chunk types are skipped; known ones in a newer layout are not readable
+    for (const auto& chunk : reader.GetChunks()) {
+        BinaryCursor cursor(reader, chunk);
+        if ((chunk.id == kInfoChunk || chunk.id == kTrackChunk) && chunk.version > kChunkVersion) {
+            return false;
+        }
+        
+        if (chunk.id == kInfoChunk) {
+            if (!ParseBinaryInfo(cursor, info)) {
+                return false;
+            }
+            haveInfo = true;
+        } else if (chunk.id == kTrackChunk) {
+            tracks.emplace_back();
+            if (!ParseBinaryTrack(cursor, tracks.back())) {
+                return false;
+            }
+            for (auto& item : tracks.back().items) {
+                item.trackIndex = static_cast<int>(tracks.size()) - 1;
+            }
+        } else if (chunk.id == kCheckpointChunk && generation) {
+            *generation = cursor.ReadU64();
+        }
+    }
+    
+    return haveInfo;
+}
+
+bool ProjectManager::ParseBinaryInfo(BinaryCursor& cursor, ProjectInfo& info) {
+    info.title = std::string(cursor.ReadString());
+    info.author = std::string(cursor.ReadString());
+    info.notes = std::string(cursor.ReadString());
+    info.projectPath = std::string(cursor.ReadString());
+    info.timebase = std::string(cursor.ReadString());
+    info.length = cursor.ReadF64();
+    info.sampleRate = cursor.ReadF64();
+    info.tempo = cursor.ReadF64();
+    info.channels = cursor.ReadI32();
+    info.timeSigNumerator = cursor.ReadI32();
+    info.timeSigDenominator = cursor.ReadI32();
+    
+    // Tempo markers were appended later; older files end here
+    info.tempoMarkers.clear();
+    if (!cursor.HasError() && !cursor.AtEnd()) {
+        uint32_t count = cursor.ReadU32();
+        if (!cursor.CanRead(count, 2 * sizeof(double) + 2 * sizeof(int32_t) + 1)) {
+            return false;
+        }
+        info.tempoMarkers.resize(count);
+        for (auto& marker : info.tempoMarkers) {
+            marker.time = cursor.ReadF64();
+            marker.bpm = cursor.ReadF64();
+            marker.timeSigNumerator = cursor.ReadI32();
+            marker.timeSigDenominator = cursor.ReadI32();
+            marker.ramp = cursor.ReadBool();
+        }
+    }
+    return !cursor.HasError();
+}
+
+bool ProjectManager::ParseBinaryTrackProperties(BinaryCursor& cursor, ProjectTrack& track) {
+    track.guid = std::string(cursor.ReadString());
+    track.name = std::string(cursor.ReadString());
+    track.inputDevice = std::string(cursor.ReadString());
+    track.volume = cursor.ReadF64();
+    track.pan = cursor.ReadF64();
+    track.inputChannel = cursor.ReadI32();
+    track.folderDepth = cursor.ReadI32();
+    track.mute = cursor.ReadBool();
+    track.solo = cursor.ReadBool();
+    track.recordArm = cursor.ReadBool();
+    track.inputMonitor = cursor.ReadBool();
+    track.isFolder = cursor.ReadBool();
+    track.folderCompact = cursor.ReadBool();
+    
+    uint32_t effectCount = cursor.ReadU32();
+    if (!cursor.CanRead(effectCount, sizeof(uint32_t))) {
+        return false;
+    }
+    track.effects.resize(effectCount);
+    for (auto& effect : track.effects) {
+        effect = std::string(cursor.ReadString());
+    }
+    
+    uint32_t sendCount = cursor.ReadU32();
+    if (!cursor.CanRead(sendCount, 2 * sizeof(double))) {
+        return false;
+    }
+    track.sends.resize(sendCount);
+    for (auto& send : track.sends) {
+        send.destTrack = cursor.ReadI32();
+        send.volume = cursor.ReadF64();
+        send.pan = cursor.ReadF64();
+        send.mute = cursor.ReadBool();
+        send.postFader = cursor.ReadBool();
+    }
+    
+    return !cursor.HasError();
+}
+
+bool ProjectManager::ParseBinaryEnvelope(BinaryCursor& cursor, ProjectTrack::Envelope& envelope) {
+    envelope.parameter = std::string(cursor.ReadString());
+    envelope.visible = cursor.ReadBool();
+    envelope.armed = cursor.ReadBool();
+    
+    // Points are one raw array; copy it straight into the vector
+    uint64_t pointCount = cursor.ReadU64();
+    if (!cursor.CanRead(pointCount, sizeof(EnvelopePoint))) {
+        return false;
+    }
+    envelope.points.resize(static_cast<size_t>(pointCount));
+    cursor.ReadBytes(static_cast<void*>(envelope.points.data()), envelope.points.size() * sizeof(EnvelopePoint));
+    return !cursor.HasError();
+}
+
+bool ProjectManager::ParseBinaryItem(BinaryCursor& cursor, MediaItem& item) {
+    item.guid = std::string(cursor.ReadString());
+    item.name = std::string(cursor.ReadString());
+    item.sourceFile = std::string(cursor.ReadString());
+    item.position = cursor.ReadF64();
+    item.length = cursor.ReadF64();
+    item.fadeIn = cursor.ReadF64();
+    item.fadeOut = cursor.ReadF64();
+    item.volume = cursor.ReadF64();
+    item.sourceOffset = cursor.ReadF64();
+    item.activeTake = cursor.ReadI32();
+    item.mute = cursor.ReadBool();
+    item.locked = cursor.ReadBool();
+    
+    uint32_t takeCount = cursor.ReadU32();
+    if (!cursor.CanRead(takeCount, 3 * sizeof(double))) {
+        return false;
+    }
+    item.takes.resize(takeCount);
+    for (auto& take : item.takes) {
+        take.name = std::string(cursor.ReadString());
+        take.sourceFile = std::string(cursor.ReadString());
+        take.stretchMode = std::string(cursor.ReadString());
+        take.sourceOffset = cursor.ReadF64();
+        take.playRate = cursor.ReadF64();
+        take.pitch = cursor.ReadF64();
+        take.preservePitch = cursor.ReadBool();
+    }
+    
+    return !cursor.HasError();
+}
+
+bool ProjectManager::ParseBinaryTrack(BinaryCursor& cursor, ProjectTrack& track) {
+    if (!ParseBinaryTrackProperties(cursor, track)) {
+        return false;
+    }
+    
+    uint32_t envelopeCount = cursor.ReadU32();
+    if (!cursor.CanRead(envelopeCount, sizeof(uint64_t))) {
+        return false;
+    }
+    track.envelopes.resize(envelopeCount);
+    for (auto& envelope : track.envelopes) {
+        if (!ParseBinaryEnvelope(cursor, envelope)) {
+            return false;
+        }
+    }
+    
+    uint32_t itemCount = cursor.ReadU32();
+    if (!cursor.CanRead(itemCount, 6 * sizeof(double))) {
+        return false;
+    }
+    track.items.resize(itemCount);
+    for (auto& item : track.items) {
+        if (!ParseBinaryItem(cursor, item)) {
+            return false;
+        }
+    }
+    
+    return !cursor.HasError();
+}
+
+bool ProjectManager::WriteBinaryFile(const std::string& filePath, const ProjectInfo& info,
+                                     const std::vector<ProjectTrack>& tracks, uint64_t* bytesWritten,
+                                     uint64_t generation) {
+    const std::string tempPath = filePath + ".tmp";
+    
+    BinaryChunkWriter writer;
+    if (!writer.Open(tempPath)) {
+        return false;
+    }
+    
+    writer.BeginChunk(kInfoChunk, kChunkVersion);
+    WriteBinaryInfo(writer, info);
+    writer.EndChunk();
+    
+    // Autosave checkpoints name the log generation that may follow them
+    if (generation != 0) {
+        writer.BeginChunk(kCheckpointChunk, kChunkVersion);
+        writer.WriteU64(generation);
+        writer.EndChunk();
+    }
+    
+    // One chunk per track, streamed out as it is encoded
+    for (const auto& track : tracks) {
+        WriteBinaryTrack(writer, track);
+    }
+    
+    if (!writer.Close()) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    if (bytesWritten) {
+        *bytesWritten = writer.GetBytesWritten();
+    }
+    return ReplaceFile(tempPath, filePath);
+}
+
+template <typename Writer>
+void ProjectManager::WriteBinaryInfo(Writer& writer, const ProjectInfo& info) {
+    writer.WriteString(info.title);
+    writer.WriteString(info.author);
+    writer.WriteString(info.notes);
+    writer.WriteString(info.projectPath);
+    writer.WriteString(info.timebase);
+    writer.WriteF64(info.length);
+    writer.WriteF64(info.sampleRate);
+    writer.WriteF64(info.tempo);
+    writer.WriteI32(info.channels);
+    writer.WriteI32(info.timeSigNumerator);
+    writer.WriteI32(info.timeSigDenominator);
+    writer.WriteU32(static_cast<uint32_t>(info.tempoMarkers.size()));
+    for (const auto& marker : info.tempoMarkers) {
+        writer.WriteF64(marker.time);
+        writer.WriteF64(marker.bpm);
+        writer.WriteI32(marker.timeSigNumerator);
+        writer.WriteI32(marker.timeSigDenominator);
+        writer.WriteBool(marker.ramp);
+    }
+}
+
+template <typename Writer>
+void ProjectManager::WriteBinaryTrackProperties(Writer& writer, const ProjectTrack& track) {
+    writer.WriteString(track.guid);
+    writer.WriteString(track.name);
+    writer.WriteString(track.inputDevice);
+    writer.WriteF64(track.volume);
+    writer.WriteF64(track.pan);
+    writer.WriteI32(track.inputChannel);
+    writer.WriteI32(track.folderDepth);
+    writer.WriteBool(track.mute);
+    writer.WriteBool(track.solo);
+    writer.WriteBool(track.recordArm);
+    writer.WriteBool(track.inputMonitor);
+    writer.WriteBool(track.isFolder);
+    writer.WriteBool(track.folderCompact);
+    
+    writer.WriteU32(static_cast<uint32_t>(track.effects.size()));
+    for (const auto& effect : track.effects) {
+        writer.WriteString(effect);
+    }
+    
+    writer.WriteU32(static_cast<uint32_t>(track.sends.size()));
+    for (const auto& send : track.sends) {
+        writer.WriteI32(send.destTrack);
+        writer.WriteF64(send.volume);
+        writer.WriteF64(send.pan);
+        writer.WriteBool(send.mute);
+        writer.WriteBool(send.postFader);
+    }
+}
+
+template <typename Writer>
+void ProjectManager::WriteBinaryEnvelope(Writer& writer, const ProjectTrack::Envelope& envelope) {
+    writer.WriteString(envelope.parameter);
+    writer.WriteBool(envelope.visible);
+    writer.WriteBool(envelope.armed);
+    writer.WriteU64(envelope.points.size());
+    writer.WriteBytes(envelope.points.data(), envelope.points.size() * sizeof(EnvelopePoint));
+}
+
+template <typename Writer>
+void ProjectManager::WriteBinaryItem(Writer& writer, const MediaItem& item) {
+    writer.WriteString(item.guid);
+    writer.WriteString(item.name);
+    writer.WriteString(item.sourceFile);
+    writer.WriteF64(item.position);
+    writer.WriteF64(item.length);
+    writer.WriteF64(item.fadeIn);
+    writer.WriteF64(item.fadeOut);
+    writer.WriteF64(item.volume);
+    writer.WriteF64(item.sourceOffset);
+    writer.WriteI32(item.activeTake);
+    writer.WriteBool(item.mute);
+    writer.WriteBool(item.locked);
+    
+    writer.WriteU32(static_cast<uint32_t>(item.takes.size()));
+    for (const auto& take : item.takes) {
+        writer.WriteString(take.name);
+        writer.WriteString(take.sourceFile);
+        writer.WriteString(take.stretchMode);
+        writer.WriteF64(take.sourceOffset);
+        writer.WriteF64(take.playRate);
+        writer.WriteF64(take.pitch);
+        writer.WriteBool(take.preservePitch);
+    }
+}
+
+void ProjectManager::WriteBinaryTrack(BinaryChunkWriter& writer, const ProjectTrack& track) {
+    writer.BeginChunk(kTrackChunk, kChunkVersion);
+    WriteBinaryTrackProperties(writer, track);
+    
+    writer.WriteU32(static_cast<uint32_t>(track.envelopes.size()));
+    for (const auto& envelope : track.envelopes) {
+        WriteBinaryEnvelope(writer, envelope);
+    }
+    
+    writer.WriteU32(static_cast<uint32_t>(track.items.size()));
+    for (const auto& item : track.items) {
+        WriteBinaryItem(writer, item);
+    }
+    
+    writer.EndChunk();
+}
+
+bool ProjectManager::HasDirtyChanges() const {
+    return m_dirty.all || m_dirty.info || m_dirty.trackList || !m_dirty.tracks.empty() ||
+           !m_dirty.items.empty() || !m_dirty.envelopes.empty();
+}
+
+std::shared_ptr<const ProjectManager::LogBatch> ProjectManager::CaptureLogBatch() {
+    auto batch = std::make_shared<LogBatch>();
+    
+    if (m_dirty.info) {
+        batch->hasInfo = true;
+        batch->info = m_projectInfo;
+    }
+    
+    // One pass over the project; only marked objects are copied
+    for (const auto& track : m_tracks) {
+        if (m_dirty.trackList) {
+            batch->trackOrder.push_back(track.guid);
+        }
+        if (m_dirty.tracks.count(track.guid)) {
+            batch->tracks.push_back(TrackOutline(track));
+        }
+        if (!m_dirty.items.empty()) {
+            for (const auto& item : track.items) {
+                if (m_dirty.items.count(item.guid)) {
+                    batch->items.emplace_back(track.guid, item);
+                }
+            }
+        }
+        if (!m_dirty.envelopes.empty()) {
+            for (const auto& envelope : track.envelopes) {
+                if (m_dirty.envelopes.count({ track.guid, envelope.parameter })) {
+                    batch->envelopes.emplace_back(track.guid, envelope);
+                }
+            }
+        }
+    }
+    
+    m_dirty = DirtyState();
+    m_dirty.all = false;
+    return batch;
+}
+
+bool ProjectManager::AppendLogBatch(const std::string& logPath, const LogBatch& batch, uint64_t* bytesWritten) {
+    // The whole batch, COMMIT included, goes out in one write
+    BinaryRecordWriter records;
+    if (batch.hasInfo) {
+        records.BeginRecord(kLogInfo);
+        WriteBinaryInfo(records, batch.info);
+        records.EndRecord();
+    }
+    if (!batch.trackOrder.empty()) {
+        records.BeginRecord(kLogTrackOrder);
+        records.WriteU32(static_cast<uint32_t>(batch.trackOrder.size()));
+        for (const auto& guid : batch.trackOrder) {
+            records.WriteString(guid);
+        }
+        records.EndRecord();
+    }
+    for (const auto& track : batch.tracks) {
+        records.BeginRecord(kLogTrack);
+        WriteBinaryTrackProperties(records, track);
+        records.WriteU32(static_cast<uint32_t>(track.items.size()));
+        for (const auto& item : track.items) {
+            records.WriteString(item.guid);
+        }
+        records.WriteU32(static_cast<uint32_t>(track.envelopes.size()));
+        for (const auto& envelope : track.envelopes) {
+            records.WriteString(envelope.parameter);
+        }
+        records.EndRecord();
+    }
+    for (const auto& entry : batch.items) {
+        records.BeginRecord(kLogItem);
+        records.WriteString(entry.first);
+        WriteBinaryItem(records, entry.second);
+        records.EndRecord();
+    }
+    for (const auto& entry : batch.envelopes) {
+        records.BeginRecord(kLogEnvelope);
+        records.WriteString(entry.first);
+        WriteBinaryEnvelope(records, entry.second);
+        records.EndRecord();
+    }
+    records.BeginRecord(kLogCommit);
+    records.EndRecord();
+    
+    // The log must already exist (ResetLog); appending to a missing one would
+    // produce a file without a header
+    FILE* file = std::fopen(logPath.c_str(), "r+b");
+    if (!file) {
+        return false;
+    }
+    
+    bool written = std::fseek(file, 0, SEEK_END) == 0 &&
+                   std::fwrite(records.GetData(), 1, records.GetSize(), file) == records.GetSize();
+    written = std::fclose(file) == 0 && written;
+    
+    if (bytesWritten) {
+        *bytesWritten = records.GetSize();
+    }
+    return written;
+}
+
+bool ProjectManager::ResetLog(const std::string& logPath, uint64_t generation) {
+    FILE* file = std::fopen(logPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    
+    BinaryLogHeader header;
+    header.generation = generation;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    return std::fclose(file) == 0 && written;
+}
+
+bool ProjectManager::ReplayLog(const std::string& logPath, uint64_t generation, ProjectInfo& info,
+                               std::vector<ProjectTrack>& tracks) {
+    MappedFile file;
+    BinaryLogReader reader;
+    if (!file.Open(logPath) || !reader.Open(file.GetData(), file.GetSize()) || reader.GetGeneration() != generation) {
+        return false;
+    }
+    
+    // Records take effect a batch at a time; a torn final batch has no COMMIT
+    std::vector<std::pair<BinaryLogRecord, const char*>> batch;
+    std::vector<MediaItem> detached;    // Items a track record dropped, in case another picks them up
+    BinaryLogRecord record;
+    const char* payload = nullptr;
+    while (reader.Next(record, payload)) {
+        if (record.type != kLogCommit) {
+            batch.emplace_back(record, payload);
+            continue;
+        }
+        
+        for (const auto& entry : batch) {
+            BinaryCursor cursor(entry.second, static_cast<size_t>(entry.first.size));
+            if (!ApplyLogRecord(entry.first.type, cursor, info, tracks, detached)) {
+                // Checksums passed, so this is a writer bug; keep what applied cleanly
+                return false;
+            }
+        }
+        batch.clear();
+        detached.clear();
+    }
+    
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        for (auto& item : tracks[t].items) {
+            item.trackIndex = static_cast<int>(t);
+        }
+    }
+    return true;
+}
+
+bool ProjectManager::ApplyLogRecord(uint32_t type, BinaryCursor& cursor, ProjectInfo& info,
+                                    std::vector<ProjectTrack>& tracks, std::vector<MediaItem>& detached) {
+    switch (type) {
+        case kLogInfo:
+            return ParseBinaryInfo(cursor, info);
+        
+        case kLogTrackOrder: {
+            uint32_t count = cursor.ReadU32();
+            if (!cursor.CanRead(count, sizeof(uint32_t))) {
+                return false;
+            }
+            
+            // Known tracks move into the new order; new ones start empty and
+            // are filled by the track records that follow
+            std::vector<ProjectTrack> ordered(count);
+            for (auto& track : ordered) {
+                std::string_view guid = cursor.ReadString();
+                if (ProjectTrack* existing = FindTrack(tracks, guid)) {
+                    track = std::move(*existing);
+                    existing->guid.clear();
+                }
+                track.guid = std::string(guid);
+            }
+            tracks = std::move(ordered);
+            return !cursor.HasError();
+        }
+        
+        case kLogTrack: {
+            ProjectTrack properties;
+            if (!ParseBinaryTrackProperties(cursor, properties)) {
+                return false;
+            }
+            ProjectTrack* track = FindTrack(tracks, properties.guid);
+            if (!track) {
+                return false;
+            }
+            
+            // Items keep their contents unless an item record follows; one
+            // moved here from another track is taken from there
+            auto matches = [](std::string_view guid) {
+                return [guid](const MediaItem& existing) { return existing.guid == guid; };
+            };
+            uint32_t itemCount = cursor.ReadU32();
+            if (!cursor.CanRead(itemCount, sizeof(uint32_t))) {
+                return false;
+            }
+            properties.items.resize(itemCount);
+            for (auto& item : properties.items) {
+                std::string_view guid = cursor.ReadString();
+                auto own = std::find_if(track->items.begin(), track->items.end(), matches(guid));
+                auto loose = std::find_if(detached.begin(), detached.end(), matches(guid));
+                if (own != track->items.end()) {
+                    item = std::move(*own);
+                    own->guid.clear();
+                } else if (loose != detached.end()) {
+                    item = std::move(*loose);
+                    detached.erase(loose);
+                } else {
+                    for (const auto& other : tracks) {
+                        auto found = std::find_if(other.items.begin(), other.items.end(), matches(guid));
+                        if (found != other.items.end()) {
+                            item = *found;
+                            break;
+                        }
+                    }
+                }
+                item.guid = std::string(guid);
+            }
+            for (auto& dropped : track->items) {
+                if (!dropped.guid.empty()) {
+                    detached.push_back(std::move(dropped));
+                }
+            }
+            
+            uint32_t envelopeCount = cursor.ReadU32();
+            if (!cursor.CanRead(envelopeCount, sizeof(uint32_t))) {
+                return false;
+            }
+            properties.envelopes.resize(envelopeCount);
+            for (auto& envelope : properties.envelopes) {
+                std::string_view parameter = cursor.ReadString();
+                auto own = std::find_if(track->envelopes.begin(), track->envelopes.end(),
+                                        [&](const ProjectTrack::Envelope& existing) {
+                                            return existing.parameter == parameter;
+                                        });
+                if (own != track->envelopes.end()) {
+                    envelope = std::move(*own);
+                }
+                envelope.parameter = std::string(parameter);
+            }
+            
+            *track = std::move(properties);
+            return !cursor.HasError();
+        }
+        
+        case kLogItem: {
+            ProjectTrack* track = FindTrack(tracks, cursor.ReadString());
+            MediaItem item;
+            if (!track || !ParseBinaryItem(cursor, item)) {
+                return false;
+            }
+            auto existing = std::find_if(track->items.begin(), track->items.end(),
+                                         [&](const MediaItem& candidate) { return candidate.guid == item.guid; });
+            if (existing != track->items.end()) {
+                *existing = std::move(item);
+            } else {
+                track->items.push_back(std::move(item));
+            }
+            return true;
+        }
+        
+        case kLogEnvelope: {
+            ProjectTrack* track = FindTrack(tracks, cursor.ReadString());
+            ProjectTrack::Envelope envelope;
+            if (!track || !ParseBinaryEnvelope(cursor, envelope)) {
+                return false;
+            }
+            auto existing = std::find_if(track->envelopes.begin(), track->envelopes.end(),
+                                         [&](const ProjectTrack::Envelope& candidate) {
+                                             return candidate.parameter == envelope.parameter;
+                                         });
+            if (existing != track->envelopes.end()) {
+                *existing = std::move(envelope);
+            } else {
+                track->envelopes.push_back(std::move(envelope));
+            }
+            return true;
+        }
+        
+        default:
+            // Record types from newer writers
+            return true;
+    }
+}
+
+std::string ProjectManager::GenerateGUID() const {
+    // REAPER-style {XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX}
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    uint64_t high = generator();
+    uint64_t low = generator();
+    
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "{%08X-%04X-%04X-%04X-%012llX}",
+                  static_cast<unsigned>(high >> 32), static_cast<unsigned>((high >> 16) & 0xFFFF),
+                  static_cast<unsigned>(high & 0xFFFF), static_cast<unsigned>(low >> 48),
+                  static_cast<unsigned long long>(low & 0xFFFFFFFFFFFFULL));
+    return buffer;
+}
+
+std::string ProjectManager::GetProjectDirectory() const {
+    std::string directory = GetFileDirectory(m_projectInfo.projectPath);
+    return directory.empty() ? "." : directory;
+}
+
+std::string ProjectManager::GetBackupDirectory() const {
+    return GetProjectDirectory() + "/Backups";
+}
+
+std::string ProjectManager::GetTemplateDirectory() const {
+    return kTemplateDirectory;
+}
+
+std::string ProjectManager::MakeRelativePath(const std::string& filePath) const {
+    std::error_code error;
+    auto relative = std::filesystem::relative(filePath, GetProjectDirectory(), error);
+    if (error || relative.empty() || relative.string().compare(0, 2, "..") == 0) {
+        return filePath;
+    }
+    return relative.string();
+}
+
+std::string ProjectManager::MakeAbsolutePath(const std::string& relativePath) const {
+    std::filesystem::path path(relativePath);
+    if (path.is_absolute()) {
+        return relativePath;
+    }
+    return (std::filesystem::path(GetProjectDirectory()) / path).lexically_normal().string();
+}
+
+bool ProjectManager::FileExists(const std::string& filePath) const {
+    std::error_code error;
+    return std::filesystem::is_regular_file(filePath, error);
+}
+
+bool ProjectManager::CreateDirectory(const std::string& dirPath) const {
+    std::error_code error;
+    std::filesystem::create_directories(dirPath, error);
+    return std::filesystem::is_directory(dirPath, error);
+}
+
+std::string ProjectManager::GetFileExtension(const std::string& filePath) const {
+    return std::filesystem::path(filePath).extension().string();
+}
+
+std::string ProjectManager::GetFileName(const std::string& filePath) const {
+    return std::filesystem::path(filePath).filename().string();
+}
+
+std::string ProjectManager::GetFileDirectory(const std::string& filePath) const {
+    return std::filesystem::path(filePath).parent_path().string();
+}
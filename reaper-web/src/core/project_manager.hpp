@@ -6,14 +6,27 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include "tempo_map.hpp"
 
 // Forward declarations
 class Track;
 class ReaperEngine;
+class RPPTokenizer;
+class RPPWriter;
+struct RPPLine;
+class BinaryChunkWriter;
+class BinaryCursor;
 
 /**
  * Project Manager - handles REAPER .rpp project files
@@ -32,6 +45,7 @@ public:
         double tempo = 120.0;
         int timeSigNumerator = 4;
         int timeSigDenominator = 4;
+        std::vector<TempoMarker> tempoMarkers;  // Empty: tempo and time signature above hold throughout
         std::string projectPath;
         bool hasUnsavedChanges = false;
     };
@@ -107,6 +121,24 @@ public:
         bool folderCompact = false;
     };
 
+    // Immutable copy of the project handed to the snapshot writer
+    struct ProjectState {
+        ProjectInfo info;
+        std::vector<ProjectTrack> tracks;
+    };
+
+    struct AutoSaveStats {
+        double captureMs = 0.0;     // Last state copy (calling thread)
+        double writeMs = 0.0;       // Last encode + write (writer thread)
+        uint64_t bytesWritten = 0;  // Size of the last snapshot or log batch
+        uint64_t checkpointBytes = 0;   // Last full autosave checkpoint
+        uint64_t logBytes = 0;      // Log appended since that checkpoint
+        int logBatches = 0;         // Batches since that checkpoint
+        int checkpoints = 0;
+        int completedWrites = 0;
+        int failedWrites = 0;
+    };
+
 public:
     ProjectManager();
     ~ProjectManager();
@@ -122,11 +154,29 @@ public:
     
     // Auto-save functionality
     void EnableAutoSave(bool enable, int intervalSeconds = 300);
-    void AutoSave();
+    void AutoSave();                    // Calls WriteAutoSave when the interval has passed
+    bool WriteAutoSave();               // Full checkpoint, or only what changed since the last one
+    std::string GetAutoSavePath() const;    // Checkpoint; its log is this path + ".wal"
+    AutoSaveStats GetAutoSaveStats() const;
+    
+    // Dirty tracking for incremental autosave. The mutators below mark what
+    // they change; edits made through GetTrack()/GetTracks() must be reported.
+    void MarkTrackDirty(int trackIndex);    // Properties, FX, sends, item and envelope lists
+    void MarkItemDirty(const std::string& itemGuid);
+    void MarkEnvelopeDirty(int trackIndex, const std::string& parameter);
+    void MarkAllDirty();                    // Next autosave writes a full checkpoint
+    
+    // Binary snapshots (.rpb) - LoadProject and RestoreFromBackup accept them too
+    std::shared_ptr<const ProjectState> CaptureState() const;
+    bool SaveBinarySnapshot(const std::string& filePath);
+    bool SaveBinarySnapshotAsync(const std::string& filePath);   // Written on the writer thread
+    void WaitForPendingSaves();
+    static bool IsBinaryProjectFile(const std::string& filePath);
     
     // Project information
     const ProjectInfo& GetProjectInfo() const { return m_projectInfo; }
     void SetProjectInfo(const ProjectInfo& info);
+    void SetUnsavedChanges(bool unsaved) { m_projectInfo.hasUnsavedChanges = unsaved; }
     
     // Track management
     std::vector<ProjectTrack>& GetTracks() { return m_tracks; }
@@ -169,32 +219,109 @@ private:
     int m_autoSaveInterval = 300; // seconds
     std::chrono::steady_clock::time_point m_lastAutoSave;
     
+    // Incremental autosave - what changed since the last checkpoint or log batch
+    struct DirtyState {
+        bool all = true;            // Needs a full checkpoint
+        bool info = false;
+        bool trackList = false;     // Tracks added, removed or reordered
+        std::unordered_set<std::string> tracks;     // Track GUIDs
+        std::unordered_set<std::string> items;      // Item GUIDs
+        std::set<std::pair<std::string, std::string>> envelopes;   // Track GUID, parameter
+    };
+    DirtyState m_dirty;
+    uint64_t m_checkpointGeneration = 0;
+    std::string m_checkpointPath;
+    static constexpr int MAX_LOG_BATCHES = 256;
+    
+    // Changed objects copied out for the writer thread. Track entries carry
+    // only item GUIDs and envelope parameters; contents travel separately.
+    struct LogBatch {
+        bool hasInfo = false;
+        ProjectInfo info;
+        std::vector<std::string> trackOrder;        // Empty unless the track list changed
+        std::vector<ProjectTrack> tracks;
+        std::vector<std::pair<std::string, MediaItem>> items;                  // Track GUID, item
+        std::vector<std::pair<std::string, ProjectTrack::Envelope>> envelopes;  // Track GUID, envelope
+    };
+    
+    // Snapshot writer thread - runs writes in order; a newer plain snapshot
+    // for the same path replaces a queued one
+    struct PendingWrite {
+        enum class Kind { SNAPSHOT, CHECKPOINT, LOG };
+        Kind kind = Kind::SNAPSHOT;
+        std::shared_ptr<const ProjectState> state;
+        std::shared_ptr<const LogBatch> batch;
+        std::string filePath;
+        uint64_t generation = 0;    // Checkpoint the log belongs to
+    };
+    std::thread m_writerThread;
+    mutable std::mutex m_writerMutex;
+    std::condition_variable m_writerCondition;
+    std::deque<PendingWrite> m_pendingWrites;
+    bool m_writerRunning = false;
+    bool m_writerBusy = false;
+    AutoSaveStats m_autoSaveStats;
+    
     // Recent projects
     std::vector<std::string> m_recentProjects;
     static constexpr int MAX_RECENT_PROJECTS = 20;
     
-    // File parsing
+    // File parsing - one pass over the memory-mapped file; the project is
+    // replaced only if the whole file parses
     bool ParseRPPFile(const std::string& filePath);
     bool WriteRPPFile(const std::string& filePath);
     
-    // RPP format helpers
-    std::string ParseRPPLine(const std::string& line, const std::string& key);
-    std::vector<std::string> ParseRPPArray(const std::string& line);
-    double ParseRPPDouble(const std::string& value);
-    int ParseRPPInt(const std::string& value);
-    bool ParseRPPBool(const std::string& value);
-    
-    // Track parsing
-    bool ParseTrack(const std::vector<std::string>& lines, int& lineIndex, ProjectTrack& track);
-    bool ParseItem(const std::vector<std::string>& lines, int& lineIndex, MediaItem& item);
-    bool ParseSource(const std::vector<std::string>& lines, int& lineIndex, MediaItem::Take& take);
+    // Block parsing (called after the block's start line)
+    bool ParseProject(RPPTokenizer& tokenizer, ProjectInfo& info, std::vector<ProjectTrack>& tracks);
+    bool ParseNotes(RPPTokenizer& tokenizer, std::string& notes);
+    bool ParseTempoEnvelope(RPPTokenizer& tokenizer, std::vector<TempoMarker>& markers);
+    bool ParseTrack(RPPTokenizer& tokenizer, const RPPLine& header, ProjectTrack& track,
+                    std::vector<std::pair<int, ProjectTrack::Send>>& receives);
+    bool ParseFXChain(RPPTokenizer& tokenizer, ProjectTrack& track);
+    bool ParseEnvelope(RPPTokenizer& tokenizer, ProjectTrack::Envelope& envelope);
+    bool ParseItem(RPPTokenizer& tokenizer, MediaItem& item);
+    bool ParseSource(RPPTokenizer& tokenizer, MediaItem::Take& take);
     
     // Writing helpers
-    void WriteRPPHeader(std::ofstream& file);
-    void WriteRPPTrack(std::ofstream& file, const ProjectTrack& track, int indent = 1);
-    void WriteRPPItem(std::ofstream& file, const MediaItem& item, int indent = 2);
-    void WriteRPPSource(std::ofstream& file, const MediaItem::Take& take, int indent = 3);
-    std::string IndentString(int level) const;
+    void WriteRPPHeader(RPPWriter& writer);
+    void WriteRPPTrack(RPPWriter& writer, const ProjectTrack& track, int trackIndex);
+    void WriteRPPEnvelope(RPPWriter& writer, const ProjectTrack::Envelope& envelope);
+    void WriteRPPItem(RPPWriter& writer, const MediaItem& item);
+    void WriteRPPSource(RPPWriter& writer, const MediaItem::Take& take);
+    
+    // Binary snapshots - the writers only read their arguments, so they run off-thread
+    bool ParseBinaryFile(const std::string& filePath);
+    static bool ReadBinaryFile(const std::string& filePath, ProjectInfo& info, std::vector<ProjectTrack>& tracks,
+                               uint64_t* generation = nullptr);
+    static bool WriteBinaryFile(const std::string& filePath, const ProjectInfo& info,
+                                const std::vector<ProjectTrack>& tracks, uint64_t* bytesWritten = nullptr,
+                                uint64_t generation = 0);
+    
+    // Field encoders shared by snapshot chunks and log records
+    template <typename Writer> static void WriteBinaryInfo(Writer& writer, const ProjectInfo& info);
+    template <typename Writer> static void WriteBinaryTrackProperties(Writer& writer, const ProjectTrack& track);
+    template <typename Writer> static void WriteBinaryEnvelope(Writer& writer, const ProjectTrack::Envelope& envelope);
+    template <typename Writer> static void WriteBinaryItem(Writer& writer, const MediaItem& item);
+    static void WriteBinaryTrack(BinaryChunkWriter& writer, const ProjectTrack& track);
+    static bool ParseBinaryInfo(BinaryCursor& cursor, ProjectInfo& info);
+    static bool ParseBinaryTrackProperties(BinaryCursor& cursor, ProjectTrack& track);
+    static bool ParseBinaryEnvelope(BinaryCursor& cursor, ProjectTrack::Envelope& envelope);
+    static bool ParseBinaryItem(BinaryCursor& cursor, MediaItem& item);
+    static bool ParseBinaryTrack(BinaryCursor& cursor, ProjectTrack& track);
+    
+    // Write-ahead log
+    bool HasDirtyChanges() const;
+    std::shared_ptr<const LogBatch> CaptureLogBatch();
+    static bool AppendLogBatch(const std::string& logPath, const LogBatch& batch, uint64_t* bytesWritten);
+    static bool ResetLog(const std::string& logPath, uint64_t generation);
+    static bool ReplayLog(const std::string& logPath, uint64_t generation, ProjectInfo& info,
+                          std::vector<ProjectTrack>& tracks);
+    static bool ApplyLogRecord(uint32_t type, BinaryCursor& cursor, ProjectInfo& info,
+                               std::vector<ProjectTrack>& tracks, std::vector<MediaItem>& detached);
+    
+    void QueueWrite(PendingWrite write);
+    void WriterThreadMain();
+    void StopWriterThread();
     
     // GUID generation for items and tracks
     std::string GenerateGUID() const;
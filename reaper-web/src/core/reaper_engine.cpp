@@ -7,26 +7,46 @@
 #include "audio_engine.hpp"
 #include "project_manager.hpp"
 #include "track_manager.hpp"
+#include "undo_manager.hpp"
 #include "../media/media_item.hpp"
+#include "../recording/track_recorder.hpp"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <sstream>
 #include <iomanip>
 
 // Global engine instance
 ReaperEngine* g_reaperEngine = nullptr;
 
+namespace {
+
+// Project-level state that undo points carry alongside tracks and items
+ProjectSnapshot::MasterState CaptureMasterState(const ReaperEngine::TransportState& transport,
+                                                const ReaperEngine::RealtimeSettings& realtime,
+                                                std::shared_ptr<const TempoMap> tempoMap) {
+    ProjectSnapshot::MasterState master;
+    master.volume = realtime.masterVolume.load();
+    master.pan = realtime.masterPan.load();
+    master.mute = realtime.masterMute.load();
+    master.tempo = transport.tempo.load();
+    master.timeSigNumerator = transport.timeSigNumerator.load();
+    master.timeSigDenominator = transport.timeSigDenominator.load();
+    master.tempoMap = std::move(tempoMap);
+    return master;
+}
+
+} // namespace
+
 ReaperEngine::ReaperEngine() {
     // Initialize subsystems in dependency order
     m_audioEngine = std::make_unique<AudioEngine>();
     m_projectManager = std::make_unique<ProjectManager>();
     m_trackManager = std::make_unique<TrackManager>();
     m_mediaItemManager = std::make_unique<MediaItemManager>();
-    
-    // Reserve undo stack capacity
-    m_undoStack.reserve(m_globalSettings.undoLevels);
-    m_redoStack.reserve(m_globalSettings.undoLevels);
+    m_undoManager = std::make_unique<UndoManager>();
 }
 
 ReaperEngine::~ReaperEngine() {
@@ -54,6 +74,7 @@ bool ReaperEngine::Initialize(const GlobalSettings& settings) {
     if (!m_projectManager->Initialize()) {
         return false;
     }
+    m_projectManager->EnableAutoSave(settings.autoSave, settings.autoSaveInterval);
     
     // Initialize track manager
     if (!m_trackManager->Initialize(m_audioEngine.get())) {
@@ -63,14 +84,25 @@ bool ReaperEngine::Initialize(const GlobalSettings& settings) {
     // Set up transport state defaults
     m_transportState.playState = PlayState::STOPPED;
     m_transportState.playPosition = 0.0;
-    m_transportState.tempo = 120.0;
-    m_transportState.timeSigNumerator = 4;
-    m_transportState.timeSigDenominator = 4;
+    m_transportState.playPositionSamples = 0;
+    PublishTempoMap(std::make_shared<const TempoMap>());
     
     // Set up realtime settings
     m_realtimeSettings.masterVolume = 1.0;
     m_realtimeSettings.masterPan = 0.0;
     m_realtimeSettings.monitoring = true;
+    SetClickVolume(m_realtimeSettings.clickVolume.load());
+    m_inputScratch.resize(settings.maxChannels);
+    m_outputScratch.resize(settings.maxChannels);
+    UpdateDeviceConversion();
+    
+    // Undo history starts from the empty project
+    if (!m_undoManager->Initialize(m_trackManager.get(), m_mediaItemManager.get())) {
+        return false;
+    }
+    m_undoManager->SetMaxLevels(settings.undoLevels);
+    m_undoManager->SetMemoryBudget(settings.undoMemoryBudget);
+    ClearUndoHistory();
     
     // Set global instance
     g_reaperEngine = this;
@@ -111,17 +143,18 @@ bool ReaperEngine::NewProject() {
         return false;
     }
     
-    BeginUndoBlock("New Project");
-    
     // Reset transport
     Stop();
     m_transportState.playPosition = 0.0;
+    m_transportState.playPositionSamples = 0;
     m_transportState.loopStart = 0.0;
     m_transportState.loopEnd = 60.0;
     
-    // Clear tracks and reset project state
+    // Clear items and tracks (items first - they point at their tracks) and reset project state
+    m_mediaItemManager->DeleteAllItems();
     m_trackManager->ClearAllTracks();
     m_projectManager->NewProject();
+    LoadTempoFromProject();
     
     // Reset master controls
     m_realtimeSettings.masterVolume = 1.0;
@@ -131,7 +164,8 @@ bool ReaperEngine::NewProject() {
     m_currentProjectPath.clear();
     m_projectDirty = false;
     
-    EndUndoBlock();
+    // A new project starts a new history
+    ClearUndoHistory();
     return true;
 }
 
@@ -143,6 +177,7 @@ bool ReaperEngine::LoadProject(const std::string& filePath) {
     if (!m_projectManager->LoadProject(filePath)) {
         return false;
     }
+    LoadTempoFromProject();
     
     m_currentProjectPath = filePath;
     m_projectDirty = false;
@@ -181,13 +216,27 @@ void ReaperEngine::Play() {
         // Start from current position
     }
     
+    // Size item render buffers, resamplers and track lists before the audio thread needs them
+    m_mediaItemManager->PrepareForPlayback(m_globalSettings.sampleRate, m_globalSettings.bufferSize);
+    m_audioEngine->PrepareForTracks(m_trackManager->GetTrackCount());
+    m_mediaItemManager->Prefetch(m_transportState.playPosition.load());
+    if (m_transportState.loop) {
+        UpdateLoopStartBlocks();
+        PrefetchLoopStart();
+    }
     m_audioEngine->StartPlayback();
 }
 
 void ReaperEngine::Stop() {
+    bool wasRecording = m_transportState.playState == PlayState::RECORDING;
     m_transportState.playState = PlayState::STOPPED;
     m_audioEngine->StopPlayback();
     
+    if (wasRecording) {
+        m_audioEngine->StopRecording();
+        FinishRecordingItems();
+    }
+    
     // Reset to beginning if not looping or if we hit the end
     if (!m_transportState.loop) {
         // Option: return to start or stay at current position
@@ -203,10 +252,160 @@ void ReaperEngine::Pause() {
 }
 
 void ReaperEngine::Record() {
+    if (m_transportState.playState == PlayState::RECORDING) return;
+    
+    // Files and items exist before the audio thread captures a single block
+    StartRecordingItems();
+    m_mediaItemManager->PrepareForPlayback(m_globalSettings.sampleRate, m_globalSettings.bufferSize);
+    m_audioEngine->PrepareForTracks(m_trackManager->GetTrackCount());
+    m_mediaItemManager->Prefetch(m_transportState.playPosition.load());
+    if (m_transportState.loop) {
+        UpdateLoopStartBlocks();
+        PrefetchLoopStart();
+    }
+    
+    // Count-in holds the transport at the record position until its bars have clicked
+    if (m_realtimeSettings.countIn) {
+        m_audioEngine->StartCountIn(m_transportState.playPosition.load(), m_realtimeSettings.countInBars.load());
+    }
+    
+    m_transportState.recordPosition = m_transportState.playPosition.load();
     m_transportState.playState = PlayState::RECORDING;
     m_audioEngine->StartRecording();
 }
 
+void ReaperEngine::UpdateRecording() {
+    RecordingEngine* recording = m_trackManager->GetRecordingEngine();
+    if (!recording || !recording->IsRecording()) return;
+    
+    recording->Service();
+    
+    // Each new segment (first capture, punch-in, loop wrap) is a take on the
+    // item recorded from the same position, or starts a new item there
+    const double sampleRate = m_globalSettings.sampleRate;
+    std::vector<RecordingEngine::Segment> segments = recording->GetSegments();
+    for (; m_recordedSegments < segments.size(); ++m_recordedSegments) {
+        const RecordingEngine::Segment& segment = segments[m_recordedSegments];
+        for (const auto& recorder : recording->GetRecorders()) {
+            auto entry = std::find_if(m_recordingItems.begin(), m_recordingItems.end(),
+                                      [&](const RecordingItem& existing) {
+                                          return existing.recorder == recorder.get() &&
+                                                 existing.projectStart == segment.projectStart;
+                                      });
+            
+            MediaItem* item = nullptr;
+            if (entry != m_recordingItems.end()) {
+                item = m_mediaItemManager->FindItemByGUID(entry->itemGuid);
+                if (!item) continue;    // Removed while recording
+            } else {
+                item = m_mediaItemManager->CreateEmptyItem(recorder->GetTrack(), SamplesToSeconds(segment.projectStart), 0.0);
+                if (!item) continue;
+                item->SetName(std::filesystem::path(recorder->GetFilePath()).stem().string());
+                m_recordingItems.push_back({item->GetGUID(), recorder.get(), segment.projectStart, segment.fileFrame});
+            }
+            
+            // Every pass plays from its own offset into the one growing file
+            int take = item->AddTake(recorder->GetSource(), segment.fileFrame / sampleRate);
+            item->SetActiveTake(take);
+        }
+    }
+    
+    // Items are as long as their first pass, or what has been recorded of it
+    for (const RecordingItem& entry : m_recordingItems) {
+        MediaItem* item = m_mediaItemManager->FindItemByGUID(entry.itemGuid);
+        int64_t end = GetRecordingItemEnd(entry, segments);
+        if (item && end > entry.firstFileFrame) {
+            item->SetLength((end - entry.firstFileFrame) / sampleRate);
+        }
+    }
+}
+
+int64_t ReaperEngine::GetRecordingItemEnd(const RecordingItem& entry,
+                                          const std::vector<RecordingEngine::Segment>& segments) const {
+    int64_t end = entry.recorder->GetRecordedFrames();
+    for (const RecordingEngine::Segment& segment : segments) {
+        if (segment.fileFrame > entry.firstFileFrame) {
+            return std::min(end, segment.fileFrame);
+        }
+    }
+    return end;
+}
+
+bool ReaperEngine::StartRecordingItems() {
+    m_recordingItems.clear();
+    m_recordedSegments = 0;
+    
+    // The punch range must be in place before the first block is captured
+    ApplyPunchRange();
+    return m_trackManager->StartRecording(GetRecordDirectory(), m_globalSettings.sampleRate,
+                                          m_globalSettings.recordFormat, m_globalSettings.recordDither);
+}
+
+void ReaperEngine::FinishRecordingItems() {
+    RecordingEngine* recording = m_trackManager->GetRecordingEngine();
+    if (!recording || !recording->IsRecording()) return;
+    
+    UpdateRecording();
+    std::vector<RecordingEngine::Segment> segments = recording->GetSegments();
+    m_trackManager->StopRecording();
+    
+    const double sampleRate = m_globalSettings.sampleRate;
+    for (const RecordingItem& entry : m_recordingItems) {
+        MediaItem* item = m_mediaItemManager->FindItemByGUID(entry.itemGuid);
+        if (!item) continue;
+        
+        int64_t end = GetRecordingItemEnd(entry, segments);
+        if (end <= entry.firstFileFrame) {
+            m_mediaItemManager->DeleteItem(item);
+            continue;
+        }
+        item->SetLength((end - entry.firstFileFrame) / sampleRate);
+        
+        // A loop pass cut short by Stop is dropped when a complete one exists
+        const RecordingEngine::Segment& last = segments.back();
+        int64_t lastFrames = entry.recorder->GetRecordedFrames() - last.fileFrame;
+        if (last.projectStart == entry.projectStart && item->GetTakeCount() > 1 &&
+            lastFrames < end - entry.firstFileFrame) {
+            item->RemoveTake(item->GetTakeCount() - 1);
+            item->SetActiveTake(item->GetTakeCount() - 1);
+        }
+        
+        // Takes move from the growing source to the finished file
+        std::shared_ptr<AudioSource> source = AudioSource::GetShared(entry.recorder->GetFilePath());
+        for (int i = 0; i < item->GetTakeCount(); ++i) {
+            item->GetTake(i)->source = source;
+        }
+        item->MarkChanged();
+    }
+    m_recordingItems.clear();
+    
+    AddUndoPoint("Recorded media");
+    SetProjectDirty();
+}
+
+void ReaperEngine::ApplyPunchRange() {
+    RecordingEngine* recording = m_trackManager->GetRecordingEngine();
+    if (!recording) return;
+    
+    double punchIn = m_transportState.punchIn.load();
+    double punchOut = m_transportState.punchOut.load();
+    if (m_transportState.autoPunch && punchOut > punchIn) {
+        recording->SetPunchRange(SecondsToSamples(punchIn), SecondsToSamples(punchOut));
+    } else {
+        recording->ClearPunchRange();
+    }
+}
+
+std::string ReaperEngine::GetRecordDirectory() const {
+    if (!m_globalSettings.recordPath.empty()) {
+        return m_globalSettings.recordPath;
+    }
+    
+    // Beside the project, as REAPER does with no recording path set
+    std::filesystem::path projectDir = std::filesystem::path(m_currentProjectPath).parent_path();
+    return projectDir.empty() ? std::string(".") : projectDir.string();
+}
+
 void ReaperEngine::TogglePlayPause() {
     switch (m_transportState.playState.load()) {
         case PlayState::STOPPED:
@@ -221,21 +420,76 @@ void ReaperEngine::TogglePlayPause() {
 }
 
 void ReaperEngine::SetPlayPosition(double seconds) {
-    m_transportState.playPosition = std::max(0.0, seconds);
-    m_audioEngine->SetPlayPosition(seconds);
+    int64_t samples = SecondsToSamples(std::max(0.0, seconds));
+    m_transportState.playPositionSamples = samples;
+    m_transportState.playPosition = SamplesToSeconds(samples);
+    m_audioEngine->SetPlayPosition(m_transportState.playPosition.load());
 }
 
 void ReaperEngine::SetLoopPoints(double start, double end) {
     if (start < end) {
         m_transportState.loopStart = start;
         m_transportState.loopEnd = end;
+        
+        // Dragging the loop must not block the UI on decoding
+        if (m_transportState.loop) {
+            UpdateLoopStartBlocks();
+            RequestLoopStart();
+        }
+    }
+}
+
+void ReaperEngine::SetLoop(bool enabled) {
+    m_transportState.loop = enabled;
+    UpdateLoopStartBlocks();
+    if (enabled) {
+        RequestLoopStart();
+    }
+}
+
+void ReaperEngine::SetPunchRange(double start, double end) {
+    if (start < end) {
+        m_transportState.punchIn = std::max(0.0, start);
+        m_transportState.punchOut = end;
+        ApplyPunchRange();
+    }
+}
+
+void ReaperEngine::SetAutoPunch(bool enabled) {
+    m_transportState.autoPunch = enabled;
+    ApplyPunchRange();
+}
+
+void ReaperEngine::PrefetchLoopStart() {
+    if (!m_globalSettings.enablePreRoll) return;
+    
+    m_mediaItemManager->PrefetchRange(m_transportState.loopStart.load(), m_transportState.loopEnd.load());
+}
+
+void ReaperEngine::UpdateLoopStartBlocks() {
+    // The item walk happens here so the audio thread never touches the item list for it
+    std::shared_ptr<std::vector<AudioBlockCache::BlockRef>> blocks;
+    if (m_globalSettings.enablePreRoll && m_transportState.loop) {
+        blocks = std::make_shared<std::vector<AudioBlockCache::BlockRef>>();
+        m_mediaItemManager->GetRangeBlocks(m_transportState.loopStart.load(), m_transportState.loopEnd.load(),
+                                           *blocks);
+    }
+    std::atomic_store(&m_loopStartBlocks, std::shared_ptr<const std::vector<AudioBlockCache::BlockRef>>(blocks));
+}
+
+void ReaperEngine::RequestLoopStart() {
+    // Blocks of sources deleted since the last update are skipped by the decoder thread
+    std::shared_ptr<const std::vector<AudioBlockCache::BlockRef>> blocks = std::atomic_load(&m_loopStartBlocks);
+    if (blocks) {
+        AudioBlockCache::GetInstance().RequestBlocks(*blocks);
     }
 }
 
 void ReaperEngine::SetTempo(double bpm) {
     if (bpm >= 20.0 && bpm <= 999.0) {
-        m_transportState.tempo = bpm;
-        SetProjectDirty();
+        std::vector<TempoMarker> markers = GetTempoMap()->GetMarkers();
+        markers.front().bpm = bpm;
+        SetTempoMap(TempoMap(markers));
     }
 }
 
@@ -243,20 +497,33 @@ void ReaperEngine::SetTimeSignature(int numerator, int denominator) {
     if (numerator >= 1 && numerator <= 32 && 
         (denominator == 1 || denominator == 2 || denominator == 4 || 
          denominator == 8 || denominator == 16 || denominator == 32)) {
-        m_transportState.timeSigNumerator = numerator;
-        m_transportState.timeSigDenominator = denominator;
-        SetProjectDirty();
+        std::vector<TempoMarker> markers = GetTempoMap()->GetMarkers();
+        markers.front().timeSigNumerator = numerator;
+        markers.front().timeSigDenominator = denominator;
+        SetTempoMap(TempoMap(markers));
     }
 }
 
+void ReaperEngine::SetTempoMap(const TempoMap& tempoMap) {
+    PublishTempoMap(std::make_shared<const TempoMap>(tempoMap));
+    StoreTempoInProject();
+    SetProjectDirty();
+}
+
 double ReaperEngine::BeatsToSeconds(double beats) const {
-    double bpm = m_transportState.tempo.load();
-    return beats * (60.0 / bpm);
+    return GetTempoMap()->BeatsToTime(beats);
 }
 
 double ReaperEngine::SecondsToBeats(double seconds) const {
-    double bpm = m_transportState.tempo.load();
-    return seconds * (bpm / 60.0);
+    return GetTempoMap()->TimeToBeats(seconds);
+}
+
+int64_t ReaperEngine::SecondsToSamples(double seconds) const {
+    return std::llround(seconds * m_globalSettings.sampleRate);
+}
+
+double ReaperEngine::SamplesToSeconds(int64_t samples) const {
+    return static_cast<double>(samples) / m_globalSettings.sampleRate;
 }
 
 std::string ReaperEngine::FormatTime(double seconds, TimeFormat format) const {
@@ -272,10 +539,10 @@ std::string ReaperEngine::FormatTime(double seconds, TimeFormat format) const {
             break;
             
         case TimeFormat::MEASURES_BEATS: {
-            double beats = SecondsToBeats(seconds);
-            int measure = static_cast<int>(beats / m_transportState.timeSigNumerator) + 1;
-            double beat = fmod(beats, m_transportState.timeSigNumerator) + 1.0;
-            ss << measure << ":" << std::fixed << std::setprecision(3) << beat;
+            int measure = 0;
+            double beat = 0.0;
+            GetTempoMap()->BeatsToMeasure(SecondsToBeats(seconds), measure, beat);
+            ss << (measure + 1) << ":" << std::fixed << std::setprecision(3) << (beat + 1.0);
             break;
         }
         
@@ -316,6 +583,19 @@ void ReaperEngine::ToggleMasterMute() {
 
 void ReaperEngine::SetMetronome(bool enabled) {
     m_realtimeSettings.metronomeEnabled = enabled;
+    m_transportState.metronomeEnabled = enabled;
+    m_audioEngine->GetMetronome().SetEnabled(enabled);
+}
+
+void ReaperEngine::SetClickVolume(int volume) {
+    volume = std::clamp(volume, 0, 100);
+    m_realtimeSettings.clickVolume = volume;
+    m_audioEngine->GetMetronome().SetVolume(volume / 100.0f);
+}
+
+void ReaperEngine::SetCountIn(bool enabled, int bars) {
+    m_realtimeSettings.countIn = enabled;
+    m_realtimeSettings.countInBars = std::clamp(bars, 1, 16);
 }
 
 void ReaperEngine::ProcessAudioBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
@@ -327,25 +607,173 @@ void ReaperEngine::ProcessAudioBlock(float** inputs, float** outputs, int numCha
         return;
     }
     
-    // Update playback position
-    if (m_transportState.playState == PlayState::PLAYING || 
-        m_transportState.playState == PlayState::RECORDING) {
-        double deltaTime = static_cast<double>(numSamples) / m_globalSettings.sampleRate;
-        double newPosition = m_transportState.playPosition.load() + deltaTime;
+    if (m_audioEngine->IsSampleRateConversionActive()) {
+        ProcessConvertedBlock(inputs, outputs, numChannels, numSamples);
+        return;
+    }
+    
+    ProcessEngineBlock(inputs, outputs, numChannels, numSamples);
+}
+
+void ReaperEngine::ProcessConvertedBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
+    // Device input converts to the project rate the way the output converts
+    // from it, and each render takes its own length of it off the queue
+    const int channels = m_deviceRender.GetChannelCount();
+    const double ratio = m_globalSettings.sampleRate / m_globalSettings.deviceSampleRate;
+    int produced = 0;
+    
+    if (inputs && numChannels > 0) {
+        QueueDeviceInput(inputs, numChannels, numSamples);
+    }
+    
+    while (produced < numSamples) {
+        if (m_deviceConvertedRead == m_deviceConvertedFill) {
+            // Render about as many project frames as the device still wants
+            const int frames = std::clamp(static_cast<int>(std::ceil((numSamples - produced) * ratio)), 1,
+                                          m_deviceRender.GetSampleCount());
+            float** renderInputs = nullptr;
+            if (inputs && numChannels > 0) {
+                // Input still inside the converter's filter reads as silence
+                for (int ch = 0; ch < channels; ++ch) {
+                    float* queued = m_deviceInput.GetChannelData(ch);
+                    if (m_deviceInputFill < frames) {
+                        std::fill(queued + m_deviceInputFill, queued + frames, 0.0f);
+                    }
+                    m_deviceInputPtrs[ch] = queued;
+                }
+                renderInputs = m_deviceInputPtrs.data();
+            }
+            
+            m_deviceRender.Clear();
+            ProcessEngineBlock(renderInputs, m_deviceRender.GetChannelPointers(), channels, frames);
+            if (renderInputs) {
+                DiscardDeviceInput(frames);
+            }
+            m_deviceConvertedFill = m_audioEngine->ConvertSampleRate(m_deviceRender.GetChannelPointers(), frames,
+                                                                     m_deviceConverted.GetChannelPointers(),
+                                                                     m_deviceConverted.GetSampleCount());
+            m_deviceConvertedRead = 0;
+            continue;
+        }
+        
+        const int count = std::min(numSamples - produced, m_deviceConvertedFill - m_deviceConvertedRead);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            if (ch < channels) {
+                const float* converted = m_deviceConverted.GetChannelData(ch) + m_deviceConvertedRead;
+                std::copy(converted, converted + count, outputs[ch] + produced);
+            } else {
+                std::fill(outputs[ch] + produced, outputs[ch] + produced + count, 0.0f);
+            }
+        }
+        m_deviceConvertedRead += count;
+        produced += count;
+    }
+}
+
+void ReaperEngine::QueueDeviceInput(float** inputs, int numChannels, int numSamples) {
+    const int channels = m_deviceInput.GetChannelCount();
+    const int capacity = m_deviceInput.GetSampleCount();
+    int taken = 0;
+    
+    while (taken < numSamples) {
+        // Renders have fallen behind the device: the oldest queued input goes
+        if (m_deviceInputFill == capacity) {
+            DiscardDeviceInput(capacity / 2);
+        }
         
-        // Handle looping
-        if (m_transportState.loop && newPosition >= m_transportState.loopEnd) {
-            newPosition = m_transportState.loopStart;
+        // A device with fewer inputs than the engine has channels repeats its last one
+        for (int ch = 0; ch < channels; ++ch) {
+            m_deviceInputSource[ch] = inputs[std::min(ch, numChannels - 1)] + taken;
+            m_deviceInputPtrs[ch] = m_deviceInput.GetChannelData(ch) + m_deviceInputFill;
         }
         
-        m_transportState.playPosition = newPosition;
+        int consumed = 0;
+        const int written = m_audioEngine->ConvertInputSampleRate(m_deviceInputSource.data(), numSamples - taken,
+                                                                  m_deviceInputPtrs.data(),
+                                                                  capacity - m_deviceInputFill, &consumed);
+        m_deviceInputFill += written;
+        taken += consumed;
+        
+        if (consumed == 0 && written == 0) break;
+    }
+}
+
+void ReaperEngine::DiscardDeviceInput(int frames) {
+    frames = std::min(frames, m_deviceInputFill);
+    const int remaining = m_deviceInputFill - frames;
+    for (int ch = 0; ch < m_deviceInput.GetChannelCount(); ++ch) {
+        float* queued = m_deviceInput.GetChannelData(ch);
+        std::memmove(queued, queued + frames, remaining * sizeof(float));
     }
+    m_deviceInputFill = remaining;
+}
+
+void ReaperEngine::ProcessEngineBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
+    // Render at the current sample position, then advance. Positions are kept
+    // as integer samples so consecutive blocks can never drift or overlap.
+    const bool playing = m_transportState.playState == PlayState::PLAYING ||
+                         m_transportState.playState == PlayState::RECORDING;
+    int64_t blockStart = m_transportState.playPositionSamples.load();
     
-    // Process audio through the engine with track and media item integration
-    double blockLength = static_cast<double>(numSamples) / m_globalSettings.sampleRate;
-    m_audioEngine->ProcessBlock(inputs, outputs, numChannels, numSamples, 
-                               m_mediaItemManager.get(), m_trackManager.get(), 
-                               m_transportState.playPosition.load(), blockLength);
+    // Count-in clicks hold the transport; the block it ends in plays from the
+    // exact sample it ended on
+    int offset = 0;
+    if (playing && m_audioEngine->IsCountingIn()) {
+        offset = m_audioEngine->ProcessCountIn(outputs, numChannels, numSamples);
+        if (offset == numSamples) {
+            return;
+        }
+    }
+    
+    // A block that crosses the loop end renders as two sub-blocks, the second
+    // from the loop start, so the wrap lands on the exact sample
+    int64_t position = blockStart;
+    const int playStart = offset;
+    while (offset < numSamples) {
+        int count = numSamples - offset;
+        int64_t loopStart = 0;
+        int64_t loopEnd = 0;
+        const bool looping = playing && m_transportState.loop;
+        if (looping) {
+            loopStart = SecondsToSamples(m_transportState.loopStart.load());
+            loopEnd = SecondsToSamples(m_transportState.loopEnd.load());
+            if (loopEnd > loopStart && position < loopEnd && position + count > loopEnd) {
+                count = static_cast<int>(loopEnd - position);
+            }
+        }
+        
+        position = RenderBlockAt(inputs, outputs, numChannels, offset, count, position, playing);
+        offset += count;
+        
+        if (looping && loopEnd > loopStart) {
+            // Only a block that reached the end wraps; playing on from beyond it continues
+            if (position == loopEnd) {
+                position = loopStart;
+                m_loopPrefetched = false;
+            } else if (!m_loopPrefetched &&
+                       position >= loopEnd - SecondsToSamples(m_globalSettings.preRollTime)) {
+                // Nearing the end: queue the loop start so the wrap reads resident audio
+                RequestLoopStart();
+                m_loopPrefetched = true;
+            }
+        }
+    }
+    
+    if (playing) {
+        // A seek from another thread during the block takes precedence
+        m_transportState.playPositionSamples.compare_exchange_strong(blockStart, position);
+        m_transportState.playPosition = SamplesToSeconds(m_transportState.playPositionSamples.load());
+    }
+    
+    // Count-in clicks are not part of the master mix
+    if (playStart > 0) {
+        numChannels = std::min(numChannels, static_cast<int>(m_outputScratch.size()));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            m_outputScratch[ch] = outputs[ch] + playStart;
+        }
+        outputs = m_outputScratch.data();
+        numSamples -= playStart;
+    }
     
     // Apply master volume and pan
     double masterVol = m_realtimeSettings.masterVolume.load();
@@ -364,93 +792,235 @@ void ReaperEngine::ProcessAudioBlock(float** inputs, float** outputs, int numCha
     }
 }
 
+int64_t ReaperEngine::RenderBlockAt(float** inputs, float** outputs, int numChannels, int offset, int numSamples,
+                                    int64_t position, bool playing) {
+    if (offset > 0) {
+        numChannels = std::min(numChannels, static_cast<int>(m_outputScratch.size()));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            m_inputScratch[ch] = inputs ? inputs[ch] + offset : nullptr;
+            m_outputScratch[ch] = outputs[ch] + offset;
+        }
+        inputs = inputs ? m_inputScratch.data() : nullptr;
+        outputs = m_outputScratch.data();
+    }
+    
+    m_audioEngine->ProcessBlock(inputs, outputs, numChannels, numSamples, 
+                               playing ? m_mediaItemManager.get() : nullptr, m_trackManager.get(), 
+                               position);
+    return playing ? position + numSamples : position;
+}
+
+void ReaperEngine::SetBufferSize(int samples) {
+    if (samples <= 0) {
+        return;
+    }
+    
+    m_globalSettings.bufferSize = samples;
+    m_audioEngine->SetBufferSize(samples);
+    m_mediaItemManager->PrepareForPlayback(m_globalSettings.sampleRate, samples);
+    UpdateDeviceConversion();
+}
+
+void ReaperEngine::SetSampleRate(double rate) {
+    if (rate <= 0.0) {
+        return;
+    }
+    
+    // The play cursor is kept in samples; hold it at the same time on the new grid
+    const double position = m_transportState.playPosition.load();
+    m_globalSettings.sampleRate = rate;
+    m_audioEngine->SetSampleRate(rate);
+    m_mediaItemManager->PrepareForPlayback(rate, m_globalSettings.bufferSize);
+    SetPlayPosition(position);
+    UpdateDeviceConversion();
+}
+
+// Not real-time safe; call with the device stopped
+void ReaperEngine::SetDeviceSampleRate(double rate) {
+    m_globalSettings.deviceSampleRate = std::max(rate, 0.0);
+    UpdateDeviceConversion();
+}
+
+void ReaperEngine::UpdateDeviceConversion() {
+    const double deviceRate = m_globalSettings.deviceSampleRate;
+    if (deviceRate <= 0.0 || deviceRate == m_globalSettings.sampleRate) {
+        m_audioEngine->SetupSampleRateConversion(0.0, 0.0);     // Blocks render straight to the device
+        return;
+    }
+    
+    // The converter takes up to one engine buffer per call
+    m_audioEngine->SetupSampleRateConversion(m_globalSettings.sampleRate, deviceRate);
+    const int channels = m_audioEngine->GetSettings().outputChannels;
+    const int bufferSize = m_globalSettings.bufferSize;
+    m_deviceRender.SetSize(channels, bufferSize);
+    m_deviceConverted.SetSize(channels,
+                              static_cast<int>(std::ceil(bufferSize * deviceRate / m_globalSettings.sampleRate)) + 2);
+    m_deviceConvertedRead = 0;
+    m_deviceConvertedFill = 0;
+    
+    // Room for several engine buffers of input between renders
+    m_deviceInput.SetSize(channels, bufferSize * 4);
+    m_deviceInputFill = 0;
+    m_deviceInputSource.assign(channels, nullptr);
+    m_deviceInputPtrs.assign(channels, nullptr);
+}
+
 void ReaperEngine::BeginUndoBlock(const std::string& description) {
     std::lock_guard<std::mutex> lock(m_undoMutex);
-    m_currentUndoBlock++;
-    SaveUndoState(description);
+    
+    // Nested blocks fold into the outermost one
+    if (m_undoBlockDepth++ == 0) {
+        m_undoBlockDescription = description;
+    }
 }
 
 void ReaperEngine::EndUndoBlock() {
-    // Undo block is implicitly ended
-    m_currentUndoBlock = -1;
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    
+    if (m_undoBlockDepth == 0) {
+        return;
+    }
+    
+    // The undo point records the project as the outermost block leaves it
+    if (--m_undoBlockDepth == 0) {
+        SaveUndoState(m_undoBlockDescription);
+    }
+}
+
+void ReaperEngine::AddUndoPoint(const std::string& description, const std::string& mergeKey) {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    
+    // Inside a block the edit becomes part of the block's undo point
+    if (m_undoBlockDepth == 0) {
+        SaveUndoState(description, mergeKey);
+    }
 }
 
 bool ReaperEngine::Undo() {
     std::lock_guard<std::mutex> lock(m_undoMutex);
     
-    if (m_undoStack.empty()) {
+    const ProjectSnapshot* snapshot = m_undoManager->Undo();
+    if (!snapshot) {
         return false;
     }
     
-    UndoState state = m_undoStack.back();
-    m_undoStack.pop_back();
-    
-    // Save current state to redo stack
-    UndoState currentState;
-    currentState.description = "Redo " + state.description;
-    currentState.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count();
-    // TODO: Serialize current state
-    m_redoStack.push_back(currentState);
-    
-    // Restore state
-    RestoreUndoState(state);
-    
+    RestoreUndoState(*snapshot);
     return true;
 }
 
 bool ReaperEngine::Redo() {
     std::lock_guard<std::mutex> lock(m_undoMutex);
     
-    if (m_redoStack.empty()) {
+    const ProjectSnapshot* snapshot = m_undoManager->Redo();
+    if (!snapshot) {
         return false;
     }
     
-    UndoState state = m_redoStack.back();
-    m_redoStack.pop_back();
-    
-    // Save current state to undo stack
-    SaveUndoState("Undo " + state.description);
-    
-    // Restore state
-    RestoreUndoState(state);
-    
+    RestoreUndoState(*snapshot);
     return true;
 }
 
+bool ReaperEngine::CanUndo() const {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    return m_undoManager->CanUndo();
+}
+
+bool ReaperEngine::CanRedo() const {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    return m_undoManager->CanRedo();
+}
+
+std::string ReaperEngine::GetUndoDescription() const {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    return m_undoManager->GetUndoDescription();
+}
+
+std::string ReaperEngine::GetRedoDescription() const {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    return m_undoManager->GetRedoDescription();
+}
+
 void ReaperEngine::ClearUndoHistory() {
     std::lock_guard<std::mutex> lock(m_undoMutex);
-    m_undoStack.clear();
-    m_redoStack.clear();
+    
+    // The live project becomes the baseline
+    m_undoManager->Reset(CaptureMasterState(m_transportState, m_realtimeSettings, GetTempoMap()));
+}
+
+size_t ReaperEngine::GetUndoMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_undoMutex);
+    return m_undoManager->GetMemoryUsage().totalBytes;
 }
 
 bool ReaperEngine::IsRealtimeThread() const {
     return std::this_thread::get_id() == m_realtimeThreadId;
 }
 
-void ReaperEngine::SaveUndoState(const std::string& description) {
-    UndoState state;
-    state.description = description;
-    state.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count();
-    
-    // TODO: Serialize project state to state.data
+void ReaperEngine::SaveUndoState(const std::string& description, const std::string& mergeKey) {
+    // Called with m_undoMutex held
+    m_undoManager->Commit(description, CaptureMasterState(m_transportState, m_realtimeSettings, GetTempoMap()), mergeKey);
     
-    m_undoStack.push_back(state);
+    // Every edit ends in an undo point, so items moved onto the loop start are picked up here
+    if (m_transportState.loop) {
+        UpdateLoopStartBlocks();
+    }
+}
+
+void ReaperEngine::RestoreUndoState(const ProjectSnapshot& snapshot) {
+    // Tracks and items are already restored; master and tempo live here
+    m_realtimeSettings.masterVolume = snapshot.master.volume;
+    m_realtimeSettings.masterPan = snapshot.master.pan;
+    m_realtimeSettings.masterMute = snapshot.master.mute;
+    PublishTempoMap(snapshot.master.tempoMap ? snapshot.master.tempoMap
+                                             : std::make_shared<const TempoMap>(snapshot.master.tempo,
+                                                                               snapshot.master.timeSigNumerator,
+                                                                               snapshot.master.timeSigDenominator));
+    StoreTempoInProject();
     
-    // Limit undo stack size
-    if (m_undoStack.size() > static_cast<size_t>(m_globalSettings.undoLevels)) {
-        m_undoStack.erase(m_undoStack.begin());
+    if (m_transportState.loop) {
+        UpdateLoopStartBlocks();
     }
     
-    // Clear redo stack when new action is performed
-    m_redoStack.clear();
+    SetProjectDirty();
 }
 
-void ReaperEngine::RestoreUndoState(const UndoState& state) {
-    // TODO: Deserialize and restore project state from state.data
+void ReaperEngine::PublishTempoMap(std::shared_ptr<const TempoMap> tempoMap) {
+    // The transport reports the first marker as the project tempo
+    const TempoMarker& first = tempoMap->GetMarkers().front();
+    m_transportState.tempo = first.bpm;
+    m_transportState.timeSigNumerator = first.timeSigNumerator;
+    m_transportState.timeSigDenominator = first.timeSigDenominator;
+    
+    std::atomic_store(&m_tempoMap, tempoMap);
+    m_audioEngine->SetTempoMap(std::move(tempoMap));
+}
+
+void ReaperEngine::LoadTempoFromProject() {
+    const auto& info = m_projectManager->GetProjectInfo();
+    if (info.tempoMarkers.empty()) {
+        PublishTempoMap(std::make_shared<const TempoMap>(info.tempo, info.timeSigNumerator, info.timeSigDenominator));
+    } else {
+        PublishTempoMap(std::make_shared<const TempoMap>(info.tempoMarkers));
+    }
+}
+
+void ReaperEngine::StoreTempoInProject() {
+    std::shared_ptr<const TempoMap> tempoMap = GetTempoMap();
+    const std::vector<TempoMarker>& markers = tempoMap->GetMarkers();
+    
+    ProjectManager::ProjectInfo info = m_projectManager->GetProjectInfo();
+    info.tempo = markers.front().bpm;
+    info.timeSigNumerator = markers.front().timeSigNumerator;
+    info.timeSigDenominator = markers.front().timeSigDenominator;
+    if (markers.size() > 1 || markers.front().ramp) {
+        info.tempoMarkers = markers;
+    } else {
+        info.tempoMarkers.clear();
+    }
+    m_projectManager->SetProjectInfo(info);
 }
 
 void ReaperEngine::SetProjectDirty(bool dirty) {
     m_projectDirty = dirty;
+    m_projectManager->SetUnsavedChanges(dirty);
 }
\ No newline at end of file
@@ -8,11 +8,16 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include "audio_buffer.hpp"
+#include "tempo_map.hpp"
+#include "../media/audio_block_cache.hpp"
+#include "../recording/track_recorder.hpp"
 
 // Forward declarations
 class AudioEngine;
@@ -20,6 +25,8 @@ class ProjectManager;
 class TrackManager;
 class MediaItemManager;
 class EffectsProcessor;
+class UndoManager;
+struct ProjectSnapshot;
 
 /**
  * Main REAPER-style DAW Engine
@@ -45,23 +52,32 @@ public:
 
     struct GlobalSettings {
         double sampleRate = 48000.0;
+        double deviceSampleRate = 0.0;  // Rate of the device blocks when it differs; 0 = sampleRate
         int bufferSize = 512;
         int maxChannels = 64;
         bool enablePDC = true;          // Plugin Delay Compensation
         bool enablePreRoll = true;
         double preRollTime = 2.0;       // seconds
         int undoLevels = 1000;
+        size_t undoMemoryBudget = 32 * 1024 * 1024;    // Older undo points are delta-compressed beyond this
         bool autoSave = true;
         int autoSaveInterval = 300;     // seconds
+        std::string recordPath;         // Recorded media folder; empty records beside the project
+        AudioFileWriter::SampleFormat recordFormat = AudioFileWriter::SampleFormat::PCM_24;
+        bool recordDither = false;      // TPDF dither for 16/24-bit recordings
     };
 
     struct TransportState {
         std::atomic<PlayState> playState{PlayState::STOPPED};
-        std::atomic<double> playPosition{0.0};      // in seconds
+        std::atomic<double> playPosition{0.0};      // in seconds (derived from playPositionSamples)
+        std::atomic<int64_t> playPositionSamples{0}; // Authoritative position on the sample timeline
         std::atomic<double> recordPosition{0.0};
         std::atomic<bool> loop{false};
         std::atomic<double> loopStart{0.0};
         std::atomic<double> loopEnd{60.0};
+        std::atomic<bool> autoPunch{false};         // Record only inside [punchIn, punchOut)
+        std::atomic<double> punchIn{0.0};
+        std::atomic<double> punchOut{0.0};
         std::atomic<bool> metronomeEnabled{false};
         std::atomic<double> tempo{120.0};
         std::atomic<int> timeSigNumerator{4};
@@ -108,12 +124,20 @@ public:
     void GoToEnd();
     void SetPlayPosition(double seconds);
     void SetLoopPoints(double start, double end);
+    void SetLoop(bool enabled);
+    void SetPunchRange(double start, double end);
+    void SetAutoPunch(bool enabled);
+    void UpdateRecording();             // UI timer: grows the items being recorded
     
     // Time and tempo
-    void SetTempo(double bpm);
-    void SetTimeSignature(int numerator, int denominator);
+    void SetTempo(double bpm);                              // Tempo of the first marker
+    void SetTimeSignature(int numerator, int denominator);  // Time signature of the first marker
+    void SetTempoMap(const TempoMap& tempoMap);
+    std::shared_ptr<const TempoMap> GetTempoMap() const { return std::atomic_load(&m_tempoMap); }
     double BeatsToSeconds(double beats) const;
     double SecondsToBeats(double seconds) const;
+    int64_t SecondsToSamples(double seconds) const;
+    double SamplesToSeconds(int64_t samples) const;
     std::string FormatTime(double seconds, TimeFormat format) const;
 
     // Master controls
@@ -121,24 +145,37 @@ public:
     void SetMasterPan(double pan);
     void ToggleMasterMute();
     void SetMetronome(bool enabled);
+    void SetClickVolume(int volume);                // 0-100
+    void SetCountIn(bool enabled, int bars = 1);    // Before recording
 
     // Audio processing coordination
     void ProcessAudioBlock(float** inputs, float** outputs, int numChannels, int numSamples);
     void SetBufferSize(int samples);
     void SetSampleRate(double rate);
+    void SetDeviceSampleRate(double rate);  // Blocks at another rate are converted from the project rate
 
-    // Undo/Redo system - REAPER-style unlimited undo
+    // Undo/Redo system - REAPER-style unlimited undo. Every undo point is
+    // an immutable project snapshot sharing unchanged tracks and items.
+    // Blocks nest; only the outermost EndUndoBlock adds the undo point.
     void BeginUndoBlock(const std::string& description);
     void EndUndoBlock();
+    void AddUndoPoint(const std::string& description,       // Edit made outside a block; repeated
+                      const std::string& mergeKey = "");    // edits with one key merge (fader drags)
     bool Undo();
     bool Redo();
+    bool CanUndo() const;
+    bool CanRedo() const;
+    std::string GetUndoDescription() const;
+    std::string GetRedoDescription() const;
     void ClearUndoHistory();
+    size_t GetUndoMemoryUsage() const;  // Bytes held by the undo history
     
     // Subsystem access
     AudioEngine* GetAudioEngine() const { return m_audioEngine.get(); }
     ProjectManager* GetProjectManager() const { return m_projectManager.get(); }
     TrackManager* GetTrackManager() const { return m_trackManager.get(); }
     MediaItemManager* GetMediaItemManager() const { return m_mediaItemManager.get(); }
+    UndoManager* GetUndoManager() const { return m_undoManager.get(); }
     
     // State access
     const TransportState& GetTransportState() const { return m_transportState; }
@@ -160,6 +197,7 @@ private:
     std::unique_ptr<ProjectManager> m_projectManager;
     std::unique_ptr<TrackManager> m_trackManager;
     std::unique_ptr<MediaItemManager> m_mediaItemManager;
+    std::unique_ptr<UndoManager> m_undoManager;
     
     // State
     GlobalSettings m_globalSettings;
@@ -170,15 +208,17 @@ private:
     std::atomic<bool> m_projectDirty{false};
     std::string m_currentProjectPath;
     
+    // Tempo - replaced whole on every edit (std::atomic_load/atomic_store)
+    std::shared_ptr<const TempoMap> m_tempoMap;
+    
+    // Cache blocks under the loop start, collected off the audio thread when
+    // the loop or the project changes; the audio thread only queues them
+    // (std::atomic_load/atomic_store)
+    std::shared_ptr<const std::vector<AudioBlockCache::BlockRef>> m_loopStartBlocks;
+    
     // Undo system
-    struct UndoState {
-        std::string description;
-        std::vector<uint8_t> data;
-        double timestamp;
-    };
-    std::vector<UndoState> m_undoStack;
-    std::vector<UndoState> m_redoStack;
-    int m_currentUndoBlock = -1;
+    std::string m_undoBlockDescription;
+    int m_undoBlockDepth = 0;
     mutable std::mutex m_undoMutex;
     
     // Performance monitoring
@@ -190,11 +230,58 @@ private:
     std::thread::id m_realtimeThreadId;
     std::atomic<bool> m_initialized{false};
     
+    // Channel pointers offset into the device buffers when a block is split
+    std::vector<float*> m_inputScratch;
+    std::vector<float*> m_outputScratch;
+    bool m_loopPrefetched = false;      // Loop start requested this pass (audio thread)
+    
+    // Device rate conversion: project-rate blocks render here, and their
+    // converted frames wait until the device has taken them. Device input
+    // queues at the project rate until a render takes it (audio thread).
+    AudioBuffer m_deviceRender;
+    AudioBuffer m_deviceConverted;
+    int m_deviceConvertedRead = 0;
+    int m_deviceConvertedFill = 0;
+    AudioBuffer m_deviceInput;
+    int m_deviceInputFill = 0;
+    std::vector<const float*> m_deviceInputSource;
+    std::vector<float*> m_deviceInputPtrs;
+    
+    // Items growing under the current recording: one per armed track and
+    // pass start, each loop pass over the same range adding a take
+    struct RecordingItem {
+        std::string itemGuid;           // Looked up each time; undo may have removed it
+        const TrackRecorder* recorder = nullptr;
+        int64_t projectStart = 0;       // Project sample the item's passes start at
+        int64_t firstFileFrame = 0;     // File frame of its first pass
+    };
+    std::vector<RecordingItem> m_recordingItems;
+    size_t m_recordedSegments = 0;      // Recording segments already given an item or take
+    
     // Internal methods
     void UpdatePerformanceMetrics();
-    void SaveUndoState(const std::string& description);
-    void RestoreUndoState(const UndoState& state);
+    void SaveUndoState(const std::string& description, const std::string& mergeKey = "");
+    void RestoreUndoState(const ProjectSnapshot& snapshot);
+    void PublishTempoMap(std::shared_ptr<const TempoMap> tempoMap);
+    void LoadTempoFromProject();
+    void StoreTempoInProject();
     void ProcessTransportUpdate();
+    void PrefetchLoopStart();           // Decodes the loop start now
+    void UpdateLoopStartBlocks();       // Recollects what RequestLoopStart queues
+    void RequestLoopStart();            // Realtime
+    bool StartRecordingItems();
+    void FinishRecordingItems();
+    void ApplyPunchRange();
+    int64_t GetRecordingItemEnd(const RecordingItem& entry,
+                                const std::vector<RecordingEngine::Segment>& segments) const;
+    std::string GetRecordDirectory() const;
+    int64_t RenderBlockAt(float** inputs, float** outputs, int numChannels, int offset, int numSamples,
+                          int64_t position, bool playing);
+    void ProcessEngineBlock(float** inputs, float** outputs, int numChannels, int numSamples);
+    void ProcessConvertedBlock(float** inputs, float** outputs, int numChannels, int numSamples);
+    void QueueDeviceInput(float** inputs, int numChannels, int numSamples);
+    void DiscardDeviceInput(int frames);
+    void UpdateDeviceConversion();
     
     // REAPER-style time calculations
     double CalculateBeatPosition(double seconds) const;
@@ -0,0 +1,454 @@
+/*
+ * REAPER Web - RPP Parser Implementation
+ */
+
+#include "rpp_parser.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsQuote(char c) {
+    return c == '"' || c == '\'' || c == '`';
+}
+
+// Exactly representable powers of ten (Clinger's fast path)
+const double kPowersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double ParseDoubleSlow(std::string_view text, double defaultValue) {
+    char buffer[64];
+    std::string owned;
+    const char* terminated;
+    if (text.size() < sizeof(buffer)) {
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+        terminated = buffer;
+    } else {
+        owned.assign(text.data(), text.size());
+        terminated = owned.c_str();
+    }
+    
+    char* parsedEnd = nullptr;
+    double value = std::strtod(terminated, &parsedEnd);
+    return parsedEnd == terminated ? defaultValue : value;
+}
+
+} // anonymous namespace
+
+// RPPLine implementation
+
+std::string_view RPPLine::GetToken(int index) const {
+    return index >= 0 && index < numTokens ? tokens[index] : std::string_view();
+}
+
+double RPPLine::GetDouble(int index, double defaultValue) const {
+    return index >= 0 && index < numTokens ? RPPTokenizer::ParseDouble(tokens[index], defaultValue) : defaultValue;
+}
+
+int RPPLine::GetInt(int index, int defaultValue) const {
+    return index >= 0 && index < numTokens ? static_cast<int>(RPPTokenizer::ParseInt(tokens[index], defaultValue)) : defaultValue;
+}
+
+// RPPTokenizer implementation
+
+RPPTokenizer::RPPTokenizer(const char* data, size_t size)
+    : m_begin(data)
+    , m_cursor(data)
+    , m_end(data + size) {
+}
+
+bool RPPTokenizer::NextLineText(std::string_view& text) {
+    while (m_cursor < m_end) {
+        const char* lineStart = m_cursor;
+        const char* newline = static_cast<const char*>(std::memchr(m_cursor, '\n', m_end - m_cursor));
+        const char* lineEnd = newline ? newline : m_end;
+        m_cursor = newline ? newline + 1 : m_end;
+        ++m_lineNumber;
+        
+        while (lineStart < lineEnd && IsSpace(*lineStart)) ++lineStart;
+        while (lineEnd > lineStart && IsSpace(lineEnd[-1])) --lineEnd;
+        
+        if (lineStart < lineEnd) {
+            text = std::string_view(lineStart, static_cast<size_t>(lineEnd - lineStart));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RPPTokenizer::Next(RPPLine& line) {
+    std::string_view text;
+    if (!NextLineText(text)) {
+        return false;
+    }
+    
+    line.text = text;
+    line.remainder = std::string_view();
+    
+    if (text[0] == '<') {
+        line.type = RPPLine::Type::BLOCK_START;
+        Tokenize(text.substr(1), line);
+        ++m_depth;
+    } else if (text[0] == '>') {
+        line.type = RPPLine::Type::BLOCK_END;
+        line.numTokens = 0;
+        --m_depth;
+    } else {
+        line.type = RPPLine::Type::ATTRIBUTE;
+        Tokenize(text, line);
+    }
+    return true;
+}
+
+bool RPPTokenizer::SkipBlock() {
+    // Only the first character of each line matters here, so binary payloads
+    // (base64 plugin state) are skipped without tokenizing
+    int depth = 1;
+    std::string_view text;
+    while (NextLineText(text)) {
+        if (text[0] == '<') {
+            ++depth;
+        } else if (text[0] == '>') {
+            if (--depth == 0) {
+                --m_depth;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RPPTokenizer::Tokenize(std::string_view text, RPPLine& line) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    line.numTokens = 0;
+    
+    while (true) {
+        while (p < end && IsSpace(*p)) ++p;
+        if (p >= end) break;
+        
+        if (line.numTokens == RPPLine::MAX_TOKENS) {
+            line.remainder = std::string_view(p, static_cast<size_t>(end - p));
+            break;
+        }
+        
+        if (IsQuote(*p)) {
+            // Quoted strings run to the matching quote; there are no escapes
+            const char quote = *p++;
+            const char* close = static_cast<const char*>(std::memchr(p, quote, end - p));
+            const char* tokenEnd = close ? close : end;
+            line.tokens[line.numTokens++] = std::string_view(p, static_cast<size_t>(tokenEnd - p));
+            p = close ? close + 1 : end;
+        } else {
+            const char* tokenStart = p;
+            while (p < end && !IsSpace(*p)) ++p;
+            line.tokens[line.numTokens++] = std::string_view(tokenStart, static_cast<size_t>(p - tokenStart));
+        }
+    }
+}
+
+double RPPTokenizer::ParseDouble(std::string_view text, double defaultValue) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    
+    // Up to 19 significant digits fit the mantissa exactly
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+    bool truncated = false;
+    
+    for (; p < end && IsDigit(*p); ++p) {
+        anyDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) ++significantDigits;
+        } else {
+            ++exponent;
+            truncated = truncated || *p != '0';
+        }
+    }
+    
+    if (p < end && *p == '.') {
+        // Zeros are held back until a nonzero digit follows, so fixed-point
+        // padding ("12.50000000000000") keeps the mantissa short
+        int pendingZeros = 0;
+        for (++p; p < end && IsDigit(*p); ++p) {
+            anyDigits = true;
+            if (*p == '0') {
+                ++pendingZeros;
+                continue;
+            }
+            if (truncated || significantDigits + (mantissa != 0 ? pendingZeros : 0) >= 19) {
+                truncated = true;
+                continue;
+            }
+            for (; pendingZeros > 0; --pendingZeros) {
+                mantissa *= 10;
+                --exponent;
+                if (mantissa != 0) ++significantDigits;
+            }
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            --exponent;
+            ++significantDigits;
+        }
+    }
+    
+    if (!anyDigits) {
+        return ParseDoubleSlow(text, defaultValue);     // inf, nan, ...
+    }
+    
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* exponentStart = p;
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p < end && IsDigit(*p)) {
+            int value = 0;
+            for (; p < end && IsDigit(*p); ++p) {
+                value = std::min(value * 10 + (*p - '0'), 100000);
+            }
+            exponent += negativeExponent ? -value : value;
+        } else {
+            p = exponentStart;
+        }
+    }
+    
+    // Exact mantissa and exact power of ten: one correctly rounded operation
+    if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPowersOf10[-exponent] : value * kPowersOf10[exponent];
+        return negative ? -value : value;
+    }
+    
+    return ParseDoubleSlow(text.substr(0, static_cast<size_t>(p - text.data())), defaultValue);
+}
+
+int64_t RPPTokenizer::ParseInt(std::string_view text, int64_t defaultValue) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    
+    if (p >= end || !IsDigit(*p)) {
+        return defaultValue;
+    }
+    
+    int64_t value = 0;
+    for (; p < end && IsDigit(*p); ++p) {
+        value = value * 10 + (*p - '0');
+    }
+    return negative ? -value : value;
+}
+
+// RPPWriter implementation
+
+RPPWriter::RPPWriter(size_t bufferSize)
+    : m_buffer(std::max<size_t>(bufferSize, 256)) {
+}
+
+RPPWriter::~RPPWriter() {
+    Close();
+}
+
+bool RPPWriter::Open(const std::string& filePath) {
+    Close();
+    
+    m_file = std::fopen(filePath.c_str(), "wb");
+    if (!m_file) {
+        return false;
+    }
+    
+    // Writes are already batched here
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    m_used = 0;
+    m_depth = 0;
+    m_blockPending = false;
+    m_error = false;
+    m_bytesWritten = 0;
+    return true;
+}
+
+bool RPPWriter::Close() {
+    if (!m_file) {
+        return !m_error;
+    }
+    
+    Flush();
+    if (std::fclose(m_file) != 0) {
+        m_error = true;
+    }
+    m_file = nullptr;
+    return !m_error;
+}
+
+RPPWriter& RPPWriter::Block(std::string_view name) {
+    for (int i = 0; i < m_depth; ++i) {
+        Append("  ", 2);
+    }
+    AppendChar('<');
+    Append(name.data(), name.size());
+    m_blockPending = true;
+    return *this;
+}
+
+RPPWriter& RPPWriter::Key(std::string_view key) {
+    for (int i = 0; i < m_depth; ++i) {
+        Append("  ", 2);
+    }
+    Append(key.data(), key.size());
+    return *this;
+}
+
+RPPWriter& RPPWriter::Number(double value) {
+    AppendSeparator();
+    if (m_buffer.size() - m_used < 32) {
+        Flush();
+    }
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(m_buffer.data() + m_used, m_buffer.data() + m_used + 32, value,
+                                std::chars_format::general, 14);
+    m_used = static_cast<size_t>(result.ptr - m_buffer.data());
+#else
+    int length = std::snprintf(m_buffer.data() + m_used, 32, "%.14g", value);
+    m_used += static_cast<size_t>(std::max(length, 0));
+#endif
+    return *this;
+}
+
+RPPWriter& RPPWriter::Integer(int64_t value) {
+    AppendSeparator();
+    
+    char digits[24];
+    int count = 0;
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        digits[count++] = '-';
+    }
+    
+    std::reverse(digits, digits + count);
+    Append(digits, static_cast<size_t>(count));
+    return *this;
+}
+
+RPPWriter& RPPWriter::String(std::string_view value) {
+    AppendSeparator();
+    
+    bool needsQuotes = value.empty() || IsQuote(value[0]);
+    bool hasDouble = false, hasSingle = false, hasBack = false;
+    for (char c : value) {
+        needsQuotes = needsQuotes || IsSpace(c);
+        hasDouble = hasDouble || c == '"';
+        hasSingle = hasSingle || c == '\'';
+        hasBack = hasBack || c == '`';
+    }
+    
+    if (!needsQuotes) {
+        Append(value.data(), value.size());
+        return *this;
+    }
+    
+    // REAPER picks the first quote character the text does not contain;
+    // with all three present, backticks become single quotes
+    const char quote = !hasDouble ? '"' : !hasSingle ? '\'' : '`';
+    AppendChar(quote);
+    if (quote == '`' && hasBack) {
+        for (char c : value) {
+            AppendChar(c == '`' ? '\'' : c);
+        }
+    } else {
+        Append(value.data(), value.size());
+    }
+    AppendChar(quote);
+    return *this;
+}
+
+RPPWriter& RPPWriter::Raw(std::string_view value) {
+    AppendSeparator();
+    Append(value.data(), value.size());
+    return *this;
+}
+
+void RPPWriter::End() {
+    AppendChar('\n');
+    if (m_blockPending) {
+        ++m_depth;
+        m_blockPending = false;
+    }
+}
+
+void RPPWriter::EndBlock() {
+    m_depth = std::max(0, m_depth - 1);
+    for (int i = 0; i < m_depth; ++i) {
+        Append("  ", 2);
+    }
+    Append(">\n", 2);
+}
+
+void RPPWriter::Append(const char* data, size_t size) {
+    if (size > m_buffer.size() - m_used) {
+        Flush();
+        if (size > m_buffer.size()) {
+            // Larger than the whole buffer - write through
+            if (m_file && std::fwrite(data, 1, size, m_file) != size) {
+                m_error = true;
+            }
+            m_bytesWritten += size;
+            return;
+        }
+    }
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+}
+
+void RPPWriter::AppendChar(char c) {
+    if (m_used == m_buffer.size()) {
+        Flush();
+    }
+    m_buffer[m_used++] = c;
+}
+
+void RPPWriter::AppendSeparator() {
+    AppendChar(' ');
+}
+
+void RPPWriter::Flush() {
+    if (m_used == 0) {
+        return;
+    }
+    if (!m_file || std::fwrite(m_buffer.data(), 1, m_used, m_file) != m_used) {
+        m_error = true;
+    }
+    m_bytesWritten += m_used;
+    m_used = 0;
+}
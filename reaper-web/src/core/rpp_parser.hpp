@@ -0,0 +1,128 @@
+/*
+ * REAPER Web - RPP Parser
+ * Streaming tokenizer and buffered writer for REAPER .rpp project files
+ * Based on REAPER's project text format (nested "<BLOCK" ... ">" chunks)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * RPPLine - One tokenized line of a project file
+ * Tokens are views into the source text (quotes stripped), so they are
+ * only valid while the tokenizer's buffer is. Token 0 is the key; for a
+ * block start it is the block name without the '<'.
+ */
+struct RPPLine {
+    enum class Type {
+        ATTRIBUTE,          // KEY value value ...
+        BLOCK_START,        // <KEY value ...
+        BLOCK_END           // >
+    };
+
+    static constexpr int MAX_TOKENS = 24;
+
+    Type type = Type::ATTRIBUTE;
+    std::string_view tokens[MAX_TOKENS];
+    int numTokens = 0;
+    std::string_view remainder;     // Unsplit text beyond MAX_TOKENS
+    std::string_view text;          // Whole line without indentation
+
+    std::string_view Key() const { return numTokens > 0 ? tokens[0] : std::string_view(); }
+    bool Is(std::string_view key) const { return numTokens > 0 && tokens[0] == key; }
+
+    // Typed access - missing tokens return the default
+    std::string_view GetToken(int index) const;
+    double GetDouble(int index, double defaultValue = 0.0) const;
+    int GetInt(int index, int defaultValue = 0) const;
+    bool GetBool(int index, bool defaultValue = false) const { return GetInt(index, defaultValue ? 1 : 0) != 0; }
+    std::string GetString(int index) const { return std::string(GetToken(index)); }
+};
+
+/**
+ * RPPTokenizer - Single-pass, zero-copy line tokenizer
+ * Walks a text buffer (usually a MappedFile) once. No allocation happens
+ * per line; callers copy only the values they keep.
+ */
+class RPPTokenizer {
+public:
+    RPPTokenizer(const char* data, size_t size);
+
+    bool Next(RPPLine& line);           // False at end of input
+    bool SkipBlock();                   // After a BLOCK_START: consume through its '>'
+
+    int GetLineNumber() const { return m_lineNumber; }
+    int GetDepth() const { return m_depth; }
+    size_t GetOffset() const { return static_cast<size_t>(m_cursor - m_begin); }
+
+    // Number parsing on views (no terminator required)
+    static double ParseDouble(std::string_view text, double defaultValue = 0.0);
+    static int64_t ParseInt(std::string_view text, int64_t defaultValue = 0);
+
+private:
+    const char* m_begin;
+    const char* m_cursor;
+    const char* m_end;
+    int m_lineNumber = 0;
+    int m_depth = 0;
+
+    bool NextLineText(std::string_view& text);
+    static void Tokenize(std::string_view text, RPPLine& line);
+};
+
+/**
+ * RPPWriter - Buffered project file writer
+ * Lines are assembled directly in a fixed buffer that is flushed with one
+ * fwrite when full. Indentation follows block depth; strings are quoted
+ * with REAPER's rules.
+ *
+ *   writer.Block("TRACK").Raw(guid).End();
+ *   writer.Key("VOLPAN").Number(volume).Number(pan).End();
+ *   writer.EndBlock();
+ */
+class RPPWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+    explicit RPPWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~RPPWriter();
+
+    RPPWriter(const RPPWriter&) = delete;
+    RPPWriter& operator=(const RPPWriter&) = delete;
+
+    bool Open(const std::string& filePath);
+    bool Close();                       // Flushes; false if any write failed
+
+    // Line assembly
+    RPPWriter& Block(std::string_view name);    // "<NAME", nests after End()
+    RPPWriter& Key(std::string_view key);
+    RPPWriter& Number(double value);
+    RPPWriter& Integer(int64_t value);
+    RPPWriter& String(std::string_view value);  // Quoted when needed
+    RPPWriter& Raw(std::string_view value);     // Written as is
+    void End();
+    void EndBlock();                    // ">"
+
+    bool HasError() const { return m_error; }
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+
+private:
+    FILE* m_file = nullptr;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+    int m_depth = 0;
+    bool m_blockPending = false;        // Current line opens a block
+    bool m_error = false;
+    uint64_t m_bytesWritten = 0;
+
+    void Append(const char* data, size_t size);
+    void AppendChar(char c);
+    void AppendSeparator();
+    void Flush();
+};
@@ -0,0 +1,442 @@
+/*
+ * REAPER Web - Sample Rate Converter Implementation
+ * Windowed-sinc polyphase resampler with shared coefficient tables
+ */
+
+#include "sample_rate_converter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define REAPER_SRC_SSE 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define REAPER_SRC_WASM_SIMD 1
+#endif
+
+namespace {
+
+// Ratios needing more phases than this use an interpolated filter bank
+constexpr int64_t kMaxExactPhases = 4096;
+
+// Zeroth-order modified Bessel function (Kaiser window)
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+
+    return sum;
+}
+
+} // namespace
+
+SampleRateConverter::SampleRateConverter() = default;
+
+SampleRateConverter::~SampleRateConverter() = default;
+
+SampleRateConverter::QualitySettings SampleRateConverter::GetQualitySettings(Quality quality) {
+    QualitySettings settings;
+
+    switch (quality) {
+        case Quality::DRAFT:
+            settings.taps = 8;
+            settings.phases = 64;
+            settings.rolloff = 0.80;
+            settings.kaiserBeta = 5.0;
+            break;
+        case Quality::STANDARD:
+            settings.taps = 20;
+            settings.phases = 128;
+            settings.rolloff = 0.86;
+            settings.kaiserBeta = 7.5;
+            break;
+        case Quality::HIGH:
+            settings.taps = 32;
+            settings.phases = 256;
+            settings.rolloff = 0.92;
+            settings.kaiserBeta = 9.0;
+            break;
+        case Quality::MASTERING:
+            settings.taps = 64;
+            settings.phases = 512;
+            settings.rolloff = 0.95;
+            settings.kaiserBeta = 11.0;
+            break;
+    }
+
+    return settings;
+}
+
+bool SampleRateConverter::Prepare(double inputRate, double outputRate, int numChannels, int maxInputBlock,
+                                  Quality quality) {
+    if (inputRate <= 0.0 || outputRate <= 0.0 || numChannels <= 0 || maxInputBlock <= 0) {
+        return false;
+    }
+
+    m_inputRate = inputRate;
+    m_outputRate = outputRate;
+    m_numChannels = numChannels;
+    m_maxInputBlock = maxInputBlock;
+    m_quality = quality;
+
+    ReduceRatio(inputRate, outputRate, m_upFactor, m_downFactor);
+
+    QualitySettings settings = GetQualitySettings(quality);
+
+    // Exact rational phases for common rate pairs (44.1k <-> 48k uses 160/147)
+    m_exactPhases = m_upFactor <= kMaxExactPhases;
+    int phases = m_exactPhases ? static_cast<int>(m_upFactor) : settings.phases;
+    m_variableTables.clear();
+    m_variableBandwidths.clear();
+
+    // Cutoff in cycles per input sample, below the lower of the two Nyquist limits
+    double cutoff = 0.5 * std::min(1.0, static_cast<double>(m_upFactor) / m_downFactor) * settings.rolloff;
+    m_table = GetCoefficientTable(phases, settings.taps, cutoff, settings.kaiserBeta);
+
+    // History holds the filter tail plus a full input block
+    m_historyCapacity = maxInputBlock + settings.taps * 2;
+    m_history.assign(numChannels, std::vector<float>(m_historyCapacity, 0.0f));
+
+    Reset();
+    return true;
+}
+
+bool SampleRateConverter::PrepareVariable(double minInputRate, double maxInputRate, double outputRate,
+                                          int numChannels, int maxInputBlock, Quality quality) {
+    if (minInputRate <= 0.0 || maxInputRate < minInputRate ||
+        !Prepare(minInputRate, outputRate, numChannels, maxInputBlock, quality)) {
+        return false;
+    }
+
+    // Ratios change freely, so phases are always interpolated from the filter bank
+    QualitySettings settings = GetQualitySettings(quality);
+    m_exactPhases = false;
+    m_minInputRate = minInputRate;
+    m_maxInputRate = maxInputRate;
+
+    // Downsampling narrows the filter; step down to the narrowest band the range needs
+    const double narrowest = std::min(1.0, outputRate / maxInputRate);
+    for (int step = 0;; ++step) {
+        double bandwidth = std::max(narrowest, std::pow(2.0, -step / 8.0));
+        m_variableTables.push_back(GetCoefficientTable(settings.phases, settings.taps,
+                                                       0.5 * bandwidth * settings.rolloff, settings.kaiserBeta));
+        m_variableBandwidths.push_back(bandwidth);
+        if (bandwidth <= narrowest) break;
+    }
+
+    SetInputRate(minInputRate);
+    Reset();
+    return true;
+}
+
+bool SampleRateConverter::SetInputRate(double inputRate) {
+    if (m_variableTables.empty() || inputRate < m_minInputRate * (1.0 - 1e-9) ||
+        inputRate > m_maxInputRate * (1.0 + 1e-9)) {
+        return false;
+    }
+
+    int64_t up = 1;
+    int64_t down = 1;
+    ReduceRatio(inputRate, m_outputRate, up, down);
+
+    // Carry the position between input frames over to the new phase denominator
+    m_phase = std::min<int64_t>(up - 1, static_cast<int64_t>(static_cast<double>(m_phase) / m_upFactor * up));
+    m_upFactor = up;
+    m_downFactor = down;
+    m_inputRate = inputRate;
+
+    // The widest table that still stops at the lower Nyquist
+    const double bandwidth = std::min(1.0, static_cast<double>(up) / down);
+    size_t index = 0;
+    while (index + 1 < m_variableBandwidths.size() && m_variableBandwidths[index] > bandwidth * (1.0 + 1e-9)) {
+        ++index;
+    }
+    m_table = m_variableTables[index];
+    return true;
+}
+
+void SampleRateConverter::Reset() {
+    m_phase = 0;
+    m_inputIndex = 0;
+
+    // Pre-fill so the first output sample lines up with the first input sample
+    m_historyFill = m_table ? (m_table->taps / 2 - 1) : 0;
+    for (auto& channel : m_history) {
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    }
+}
+
+int64_t SampleRateConverter::ResetForOutputFrame(int64_t outputFrame) {
+    m_inputIndex = 0;
+    m_historyFill = 0;
+    for (auto& channel : m_history) {
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    }
+
+    if (!m_table || IsPassthrough()) {
+        m_phase = 0;
+        return outputFrame;
+    }
+
+    // outputFrame * down / up without overflowing on long sessions
+    int64_t whole = outputFrame / m_upFactor;
+    int64_t rem = outputFrame % m_upFactor;
+    int64_t inputFrame = whole * m_downFactor + (rem * m_downFactor) / m_upFactor;
+    m_phase = (rem * m_downFactor) % m_upFactor;
+
+    return inputFrame - (m_table->taps / 2 - 1);
+}
+
+int SampleRateConverter::Process(const float* const* input, int numInputFrames, float** output, int maxOutputFrames,
+                                 int* inputFramesConsumed) {
+    if (inputFramesConsumed) {
+        *inputFramesConsumed = 0;
+    }
+    if (!m_table || !input || !output) {
+        return 0;
+    }
+
+    if (IsPassthrough()) {
+        int frames = std::min(numInputFrames, maxOutputFrames);
+        for (int ch = 0; ch < m_numChannels; ++ch) {
+            std::copy(input[ch], input[ch] + frames, output[ch]);
+        }
+        if (inputFramesConsumed) {
+            *inputFramesConsumed = frames;
+        }
+        return frames;
+    }
+
+    const int taps = m_table->taps;
+    const int tableResolution = m_table->phases;
+    int produced = 0;
+    int consumed = 0;
+
+    while (true) {
+        // Append as much input as the history can hold
+        int toCopy = std::min(m_historyCapacity - m_historyFill, numInputFrames - consumed);
+        if (toCopy > 0) {
+            for (int ch = 0; ch < m_numChannels; ++ch) {
+                std::memcpy(m_history[ch].data() + m_historyFill, input[ch] + consumed, toCopy * sizeof(float));
+            }
+            m_historyFill += toCopy;
+            consumed += toCopy;
+        }
+
+        // Generate every output whose filter window is fully available
+        while (produced < maxOutputFrames && m_inputIndex + taps <= m_historyFill) {
+            if (m_exactPhases) {
+                const float* coeffs = m_table->GetPhase(static_cast<int>(m_phase));
+                for (int ch = 0; ch < m_numChannels; ++ch) {
+                    output[ch][produced] = DotProduct(m_history[ch].data() + m_inputIndex, coeffs, taps);
+                }
+            } else {
+                // Interpolate between the two nearest filter phases
+                int64_t scaled = m_phase * tableResolution;
+                int row = static_cast<int>(scaled / m_upFactor);
+                float frac = static_cast<float>(scaled % m_upFactor) / static_cast<float>(m_upFactor);
+                const float* coeffsA = m_table->GetPhase(row);
+                const float* coeffsB = m_table->GetPhase(row + 1);
+
+                for (int ch = 0; ch < m_numChannels; ++ch) {
+                    const float* x = m_history[ch].data() + m_inputIndex;
+                    float a = DotProduct(x, coeffsA, taps);
+                    float b = DotProduct(x, coeffsB, taps);
+                    output[ch][produced] = a + (b - a) * frac;
+                }
+            }
+
+            m_phase += m_downFactor;
+            m_inputIndex += static_cast<int>(m_phase / m_upFactor);
+            m_phase %= m_upFactor;
+            ++produced;
+        }
+
+        CompactHistory();
+
+        if (consumed >= numInputFrames) break;
+        if (produced >= maxOutputFrames && m_historyFill >= m_historyCapacity) break; // Output full; the rest waits
+    }
+
+    if (inputFramesConsumed) {
+        *inputFramesConsumed = consumed;
+    }
+    return produced;
+}
+
+int SampleRateConverter::GetInputFramesNeeded(int numOutputFrames) const {
+    if (numOutputFrames <= 0 || !m_table) {
+        return 0;
+    }
+
+    if (IsPassthrough()) {
+        return numOutputFrames;
+    }
+
+    // Window of the last requested output must be fully buffered
+    int64_t advance = (m_phase + static_cast<int64_t>(numOutputFrames - 1) * m_downFactor) / m_upFactor;
+    int64_t needed = m_inputIndex + advance + m_table->taps - m_historyFill;
+
+    return static_cast<int>(std::max<int64_t>(0, needed));
+}
+
+int SampleRateConverter::GetAvailableOutputFrames() const {
+    if (!m_table || IsPassthrough()) {
+        return 0;
+    }
+
+    int64_t room = m_historyFill - m_table->taps - m_inputIndex;
+    if (room < 0) {
+        return 0;
+    }
+
+    return static_cast<int>(((room + 1) * m_upFactor - 1 - m_phase) / m_downFactor + 1);
+}
+
+int SampleRateConverter::GetLatencyFrames() const {
+    return m_table ? m_table->taps / 2 : 0;
+}
+
+void SampleRateConverter::CompactHistory() {
+    int shift = std::min(m_inputIndex, m_historyFill);
+    if (shift <= 0) return;
+
+    int remaining = m_historyFill - shift;
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        float* data = m_history[ch].data();
+        std::memmove(data, data + shift, remaining * sizeof(float));
+    }
+
+    m_historyFill = remaining;
+    m_inputIndex -= shift;
+}
+
+void SampleRateConverter::ReduceRatio(double inputRate, double outputRate, int64_t& up, int64_t& down) {
+    // Integer rates reduce exactly; fractional rates are resolved to 1/1000 Hz
+    bool integral = std::abs(inputRate - std::round(inputRate)) < 1e-9 &&
+                    std::abs(outputRate - std::round(outputRate)) < 1e-9;
+    double scale = integral ? 1.0 : 1000.0;
+
+    int64_t in = static_cast<int64_t>(std::llround(inputRate * scale));
+    int64_t out = static_cast<int64_t>(std::llround(outputRate * scale));
+    int64_t g = std::gcd(in, out);
+
+    up = out / g;
+    down = in / g;
+}
+
+std::shared_ptr<const SampleRateConverter::CoefficientTable>
+SampleRateConverter::GetCoefficientTable(int phases, int taps, double cutoff, double beta) {
+    using Key = std::tuple<int, int, double, double>;
+    static std::map<Key, std::shared_ptr<const CoefficientTable>> s_tables;
+    static std::mutex s_tablesMutex;
+
+    std::lock_guard<std::mutex> lock(s_tablesMutex);
+
+    Key key(phases, taps, cutoff, beta);
+    auto it = s_tables.find(key);
+    if (it != s_tables.end()) {
+        return it->second;
+    }
+
+    auto table = std::make_shared<CoefficientTable>();
+    table->taps = taps;
+    table->phases = phases;
+
+    // One extra row (offset 1.0) so interpolated lookups never wrap
+    table->coefficients.resize(static_cast<size_t>(phases + 1) * taps);
+
+    const double halfWidth = taps * 0.5;
+    const double i0Beta = BesselI0(beta);
+
+    for (int phase = 0; phase <= phases; ++phase) {
+        double frac = static_cast<double>(phase) / phases;
+        float* row = table->coefficients.data() + static_cast<size_t>(phase) * taps;
+        double sum = 0.0;
+
+        for (int tap = 0; tap < taps; ++tap) {
+            // Distance from the output position to this input sample
+            double t = tap - (taps / 2 - 1) - frac;
+            double x = 2.0 * cutoff * t;
+            double sinc = (std::abs(x) < 1e-12) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+
+            double ratio = t / halfWidth;
+            double window = (std::abs(ratio) < 1.0)
+                ? BesselI0(beta * std::sqrt(1.0 - ratio * ratio)) / i0Beta
+                : 0.0;
+
+            double coeff = 2.0 * cutoff * sinc * window;
+            row[tap] = static_cast<float>(coeff);
+            sum += coeff;
+        }
+
+        // Normalize each phase for unity DC gain
+        if (sum != 0.0) {
+            for (int tap = 0; tap < taps; ++tap) {
+                row[tap] = static_cast<float>(row[tap] / sum);
+            }
+        }
+    }
+
+    s_tables[key] = table;
+    return table;
+}
+
+float SampleRateConverter::DotProduct(const float* a, const float* b, int count) {
+#if defined(REAPER_SRC_SSE)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    acc0 = _mm_add_ps(acc0, acc1);
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc0);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#elif defined(REAPER_SRC_WASM_SIMD)
+    v128_t acc = wasm_f32x4_splat(0.0f);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        acc = wasm_f32x4_add(acc, wasm_f32x4_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+    }
+
+    float sum = wasm_f32x4_extract_lane(acc, 0) + wasm_f32x4_extract_lane(acc, 1) +
+                wasm_f32x4_extract_lane(acc, 2) + wasm_f32x4_extract_lane(acc, 3);
+
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#else
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#endif
+}
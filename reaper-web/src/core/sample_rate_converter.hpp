@@ -0,0 +1,118 @@
+/*
+ * REAPER Web - Sample Rate Converter
+ * Windowed-sinc polyphase resampler for source playback and device I/O
+ * Based on REAPER's resampling modes (draft to extreme quality)
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * SampleRateConverter - Streaming polyphase resampler
+ * Converts between arbitrary sample rates with a windowed-sinc filter bank.
+ * Filter state is carried across blocks so consecutive calls produce a
+ * continuous stream; the output position is tracked with an exact rational
+ * phase accumulator, so long streams never drift.
+ */
+class SampleRateConverter {
+public:
+    enum class Quality {
+        DRAFT,              // 8 taps, fast preview quality
+        STANDARD,           // 20 taps, default playback quality
+        HIGH,               // 32 taps, render quality
+        MASTERING           // 64 taps, offline/extreme quality
+    };
+
+    struct QualitySettings {        // Defaults are STANDARD's
+        int taps = 20;              // Filter taps per phase (multiple of 4)
+        int phases = 128;           // Filter bank resolution for irrational ratios
+        double rolloff = 0.86;      // Cutoff relative to the lower Nyquist
+        double kaiserBeta = 7.5;    // Kaiser window shape (stopband attenuation)
+    };
+
+    /**
+     * Coefficient table - one row of taps per filter phase
+     * Rows are stored contiguously and padded for SIMD loads. Tables are
+     * immutable once built and shared between converters with the same design.
+     */
+    struct CoefficientTable {
+        int taps = 0;
+        int phases = 0;
+        std::vector<float> coefficients;    // [phase][tap]
+
+        const float* GetPhase(int phase) const { return coefficients.data() + static_cast<size_t>(phase) * taps; }
+    };
+
+public:
+    SampleRateConverter();
+    ~SampleRateConverter();
+
+    // Setup - allocates all buffers; must not be called from the audio thread
+    bool Prepare(double inputRate, double outputRate, int numChannels, int maxInputBlock,
+                 Quality quality = Quality::STANDARD);
+
+    // Variable ratio setup - builds filters for every input rate in the range,
+    // so SetInputRate() can retune the stream from the audio thread
+    bool PrepareVariable(double minInputRate, double maxInputRate, double outputRate, int numChannels,
+                         int maxInputBlock, Quality quality = Quality::STANDARD);
+    bool SetInputRate(double inputRate);                // Realtime; false outside the prepared range
+    void Reset();
+    int64_t ResetForOutputFrame(int64_t outputFrame);   // Returns first input frame to feed
+
+    // Streaming conversion - returns frames written. All input is consumed
+    // unless the output fills first; the frames taken go to inputFramesConsumed
+    // and the caller feeds the rest on the next call.
+    int Process(const float* const* input, int numInputFrames, float** output, int maxOutputFrames,
+                int* inputFramesConsumed = nullptr);
+    int GetInputFramesNeeded(int numOutputFrames) const;
+    int GetAvailableOutputFrames() const;
+
+    // Properties
+    bool IsPrepared() const { return m_table != nullptr; }
+    bool IsPassthrough() const { return m_upFactor == m_downFactor; }
+    double GetInputRate() const { return m_inputRate; }
+    double GetOutputRate() const { return m_outputRate; }
+    double GetRatio() const { return m_outputRate / m_inputRate; }
+    int GetNumChannels() const { return m_numChannels; }
+    int GetLatencyFrames() const;                       // In input frames
+    Quality GetQuality() const { return m_quality; }
+
+    static QualitySettings GetQualitySettings(Quality quality);
+
+private:
+    double m_inputRate = 48000.0;
+    double m_outputRate = 48000.0;
+    int m_numChannels = 0;
+    int m_maxInputBlock = 0;
+    Quality m_quality = Quality::STANDARD;
+
+    // Rational ratio: output n sits at input position n * m_downFactor / m_upFactor
+    int64_t m_upFactor = 1;
+    int64_t m_downFactor = 1;
+
+    // Stream state
+    int64_t m_phase = 0;                // Phase numerator in [0, m_upFactor)
+    int m_inputIndex = 0;               // First tap of the next output within m_history
+    int m_historyFill = 0;              // Valid frames in each history channel
+    int m_historyCapacity = 0;
+    std::vector<std::vector<float>> m_history;  // [channel][frame], contiguous per channel
+
+    std::shared_ptr<const CoefficientTable> m_table;
+    bool m_exactPhases = true;          // One table row per rational phase
+
+    // Variable ratio: tables at 1/8-octave cutoff steps, widest first
+    std::vector<std::shared_ptr<const CoefficientTable>> m_variableTables;
+    std::vector<double> m_variableBandwidths;   // Fraction of the input Nyquist each table passes
+    double m_minInputRate = 0.0;
+    double m_maxInputRate = 0.0;
+
+    // Internal helpers
+    void CompactHistory();
+    static void ReduceRatio(double inputRate, double outputRate, int64_t& up, int64_t& down);
+    static std::shared_ptr<const CoefficientTable> GetCoefficientTable(int phases, int taps,
+                                                                       double cutoff, double beta);
+    static float DotProduct(const float* a, const float* b, int count);
+};
@@ -0,0 +1,225 @@
+/*
+ * REAPER Web - Tempo Map Implementation
+ */
+
+#include "tempo_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kMinBpm = 1.0;
+constexpr double kBarEpsilon = 1e-9;
+
+} // anonymous namespace
+
+TempoMap::TempoMap(double bpm, int timeSigNumerator, int timeSigDenominator) {
+    TempoMarker marker;
+    marker.bpm = bpm;
+    marker.timeSigNumerator = timeSigNumerator;
+    marker.timeSigDenominator = timeSigDenominator;
+    SetMarkers({marker});
+}
+
+TempoMap::TempoMap(const std::vector<TempoMarker>& markers) {
+    SetMarkers(markers);
+}
+
+void TempoMap::SetMarkers(const std::vector<TempoMarker>& markers) {
+    m_markers = markers;
+    std::stable_sort(m_markers.begin(), m_markers.end(),
+                     [](const TempoMarker& a, const TempoMarker& b) { return a.time < b.time; });
+    
+    if (m_markers.empty()) {
+        m_markers.emplace_back();
+    }
+    if (m_markers.front().time > 0.0) {
+        TempoMarker start = m_markers.front();
+        start.time = 0.0;
+        start.ramp = false;
+        m_markers.insert(m_markers.begin(), start);
+    }
+    m_markers.front().time = 0.0;
+    if (m_markers.front().timeSigNumerator <= 0 || m_markers.front().timeSigDenominator <= 0) {
+        m_markers.front().timeSigNumerator = 4;
+        m_markers.front().timeSigDenominator = 4;
+    }
+    
+    Build();
+}
+
+void TempoMap::Build() {
+    m_segments.clear();
+    m_segments.reserve(m_markers.size());
+    
+    for (size_t i = 0; i < m_markers.size(); ++i) {
+        TempoMarker& marker = m_markers[i];
+        marker.bpm = std::max(marker.bpm, kMinBpm);
+        
+        Segment segment;
+        segment.time = marker.time;
+        segment.startBpm = marker.bpm;
+        
+        const bool newSignature = marker.timeSigNumerator > 0 && marker.timeSigDenominator > 0;
+        if (i == 0) {
+            segment.timeSigNumerator = marker.timeSigNumerator;
+            segment.timeSigDenominator = marker.timeSigDenominator;
+        } else {
+            const Segment& previous = m_segments.back();
+            segment.beats = SegmentBeats(previous, segment.time);
+            segment.measure = previous.measure + (segment.beats - previous.beats) / previous.QuarterNotesPerBar();
+            segment.timeSigNumerator = newSignature ? marker.timeSigNumerator : previous.timeSigNumerator;
+            segment.timeSigDenominator = newSignature ? marker.timeSigDenominator : previous.timeSigDenominator;
+            
+            // A new time signature always starts a bar
+            if (newSignature) {
+                segment.measure = std::ceil(segment.measure - kBarEpsilon);
+            }
+        }
+        
+        if (marker.ramp && i + 1 < m_markers.size() && m_markers[i + 1].time > marker.time) {
+            const double nextBpm = std::max(m_markers[i + 1].bpm, kMinBpm);
+            segment.slope = (nextBpm - marker.bpm) / (m_markers[i + 1].time - marker.time);
+        }
+        
+        m_segments.push_back(segment);
+    }
+}
+
+double TempoMap::TimeToBeats(double seconds) const {
+    return SegmentBeats(m_segments[FindByTime(seconds)], seconds);
+}
+
+double TempoMap::BeatsToTime(double beats) const {
+    return SegmentTime(m_segments[FindByBeats(beats)], beats);
+}
+
+double TempoMap::GetTempoAt(double seconds) const {
+    return SegmentPosition(m_segments[FindByTime(seconds)], seconds).bpm;
+}
+
+TimeSignature TempoMap::GetTimeSignatureAt(double seconds) const {
+    const Segment& segment = m_segments[FindByTime(seconds)];
+    TimeSignature timeSig;
+    timeSig.numerator = segment.timeSigNumerator;
+    timeSig.denominator = segment.timeSigDenominator;
+    return timeSig;
+}
+
+TempoPosition TempoMap::GetPosition(double seconds) const {
+    return SegmentPosition(m_segments[FindByTime(seconds)], seconds);
+}
+
+void TempoMap::BeatsToMeasure(double beats, int& measure, double& beatInBar, TimeSignature* timeSig) const {
+    const Segment& segment = m_segments[FindByBeats(beats)];
+    const double bars = segment.measure + (beats - segment.beats) / segment.QuarterNotesPerBar();
+    
+    measure = static_cast<int>(std::floor(bars + kBarEpsilon));
+    beatInBar = std::max(0.0, (bars - measure) * segment.timeSigNumerator);
+    if (timeSig) {
+        timeSig->numerator = segment.timeSigNumerator;
+        timeSig->denominator = segment.timeSigDenominator;
+    }
+}
+
+double TempoMap::MeasureToBeats(int measure) const {
+    const Segment& segment = m_segments[FindByMeasure(measure)];
+    return segment.beats + (measure - segment.measure) * segment.QuarterNotesPerBar();
+}
+
+TimeSignature TempoMap::GetTimeSignatureAtMeasure(int measure) const {
+    const Segment& segment = m_segments[FindByMeasure(measure)];
+    TimeSignature timeSig;
+    timeSig.numerator = segment.timeSigNumerator;
+    timeSig.denominator = segment.timeSigDenominator;
+    return timeSig;
+}
+
+size_t TempoMap::FindByTime(double seconds) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), seconds,
+                               [](double t, const Segment& s) { return t < s.time; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+size_t TempoMap::FindByBeats(double beats) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), beats,
+                               [](double b, const Segment& s) { return b < s.beats; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+size_t TempoMap::FindByMeasure(double measure) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), measure,
+                               [](double m, const Segment& s) { return m < s.measure; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+size_t TempoMap::FindByTime(double seconds, size_t hint) const {
+    const size_t count = m_segments.size();
+    for (size_t i = hint; i < count && i <= hint + 1; ++i) {
+        if ((i == 0 || m_segments[i].time <= seconds) && (i + 1 == count || seconds < m_segments[i + 1].time)) {
+            return i;
+        }
+    }
+    return FindByTime(seconds);
+}
+
+size_t TempoMap::FindByBeats(double beats, size_t hint) const {
+    const size_t count = m_segments.size();
+    for (size_t i = hint; i < count && i <= hint + 1; ++i) {
+        if ((i == 0 || m_segments[i].beats <= beats) && (i + 1 == count || beats < m_segments[i + 1].beats)) {
+            return i;
+        }
+    }
+    return FindByBeats(beats);
+}
+
+double TempoMap::SegmentBeats(const Segment& segment, double seconds) {
+    // Integral of bpm / 60 over the segment; times before it use the start tempo
+    const double elapsed = seconds - segment.time;
+    if (elapsed <= 0.0) {
+        return segment.beats + segment.startBpm * elapsed / 60.0;
+    }
+    return segment.beats + (segment.startBpm + 0.5 * segment.slope * elapsed) * elapsed / 60.0;
+}
+
+double TempoMap::SegmentTime(const Segment& segment, double beats) {
+    // Solve 0.5 * slope * t^2 + startBpm * t = 60 * beats in the form that
+    // stays accurate as the slope goes to zero
+    const double target = 60.0 * (beats - segment.beats);
+    if (target <= 0.0 || segment.slope == 0.0) {
+        return segment.time + target / segment.startBpm;
+    }
+    
+    const double root = std::sqrt(std::max(0.0, segment.startBpm * segment.startBpm + 2.0 * segment.slope * target));
+    return segment.time + 2.0 * target / (segment.startBpm + root);
+}
+
+TempoPosition TempoMap::SegmentPosition(const Segment& segment, double seconds) {
+    TempoPosition position;
+    position.bpm = segment.startBpm + segment.slope * std::max(0.0, seconds - segment.time);
+    position.beats = SegmentBeats(segment, seconds);
+    position.timeSigNumerator = segment.timeSigNumerator;
+    position.timeSigDenominator = segment.timeSigDenominator;
+    return position;
+}
+
+double TempoMap::Cursor::TimeToBeats(double seconds) {
+    if (!m_map) return 0.0;
+    
+    m_segment = m_map->FindByTime(seconds, m_segment);
+    return SegmentBeats(m_map->m_segments[m_segment], seconds);
+}
+
+double TempoMap::Cursor::BeatsToTime(double beats) {
+    if (!m_map) return 0.0;
+    
+    m_segment = m_map->FindByBeats(beats, m_segment);
+    return SegmentTime(m_map->m_segments[m_segment], beats);
+}
+
+TempoPosition TempoMap::Cursor::GetPosition(double seconds) {
+    if (!m_map) return TempoPosition();
+    
+    m_segment = m_map->FindByTime(seconds, m_segment);
+    return SegmentPosition(m_map->m_segments[m_segment], seconds);
+}
@@ -0,0 +1,116 @@
+/*
+ * REAPER Web - Tempo Map
+ * Tempo and time signature changes with fast beat <-> time conversion
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct TempoMarker {
+    double time = 0.0;              // Seconds
+    double bpm = 120.0;             // Quarter notes per minute
+    int timeSigNumerator = 0;       // 0 keeps the previous time signature
+    int timeSigDenominator = 0;
+    bool ramp = false;              // Tempo moves linearly (in time) to the next marker's
+};
+
+struct TimeSignature {
+    int numerator = 4;
+    int denominator = 4;
+};
+
+// What plugins see at the start of a block
+struct TempoPosition {
+    double bpm = 120.0;
+    double beats = 0.0;             // Quarter notes from project start
+    int timeSigNumerator = 4;
+    int timeSigDenominator = 4;
+};
+
+/**
+ * TempoMap - Sorted tempo markers with cumulative beat and bar prefix sums
+ * Each segment stores where it starts in seconds, beats and bars, so a
+ * conversion is a binary search plus a closed-form step inside one
+ * segment (a quadratic for linear ramps). Beats are quarter notes; bars
+ * count from 0 at time 0, and a time signature change that falls inside
+ * a bar starts a new one. Immutable once built, so the audio thread can
+ * share one through a shared_ptr while the UI builds the next.
+ *
+ * Sequential readers (playback, grid drawing) use a Cursor, which checks
+ * the segment it used last and its neighbour before searching.
+ */
+class TempoMap {
+public:
+    explicit TempoMap(double bpm = 120.0, int timeSigNumerator = 4, int timeSigDenominator = 4);
+    explicit TempoMap(const std::vector<TempoMarker>& markers);
+
+    // A map whose first marker is after 0 holds that tempo from 0; the first
+    // segment defaults to 4/4 if it names no time signature
+    void SetMarkers(const std::vector<TempoMarker>& markers);
+    const std::vector<TempoMarker>& GetMarkers() const { return m_markers; }
+    size_t GetMarkerCount() const { return m_markers.size(); }
+
+    // Conversions - O(log n)
+    double TimeToBeats(double seconds) const;
+    double BeatsToTime(double beats) const;
+    double GetTempoAt(double seconds) const;
+    TimeSignature GetTimeSignatureAt(double seconds) const;
+    TempoPosition GetPosition(double seconds) const;
+
+    // Bars - measure is 0-based, beatInBar counts time signature beats from 0
+    void BeatsToMeasure(double beats, int& measure, double& beatInBar, TimeSignature* timeSig = nullptr) const;
+    double MeasureToBeats(int measure) const;
+    TimeSignature GetTimeSignatureAtMeasure(int measure) const;
+
+    /**
+     * Cursor - O(1) conversions for queries that move forward in small steps
+     * Holds a plain pointer; the owner keeps the map alive.
+     */
+    class Cursor {
+    public:
+        explicit Cursor(const TempoMap* map = nullptr) : m_map(map) {}
+
+        void SetMap(const TempoMap* map) { m_map = map; m_segment = 0; }
+        const TempoMap* GetMap() const { return m_map; }
+
+        double TimeToBeats(double seconds);
+        double BeatsToTime(double beats);
+        TempoPosition GetPosition(double seconds);
+
+    private:
+        const TempoMap* m_map;
+        size_t m_segment = 0;
+    };
+
+private:
+    struct Segment {
+        double time = 0.0;          // Start, seconds
+        double beats = 0.0;         // Start, quarter notes
+        double measure = 0.0;       // Start, bars (whole where the time signature changes)
+        double startBpm = 120.0;
+        double slope = 0.0;         // BPM per second (ramps only)
+        int timeSigNumerator = 4;
+        int timeSigDenominator = 4;
+
+        double QuarterNotesPerBar() const { return timeSigNumerator * 4.0 / timeSigDenominator; }
+    };
+
+    std::vector<TempoMarker> m_markers;
+    std::vector<Segment> m_segments;    // One per marker
+
+    void Build();
+
+    size_t FindByTime(double seconds) const;
+    size_t FindByBeats(double beats) const;
+    size_t FindByMeasure(double measure) const;
+
+    // Hinted lookups: the hint and the segment after it are tried first
+    size_t FindByTime(double seconds, size_t hint) const;
+    size_t FindByBeats(double beats, size_t hint) const;
+
+    static double SegmentBeats(const Segment& segment, double seconds);
+    static double SegmentTime(const Segment& segment, double beats);
+    static TempoPosition SegmentPosition(const Segment& segment, double seconds);
+};
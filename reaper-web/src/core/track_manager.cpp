@@ -6,8 +6,12 @@
 #include "track_manager.hpp"
 #include "audio_engine.hpp"
 #include "../effects/effect_chain.hpp"
+#include "../recording/track_recorder.hpp"
 #include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -16,6 +20,7 @@
 TrackManager::TrackManager() {
     // Reserve capacity for tracks
     m_tracks.reserve(128);
+    m_recordingEngine = std::make_unique<RecordingEngine>();
 }
 
 TrackManager::~TrackManager() {
@@ -259,7 +264,9 @@ void TrackManager::SetTrackSolo(Track* track, bool solo) {
     
     std::lock_guard<std::mutex> lock(m_soloMutex);
     
-    track->SetSolo(solo);
+    // Set the state directly: Track::SetSolo calls back into here
+    ++track->m_revision;
+    track->m_state.solo = solo;
     
     auto it = std::find(m_soloedTracks.begin(), m_soloedTracks.end(), track);
     
@@ -280,7 +287,8 @@ void TrackManager::ClearAllSolo() {
     std::lock_guard<std::mutex> lock(m_soloMutex);
     
     for (Track* track : m_soloedTracks) {
-        track->SetSolo(false);
+        ++track->m_revision;
+        track->m_state.solo = false;
     }
     
     m_soloedTracks.clear();
@@ -292,22 +300,132 @@ void TrackManager::ProcessAllTracks(AudioBuffer& masterBuffer) {
     // Implementation depends on the specific audio routing architecture
 }
 
-void TrackManager::StartRecording() {
-    m_isRecording = true;
+TrackManager::TrackStats TrackManager::GetTrackStats(Track* track) const {
+    TrackStats stats;
+    if (!track) return stats;
+    
+    stats.cpuUsage = track->GetCpuMeter().GetAverage() * 100.0;
+    stats.peakCpuUsage = track->GetCpuMeter().GetPeak() * 100.0;
+    stats.isProcessing = track->m_isProcessing.load();
     
-    // Get list of armed tracks
+    EffectChain* chain = track->GetEffectsChain();
+    if (chain && !chain->IsBypassed()) {
+        for (size_t i = 0; i < chain->GetEffectCount(); ++i) {
+            const JSFXEffect* effect = chain->GetEffect(i);
+            if (effect && !effect->IsBypassed()) {
+                stats.activePlugins++;
+            }
+        }
+    }
+    
+    return stats;
+}
+
+double TrackManager::GetTotalCpuUsage() const {
     std::lock_guard<std::mutex> lock(m_tracksMutex);
-    m_armedTracks.clear();
     
-    for (auto& track : m_tracks) {
-        if (track->IsRecordArmed()) {
-            m_armedTracks.push_back(track.get());
+    double total = 0.0;
+    for (const auto& track : m_tracks) {
+        total += track->GetCpuMeter().GetAverage();
+    }
+    return total * 100.0;
+}
+
+std::vector<TrackManager::EffectStats> TrackManager::GetEffectStats() const {
+    std::vector<EffectStats> stats;
+    
+    // The meters are atomics; only the chains' structure needs the track lock
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        for (size_t t = 0; t < m_tracks.size(); ++t) {
+            EffectChain* chain = m_tracks[t]->GetEffectsChain();
+            if (!chain) continue;
+            
+            for (size_t e = 0; e < chain->GetEffectCount(); ++e) {
+                const JSFXEffect* effect = chain->GetEffect(e);
+                if (!effect) continue;
+                
+                EffectStats effectStats;
+                effectStats.trackIndex = static_cast<int>(t);
+                effectStats.effectIndex = static_cast<int>(e);
+                effectStats.name = effect->GetName();
+                effectStats.cpuUsage = effect->GetCpuUsage();
+                effectStats.peakCpuUsage = effect->GetPeakCpuUsage();
+                stats.push_back(std::move(effectStats));
+            }
         }
     }
+    
+    std::sort(stats.begin(), stats.end(), [](const EffectStats& a, const EffectStats& b) {
+        return a.cpuUsage > b.cpuUsage;
+    });
+    return stats;
 }
 
-void TrackManager::StopRecording() {
+bool TrackManager::StartRecording(const std::string& directory, double sampleRate,
+                                  AudioFileWriter::SampleFormat format, bool dither) {
+    std::vector<RecordingEngine::TrackInput> inputs;
+    
+    // Get list of armed tracks and where each records from
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        m_armedTracks.clear();
+        
+        for (size_t i = 0; i < m_tracks.size(); ++i) {
+            Track* track = m_tracks[i].get();
+            if (!track->IsRecordArmed()) continue;
+            m_armedTracks.push_back(track);
+            
+            RecordingEngine::TrackInput input;
+            input.track = track;
+            DecodeInputChannel(track->GetInputChannel(), input.firstInput, input.numChannels);
+            input.filePath = MakeRecordingPath(directory, static_cast<int>(i) + 1, track);
+            inputs.push_back(std::move(input));
+        }
+    }
+    
+    if (inputs.empty() || !m_recordingEngine->Start(inputs, sampleRate, format, dither)) {
+        return false;
+    }
+    
+    m_isRecording = true;
+    return true;
+}
+
+bool TrackManager::StopRecording() {
     m_isRecording = false;
+    return m_recordingEngine ? m_recordingEngine->Stop() : true;
+}
+
+void TrackManager::CaptureInput(float** inputs, int numInputs, int numSamples, int64_t startSample) {
+    m_recordingEngine->Capture(inputs, numInputs, numSamples, startSample);
+}
+
+void TrackManager::DecodeInputChannel(int inputChannel, int& firstInput, int& numChannels) {
+    const bool stereo = inputChannel >= STEREO_INPUT_FLAG;
+    firstInput = std::max(0, stereo ? inputChannel - STEREO_INPUT_FLAG : inputChannel);
+    numChannels = stereo ? 2 : 1;
+}
+
+std::string TrackManager::MakeRecordingPath(const std::string& directory, int trackNumber, const Track* track) const {
+    // REAPER-style "<track number>-<track name>-<take>.wav"; never overwrites
+    std::string name = track->GetName();
+    std::replace_if(name.begin(), name.end(), [](char c) {
+        return !std::isalnum(static_cast<unsigned char>(c)) && c != ' ' && c != '-' && c != '_';
+    }, '_');
+    
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    
+    for (int take = 1;; ++take) {
+        std::ostringstream fileName;
+        fileName << std::setfill('0') << std::setw(2) << trackNumber << '-' << name << '-'
+                 << std::setw(3) << take << ".wav";
+        std::filesystem::path path = std::filesystem::path(directory) / fileName.str();
+        if (!std::filesystem::exists(path, error)) {
+            return path.string();
+        }
+    }
 }
 
 std::vector<Track*> TrackManager::GetArmedTracks() const {
@@ -371,22 +489,27 @@ Track::~Track() {
 }
 
 void Track::SetName(const std::string& name) {
+    ++m_revision;
     m_state.name = name;
 }
 
 void Track::SetVolume(double volume) {
+    ++m_revision;
     m_state.volume = std::clamp(volume, 0.0, 4.0); // 0 to +12dB
 }
 
 void Track::SetPan(double pan) {
+    ++m_revision;
     m_state.pan = std::clamp(pan, -1.0, 1.0);
 }
 
 void Track::SetMute(bool mute) {
+    ++m_revision;
     m_state.mute = mute;
 }
 
 void Track::SetSolo(bool solo) {
+    ++m_revision;
     m_state.solo = solo;
     
     // Notify track manager
@@ -396,43 +519,53 @@ void Track::SetSolo(bool solo) {
 }
 
 void Track::SetRecordArm(bool armed) {
+    ++m_revision;
     m_state.recordArm = armed;
 }
 
 void Track::SetInputMonitor(bool monitor) {
+    ++m_revision;
     m_state.inputMonitor = monitor;
 }
 
 void Track::SetInputChannel(int channel) {
+    ++m_revision;
     m_state.inputChannel = channel;
 }
 
 void Track::SetOutputChannel(int channel) {
+    ++m_revision;
     m_state.outputChannel = channel;
 }
 
 void Track::SetColor(const std::string& color) {
+    ++m_revision;
     m_state.color = color;
 }
 
 void Track::SetFolder(bool isFolder, int depth) {
+    ++m_revision;
     m_state.isFolder = isFolder;
     m_state.folderDepth = depth;
 }
 
 void Track::SetFolderOpen(bool open) {
+    ++m_revision;
     m_state.folderOpen = open;
 }
 
-void Track::ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer) {
+void Track::ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer, double timePosition,
+                         const TempoPosition* tempo) {
     // Copy input to output
-    outputBuffer.CopyFrom(inputBuffer);
+    if (&inputBuffer != &outputBuffer) {
+        outputBuffer.CopyFrom(inputBuffer);
+    }
     
     // Apply volume and pan
-    ApplyVolumeAndPan(outputBuffer);
+    ApplyVolumeAndPan(outputBuffer, timePosition);
     
     // Process effects chain
-    ProcessEffects(outputBuffer);
+    ProcessEffects(outputBuffer, timePosition, tempo);
     
     // Apply mute
     if (m_state.mute) {
@@ -441,10 +574,12 @@ void Track::ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer) {
 }
 
 void Track::SetState(const TrackState& state) {
+    ++m_revision;
     m_state = state;
 }
 
 void Track::SetFreeze(bool freeze) {
+    ++m_revision;
     m_state.freeze = freeze;
 }
 
@@ -455,6 +590,11 @@ EffectChain* Track::GetEffectsChain() const {
     return nullptr;
 }
 
+int Track::GetLatencySamples() const {
+    EffectChain* chain = GetEffectsChain();
+    return chain ? chain->GetLatencySamples() : 0;
+}
+
 std::string Track::GenerateGUID() const {
     // Generate a REAPER-style GUID
     std::random_device rd;
@@ -489,37 +629,71 @@ std::string Track::GenerateGUID() const {
     return ss.str();
 }
 
-void Track::ApplyVolumeAndPan(AudioBuffer& buffer) {
-    if (!buffer.isValid) return;
+void Track::ApplyVolumeAndPan(AudioBuffer& buffer, double timePosition) {
+    const int numSamples = buffer.GetSampleCount();
+    const int numChannels = buffer.GetChannelCount();
+    if (numSamples <= 0 || numChannels <= 0) return;
     
-    // Apply volume
     float volume = static_cast<float>(m_state.volume);
-    if (volume != 1.0f) {
-        for (int ch = 0; ch < buffer.numChannels; ++ch) {
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[ch][i] *= volume;
-            }
+    double pan = m_state.pan;
+    bool volumeRamp = false;
+    bool panRamp = false;
+    
+    // Envelopes that are flat over the block fold into the static gains
+    if (!m_volumeEnvelope.IsEmpty()) {
+        if (m_volumeRamp.size() < static_cast<size_t>(numSamples)) {
+            m_volumeRamp.resize(numSamples);
+        }
+        double value = 1.0;
+        volumeRamp = m_volumeEnvelope.RenderBlock(timePosition, buffer.GetSampleRate(), numSamples,
+                                                  m_volumeRamp.data(), value);
+        if (!volumeRamp) {
+            volume *= static_cast<float>(value);
+        }
+    }
+    if (numChannels >= 2 && !m_panEnvelope.IsEmpty()) {
+        if (m_panRamp.size() < static_cast<size_t>(numSamples)) {
+            m_panRamp.resize(numSamples);
+        }
+        double value = 0.0;
+        panRamp = m_panEnvelope.RenderBlock(timePosition, buffer.GetSampleRate(), numSamples,
+                                            m_panRamp.data(), value);
+        if (!panRamp) {
+            pan = std::clamp(value, -1.0, 1.0);
         }
     }
     
+    // Apply volume
+    if (volumeRamp) {
+        for (int i = 0; i < numSamples; ++i) {
+            m_volumeRamp[i] *= volume;
+        }
+        buffer.ApplyGainCurve(m_volumeRamp.data(), 0, numSamples);
+    } else if (volume != 1.0f) {
+        buffer.ApplyGain(volume);
+    }
+    
     // Apply pan (for stereo tracks)
-    if (buffer.numChannels >= 2 && m_state.pan != 0.0) {
-        float pan = static_cast<float>(m_state.pan);
-        float leftGain = std::sqrt((1.0f - pan) * 0.5f);
-        float rightGain = std::sqrt((1.0f + pan) * 0.5f);
-        
-        for (int i = 0; i < buffer.numSamples; ++i) {
-            buffer.channels[0][i] *= leftGain;
-            buffer.channels[1][i] *= rightGain;
+    if (panRamp) {
+        float* left = buffer.GetChannelData(0);
+        float* right = buffer.GetChannelData(1);
+        for (int i = 0; i < numSamples; ++i) {
+            float p = std::clamp(m_panRamp[i], -1.0f, 1.0f);
+            left[i] *= std::sqrt((1.0f - p) * 0.5f);
+            right[i] *= std::sqrt((1.0f + p) * 0.5f);
         }
+    } else if (numChannels >= 2 && pan != 0.0) {
+        float leftGain = std::sqrt((1.0f - static_cast<float>(pan)) * 0.5f);
+        float rightGain = std::sqrt((1.0f + static_cast<float>(pan)) * 0.5f);
+        
+        buffer.ApplyChannelGain(0, leftGain);
+        buffer.ApplyChannelGain(1, rightGain);
     }
 }
 
-void Track::ProcessEffects(AudioBuffer& buffer) {
+void Track::ProcessEffects(AudioBuffer& buffer, double timePosition, const TempoPosition* tempo) {
     // Process through effects processor
     if (m_effectProcessor) {
-        // Get current time position from manager or audio engine
-        double timePosition = 0.0; // TODO: Get actual time position
-        m_effectProcessor->ProcessTrackAudio(buffer, timePosition);
+        m_effectProcessor->ProcessTrackAudio(buffer, timePosition, tempo);
     }
 }
\ No newline at end of file
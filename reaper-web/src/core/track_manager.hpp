@@ -11,13 +11,20 @@
 #include <string>
 #include <atomic>
 #include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include "automation_envelope.hpp"
+#include "cpu_meter.hpp"
+#include "../recording/audio_file_writer.hpp"
 
 // Forward declarations
 class AudioEngine;
 class Track;
 class EffectChain;
+struct TempoPosition;
 class TrackEffectProcessor;
 class AudioBuffer;
+class RecordingEngine;
 
 /**
  * Track Manager - coordinates all tracks and audio routing
@@ -30,7 +37,7 @@ public:
         FOLDER,
         MASTER
     };
-
+    
     struct TrackSettings {
         TrackType type = TrackType::AUDIO;
         std::string name;
@@ -40,7 +47,7 @@ public:
         bool solo = false;
         bool recordArm = false;
         bool inputMonitor = false;
-        int inputChannel = 0;       // Input channel selection
+        int inputChannel = 0;       // Input channel selection (STEREO_INPUT_FLAG + n = inputs n, n+1)
         std::string color = "#808080"; // Track color
         
         // Folder track specific
@@ -52,13 +59,18 @@ public:
         bool phase = false;         // Phase invert
     };
 
+    // REAPER's record input encoding: below the flag a mono input, at or
+    // above it a stereo pair starting at (inputChannel - flag)
+    static constexpr int STEREO_INPUT_FLAG = 1024;
+    static void DecodeInputChannel(int inputChannel, int& firstInput, int& numChannels);
+
 public:
     TrackManager();
     ~TrackManager();
-
+    
     bool Initialize(AudioEngine* audioEngine);
     void Shutdown();
-
+    
     // Track creation and management
     Track* CreateTrack(const std::string& name = "", TrackType type = TrackType::AUDIO);
     Track* CreateFolderTrack(const std::string& name = "");
@@ -107,15 +119,24 @@ public:
     bool UnfreezeTrack(Track* track);
     bool IsTrackFrozen(Track* track) const;
     
-    // Performance monitoring
+    // Performance monitoring - CPU figures are percent of real time, read lock-free
     struct TrackStats {
-        double cpuUsage = 0.0;
+        double cpuUsage = 0.0;          // Decayed average of items, FX and mix
+        double peakCpuUsage = 0.0;      // Decayed peak
         int activePlugins = 0;
         bool isProcessing = false;
         double peakLevel = 0.0;
     };
+    struct EffectStats {
+        int trackIndex = -1;
+        int effectIndex = -1;
+        std::string name;
+        double cpuUsage = 0.0;
+        double peakCpuUsage = 0.0;
+    };
     TrackStats GetTrackStats(Track* track) const;
     double GetTotalCpuUsage() const;
+    std::vector<EffectStats> GetEffectStats() const;   // Every effect, most expensive first
     
     // Track I/O configuration
     void SetTrackInput(Track* track, int inputChannel);
@@ -123,11 +144,16 @@ public:
     void SetTrackRecordArm(Track* track, bool armed);
     void SetTrackInputMonitor(Track* track, bool monitor);
     
-    // Recording
-    void StartRecording();
-    void StopRecording();
+    // Recording - every armed track records its input to a new file in directory
+    bool StartRecording(const std::string& directory, double sampleRate,
+                        AudioFileWriter::SampleFormat format = AudioFileWriter::SampleFormat::FLOAT_32, bool dither = false);
+    bool StopRecording();               // Finalises the files; false if any failed to write
     bool IsRecording() const { return m_isRecording.load(); }
     std::vector<Track*> GetArmedTracks() const;
+    RecordingEngine* GetRecordingEngine() const { return m_recordingEngine.get(); }
+    
+    // Audio thread - hands the device inputs to the armed tracks' recorders
+    void CaptureInput(float** inputs, int numInputs, int numSamples, int64_t startSample);
 
 private:
     AudioEngine* m_audioEngine = nullptr;
@@ -148,10 +174,7 @@ private:
     // Recording state
     std::atomic<bool> m_isRecording{false};
     std::vector<Track*> m_armedTracks;
-    
-    // Performance tracking
-    mutable std::mutex m_statsMutex;
-    std::unordered_map<Track*, TrackStats> m_trackStats;
+    std::unique_ptr<RecordingEngine> m_recordingEngine;
     
     // Thread safety
     mutable std::mutex m_tracksMutex;
@@ -166,6 +189,9 @@ private:
     void UpdateFolderStructure();
     int CalculateFolderDepth(Track* track) const;
     
+    // Recording helpers
+    std::string MakeRecordingPath(const std::string& directory, int trackNumber, const Track* track) const;
+    
     // Template system
     std::string GetTrackTemplateDirectory() const;
     bool SaveTrackState(Track* track, const std::string& filePath);
@@ -200,10 +226,10 @@ public:
         int folderDepth = 0;
         bool folderOpen = true;
     };
-
+    
     explicit Track(TrackManager* manager, const std::string& name = "");
     ~Track();
-
+    
     // Basic properties
     void SetName(const std::string& name);
     const std::string& GetName() const { return m_state.name; }
@@ -236,6 +262,7 @@ public:
     // Effects chain
     EffectChain* GetEffectsChain() const;
     TrackEffectProcessor* GetEffectProcessor() const { return m_effectProcessor.get(); }
+    int GetLatencySamples() const;     // Plugin delay of the active FX
     
     // Visual properties
     void SetColor(const std::string& color);
@@ -248,22 +275,37 @@ public:
     void SetFolderOpen(bool open);
     bool IsFolderOpen() const { return m_state.folderOpen; }
     
-    // Processing
-    void ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer);
+    // Automation (volume multiplies the fader; pan replaces it while present)
+    AutomationEnvelope& GetVolumeEnvelope() { return m_volumeEnvelope; }
+    AutomationEnvelope& GetPanEnvelope() { return m_panEnvelope; }
+    
+    // Processing (input and output may be the same buffer)
+    void ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer, double timePosition = 0.0,
+                      const TempoPosition* tempo = nullptr);
     
     // State management
     const TrackState& GetState() const { return m_state; }
     void SetState(const TrackState& state);
+    uint64_t GetRevision() const { return m_revision; }    // Bumped by every state change
     
     // Performance
     void SetFreeze(bool freeze);
     bool IsFrozen() const { return m_state.freeze; }
+    CpuMeter& GetCpuMeter() { return m_cpuMeter; }          // Fed by the audio engine each block
+    const CpuMeter& GetCpuMeter() const { return m_cpuMeter; }
 
 private:
     TrackManager* m_manager;
     TrackState m_state;
+    uint64_t m_revision = 0;
     std::unique_ptr<TrackEffectProcessor> m_effectProcessor;
     
+    // Automation
+    AutomationEnvelope m_volumeEnvelope;
+    AutomationEnvelope m_panEnvelope;
+    std::vector<float> m_volumeRamp;        // Per-sample values for the current block
+    std::vector<float> m_panRamp;
+    
     // Audio buffers for processing
     std::unique_ptr<AudioBuffer> m_inputBuffer;
     std::unique_ptr<AudioBuffer> m_outputBuffer;
@@ -271,11 +313,12 @@ private:
     // Performance monitoring
     mutable std::mutex m_processingMutex;
     std::atomic<bool> m_isProcessing{false};
+    CpuMeter m_cpuMeter;
     
     // GUID generation
     std::string GenerateGUID() const;
     
     // Internal processing helpers
-    void ApplyVolumeAndPan(AudioBuffer& buffer);
-    void ProcessEffects(AudioBuffer& buffer);
+    void ApplyVolumeAndPan(AudioBuffer& buffer, double timePosition);
+    void ProcessEffects(AudioBuffer& buffer, double timePosition, const TempoPosition* tempo);
 };
\ No newline at end of file
@@ -0,0 +1,560 @@
+/*
+ * REAPER Web - Undo Manager Implementation
+ * Path-copying snapshot capture, minimal restore, merging and delta compression
+ */
+
+#include "undo_manager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+namespace {
+
+using ItemNodePtr = std::shared_ptr<const ProjectSnapshot::ItemNode>;
+using TrackNodePtr = std::shared_ptr<const ProjectSnapshot::TrackNode>;
+
+// Heap bytes of a string beyond the small-string buffer
+size_t StringBytes(const std::string& str) {
+    return str.capacity() > 15 ? str.capacity() + 1 : 0;
+}
+
+size_t TrackStateBytes(const Track::TrackState& state) {
+    return sizeof(state) + StringBytes(state.name) + StringBytes(state.guid) + StringBytes(state.color);
+}
+
+size_t ItemNodeBytes(const ProjectSnapshot::ItemNode& node) {
+    const MediaItem::ItemState& state = node.state;
+    size_t bytes = sizeof(node) + StringBytes(state.guid) + StringBytes(state.name) + StringBytes(state.color);
+    bytes += state.takes.capacity() * sizeof(MediaItem::Take);
+    bytes += state.compRegions.capacity() * sizeof(MediaItem::CompRegion);
+    for (const auto& take : state.takes) {
+        bytes += StringBytes(take.guid) + StringBytes(take.name) + StringBytes(take.color);
+        bytes += take.stretchMarkers.capacity() * sizeof(MediaItem::Take::StretchMarker);
+    }
+    return bytes;
+}
+
+size_t TrackNodeBytes(const ProjectSnapshot::TrackNode& node) {
+    return sizeof(node) + node.items.capacity() * sizeof(ItemNodePtr);
+}
+
+size_t SnapshotRootBytes(const ProjectSnapshot& snapshot) {
+    return sizeof(snapshot) + snapshot.tracks.capacity() * sizeof(TrackNodePtr);
+}
+
+bool SameMaster(const ProjectSnapshot::MasterState& a, const ProjectSnapshot::MasterState& b) {
+    return a.volume == b.volume && a.pan == b.pan && a.mute == b.mute && a.tempo == b.tempo &&
+           a.timeSigNumerator == b.timeSigNumerator && a.timeSigDenominator == b.timeSigDenominator &&
+           a.tempoMap == b.tempoMap;
+}
+
+} // anonymous namespace
+
+UndoManager::UndoManager() = default;
+
+UndoManager::~UndoManager() = default;
+
+bool UndoManager::Initialize(TrackManager* trackManager, MediaItemManager* mediaItemManager) {
+    if (!trackManager || !mediaItemManager) {
+        return false;
+    }
+    
+    m_trackManager = trackManager;
+    m_mediaItemManager = mediaItemManager;
+    return true;
+}
+
+void UndoManager::SetMaxLevels(int levels) {
+    m_maxLevels = std::max(1, levels);
+    
+    while (m_history.size() > static_cast<size_t>(m_maxLevels) + 1 && m_position > 0) {
+        PopOldest();
+    }
+}
+
+void UndoManager::SetMemoryBudget(size_t bytes) {
+    m_memoryBudget = bytes;
+    EnforceMemoryBudget();
+}
+
+void UndoManager::Reset(const ProjectSnapshot::MasterState& master) {
+    m_history.clear();
+    m_itemNodes.clear();
+    m_trackNodes.clear();
+    
+    Entry baseline;
+    baseline.description = "Initial state";
+    baseline.timestamp = GetTimestamp();
+    baseline.snapshot = Capture(master);
+    
+    m_history.push_back(std::move(baseline));
+    m_position = 0;
+    m_memoryEstimate = m_captureBytes;
+}
+
+void UndoManager::Commit(const std::string& description, const ProjectSnapshot::MasterState& master,
+                         const std::string& mergeKey) {
+    if (m_history.empty()) {
+        Reset(master);
+    }
+    
+    auto snapshot = Capture(master);
+    
+    // Nothing changed since the current entry
+    const ProjectSnapshot& current = *m_history[m_position].snapshot;
+    if (snapshot->tracks == current.tracks && SameMaster(snapshot->master, current.master)) {
+        return;
+    }
+    
+    const double now = GetTimestamp();
+    const bool atEnd = m_position + 1 == m_history.size();
+    
+    // A new edit discards the redo branch
+    m_history.erase(m_history.begin() + m_position + 1, m_history.end());
+    
+    // Repeated edits of the same target fold into the newest entry
+    Entry& last = m_history.back();
+    if (!mergeKey.empty() && atEnd && m_position > 0 && last.mergeKey == mergeKey &&
+        now - last.timestamp <= m_mergeWindowMs) {
+        last.snapshot = std::move(snapshot);
+        last.timestamp = now;
+    } else {
+        Entry entry;
+        entry.description = description;
+        entry.mergeKey = mergeKey;
+        entry.timestamp = now;
+        entry.snapshot = std::move(snapshot);
+        
+        m_history.push_back(std::move(entry));
+        m_position = m_history.size() - 1;
+        
+        if (m_history.size() > static_cast<size_t>(m_maxLevels) + 1) {
+            PopOldest();
+        }
+    }
+    
+    m_memoryEstimate += m_captureBytes;
+    EnforceMemoryBudget();
+}
+
+const ProjectSnapshot* UndoManager::Undo() {
+    if (!CanUndo()) {
+        return nullptr;
+    }
+    
+    --m_position;
+    auto snapshot = Materialize(m_position);
+    Restore(*snapshot);
+    return snapshot.get();
+}
+
+const ProjectSnapshot* UndoManager::Redo() {
+    if (!CanRedo()) {
+        return nullptr;
+    }
+    
+    ++m_position;
+    auto snapshot = Materialize(m_position);
+    Restore(*snapshot);
+    return snapshot.get();
+}
+
+std::string UndoManager::GetUndoDescription() const {
+    return CanUndo() ? m_history[m_position].description : std::string();
+}
+
+std::string UndoManager::GetRedoDescription() const {
+    return CanRedo() ? m_history[m_position + 1].description : std::string();
+}
+
+const ProjectSnapshot* UndoManager::GetCurrentSnapshot() const {
+    return m_history.empty() ? nullptr : m_history[m_position].snapshot.get();
+}
+
+UndoManager::MemoryUsage UndoManager::GetMemoryUsage() const {
+    MemoryUsage usage;
+    usage.budgetBytes = m_memoryBudget;
+    usage.entries = static_cast<int>(m_history.size());
+    
+    // Count every node once however many entries share it
+    std::unordered_set<const void*> seen;
+    size_t total = 0;
+    
+    auto countState = [&](const std::shared_ptr<const Track::TrackState>& state) {
+        if (seen.insert(state.get()).second) total += TrackStateBytes(*state);
+    };
+    auto countItem = [&](const ItemNodePtr& item) {
+        if (seen.insert(item.get()).second) total += ItemNodeBytes(*item);
+    };
+    
+    for (const Entry& entry : m_history) {
+        total += sizeof(Entry) + StringBytes(entry.description) + StringBytes(entry.mergeKey);
+        
+        if (entry.snapshot) {
+            if (!seen.insert(entry.snapshot.get()).second) continue;
+            total += SnapshotRootBytes(*entry.snapshot);
+            
+            for (const auto& track : entry.snapshot->tracks) {
+                if (!seen.insert(track.get()).second) continue;
+                total += TrackNodeBytes(*track);
+                countState(track->state);
+                for (const auto& item : track->items) {
+                    countItem(item);
+                }
+            }
+        } else if (entry.delta) {
+            ++usage.compressedEntries;
+            if (!seen.insert(entry.delta.get()).second) continue;
+            total += sizeof(SnapshotDelta) + entry.delta->tracks.capacity() * sizeof(SnapshotDelta::TrackChange);
+            
+            for (const auto& change : entry.delta->tracks) {
+                total += change.items.capacity() * sizeof(change.items[0]);
+                countState(change.state);
+                for (const auto& item : change.items) {
+                    countItem(item.second);
+                }
+            }
+        }
+    }
+    
+    usage.totalBytes = total;
+    return usage;
+}
+
+std::shared_ptr<const ProjectSnapshot> UndoManager::Capture(const ProjectSnapshot::MasterState& master) {
+    auto snapshot = std::make_shared<ProjectSnapshot>();
+    snapshot->master = master;
+    ++m_generation;
+    
+    const int trackCount = m_trackManager->GetTrackCount();
+    snapshot->tracks.reserve(trackCount);
+    m_captureBytes = SnapshotRootBytes(*snapshot);
+    
+    // Bucket items by track in one pass, keeping manager order within a track
+    m_trackIndices.clear();
+    for (int t = 0; t < trackCount; ++t) {
+        m_trackIndices[m_trackManager->GetTrack(t)] = t;
+    }
+    if (m_trackItems.size() < static_cast<size_t>(trackCount)) {
+        m_trackItems.resize(trackCount);
+    }
+    for (int t = 0; t < trackCount; ++t) {
+        m_trackItems[t].clear();
+    }
+    for (int i = 0; i < m_mediaItemManager->GetItemCount(); ++i) {
+        MediaItem* item = m_mediaItemManager->GetItem(i);
+        auto it = m_trackIndices.find(item->GetTrack());
+        if (it != m_trackIndices.end()) {
+            m_trackItems[it->second].push_back(item);
+        }
+    }
+    
+    std::vector<std::shared_ptr<const ProjectSnapshot::ItemNode>> items;
+    
+    for (int t = 0; t < trackCount; ++t) {
+        Track* track = m_trackManager->GetTrack(t);
+        if (!track) continue;
+        
+        // Unchanged items keep their node; edited ones get a fresh copy
+        items.clear();
+        items.reserve(m_trackItems[t].size());
+        
+        for (MediaItem* item : m_trackItems[t]) {
+            CachedItem& cached = m_itemNodes[item->GetGUID()];
+            if (!cached.node || cached.revision != item->GetRevision()) {
+                auto node = std::make_shared<ProjectSnapshot::ItemNode>();
+                node->state = item->GetState();
+                m_captureBytes += ItemNodeBytes(*node);
+                cached.node = std::move(node);
+                cached.revision = item->GetRevision();
+            }
+            cached.generation = m_generation;
+            items.push_back(cached.node);
+        }
+        
+        // The track node is reused only if its state and item list are both unchanged
+        CachedTrack& cached = m_trackNodes[track->GetGUID()];
+        if (!cached.node || cached.revision != track->GetRevision() || cached.node->items != items) {
+            auto node = std::make_shared<ProjectSnapshot::TrackNode>();
+            if (cached.node && cached.revision == track->GetRevision()) {
+                node->state = cached.node->state;
+            } else {
+                node->state = std::make_shared<Track::TrackState>(track->GetState());
+                m_captureBytes += TrackStateBytes(*node->state);
+            }
+            node->items = items;
+            m_captureBytes += TrackNodeBytes(*node);
+            cached.node = std::move(node);
+            cached.revision = track->GetRevision();
+        }
+        cached.generation = m_generation;
+        snapshot->tracks.push_back(cached.node);
+    }
+    
+    SweepCache();
+    return snapshot;
+}
+
+void UndoManager::Restore(const ProjectSnapshot& snapshot) {
+    ++m_generation;
+    
+    // Index the live project
+    std::unordered_map<std::string, Track*> liveTracks;
+    for (int t = 0; t < m_trackManager->GetTrackCount(); ++t) {
+        if (Track* track = m_trackManager->GetTrack(t)) {
+            liveTracks[track->GetGUID()] = track;
+        }
+    }
+    
+    std::unordered_map<std::string, MediaItem*> liveItems;
+    for (int i = 0; i < m_mediaItemManager->GetItemCount(); ++i) {
+        MediaItem* item = m_mediaItemManager->GetItem(i);
+        liveItems[item->GetGUID()] = item;
+    }
+    
+    // Items and tracks the snapshot no longer has
+    std::unordered_map<std::string, const ProjectSnapshot::TrackNode*> targetTracks;
+    std::unordered_map<std::string, bool> targetItems;
+    for (const auto& trackNode : snapshot.tracks) {
+        targetTracks[trackNode->state->guid] = trackNode.get();
+        for (const auto& itemNode : trackNode->items) {
+            targetItems[itemNode->state.guid] = true;
+        }
+    }
+    
+    for (auto it = liveItems.begin(); it != liveItems.end();) {
+        if (!targetItems.count(it->first) && it->second->GetTrack()) {
+            m_mediaItemManager->DeleteItem(it->second);
+            it = liveItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // Tracks - create missing ones and restore changed state
+    std::vector<Track*> order;
+    order.reserve(snapshot.tracks.size());
+    
+    for (const auto& trackNode : snapshot.tracks) {
+        auto liveIt = liveTracks.find(trackNode->state->guid);
+        Track* track = liveIt != liveTracks.end() ? liveIt->second : nullptr;
+        if (!track) {
+            track = m_trackManager->CreateTrack(trackNode->state->name);
+        }
+        
+        // Edits made since the last undo point also count as different
+        CachedTrack& cached = m_trackNodes[trackNode->state->guid];
+        if (liveIt == liveTracks.end() || cached.node != trackNode || cached.revision != track->GetRevision()) {
+            track->SetState(*trackNode->state);
+        }
+        
+        // Items - only nodes that differ from what is live are written back
+        for (const auto& itemNode : trackNode->items) {
+            auto itemIt = liveItems.find(itemNode->state.guid);
+            MediaItem* item = itemIt != liveItems.end() ? itemIt->second : nullptr;
+            bool created = false;
+            if (!item) {
+                item = m_mediaItemManager->CreateEmptyItem(track, itemNode->state.position, itemNode->state.length);
+                created = true;
+            }
+            
+            CachedItem& cachedItem = m_itemNodes[itemNode->state.guid];
+            if (created || cachedItem.node != itemNode || cachedItem.revision != item->GetRevision()) {
+                // Selection is view state and stays as it is
+                bool selected = item->IsSelected();
+                item->SetState(itemNode->state);
+                if (!created) {
+                    item->SetSelected(selected);
+                }
+            }
+            item->SetTrack(track);
+            
+            cachedItem.node = itemNode;
+            cachedItem.revision = item->GetRevision();
+            cachedItem.generation = m_generation;
+        }
+        
+        cached.node = trackNode;
+        cached.revision = track->GetRevision();
+        cached.generation = m_generation;
+        order.push_back(track);
+    }
+    
+    // Remove tracks the snapshot does not have; their items are already gone or moved
+    for (const auto& entry : liveTracks) {
+        if (!targetTracks.count(entry.first)) {
+            m_trackManager->DeleteTrack(entry.second);
+        }
+    }
+    
+    // Restore track order
+    for (size_t i = 0; i < order.size(); ++i) {
+        int current = m_trackManager->GetTrackIndex(order[i]);
+        if (current > static_cast<int>(i)) {
+            m_trackManager->MoveTrack(current, static_cast<int>(i));
+        }
+    }
+    
+    SweepCache();
+}
+
+void UndoManager::SweepCache() {
+    // Entries not seen in the last capture/restore belong to deleted objects
+    for (auto it = m_itemNodes.begin(); it != m_itemNodes.end();) {
+        it = it->second.generation != m_generation ? m_itemNodes.erase(it) : std::next(it);
+    }
+    for (auto it = m_trackNodes.begin(); it != m_trackNodes.end();) {
+        it = it->second.generation != m_generation ? m_trackNodes.erase(it) : std::next(it);
+    }
+}
+
+void UndoManager::PopOldest() {
+    // Frees only the nodes no later entry shares; a compressed successor
+    // stays valid because deltas point toward newer entries
+    m_history.pop_front();
+    --m_position;
+}
+
+void UndoManager::EnforceMemoryBudget() {
+    if (m_memoryEstimate <= m_memoryBudget) {
+        return;
+    }
+    
+    m_memoryEstimate = GetMemoryUsage().totalBytes;
+    
+    // Oldest first, re-measuring after each pass because shared nodes make
+    // the savings per entry an estimate. The entry before the cursor stays
+    // whole so the next undo never has to rebuild it.
+    size_t next = 0;
+    while (m_memoryEstimate > m_memoryBudget) {
+        const size_t excess = m_memoryEstimate - m_memoryBudget;
+        size_t freed = 0;
+        bool compressed = false;
+        
+        for (; next + 1 < m_position && freed < excess; ++next) {
+            Entry& entry = m_history[next];
+            if (!entry.snapshot) continue;
+            
+            auto newer = Reconstruct(next + 1);
+            auto delta = MakeDelta(*entry.snapshot, *newer);
+            
+            // The root and the track nodes the newer entry does not share
+            freed += SnapshotRootBytes(*entry.snapshot);
+            for (const auto& change : delta->tracks) {
+                freed += TrackNodeBytes(*entry.snapshot->tracks[change.index]);
+            }
+            
+            entry.delta = std::move(delta);
+            entry.snapshot.reset();
+            compressed = true;
+        }
+        
+        if (!compressed) break;
+        m_memoryEstimate = GetMemoryUsage().totalBytes;
+    }
+}
+
+std::shared_ptr<const ProjectSnapshot> UndoManager::Reconstruct(size_t index) const {
+    // Walk to the nearest whole entry, then apply deltas back down to index
+    size_t full = index;
+    while (!m_history[full].snapshot) {
+        ++full;
+    }
+    
+    auto snapshot = m_history[full].snapshot;
+    while (full > index) {
+        --full;
+        snapshot = ApplyDelta(*m_history[full].delta, *snapshot);
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const ProjectSnapshot> UndoManager::Materialize(size_t index) {
+    Entry& entry = m_history[index];
+    if (!entry.snapshot) {
+        // Older deltas stay valid: they describe changes from this entry's content
+        entry.snapshot = Reconstruct(index);
+        m_memoryEstimate += SnapshotRootBytes(*entry.snapshot) +
+                            entry.delta->tracks.size() * sizeof(ProjectSnapshot::TrackNode);
+        entry.delta.reset();
+    }
+    return entry.snapshot;
+}
+
+std::shared_ptr<const SnapshotDelta> UndoManager::MakeDelta(const ProjectSnapshot& older, const ProjectSnapshot& newer) {
+    auto delta = std::make_shared<SnapshotDelta>();
+    delta->trackCount = static_cast<int>(older.tracks.size());
+    delta->master = older.master;
+    
+    std::unordered_map<std::string, const ProjectSnapshot::TrackNode*> newerTracks;
+    for (const auto& track : newer.tracks) {
+        newerTracks[track->state->guid] = track.get();
+    }
+    
+    for (size_t i = 0; i < older.tracks.size(); ++i) {
+        const TrackNodePtr& track = older.tracks[i];
+        if (i < newer.tracks.size() && newer.tracks[i] == track) continue;
+        
+        SnapshotDelta::TrackChange change;
+        change.index = static_cast<int>(i);
+        change.state = track->state;
+        change.itemCount = static_cast<int>(track->items.size());
+        
+        // Item slots are compared against the same track in the newer entry
+        auto it = newerTracks.find(track->state->guid);
+        const ProjectSnapshot::TrackNode* base = it != newerTracks.end() ? it->second : nullptr;
+        for (size_t j = 0; j < track->items.size(); ++j) {
+            if (!base || j >= base->items.size() || base->items[j] != track->items[j]) {
+                change.items.emplace_back(static_cast<int>(j), track->items[j]);
+            }
+        }
+        
+        delta->tracks.push_back(std::move(change));
+    }
+    
+    return delta;
+}
+
+std::shared_ptr<const ProjectSnapshot> UndoManager::ApplyDelta(const SnapshotDelta& delta, const ProjectSnapshot& newer) {
+    auto snapshot = std::make_shared<ProjectSnapshot>();
+    snapshot->master = delta.master;
+    
+    // Positions without a change share the newer entry's node
+    const size_t shared = std::min(static_cast<size_t>(delta.trackCount), newer.tracks.size());
+    snapshot->tracks.assign(newer.tracks.begin(), newer.tracks.begin() + shared);
+    snapshot->tracks.resize(delta.trackCount);
+    
+    if (delta.tracks.empty()) {
+        return snapshot;
+    }
+    
+    std::unordered_map<std::string, const ProjectSnapshot::TrackNode*> newerTracks;
+    for (const auto& track : newer.tracks) {
+        newerTracks[track->state->guid] = track.get();
+    }
+    
+    for (const auto& change : delta.tracks) {
+        auto node = std::make_shared<ProjectSnapshot::TrackNode>();
+        node->state = change.state;
+        
+        auto it = newerTracks.find(change.state->guid);
+        if (it != newerTracks.end()) {
+            const auto& baseItems = it->second->items;
+            const size_t count = std::min(static_cast<size_t>(change.itemCount), baseItems.size());
+            node->items.assign(baseItems.begin(), baseItems.begin() + count);
+        }
+        node->items.resize(change.itemCount);
+        for (const auto& item : change.items) {
+            node->items[item.first] = item.second;
+        }
+        
+        snapshot->tracks[change.index] = std::move(node);
+    }
+    
+    return snapshot;
+}
+
+double UndoManager::GetTimestamp() {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,173 @@
+/*
+ * REAPER Web - Undo Manager
+ * Undo history of immutable project snapshots with structural sharing
+ * Based on REAPER's undo model (every undo point is a full project state)
+ */
+
+#pragma once
+
+#include "track_manager.hpp"
+#include "tempo_map.hpp"
+#include "../media/media_item.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * ProjectSnapshot - Immutable undoable state of the whole project
+ * Tracks and items are shared, never-modified nodes. A new snapshot reuses
+ * every node whose live object is unchanged since the last capture, so an
+ * edit copies only the path to what it touched (item -> its track -> root).
+ */
+struct ProjectSnapshot {
+    struct ItemNode {
+        MediaItem::ItemState state;
+    };
+
+    struct TrackNode {
+        std::shared_ptr<const Track::TrackState> state;    // Shared while the track is unchanged
+        std::vector<std::shared_ptr<const ItemNode>> items;
+    };
+
+    struct MasterState {
+        double volume = 1.0;
+        double pan = 0.0;
+        bool mute = false;
+        double tempo = 120.0;
+        int timeSigNumerator = 4;
+        int timeSigDenominator = 4;
+        std::shared_ptr<const TempoMap> tempoMap;   // Immutable; shared until the next tempo edit
+    };
+
+    std::vector<std::shared_ptr<const TrackNode>> tracks;   // Project track order
+    MasterState master;
+};
+
+/**
+ * SnapshotDelta - An old snapshot stored as its differences from the next
+ * newer entry. Only track positions whose node differs are kept; for those,
+ * only the item slots that differ from the newer track with the same GUID.
+ */
+struct SnapshotDelta {
+    struct TrackChange {
+        int index = 0;                  // Position in the older snapshot
+        std::shared_ptr<const Track::TrackState> state;
+        int itemCount = 0;
+        std::vector<std::pair<int, std::shared_ptr<const ProjectSnapshot::ItemNode>>> items;
+    };
+
+    int trackCount = 0;
+    std::vector<TrackChange> tracks;
+    ProjectSnapshot::MasterState master;
+};
+
+/**
+ * UndoManager - Linear history of project snapshots
+ * Entry 0 is the baseline; every later entry is the state after an edit.
+ * Undo and redo move the cursor and push the target snapshot into the live
+ * project, touching only tracks and items whose nodes differ from it.
+ *
+ * Commits carrying the same merge key within the merge window replace the
+ * newest entry instead of adding one (a fader drag is a single undo point).
+ * Once the history outgrows its memory budget the oldest entries are
+ * delta-compressed; undoing into one rebuilds it from the newer entries.
+ */
+class UndoManager {
+public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+    static constexpr double DEFAULT_MERGE_WINDOW_MS = 1000.0;
+
+    struct Entry {
+        std::string description;
+        std::string mergeKey;           // Empty = never merged
+        double timestamp = 0.0;         // Milliseconds (steady clock) of the last merged edit
+        std::shared_ptr<const ProjectSnapshot> snapshot;    // Null while compressed
+        std::shared_ptr<const SnapshotDelta> delta;         // Set while compressed
+    };
+
+    struct MemoryUsage {
+        size_t totalBytes = 0;          // Distinct nodes and deltas held by the history
+        size_t budgetBytes = 0;
+        int entries = 0;
+        int compressedEntries = 0;
+    };
+
+public:
+    UndoManager();
+    ~UndoManager();
+
+    bool Initialize(TrackManager* trackManager, MediaItemManager* mediaItemManager);
+    void SetMaxLevels(int levels);
+    int GetMaxLevels() const { return m_maxLevels; }
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return m_memoryBudget; }
+    void SetMergeWindow(double milliseconds) { m_mergeWindowMs = milliseconds; }
+    double GetMergeWindow() const { return m_mergeWindowMs; }
+
+    // History
+    void Reset(const ProjectSnapshot::MasterState& master);    // Live project becomes the baseline
+    void Commit(const std::string& description, const ProjectSnapshot::MasterState& master,
+                const std::string& mergeKey = "");     // No entry if nothing changed
+    const ProjectSnapshot* Undo();      // Restored snapshot (caller applies master), or nullptr
+    const ProjectSnapshot* Redo();
+
+    // Queries
+    bool CanUndo() const { return m_position > 0; }
+    bool CanRedo() const { return m_position + 1 < m_history.size(); }
+    std::string GetUndoDescription() const;
+    std::string GetRedoDescription() const;
+    int GetHistorySize() const { return static_cast<int>(m_history.size()); }
+    const ProjectSnapshot* GetCurrentSnapshot() const;
+    MemoryUsage GetMemoryUsage() const;
+
+private:
+    // Node last captured or restored for each live object (by GUID). A live
+    // revision equal to the cached one means the node still describes it.
+    struct CachedItem {
+        uint64_t revision = 0;
+        uint64_t generation = 0;
+        std::shared_ptr<const ProjectSnapshot::ItemNode> node;
+    };
+    struct CachedTrack {
+        uint64_t revision = 0;
+        uint64_t generation = 0;
+        std::shared_ptr<const ProjectSnapshot::TrackNode> node;
+    };
+
+    TrackManager* m_trackManager = nullptr;
+    MediaItemManager* m_mediaItemManager = nullptr;
+
+    // History
+    std::deque<Entry> m_history;
+    size_t m_position = 0;              // Entry matching the live project
+    int m_maxLevels = 1000;
+    double m_mergeWindowMs = DEFAULT_MERGE_WINDOW_MS;
+
+    // Memory
+    size_t m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+    size_t m_memoryEstimate = 0;        // Exact after a recount, then grows by captured nodes
+    size_t m_captureBytes = 0;          // Bytes of nodes the last capture allocated
+
+    // Capture cache
+    std::unordered_map<std::string, CachedItem> m_itemNodes;
+    std::unordered_map<std::string, CachedTrack> m_trackNodes;
+    uint64_t m_generation = 0;
+    std::unordered_map<Track*, int> m_trackIndices;
+    std::vector<std::vector<MediaItem*>> m_trackItems;     // Per track, reused between captures
+
+    // Internal methods
+    std::shared_ptr<const ProjectSnapshot> Capture(const ProjectSnapshot::MasterState& master);
+    void Restore(const ProjectSnapshot& snapshot);
+    void SweepCache();
+    void PopOldest();
+    void EnforceMemoryBudget();
+    std::shared_ptr<const ProjectSnapshot> Reconstruct(size_t index) const;
+    std::shared_ptr<const ProjectSnapshot> Materialize(size_t index);
+    static std::shared_ptr<const SnapshotDelta> MakeDelta(const ProjectSnapshot& older, const ProjectSnapshot& newer);
+    static std::shared_ptr<const ProjectSnapshot> ApplyDelta(const SnapshotDelta& delta, const ProjectSnapshot& newer);
+    static double GetTimestamp();
+};
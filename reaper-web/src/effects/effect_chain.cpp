@@ -4,6 +4,7 @@
  */
 
 #include "effect_chain.hpp"
+#include "../core/cpu_meter.hpp"
 #include <algorithm>
 
 // EffectChain Implementation
@@ -55,11 +56,23 @@ void EffectChain::ProcessAudio(AudioBuffer& buffer) {
         return;
     }
     
-    // Process each effect in sequence
-    for (auto& effect : m_effects) {
-        if (effect && !effect->IsBypassed()) {
-            effect->ProcessBuffer(buffer);
+    // Process each effect in sequence, one cycle-counter pair per effect per block
+    const int numSamples = buffer.GetSampleCount();
+    const double sampleRate = buffer.GetSampleRate();
+    for (size_t i = 0; i < m_effects.size(); ++i) {
+        JSFXEffect* effect = m_effects[i].get();
+        if (!effect) continue;
+        
+        uint64_t ticks = 0;
+        if (!effect->IsBypassed()) {
+            ProfileScope effectScope(Profiler::Category::EFFECT, effect->GetName().c_str(), static_cast<int>(i));
+            const uint64_t startTicks = CycleClock::Now();
+            effect->ProcessBlock(buffer);
+            ticks = CycleClock::Now() - startTicks;
         }
+        
+        // A bypassed effect costs nothing and its meter falls accordingly
+        effect->GetCpuMeter().AddBlock(ticks, numSamples, sampleRate);
     }
 }
 
@@ -71,7 +84,7 @@ void EffectChain::ProcessSample(double& left, double& right) {
     // Process each effect in sequence
     for (auto& effect : m_effects) {
         if (effect && !effect->IsBypassed()) {
-            effect->ProcessSample(left, right);
+            effect->ProcessSample(left, right, left, right);
         }
     }
 }
@@ -92,7 +105,7 @@ const JSFXEffect* EffectChain::GetEffect(size_t index) const {
 
 void EffectChain::SetEffectBypass(size_t index, bool bypass) {
     if (index < m_effects.size()) {
-        m_effects[index]->SetBypass(bypass);
+        m_effects[index]->SetBypassed(bypass);
     }
 }
 
@@ -103,11 +116,34 @@ bool EffectChain::IsEffectBypassed(size_t index) const {
     return false;
 }
 
-void EffectChain::UpdateAutomation(double timePosition) {
-    // Update automation for all effects
+int EffectChain::GetLatencySamples() const {
+    if (m_bypass) {
+        return 0;
+    }
+    
+    // Effects in series delay the signal by the sum of their delays
+    int latency = 0;
+    for (const auto& effect : m_effects) {
+        if (effect && !effect->IsBypassed()) {
+            latency += effect->GetLatencySamples();
+        }
+    }
+    return latency;
+}
+
+void EffectChain::UpdateAutomation(double timePosition, int numSamples) {
+    // Render each effect's parameter ramps for the coming block
     for (auto& effect : m_effects) {
         if (effect) {
-            effect->UpdateAutomation(timePosition);
+            effect->UpdateAutomation(timePosition, numSamples);
+        }
+    }
+}
+
+void EffectChain::SetTempoPosition(const TempoPosition& position) {
+    for (auto& effect : m_effects) {
+        if (effect) {
+            effect->SetTempoPosition(position);
         }
     }
 }
@@ -143,26 +179,29 @@ bool TrackEffectProcessor::AddBuiltinEffect(const std::string& effectName) {
     return true;
 }
 
-void TrackEffectProcessor::ProcessTrackAudio(AudioBuffer& buffer, double timePosition) {
+void TrackEffectProcessor::ProcessTrackAudio(AudioBuffer& buffer, double timePosition, const TempoPosition* tempo) {
     if (!m_effectChain) {
         return;
     }
     
-    // Update automation before processing
-    m_effectChain->UpdateAutomation(timePosition);
+    // Update transport and automation before processing
+    if (tempo) {
+        m_effectChain->SetTempoPosition(*tempo);
+    }
+    m_effectChain->UpdateAutomation(timePosition, buffer.GetSampleCount());
     
     // Process through effect chain
     m_effectChain->ProcessAudio(buffer);
 }
 
 void TrackEffectProcessor::SetSendLevel(int sendIndex, double level) {
-    if (sendIndex >= 0 && sendIndex < m_sendLevels.size()) {
+    if (sendIndex >= 0 && sendIndex < static_cast<int>(m_sendLevels.size())) {
         m_sendLevels[sendIndex] = level;
     }
 }
 
 double TrackEffectProcessor::GetSendLevel(int sendIndex) const {
-    if (sendIndex >= 0 && sendIndex < m_sendLevels.size()) {
+    if (sendIndex >= 0 && sendIndex < static_cast<int>(m_sendLevels.size())) {
         return m_sendLevels[sendIndex];
     }
     return 0.0;
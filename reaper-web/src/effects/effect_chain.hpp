@@ -7,7 +7,7 @@
 
 #include "../jsfx/jsfx_interpreter.hpp"
 #include "reaper_effects.hpp"
-#include "../audio/audio_buffer.hpp"
+#include "../core/audio_buffer.hpp"
 #include <vector>
 #include <memory>
 
@@ -43,9 +43,13 @@ public:
     void SetEffectBypass(size_t index, bool bypass);
     bool IsEffectBypassed(size_t index) const;
     
-    // Automation
-    void UpdateAutomation(double timePosition);
+    // Plugin delay of the active effects, in samples
+    int GetLatencySamples() const;
     
+    // Automation
+    void UpdateAutomation(double timePosition, int numSamples);   // Before ProcessAudio() for the same block
+    void SetTempoPosition(const TempoPosition& position);
+
 private:
     std::vector<std::unique_ptr<JSFXEffect>> m_effects;
     bool m_bypass = false;
@@ -69,12 +73,12 @@ public:
     bool AddBuiltinEffect(const std::string& effectName);
     
     // Processing
-    void ProcessTrackAudio(AudioBuffer& buffer, double timePosition);
+    void ProcessTrackAudio(AudioBuffer& buffer, double timePosition, const TempoPosition* tempo = nullptr);
     
     // Send/Return support (for future implementation)
     void SetSendLevel(int sendIndex, double level);
     double GetSendLevel(int sendIndex) const;
-    
+
 private:
     std::unique_ptr<EffectChain> m_effectChain;
     std::shared_ptr<BuiltinEffectsManager> m_builtinManager;
@@ -31,7 +31,7 @@ std::unique_ptr<JSFXEffect> BuiltinEffectsManager::CreateEffect(const std::strin
     
     // Create JSFX effect from script
     auto effect = std::make_unique<JSFXEffect>();
-    if (!effect->LoadFromScript(it->second)) {
+    if (!effect->LoadEffect(it->second)) {
         return nullptr;
     }
     
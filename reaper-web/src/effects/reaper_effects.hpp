@@ -6,6 +6,7 @@
 #pragma once
 
 #include "../jsfx/jsfx_interpreter.hpp"
+#include <map>
 #include <memory>
 #include <vector>
 #include <string>
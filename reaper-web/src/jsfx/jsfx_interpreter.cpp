@@ -5,6 +5,7 @@
 
 #include "jsfx_interpreter.hpp"
 #include "../core/audio_buffer.hpp"
+#include "../core/tempo_map.hpp"
 #include <cmath>
 #include <algorithm>
 #include <chrono>
@@ -197,8 +198,8 @@ JSFXToken JSFXLexer::NextToken() {
         return ReadString();
     }
     
-    // Identifiers and keywords
-    if (IsAlpha(c) || c == '_' || c == '@') {
+    // Identifiers and keywords ($pi and friends are constants)
+    if (IsAlpha(c) || c == '_' || c == '@' || c == '$') {
         m_position--; // Back up to re-read the character
         return ReadIdentifier();
     }
@@ -259,7 +260,10 @@ JSFXToken JSFXLexer::ReadNumber() {
     
     while (m_position < m_source.length()) {
         char c = m_source[m_position];
-        if (IsDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        // A sign only belongs to the number right after an exponent: 1-x is a subtraction
+        bool exponentSign = (c == '+' || c == '-') && !number.empty() &&
+                            (number.back() == 'e' || number.back() == 'E');
+        if (IsDigit(c) || c == '.' || c == 'e' || c == 'E' || exponentSign) {
             number += GetChar();
         } else {
             break;
@@ -302,7 +306,7 @@ JSFXToken JSFXLexer::ReadIdentifier() {
     
     while (m_position < m_source.length()) {
         char c = m_source[m_position];
-        if (IsAlphaNumeric(c) || c == '_' || c == '@') {
+        if (IsAlphaNumeric(c) || c == '_' || c == '@' || c == '$') {
             identifier += GetChar();
         } else {
             break;
@@ -389,6 +393,12 @@ void JSFXParser::Expect(JSFXTokenType type) {
 std::unique_ptr<JSFXNode> JSFXParser::ParseProgram() {
     auto program = std::make_unique<JSFXNode>(JSFXNodeType::PROGRAM);
     
+    // Header lines (desc:, sliderN:, pins) are read by ParseScriptHeader; code starts at the first section
+    while (m_currentToken.type != JSFXTokenType::END_OF_FILE &&
+           !(m_currentToken.type == JSFXTokenType::IDENTIFIER && m_currentToken.value[0] == '@')) {
+        Consume();
+    }
+    
     while (m_currentToken.type != JSFXTokenType::END_OF_FILE) {
         if (m_currentToken.type == JSFXTokenType::IDENTIFIER && 
             m_currentToken.value[0] == '@') {
@@ -424,7 +434,13 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseStatement() {
     }
     
     // Try to parse as assignment or expression
-    return ParseExpression();
+    auto statement = ParseExpression();
+    
+    if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ";") {
+        Consume();
+    }
+    
+    return statement;
 }
 
 std::unique_ptr<JSFXNode> JSFXParser::ParseExpression() {
@@ -448,33 +464,56 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseAssignment() {
         return assignment;
     }
     
+    // Conditional: cond ? then [: else], executed as an if
+    if (m_currentToken.type == JSFXTokenType::OPERATOR && m_currentToken.value == "?") {
+        auto conditional = std::make_unique<JSFXNode>(JSFXNodeType::IF_STATEMENT);
+        Consume();
+        
+        conditional->AddChild(std::move(left));
+        conditional->AddChild(ParseAssignment());
+        
+        if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ":") {
+            Consume();
+            conditional->AddChild(ParseAssignment());
+        }
+        
+        return conditional;
+    }
+    
     return left;
 }
 
-std::unique_ptr<JSFXNode> JSFXParser::ParseBinaryOp() {
+std::unique_ptr<JSFXNode> JSFXParser::ParseBinaryOp(int minPrecedence) {
     auto left = ParseUnaryOp();
     
     while (m_currentToken.type == JSFXTokenType::OPERATOR) {
         std::string op = m_currentToken.value;
-        if (op == "+" || op == "-" || op == "*" || op == "/" || 
-            op == "==" || op == "!=" || op == "<" || op == ">" ||
-            op == "<=" || op == ">=" || op == "&&" || op == "||") {
-            
-            auto binaryOp = std::make_unique<JSFXNode>(JSFXNodeType::BINARY_OP, op);
-            Consume();
-            
-            binaryOp->AddChild(std::move(left));
-            binaryOp->AddChild(ParseUnaryOp());
-            
-            left = std::move(binaryOp);
-        } else {
-            break;
-        }
+        int precedence = GetBinaryPrecedence(op);
+        if (precedence < minPrecedence) break;
+        
+        auto binaryOp = std::make_unique<JSFXNode>(JSFXNodeType::BINARY_OP, op);
+        Consume();
+        
+        // Left associative: the right operand only takes tighter operators
+        binaryOp->AddChild(std::move(left));
+        binaryOp->AddChild(ParseBinaryOp(precedence + 1));
+        
+        left = std::move(binaryOp);
     }
     
     return left;
 }
 
+int JSFXParser::GetBinaryPrecedence(const std::string& op) {
+    if (op == "*" || op == "/") return 5;
+    if (op == "+" || op == "-") return 4;
+    if (op == "<" || op == ">" || op == "<=" || op == ">=") return 3;
+    if (op == "==" || op == "!=") return 2;
+    if (op == "&&") return 1;
+    if (op == "||") return 0;
+    return -1; // Not a binary operator
+}
+
 std::unique_ptr<JSFXNode> JSFXParser::ParseUnaryOp() {
     if (m_currentToken.type == JSFXTokenType::OPERATOR && 
         (m_currentToken.value == "-" || m_currentToken.value == "!" || m_currentToken.value == "+")) {
@@ -489,14 +528,14 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseUnaryOp() {
     return ParsePrimary();
 }
 
-std::unique_ptr<JSFXNode> JSFXParser::ParseFunctionCall() {
-    auto functionCall = std::make_unique<JSFXNode>(JSFXNodeType::FUNCTION_CALL, m_currentToken.value);
-    Consume(); // Consume function name
+std::unique_ptr<JSFXNode> JSFXParser::ParseFunctionCall(const std::string& name) {
+    auto functionCall = std::make_unique<JSFXNode>(JSFXNodeType::FUNCTION_CALL, name);
     
     Expect(JSFXTokenType::PUNCTUATION); // '('
     
     // Parse arguments
     while (m_currentToken.type != JSFXTokenType::PUNCTUATION || m_currentToken.value != ")") {
+        if (m_currentToken.type == JSFXTokenType::END_OF_FILE) break;
         functionCall->AddChild(ParseExpression());
         
         if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ",") {
@@ -528,9 +567,7 @@ std::unique_ptr<JSFXNode> JSFXParser::ParsePrimary() {
         
         // Check for function call
         if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == "(") {
-            m_currentToken.value = name; // Restore name for function call parsing
-            m_currentToken.type = JSFXTokenType::IDENTIFIER;
-            return ParseFunctionCall();
+            return ParseFunctionCall(name);
         }
         
         // Check for array access
@@ -553,7 +590,10 @@ std::unique_ptr<JSFXNode> JSFXParser::ParsePrimary() {
         return expr;
     }
     
-    // Error - return dummy node
+    // Error - skip the token so parsing always advances, and return a dummy node
+    if (m_currentToken.type != JSFXTokenType::END_OF_FILE) {
+        Consume();
+    }
     return std::make_unique<JSFXNode>(JSFXNodeType::NUMBER, "0");
 }
 
@@ -729,19 +769,12 @@ void JSFXInterpreter::ExecuteSample(double inputL, double inputR, double& output
     m_context.spl0 = inputL;
     m_context.spl1 = inputR;
     
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    // Execute @sample section
+    // Execute @sample section (timed per block by the caller, not per sample)
     ExecuteNode(m_sampleSection);
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    
     // Get output samples
     outputL = m_context.spl0;
     outputR = m_context.spl1;
-    
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    UpdateCpuUsage(duration.count() / 1000.0);
 }
 
 void JSFXInterpreter::ExecuteBlock(AudioBuffer& buffer) {
@@ -775,6 +808,12 @@ void JSFXInterpreter::SetParameter(int index, double value) {
     }
 }
 
+void JSFXInterpreter::SetSliderValue(int index, double value) {
+    if (index >= 0 && index < static_cast<int>(m_context.slider.size())) {
+        m_context.slider[index] = value;
+    }
+}
+
 double JSFXInterpreter::GetParameter(int index) const {
     if (index >= 0 && index < static_cast<int>(m_context.slider.size())) {
         return m_context.slider[index];
@@ -802,31 +841,31 @@ double JSFXInterpreter::ExecuteNode(JSFXNode* node) {
         
         case JSFXNodeType::ASSIGNMENT:
             return ExecuteAssignment(node);
-            
+        
         case JSFXNodeType::BINARY_OP:
             return ExecuteBinaryOp(node);
-            
+        
         case JSFXNodeType::UNARY_OP:
             return ExecuteUnaryOp(node);
-            
+        
         case JSFXNodeType::FUNCTION_CALL:
             return ExecuteFunctionCall(node);
-            
+        
         case JSFXNodeType::VARIABLE:
             return ExecuteVariable(node);
-            
+        
         case JSFXNodeType::NUMBER:
             return ExecuteNumber(node);
-            
+        
         case JSFXNodeType::ARRAY_ACCESS:
             return ExecuteArrayAccess(node);
-            
+        
         case JSFXNodeType::IF_STATEMENT:
             return ExecuteIfStatement(node);
-            
+        
         case JSFXNodeType::WHILE_LOOP:
             return ExecuteWhileLoop(node);
-            
+        
         default:
             return 0.0;
     }
@@ -840,25 +879,31 @@ double JSFXInterpreter::ExecuteAssignment(JSFXNode* node) {
     // Get the left-hand side variable
     JSFXNode* lhs = node->children[0].get();
     if (lhs->type == JSFXNodeType::VARIABLE) {
-        std::string varName = lhs->value;
+        const std::string& varName = lhs->value;
+        
+        // Globals such as spl0 write straight to the context, where ExecuteSample reads them back
+        double* builtin = GetBuiltinVariable(varName);
+        double current = builtin ? *builtin : m_context.GetVariable(varName).GetValue();
         
         if (node->value == "=") {
-            m_context.SetVariable(varName, value);
+            current = value;
         } else if (node->value == "+=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current + value);
+            current += value;
         } else if (node->value == "-=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current - value);
+            current -= value;
         } else if (node->value == "*=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current * value);
+            current *= value;
         } else if (node->value == "/=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current / value);
+            current /= value;
         }
         
-        return value;
+        if (builtin) {
+            *builtin = current;
+        } else {
+            m_context.SetVariable(varName, current);
+        }
+        
+        return current;
     }
     
     return 0.0;
@@ -909,20 +954,40 @@ double JSFXInterpreter::ExecuteFunctionCall(JSFXNode* node) {
 
 double JSFXInterpreter::ExecuteVariable(JSFXNode* node) {
     // Handle special built-in variables
-    if (node->value == "spl0") return m_context.spl0;
-    if (node->value == "spl1") return m_context.spl1;
-    if (node->value == "srate") return m_context.srate;
-    if (node->value == "tempo") return m_context.tempo;
-    
-    // Handle slider variables
-    if (node->value.substr(0, 6) == "slider") {
-        int sliderNum = std::stoi(node->value.substr(6)) - 1;
+    if (double* builtin = GetBuiltinVariable(node->value)) {
+        return *builtin;
+    }
+    
+    // Constants
+    if (node->value == "$pi") return M_PI;
+    if (node->value == "$e") return M_E;
+    
+    return m_context.GetVariable(node->value).GetValue();
+}
+
+double* JSFXInterpreter::GetBuiltinVariable(const std::string& name) {
+    if (name == "spl0") return &m_context.spl0;
+    if (name == "spl1") return &m_context.spl1;
+    if (name == "spl2") return &m_context.spl2;
+    if (name == "spl3") return &m_context.spl3;
+    if (name == "srate") return &m_context.srate;
+    if (name == "tempo") return &m_context.tempo;
+    if (name == "beat_position") return &m_context.beat_position;
+    if (name == "ts_num") return &m_context.ts_num;
+    if (name == "ts_denom") return &m_context.ts_denom;
+    if (name == "play_state") return &m_context.play_state;
+    if (name == "ext_tail_size") return &m_context.ext_tail_size;
+    
+    // Handle slider variables (slider1 is slider[0])
+    if (name.size() > 6 && name.compare(0, 6, "slider") == 0 &&
+        std::all_of(name.begin() + 6, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        int sliderNum = std::stoi(name.substr(6)) - 1;
         if (sliderNum >= 0 && sliderNum < static_cast<int>(m_context.slider.size())) {
-            return m_context.slider[sliderNum];
+            return &m_context.slider[sliderNum];
         }
     }
     
-    return m_context.GetVariable(node->value).GetValue();
+    return nullptr;
 }
 
 double JSFXInterpreter::ExecuteNumber(JSFXNode* node) {
@@ -1075,8 +1140,14 @@ bool JSFXEffect::LoadEffectFromFile(const std::string& filename) {
 
 void JSFXEffect::Initialize(double sampleRate, int maxBlockSize) {
     m_sampleRate = sampleRate;
+    m_maxBlockSize = maxBlockSize;
+    for (auto& automation : m_parameterAutomation) {
+        automation.ramp.reserve(static_cast<size_t>(std::max(maxBlockSize, 0)));
+    }
     m_interpreter->GetContext().srate = sampleRate;
     m_interpreter->ExecuteInit();
+    m_interpreter->ExecuteSlider(); // Like REAPER, @slider follows @init so the slider defaults apply
+    UpdateLatency();
     m_initialized = true;
 }
 
@@ -1099,49 +1170,121 @@ void JSFXEffect::ProcessBlock(AudioBuffer& buffer) {
         return;
     }
     
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    UpdateAutomation();
-    m_interpreter->ExecuteBlock(buffer);
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    
-    // Update CPU usage
-    const double alpha = 0.1;
-    double currentUsage = duration.count() / 1000.0; // Convert to milliseconds
-    m_averageCpuUsage = alpha * currentUsage + (1.0 - alpha) * m_averageCpuUsage;
+    if (m_hasRamps) {
+        ProcessAutomatedBlock(buffer);
+        m_hasRamps = false;
+    } else {
+        m_interpreter->ExecuteBlock(buffer);
+    }
 }
 
 void JSFXEffect::SetParameter(int index, double value) {
     m_interpreter->SetParameter(index, value);
+    UpdateLatency();
 }
 
 double JSFXEffect::GetParameter(int index) const {
     return m_interpreter->GetParameter(index);
 }
 
-void JSFXEffect::SetParameterAutomation(int index, const std::vector<double>& values) {
+void JSFXEffect::SetParameterEnvelope(int index, const AutomationEnvelope& envelope) {
+    if (index < 0 || index >= static_cast<int>(m_interpreter->GetContext().slider.size())) {
+        return;
+    }
+    
+    if (index >= static_cast<int>(m_parameterAutomation.size())) {
+        m_parameterAutomation.resize(static_cast<size_t>(index) + 1);
+    }
+    
+    auto& automation = m_parameterAutomation[index];
+    automation.envelope = envelope;
+    automation.envelope.ResetCursor();
+    automation.ramp.reserve(static_cast<size_t>(std::max(m_maxBlockSize, 0)));
+}
+
+AutomationEnvelope* JSFXEffect::GetParameterEnvelope(int index) {
     if (index >= 0 && index < static_cast<int>(m_parameterAutomation.size())) {
-        m_parameterAutomation[index].values = values;
-        m_parameterAutomation[index].currentIndex = 0;
+        return &m_parameterAutomation[index].envelope;
+    }
+    return nullptr;
+}
+
+void JSFXEffect::UpdateAutomation(double timePosition, int numSamples) {
+    m_hasRamps = false;
+    
+    for (size_t i = 0; i < m_parameterAutomation.size(); ++i) {
+        auto& automation = m_parameterAutomation[i];
+        automation.ramping = false;
+        if (automation.envelope.IsEmpty()) {
+            continue;
+        }
+        
+        if (automation.ramp.size() < static_cast<size_t>(numSamples)) {
+            automation.ramp.resize(static_cast<size_t>(numSamples));
+        }
+        
+        double value = 0.0;
+        automation.ramping = automation.envelope.RenderBlock(timePosition, m_sampleRate, numSamples,
+                                                             automation.ramp.data(), value);
+        if (automation.ramping) {
+            m_hasRamps = true;
+        } else if (value != GetParameter(static_cast<int>(i))) {
+            // Flat over the block: a single update, no per-sample work
+            SetParameter(static_cast<int>(i), value);
+        }
     }
 }
 
+void JSFXEffect::SetTempoPosition(const TempoPosition& position) {
+    JSFXContext& context = m_interpreter->GetContext();
+    context.tempo = position.bpm;
+    context.beat_position = position.beats;
+    context.ts_num = position.timeSigNumerator;
+    context.ts_denom = position.timeSigDenominator;
+}
+
 const JSFXInterpreter::ScriptInfo& JSFXEffect::GetInfo() const {
     return m_interpreter->GetScriptInfo();
 }
 
 double JSFXEffect::GetCpuUsage() const {
-    return m_averageCpuUsage;
+    return m_cpuMeter.GetAverage() * 100.0;
 }
 
-void JSFXEffect::UpdateAutomation() {
-    for (size_t i = 0; i < m_parameterAutomation.size(); ++i) {
-        auto& automation = m_parameterAutomation[i];
-        if (!automation.values.empty() && automation.currentIndex < automation.values.size()) {
-            SetParameter(static_cast<int>(i), automation.values[automation.currentIndex]);
-            automation.currentIndex++;
+double JSFXEffect::GetPeakCpuUsage() const {
+    return m_cpuMeter.GetPeak() * 100.0;
+}
+
+void JSFXEffect::UpdateLatency() {
+    // Scripts report their delay in pdc_delay from @init or @slider; read it
+    // here, off the per-sample path, since a named lookup may allocate
+    double delay = m_interpreter->GetContext().GetVariable("pdc_delay");
+    m_latencySamples = std::max(0, static_cast<int>(delay));
+}
+
+void JSFXEffect::ProcessAutomatedBlock(AudioBuffer& buffer) {
+    int numSamples = buffer.GetSampleCount();
+    int numChannels = buffer.GetChannelCount();
+    float* left = (numChannels > 0) ? buffer.GetChannelData(0) : nullptr;
+    float* right = (numChannels > 1) ? buffer.GetChannelData(1) : nullptr;
+    
+    for (int i = 0; i < numSamples; ++i) {
+        for (size_t p = 0; p < m_parameterAutomation.size(); ++p) {
+            if (m_parameterAutomation[p].ramping) {
+                m_interpreter->SetSliderValue(static_cast<int>(p), m_parameterAutomation[p].ramp[i]);
+            }
+        }
+        if (i % SLIDER_UPDATE_INTERVAL == 0) {
+            m_interpreter->ExecuteSlider();
         }
+        
+        double inputL = left ? left[i] : 0.0;
+        double inputR = right ? right[i] : inputL;
+        
+        double outputL, outputR;
+        m_interpreter->ExecuteSample(inputL, inputR, outputL, outputR);
+        
+        if (left) left[i] = static_cast<float>(outputL);
+        if (right) right[i] = static_cast<float>(outputR);
     }
-}
\ No newline at end of file
+}
@@ -12,9 +12,12 @@
 #include <unordered_map>
 #include <functional>
 #include <stack>
+#include "../core/automation_envelope.hpp"
+#include "../core/cpu_meter.hpp"
 
 // Forward declarations
 class AudioBuffer;
+struct TempoPosition;
 
 /**
  * JSFX Variable - Dynamic type system like REAPER's JSFX
@@ -91,7 +94,7 @@ public:
     // Memory management
     void Clear();
     void Reset();
-    
+
 private:
     std::vector<JSFXVariable> m_memory;
     std::unordered_map<std::string, int> m_namedVariables;
@@ -169,7 +172,7 @@ public:
     JSFXToken NextToken();
     JSFXToken PeekToken();
     bool HasMoreTokens() const;
-    
+
 private:
     std::string m_source;
     size_t m_position;
@@ -229,7 +232,7 @@ public:
     JSFXParser(const std::string& source);
     
     std::unique_ptr<JSFXNode> Parse();
-    
+
 private:
     JSFXLexer m_lexer;
     JSFXToken m_currentToken;
@@ -242,9 +245,10 @@ private:
     std::unique_ptr<JSFXNode> ParseStatement();
     std::unique_ptr<JSFXNode> ParseExpression();
     std::unique_ptr<JSFXNode> ParseAssignment();
-    std::unique_ptr<JSFXNode> ParseBinaryOp();
+    std::unique_ptr<JSFXNode> ParseBinaryOp(int minPrecedence = 0);
+    static int GetBinaryPrecedence(const std::string& op);
     std::unique_ptr<JSFXNode> ParseUnaryOp();
-    std::unique_ptr<JSFXNode> ParseFunctionCall();
+    std::unique_ptr<JSFXNode> ParseFunctionCall(const std::string& name);
     std::unique_ptr<JSFXNode> ParsePrimary();
     std::unique_ptr<JSFXNode> ParseIfStatement();
     std::unique_ptr<JSFXNode> ParseWhileLoop();
@@ -292,7 +296,7 @@ public:
     
     // Function calls
     double CallFunction(const std::string& name, const std::vector<double>& args);
-    
+
 private:
     std::unordered_map<std::string, JSFXVariable> m_variables;
 };
@@ -317,6 +321,7 @@ public:
     
     // Parameter management
     void SetParameter(int index, double value);
+    void SetSliderValue(int index, double value);  // No @slider; the caller runs ExecuteSlider()
     double GetParameter(int index) const;
     int GetParameterCount() const;
     
@@ -346,7 +351,7 @@ public:
     // Performance and debugging
     bool IsInitialized() const { return m_initialized; }
     double GetCpuUsage() const { return m_cpuUsage; }
-    
+
 private:
     std::unique_ptr<JSFXNode> m_ast;
     JSFXContext m_context;
@@ -375,6 +380,9 @@ private:
     double ExecuteWhileLoop(JSFXNode* node);
     double ExecuteBlock(JSFXNode* node);
     
+    // Storage behind a REAPER global (spl0, srate, sliderN...), or null for a script variable
+    double* GetBuiltinVariable(const std::string& name);
+    
     // Script parsing
     void ParseScriptHeader(const std::string& source);
     void FindSections();
@@ -408,7 +416,10 @@ public:
     // Parameter automation
     void SetParameter(int index, double value);
     double GetParameter(int index) const;
-    void SetParameterAutomation(int index, const std::vector<double>& values);
+    void SetParameterEnvelope(int index, const AutomationEnvelope& envelope);
+    AutomationEnvelope* GetParameterEnvelope(int index);
+    void UpdateAutomation(double timePosition, int numSamples);    // Renders this block's ramps; call before ProcessBlock
+    void SetTempoPosition(const TempoPosition& position);           // tempo, beat_position, ts_num, ts_denom
     
     // Effect information
     const JSFXInterpreter::ScriptInfo& GetInfo() const;
@@ -416,27 +427,38 @@ public:
     bool IsBypassed() const { return m_bypassed; }
     void SetBypassed(bool bypassed) { m_bypassed = bypassed; }
     
-    // Performance
+    // Performance - percent of real time, timed per block by the effect chain
     double GetCpuUsage() const;
+    double GetPeakCpuUsage() const;
+    CpuMeter& GetCpuMeter() { return m_cpuMeter; }
     bool IsInitialized() const { return m_initialized; }
-    
+    int GetLatencySamples() const { return m_latencySamples; }     // pdc_delay as of @init / the last SetParameter()
+
 private:
     std::unique_ptr<JSFXInterpreter> m_interpreter;
     std::string m_name;
     bool m_initialized = false;
     bool m_bypassed = false;
     double m_sampleRate = 48000.0;
+    int m_latencySamples = 0;
     
     // Parameter automation
     struct ParameterAutomation {
-        std::vector<double> values;
-        size_t currentIndex = 0;
+        AutomationEnvelope envelope;
+        std::vector<float> ramp;        // Per-sample values for the current block
+        bool ramping = false;           // False when the envelope is flat over the block
     };
     std::vector<ParameterAutomation> m_parameterAutomation;
+    int m_maxBlockSize = 0;
+    bool m_hasRamps = false;
+    
+    // @slider runs this often while a slider ramps; the slider variables
+    // themselves follow every sample
+    static constexpr int SLIDER_UPDATE_INTERVAL = 16;
     
     // Performance monitoring
-    std::chrono::high_resolution_clock::time_point m_lastProcessTime;
-    double m_averageCpuUsage = 0.0;
+    CpuMeter m_cpuMeter;
     
-    void UpdateAutomation();
+    void ProcessAutomatedBlock(AudioBuffer& buffer);
+    void UpdateLatency();
 };
\ No newline at end of file
@@ -0,0 +1,569 @@
+/*
+ * REAPER Web - Audio Block Cache Implementation
+ * Lock-free block lookups for the audio thread, decoding and LRU eviction
+ * on a background decoder thread
+ */
+
+#include "audio_block_cache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+/**
+ * Per-source block table. slots[block * numChannels + channel] holds the
+ * slot index or -1; pending[block] is set while a decode is queued.
+ */
+struct AudioBlockCache::SourceHandle {
+    uint32_t id = 0;
+    Provider* provider = nullptr;
+    int numChannels = 0;
+    int64_t numFrames = 0;
+    int numBlocks = 0;
+    std::unique_ptr<std::atomic<int>[]> slots;
+    std::unique_ptr<std::atomic<bool>[]> pending;
+};
+
+AudioBlockCache& AudioBlockCache::GetInstance() {
+    static AudioBlockCache instance;
+    return instance;
+}
+
+AudioBlockCache::AudioBlockCache() {
+    m_requests = std::make_unique<RequestCell[]>(REQUEST_QUEUE_SIZE);
+    for (size_t i = 0; i < REQUEST_QUEUE_SIZE; ++i) {
+        m_requests[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    AllocateSlots();
+}
+
+AudioBlockCache::~AudioBlockCache() {
+    m_running = false;
+    m_wakeCondition.notify_all();
+    if (m_decoderThread.joinable()) {
+        m_decoderThread.join();
+    }
+}
+
+void AudioBlockCache::SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Every table entry goes away with the old slots
+    for (auto& entry : m_sources) {
+        SourceHandle& handle = *entry.second;
+        for (int i = 0; i < handle.numBlocks * handle.numChannels; ++i) {
+            handle.slots[i].store(-1, std::memory_order_release);
+        }
+    }
+
+    m_memoryBudget = std::max(bytes, sizeof(float) * BLOCK_FRAMES);
+    AllocateSlots();
+}
+
+void AudioBlockCache::AllocateSlots() {
+    m_numSlots = static_cast<int>(m_memoryBudget / (sizeof(float) * BLOCK_FRAMES));
+    m_slots = std::make_unique<Slot[]>(m_numSlots);
+    m_residentSlots = 0;
+
+    // Sample memory is allocated as slots are first used, so the budget is a ceiling
+    m_freeSlots.clear();
+    m_freeSlots.reserve(m_numSlots);
+    for (int i = m_numSlots - 1; i >= 0; --i) {
+        m_freeSlots.push_back(i);
+    }
+}
+
+AudioBlockCache::SourceHandle* AudioBlockCache::RegisterSource(Provider* provider, int numChannels, int64_t numFrames) {
+    if (!provider || numChannels <= 0 || numChannels > 255 || numFrames <= 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto handle = std::make_unique<SourceHandle>();
+    handle->id = m_nextSourceId++;
+    handle->provider = provider;
+    handle->numChannels = numChannels;
+    handle->numFrames = numFrames;
+    handle->numBlocks = static_cast<int>((numFrames + BLOCK_FRAMES - 1) / BLOCK_FRAMES);
+
+    int tableSize = handle->numBlocks * numChannels;
+    handle->slots = std::make_unique<std::atomic<int>[]>(tableSize);
+    for (int i = 0; i < tableSize; ++i) {
+        handle->slots[i].store(-1, std::memory_order_relaxed);
+    }
+    handle->pending = std::make_unique<std::atomic<bool>[]>(handle->numBlocks);
+    for (int i = 0; i < handle->numBlocks; ++i) {
+        handle->pending[i].store(false, std::memory_order_relaxed);
+    }
+
+    SourceHandle* result = handle.get();
+    m_sources[result->id] = std::move(handle);
+
+    StartDecoderThread();
+    return result;
+}
+
+void AudioBlockCache::UnregisterSource(SourceHandle* handle) {
+    if (!handle) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_sources.find(handle->id);
+    if (it == m_sources.end()) return;
+
+    // Queued requests for this id are dropped by the decoder once the entry is gone
+    for (int i = 0; i < handle->numBlocks * handle->numChannels; ++i) {
+        int slotIndex = handle->slots[i].load(std::memory_order_relaxed);
+        if (slotIndex >= 0) {
+            ReleaseSlot(slotIndex);
+        }
+    }
+
+    m_sources.erase(it);
+}
+
+void AudioBlockCache::InvalidateSource(SourceHandle* handle) {
+    if (!handle) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (int i = 0; i < handle->numBlocks * handle->numChannels; ++i) {
+        int slotIndex = handle->slots[i].load(std::memory_order_relaxed);
+        if (slotIndex >= 0) {
+            ReleaseSlot(slotIndex);
+        }
+    }
+}
+
+bool AudioBlockCache::Read(SourceHandle* handle, int64_t startFrame, int numFrames, float* const* channels) {
+    if (!handle || numFrames <= 0) return false;
+
+    bool allHit = true;
+    int produced = 0;
+    int lastBlock = -1;
+
+    while (produced < numFrames) {
+        int64_t frame = startFrame + produced;
+
+        // Outside the source is silence, not a miss
+        if (frame < 0 || frame >= handle->numFrames) {
+            int64_t edge = frame < 0 ? 0 : startFrame + numFrames;
+            int count = static_cast<int>(std::min<int64_t>(numFrames - produced, edge - frame));
+            for (int ch = 0; ch < handle->numChannels; ++ch) {
+                std::memset(channels[ch] + produced, 0, sizeof(float) * count);
+            }
+            produced += count;
+            continue;
+        }
+
+        int block = static_cast<int>(frame / BLOCK_FRAMES);
+        int offset = static_cast<int>(frame - static_cast<int64_t>(block) * BLOCK_FRAMES);
+        int count = static_cast<int>(std::min<int64_t>({static_cast<int64_t>(numFrames - produced),
+                                                        static_cast<int64_t>(BLOCK_FRAMES - offset),
+                                                        handle->numFrames - frame}));
+
+        bool hit = true;
+        for (int ch = 0; ch < handle->numChannels && hit; ++ch) {
+            hit = CopyFromSlot(*handle, block, ch, offset, count, channels[ch] + produced);
+        }
+
+        if (hit) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            for (int ch = 0; ch < handle->numChannels; ++ch) {
+                std::memset(channels[ch] + produced, 0, sizeof(float) * count);
+            }
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            RequestBlock(*handle, block);
+            allHit = false;
+        }
+
+        lastBlock = block;
+        produced += count;
+    }
+
+    // Read ahead so sequential playback finds the next block resident
+    if (lastBlock >= 0 && lastBlock + 1 < handle->numBlocks) {
+        RequestBlock(*handle, lastBlock + 1);
+    }
+
+    return allHit;
+}
+
+bool AudioBlockCache::Mix(SourceHandle* handle, int64_t startFrame, int numFrames, float* const* dest,
+                          int numDestChannels, int destOffset, float gain) {
+    if (!handle || numFrames <= 0) return false;
+
+    bool allHit = true;
+    int produced = 0;
+    int lastBlock = -1;
+
+    // Outside the source contributes nothing
+    if (startFrame < 0) {
+        produced = static_cast<int>(std::min<int64_t>(numFrames, -startFrame));
+    }
+    const int end = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(numFrames,
+                                                                           handle->numFrames - startFrame)));
+
+    while (produced < end) {
+        int64_t frame = startFrame + produced;
+        int block = static_cast<int>(frame / BLOCK_FRAMES);
+        int offset = static_cast<int>(frame - static_cast<int64_t>(block) * BLOCK_FRAMES);
+        int count = std::min(end - produced, BLOCK_FRAMES - offset);
+
+        // Nothing is added unless every channel is there, so a block never plays lopsided
+        bool hit = IsResident(*handle, block) &&
+                   MixBlock(*handle, block, offset, count, dest, numDestChannels, destOffset + produced, gain);
+
+        if (hit) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            RequestBlock(*handle, block);
+            allHit = false;
+        }
+
+        lastBlock = block;
+        produced += count;
+    }
+
+    if (lastBlock >= 0 && lastBlock + 1 < handle->numBlocks) {
+        RequestBlock(*handle, lastBlock + 1);
+    }
+
+    return allHit;
+}
+
+AudioBlockCache::Slot* AudioBlockCache::ReadSlot(const SourceHandle& handle, int block, int channel, int offset,
+                                                 int count, float* dest, uint32_t& version) {
+    int slotIndex = handle.slots[block * handle.numChannels + channel].load(std::memory_order_acquire);
+    if (slotIndex < 0) return nullptr;
+
+    Slot& slot = m_slots[slotIndex];
+    version = slot.version.load(std::memory_order_acquire);
+    if ((version & 1u) != 0 || slot.key.load(std::memory_order_relaxed) != MakeKey(handle.id, block, channel)) {
+        return nullptr;
+    }
+
+    // A plain copy the caller must validate with SlotUnchanged() before using it:
+    // a writer recycling the slot meanwhile bumps the version
+    std::memcpy(dest, slot.data.get() + offset, sizeof(float) * count);
+    return &slot;
+}
+
+namespace {
+
+bool SlotUnchanged(const std::atomic<uint32_t>& slotVersion, uint32_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slotVersion.load(std::memory_order_relaxed) == version;
+}
+
+} // anonymous namespace
+
+bool AudioBlockCache::CopyFromSlot(const SourceHandle& handle, int block, int channel, int offset, int count,
+                                   float* dest) {
+    uint32_t version = 0;
+    Slot* slot = ReadSlot(handle, block, channel, offset, count, dest, version);
+    if (!slot || !SlotUnchanged(slot->version, version)) {
+        return false;   // The caller silences dest
+    }
+
+    Touch(*slot);
+    return true;
+}
+
+bool AudioBlockCache::MixBlock(const SourceHandle& handle, int block, int offset, int count, float* const* dest,
+                               int numDestChannels, int destOffset, float gain) {
+    // A mono source feeds every destination channel; otherwise channels pair up
+    const int sourceChannels = handle.numChannels == 1 ? 1 : std::min(numDestChannels, handle.numChannels);
+    if (sourceChannels <= 0 || sourceChannels > MAX_MIX_CHANNELS) return false;
+
+    // Added audio cannot be taken back, so every channel of a chunk is copied and
+    // validated before any of it is mixed. A slot recycled part way through
+    // leaves the rest of the range silent on all channels alike.
+    float scratch[MIX_SCRATCH_SAMPLES];
+    Slot* slots[MAX_MIX_CHANNELS];
+    uint32_t versions[MAX_MIX_CHANNELS];
+    const int chunkFrames = MIX_SCRATCH_SAMPLES / sourceChannels;
+
+    for (int done = 0; done < count; done += chunkFrames) {
+        const int frames = std::min(chunkFrames, count - done);
+
+        for (int ch = 0; ch < sourceChannels; ++ch) {
+            slots[ch] = ReadSlot(handle, block, ch, offset + done, frames, scratch + ch * frames, versions[ch]);
+            if (!slots[ch]) return false;
+        }
+        for (int ch = 0; ch < sourceChannels; ++ch) {
+            if (!SlotUnchanged(slots[ch]->version, versions[ch])) return false;
+        }
+
+        for (int ch = 0; ch < numDestChannels; ++ch) {
+            const int sourceChannel = handle.numChannels == 1 ? 0 : ch;
+            if (sourceChannel >= sourceChannels) break;
+            const float* source = scratch + sourceChannel * frames;
+            float* out = dest[ch] + destOffset + done;
+            for (int i = 0; i < frames; ++i) {
+                out[i] += source[i] * gain;
+            }
+        }
+    }
+
+    for (int ch = 0; ch < sourceChannels; ++ch) {
+        Touch(*slots[ch]);
+    }
+    return true;
+}
+
+void AudioBlockCache::Touch(Slot& slot) {
+    slot.lastUsed.store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+bool AudioBlockCache::IsResident(const SourceHandle& handle, int block) const {
+    // Slots are evicted one channel at a time, so a block is resident only if every channel is
+    for (int ch = 0; ch < handle.numChannels; ++ch) {
+        if (handle.slots[block * handle.numChannels + ch].load(std::memory_order_acquire) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioBlockCache::RequestBlock(SourceHandle& handle, int block) {
+    if (IsResident(handle, block)) {
+        return;
+    }
+
+    // One queued request per block
+    if (handle.pending[block].exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    if (!EnqueueRequest({handle.id, block})) {
+        handle.pending[block].store(false, std::memory_order_release); // Queue full - retried on the next read
+    }
+}
+
+bool AudioBlockCache::EnqueueRequest(const Request& request) {
+    size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        RequestCell& cell = m_requests[position & (REQUEST_QUEUE_SIZE - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.request = request;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // Full
+        } else {
+            position = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AudioBlockCache::DequeueRequest(Request& request) {
+    // Single consumer (decoder thread)
+    size_t position = m_dequeuePos.load(std::memory_order_relaxed);
+    RequestCell& cell = m_requests[position & (REQUEST_QUEUE_SIZE - 1)];
+
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false; // Empty
+    }
+
+    request = cell.request;
+    cell.sequence.store(position + REQUEST_QUEUE_SIZE, std::memory_order_release);
+    m_dequeuePos.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void AudioBlockCache::Preload(SourceHandle* handle, int64_t startFrame, int numFrames) {
+    if (!handle || numFrames <= 0) return;
+
+    int64_t first = std::max<int64_t>(0, startFrame) / BLOCK_FRAMES;
+    int64_t last = std::min<int64_t>(handle->numFrames - 1, startFrame + numFrames - 1) / BLOCK_FRAMES;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int64_t block = first; block <= last; ++block) {
+        LoadBlock(*handle, static_cast<int>(block));
+    }
+}
+
+void AudioBlockCache::GetBlockRefs(const SourceHandle* handle, int64_t startFrame, int numFrames,
+                                   std::vector<BlockRef>& refs) const {
+    if (!handle || numFrames <= 0) return;
+
+    int64_t first = std::max<int64_t>(0, startFrame) / BLOCK_FRAMES;
+    int64_t last = std::min<int64_t>(handle->numFrames - 1, startFrame + numFrames - 1) / BLOCK_FRAMES;
+
+    for (int64_t block = first; block <= last; ++block) {
+        refs.push_back({handle->id, static_cast<int>(block)});
+    }
+}
+
+void AudioBlockCache::RequestBlocks(const std::vector<BlockRef>& refs) {
+    // No residency check: the handle may already be unregistered
+    for (const BlockRef& ref : refs) {
+        if (!EnqueueRequest({ref.sourceId, ref.block})) {
+            return; // Queue full - the blocks will miss once and be read ahead from there
+        }
+    }
+}
+
+void AudioBlockCache::StartDecoderThread() {
+    // Called with m_mutex held
+    if (m_running.exchange(true)) return;
+    m_decoderThread = std::thread(&AudioBlockCache::DecoderThreadMain, this);
+}
+
+void AudioBlockCache::DecoderThreadMain() {
+    while (m_running.load()) {
+        bool worked = false;
+        Request request;
+
+        while (DequeueRequest(request)) {
+            worked = true;
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_sources.find(request.sourceId);
+            if (it != m_sources.end()) {
+                LoadBlock(*it->second, request.block);
+            }
+        }
+
+        // The audio thread never signals; poll at a fraction of a typical block
+        if (!worked) {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void AudioBlockCache::LoadBlock(SourceHandle& handle, int block) {
+    // Called with m_mutex held
+    if (block < 0 || block >= handle.numBlocks) return;
+
+    const int numChannels = handle.numChannels;
+    bool resident = true;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        resident = resident && handle.slots[block * numChannels + ch].load(std::memory_order_relaxed) >= 0;
+    }
+
+    if (!resident) {
+        int64_t startFrame = static_cast<int64_t>(block) * BLOCK_FRAMES;
+        int frames = static_cast<int>(std::min<int64_t>(BLOCK_FRAMES, handle.numFrames - startFrame));
+
+        m_decodeScratch.assign(static_cast<size_t>(numChannels) * BLOCK_FRAMES, 0.0f);
+        m_decodePtrs.resize(numChannels);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            m_decodePtrs[ch] = m_decodeScratch.data() + static_cast<size_t>(ch) * BLOCK_FRAMES;
+        }
+
+        if (handle.provider->DecodeFrames(startFrame, frames, m_decodePtrs.data())) {
+            m_decodedBlocks.fetch_add(1, std::memory_order_relaxed);
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                int tableIndex = block * numChannels + ch;
+                if (handle.slots[tableIndex].load(std::memory_order_relaxed) >= 0) continue;
+
+                int slotIndex = AcquireSlot();
+                Slot& slot = m_slots[slotIndex];
+
+                // Seqlock write: odd version while the contents change
+                uint32_t version = slot.version.load(std::memory_order_relaxed);
+                slot.version.store(version + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                if (!slot.data) {
+                    slot.data.reset(new float[BLOCK_FRAMES]);
+                    m_residentSlots.fetch_add(1, std::memory_order_relaxed);
+                }
+                std::memcpy(slot.data.get(), m_decodePtrs[ch], sizeof(float) * BLOCK_FRAMES);
+                slot.key.store(MakeKey(handle.id, block, ch), std::memory_order_relaxed);
+                slot.lastUsed.store(m_clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                slot.owner = &handle;
+                slot.tableIndex = tableIndex;
+
+                slot.version.store(version + 2, std::memory_order_release);
+                handle.slots[tableIndex].store(slotIndex, std::memory_order_release);
+            }
+        }
+    }
+
+    handle.pending[block].store(false, std::memory_order_release);
+}
+
+int AudioBlockCache::AcquireSlot() {
+    // Called with m_mutex held
+    if (!m_freeSlots.empty()) {
+        int slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slotIndex;
+    }
+
+    // Evict the least recently used slot
+    int oldest = 0;
+    uint64_t oldestUse = m_slots[0].lastUsed.load(std::memory_order_relaxed);
+    for (int i = 1; i < m_numSlots; ++i) {
+        uint64_t lastUsed = m_slots[i].lastUsed.load(std::memory_order_relaxed);
+        if (lastUsed < oldestUse) {
+            oldest = i;
+            oldestUse = lastUsed;
+        }
+    }
+
+    Slot& slot = m_slots[oldest];
+    if (slot.owner) {
+        slot.owner->slots[slot.tableIndex].store(-1, std::memory_order_release);
+    }
+    slot.owner = nullptr;
+    slot.tableIndex = -1;
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+    return oldest;
+}
+
+void AudioBlockCache::ReleaseSlot(int slotIndex) {
+    // Called with m_mutex held
+    Slot& slot = m_slots[slotIndex];
+    if (slot.owner) {
+        slot.owner->slots[slot.tableIndex].store(-1, std::memory_order_release);
+    }
+
+    // Readers still holding the index see the key change and miss
+    uint32_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.key.store(0, std::memory_order_relaxed);
+    slot.lastUsed.store(0, std::memory_order_relaxed);
+    slot.version.store(version + 2, std::memory_order_release);
+
+    slot.owner = nullptr;
+    slot.tableIndex = -1;
+    m_freeSlots.push_back(slotIndex);
+}
+
+AudioBlockCache::Stats AudioBlockCache::GetStats() const {
+    Stats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.evictions = m_evictions.load(std::memory_order_relaxed);
+    stats.decodedBlocks = m_decodedBlocks.load(std::memory_order_relaxed);
+    stats.memoryUsed = static_cast<size_t>(m_residentSlots.load(std::memory_order_relaxed)) * sizeof(float) * BLOCK_FRAMES;
+    stats.memoryBudget = m_memoryBudget;
+    return stats;
+}
+
+void AudioBlockCache::ResetStats() {
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+    m_decodedBlocks = 0;
+}
+
+uint64_t AudioBlockCache::MakeKey(uint32_t sourceId, int block, int channel) {
+    return (static_cast<uint64_t>(sourceId) << 32) | (static_cast<uint64_t>(block) << 8) |
+           static_cast<uint64_t>(channel);
+}
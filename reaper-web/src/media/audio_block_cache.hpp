@@ -0,0 +1,180 @@
+/*
+ * REAPER Web - Audio Block Cache
+ * Process-wide LRU cache of decoded source audio shared by all AudioSources
+ * Based on REAPER's media buffering (disk read-ahead feeding the audio thread)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * AudioBlockCache - Size-bounded cache of decoded audio blocks
+ * Sources are split into BLOCK_FRAMES-frame blocks. Each slot holds one
+ * channel of one block, keyed by source id + block index + channel.
+ *
+ * The audio thread reads without locks: a per-source table maps blocks to
+ * slots and every copy is validated against the slot's version counter
+ * (seqlock), so a slot recycled mid-read reads as a miss instead of torn
+ * audio. Misses read as silence and are queued to the decoder thread,
+ * which decodes the block, evicts the least recently used slot once the
+ * memory budget is reached, and publishes the new slot.
+ */
+class AudioBlockCache {
+public:
+    static constexpr int BLOCK_FRAMES = 65536;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+    /**
+     * Provider - decodes source audio; called on the decoder thread or
+     * from Preload() on the calling thread
+     */
+    class Provider {
+    public:
+        virtual ~Provider() = default;
+        virtual bool DecodeFrames(int64_t startFrame, int numFrames, float* const* channels) = 0;
+    };
+
+    struct SourceHandle;
+
+    // A block named by source id, so it can be queued after the source is gone
+    struct BlockRef {
+        uint32_t sourceId = 0;
+        int block = 0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;              // Blocks served from the cache
+        uint64_t misses = 0;            // Blocks that read as silence
+        uint64_t evictions = 0;
+        uint64_t decodedBlocks = 0;
+        size_t memoryUsed = 0;          // Bytes held by resident slots
+        size_t memoryBudget = 0;
+    };
+
+public:
+    static AudioBlockCache& GetInstance();
+    ~AudioBlockCache();
+
+    // Configuration - drops all cached audio; not while the audio thread is reading
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return m_memoryBudget; }
+
+    // Source registration (non-realtime)
+    SourceHandle* RegisterSource(Provider* provider, int numChannels, int64_t numFrames);
+    void UnregisterSource(SourceHandle* handle);
+    void InvalidateSource(SourceHandle* handle);
+
+    // Realtime read - lock-free and never blocks. Missing blocks read as
+    // silence and are queued for decoding; the following block is read
+    // ahead. Returns false if any block missed.
+    bool Read(SourceHandle* handle, int64_t startFrame, int numFrames, float* const* channels);
+
+    // Realtime mix - adds the range times gain into dest at destOffset instead
+    // of copying it out; a mono source feeds every dest channel. Misses add
+    // nothing and are queued like Read's.
+    bool Mix(SourceHandle* handle, int64_t startFrame, int numFrames, float* const* dest, int numDestChannels,
+             int destOffset, float gain);
+
+    // Non-realtime - decode any missing blocks in the range on the calling thread
+    void Preload(SourceHandle* handle, int64_t startFrame, int numFrames);
+
+    // Non-realtime - append the blocks a range covers, to be queued later
+    void GetBlockRefs(const SourceHandle* handle, int64_t startFrame, int numFrames,
+                      std::vector<BlockRef>& refs) const;
+
+    // Realtime - queue known blocks for the decoder thread, which skips
+    // resident blocks and sources no longer registered
+    void RequestBlocks(const std::vector<BlockRef>& refs);
+
+    // Statistics
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    AudioBlockCache();
+    AudioBlockCache(const AudioBlockCache&) = delete;
+    AudioBlockCache& operator=(const AudioBlockCache&) = delete;
+
+    struct Slot {
+        std::atomic<uint32_t> version{0};   // Odd while the writer owns the slot
+        std::atomic<uint64_t> key{0};       // 0 = empty
+        std::atomic<uint64_t> lastUsed{0};  // LRU clock of the last hit
+        std::unique_ptr<float[]> data;      // BLOCK_FRAMES samples, allocated on first use
+        SourceHandle* owner = nullptr;      // Writer side only
+        int tableIndex = -1;                // Entry in the owner's block table
+    };
+
+    // Bounded multi-producer request queue (audio thread + read-ahead -> decoder)
+    struct Request {
+        uint32_t sourceId = 0;
+        int block = 0;
+    };
+    struct RequestCell {
+        std::atomic<size_t> sequence{0};
+        Request request;
+    };
+    static constexpr size_t REQUEST_QUEUE_SIZE = 1024;   // Power of two
+
+    // Mix() validates a chunk of every channel on the stack before adding any of it
+    static constexpr int MAX_MIX_CHANNELS = 32;
+    static constexpr int MIX_SCRATCH_SAMPLES = 2048;
+
+    // Slots
+    size_t m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+    std::unique_ptr<Slot[]> m_slots;
+    int m_numSlots = 0;
+    std::vector<int> m_freeSlots;
+    std::atomic<int> m_residentSlots{0};
+    std::atomic<uint64_t> m_clock{0};
+
+    // Sources (writer side, under m_mutex)
+    std::unordered_map<uint32_t, std::unique_ptr<SourceHandle>> m_sources;
+    uint32_t m_nextSourceId = 1;
+    std::vector<float> m_decodeScratch;
+    std::vector<float*> m_decodePtrs;
+    mutable std::mutex m_mutex;
+
+    // Requests
+    std::unique_ptr<RequestCell[]> m_requests;
+    std::atomic<size_t> m_enqueuePos{0};
+    std::atomic<size_t> m_dequeuePos{0};
+
+    // Decoder thread
+    std::thread m_decoderThread;
+    std::atomic<bool> m_running{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    // Statistics
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::atomic<uint64_t> m_decodedBlocks{0};
+
+    // Internal methods
+    void AllocateSlots();
+    void StartDecoderThread();
+    void DecoderThreadMain();
+    Slot* ReadSlot(const SourceHandle& handle, int block, int channel, int offset, int count, float* dest,
+                   uint32_t& version);
+    bool CopyFromSlot(const SourceHandle& handle, int block, int channel, int offset, int count, float* dest);
+    bool MixBlock(const SourceHandle& handle, int block, int offset, int count, float* const* dest,
+                  int numDestChannels, int destOffset, float gain);
+    void Touch(Slot& slot);
+    bool IsResident(const SourceHandle& handle, int block) const;
+    void RequestBlock(SourceHandle& handle, int block);
+    bool EnqueueRequest(const Request& request);
+    bool DequeueRequest(Request& request);
+    void LoadBlock(SourceHandle& handle, int block);
+    int AcquireSlot();
+    void ReleaseSlot(int slotIndex);
+    static uint64_t MakeKey(uint32_t sourceId, int block, int channel);
+};
@@ -11,6 +11,41 @@
 #include <sstream>
 #include <cmath>
 #include <fstream>
+#include <limits>
+#include <mutex>
+#include <cstring>
+
+namespace {
+
+// WAV/RF64 fields are little-endian regardless of host
+inline uint16_t ReadLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t ReadLE64(const unsigned char* p) {
+    return static_cast<uint64_t>(ReadLE32(p)) | (static_cast<uint64_t>(ReadLE32(p + 4)) << 32);
+}
+
+// Splits interleaved frames into planar channels with one sample converter per format
+template <typename Convert>
+void DeinterleaveFrames(const unsigned char* bytes, int numFrames, int numChannels, int bytesPerSample,
+                        int blockAlign, float* const* channels, int destOffset, Convert convert) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const unsigned char* src = bytes + ch * bytesPerSample;
+        float* dst = channels[ch] + destOffset;
+        for (int i = 0; i < numFrames; ++i) {
+            dst[i] = convert(src);
+            src += blockAlign;
+        }
+    }
+}
+
+} // namespace
 
 // MediaItem Implementation
 MediaItem::MediaItem(Track* track, const std::string& sourceFile) : m_track(track) {
@@ -30,30 +65,37 @@ MediaItem::MediaItem(Track* track, const std::string& sourceFile) : m_track(trac
 MediaItem::~MediaItem() = default;
 
 void MediaItem::SetName(const std::string& name) {
+    ++m_revision;
     m_state.name = name;
 }
 
 void MediaItem::SetPosition(double seconds) {
+    ++m_revision;
     m_state.position = std::max(0.0, seconds);
 }
 
 void MediaItem::SetLength(double seconds) {
+    ++m_revision;
     m_state.length = std::max(0.001, seconds); // Minimum 1ms length
 }
 
 void MediaItem::SetSnapOffset(double offset) {
+    ++m_revision;
     m_state.snapOffset = offset;
 }
 
 void MediaItem::SetVolume(double volume) {
+    ++m_revision;
     m_state.volume = std::max(0.0, volume);
 }
 
 void MediaItem::SetMute(bool mute) {
+    ++m_revision;
     m_state.mute = mute;
 }
 
 void MediaItem::SetColor(const std::string& color) {
+    ++m_revision;
     m_state.color = color;
 }
 
@@ -62,40 +104,59 @@ void MediaItem::SetSelected(bool selected) {
 }
 
 void MediaItem::SetLocked(bool locked) {
+    ++m_revision;
     m_state.locked = locked;
 }
 
 void MediaItem::SetGroupId(int groupId) {
+    ++m_revision;
     m_state.groupId = groupId;
 }
 
 void MediaItem::SetFadeIn(double length, FadeType type) {
+    ++m_revision;
     m_state.fadeIn.length = std::max(0.0, std::min(length, m_state.length * 0.5));
     m_state.fadeIn.type = type;
     m_state.fadeIn.enabled = (length > 0.0);
 }
 
 void MediaItem::SetFadeOut(double length, FadeType type) {
+    ++m_revision;
     m_state.fadeOut.length = std::max(0.0, std::min(length, m_state.length * 0.5));
     m_state.fadeOut.type = type;
     m_state.fadeOut.enabled = (length > 0.0);
 }
 
 void MediaItem::ClearFadeIn() {
+    ++m_revision;
     m_state.fadeIn.enabled = false;
     m_state.fadeIn.length = 0.0;
 }
 
 void MediaItem::ClearFadeOut() {
+    ++m_revision;
     m_state.fadeOut.enabled = false;
     m_state.fadeOut.length = 0.0;
 }
 
+void MediaItem::SetCrossfadeIn(const Crossfade& crossfade) {
+    m_crossfadeIn = crossfade;
+    m_crossfadeIn.length = std::max(0.0, std::min(crossfade.length, m_state.length));
+    m_crossfadeIn.enabled = crossfade.enabled && m_crossfadeIn.length > 0.0;
+}
+
+void MediaItem::SetCrossfadeOut(const Crossfade& crossfade) {
+    m_crossfadeOut = crossfade;
+    m_crossfadeOut.length = std::max(0.0, std::min(crossfade.length, m_state.length));
+    m_crossfadeOut.enabled = crossfade.enabled && m_crossfadeOut.length > 0.0;
+}
+
 int MediaItem::AddTake(const std::string& sourceFile) {
+    ++m_revision;
     Take take;
     take.guid = GenerateGUID();
     take.name = sourceFile;
-    take.source = std::make_shared<AudioSource>(sourceFile);
+    take.source = AudioSource::GetShared(sourceFile);
     
     // Set item length to source length if this is the first take
     if (m_state.takes.empty() && take.source->IsValid()) {
@@ -106,7 +167,27 @@ int MediaItem::AddTake(const std::string& sourceFile) {
     return static_cast<int>(m_state.takes.size()) - 1;
 }
 
+int MediaItem::AddTake(std::shared_ptr<AudioSource> source, double sourceOffset) {
+    ++m_revision;
+    if (!source) return -1;
+    
+    // Takes on one recording share the source and differ only in offset
+    Take take;
+    take.guid = GenerateGUID();
+    take.name = source->GetInfo().filePath;
+    take.source = std::move(source);
+    take.sourceOffset = std::max(0.0, sourceOffset);
+    
+    if (m_state.takes.empty() && take.source->IsValid()) {
+        m_state.length = std::max(0.0, take.source->GetInfo().length - take.sourceOffset);
+    }
+    
+    m_state.takes.push_back(std::move(take));
+    return static_cast<int>(m_state.takes.size()) - 1;
+}
+
 bool MediaItem::RemoveTake(int takeIndex) {
+    ++m_revision;
     if (takeIndex < 0 || takeIndex >= static_cast<int>(m_state.takes.size())) {
         return false;
     }
@@ -116,6 +197,7 @@ bool MediaItem::RemoveTake(int takeIndex) {
         return false;
     }
     
+    m_stretchStates.erase(m_state.takes[takeIndex].guid);
     m_state.takes.erase(m_state.takes.begin() + takeIndex);
     
     // Adjust active take index if necessary
@@ -123,10 +205,21 @@ bool MediaItem::RemoveTake(int takeIndex) {
         m_state.activeTake = std::max(0, m_state.activeTake - 1);
     }
     
+    // Comp regions on the removed lane fall back to the active take
+    for (auto& region : m_state.compRegions) {
+        if (region.takeIndex == takeIndex) {
+            region.takeIndex = m_state.activeTake;
+        } else if (region.takeIndex > takeIndex) {
+            --region.takeIndex;
+        }
+    }
+    NormalizeCompRegions();
+    
     return true;
 }
 
 void MediaItem::SetActiveTake(int takeIndex) {
+    ++m_revision;
     if (takeIndex >= 0 && takeIndex < static_cast<int>(m_state.takes.size())) {
         m_state.activeTake = takeIndex;
     }
@@ -155,6 +248,7 @@ const MediaItem::Take* MediaItem::GetActiveTakePtr() const {
 }
 
 bool MediaItem::Split(double time) {
+    ++m_revision;
     if (time <= m_state.position || time >= GetEndPosition()) {
         return false; // Split time is outside item
     }
@@ -173,10 +267,13 @@ bool MediaItem::Split(double time) {
         m_state.fadeOut.length = splitPos;
     }
     
+    ClipCompRegions(0.0, splitPos);
+    
     return true;
 }
 
 bool MediaItem::Trim(double startTime, double endTime) {
+    ++m_revision;
     if (startTime >= endTime) return false;
     
     double newPosition = std::max(startTime, m_state.position);
@@ -187,16 +284,18 @@ bool MediaItem::Trim(double startTime, double endTime) {
     // Adjust source offset for all takes
     double positionDelta = newPosition - m_state.position;
     for (auto& take : m_state.takes) {
-        take.sourceOffset += positionDelta / take.playRate;
+        take.sourceOffset += positionDelta * take.playRate;
     }
     
     m_state.position = newPosition;
     m_state.length = newEndPosition - newPosition;
+    ClipCompRegions(positionDelta, m_state.length);
     
     return true;
 }
 
 bool MediaItem::Move(double deltaTime) {
+    ++m_revision;
     double newPosition = m_state.position + deltaTime;
     if (newPosition < 0.0) return false;
     
@@ -205,6 +304,7 @@ bool MediaItem::Move(double deltaTime) {
 }
 
 bool MediaItem::Stretch(double newLength) {
+    ++m_revision;
     if (newLength <= 0.0) return false;
     
     double stretchRatio = newLength / m_state.length;
@@ -222,11 +322,18 @@ bool MediaItem::Stretch(double newLength) {
         m_state.fadeOut.length *= stretchRatio;
     }
     
+    // Comp boundaries stay on the same source material
+    for (auto& region : m_state.compRegions) {
+        region.start *= stretchRatio;
+        region.end *= stretchRatio;
+    }
+    
     m_state.length = newLength;
     return true;
 }
 
 bool MediaItem::ChangeRate(double newRate) {
+    ++m_revision;
     if (newRate <= 0.0) return false;
     
     auto* activeTake = GetActiveTakePtr();
@@ -244,168 +351,618 @@ bool MediaItem::ChangeRate(double newRate) {
 }
 
 bool MediaItem::ChangePitch(double semitones) {
+    ++m_revision;
     auto* activeTake = GetActiveTakePtr();
     if (!activeTake) return false;
     
-    activeTake->pitch = semitones;
+    activeTake->pitch = std::max(-24.0, std::min(24.0, semitones));
+    
+    // Varispeed modes cannot shift pitch on their own; switch to the default stretch engine
+    if (activeTake->pitch != 0.0 &&
+        activeTake->stretchMode != StretchMode::ELASTIQUE &&
+        activeTake->stretchMode != StretchMode::RUBBER_BAND) {
+        activeTake->stretchMode = StretchMode::ELASTIQUE;
+    }
+    
+    return true;
+}
+
+bool MediaItem::AddStretchMarker(double itemTime, double sourceTime) {
+    ++m_revision;
+    auto* activeTake = GetActiveTakePtr();
+    if (!activeTake || itemTime < 0.0 || itemTime > m_state.length) {
+        return false;
+    }
+    
+    Take::StretchMarker marker;
+    marker.sourceTime = sourceTime;
+    marker.itemTime = itemTime;
+    
+    // Keep markers sorted; a marker at the same item time is moved
+    auto& markers = activeTake->stretchMarkers;
+    auto it = std::lower_bound(markers.begin(), markers.end(), itemTime,
+                               [](const Take::StretchMarker& m, double time) { return m.itemTime < time; });
+    
+    if (it != markers.end() && std::abs(it->itemTime - itemTime) < 1e-9) {
+        *it = marker;
+    } else {
+        markers.insert(it, marker);
+    }
+    
+    return true;
+}
+
+void MediaItem::ClearStretchMarkers() {
+    ++m_revision;
+    if (auto* activeTake = GetActiveTakePtr()) {
+        activeTake->stretchMarkers.clear();
+    }
+}
+
+double MediaItem::GetSourceTime(double itemTime) const {
+    const auto* activeTake = GetActiveTakePtr();
+    return activeTake ? MapItemToSourceTime(*activeTake, itemTime) : 0.0;
+}
+
+bool MediaItem::SwipeComp(int takeIndex, double startTime, double endTime) {
+    ++m_revision;
+    if (takeIndex < 0 || takeIndex >= static_cast<int>(m_state.takes.size())) {
+        return false;
+    }
+    
+    startTime = std::max(0.0, startTime);
+    endTime = std::min(m_state.length, endTime);
+    if (endTime - startTime < 1e-9) {
+        return false;
+    }
+    
+    // The first swipe starts from the active take across the whole item
+    auto& regions = m_state.compRegions;
+    if (regions.empty()) {
+        regions.push_back({0.0, m_state.length, m_state.activeTake});
+    }
+    
+    // Keep what lies outside the swipe, cut what it overlaps, insert the new lane
+    std::vector<CompRegion> result;
+    result.reserve(regions.size() + 2);
+    for (const auto& region : regions) {
+        if (region.end <= startTime || region.start >= endTime) {
+            result.push_back(region);
+            continue;
+        }
+        if (region.start < startTime) {
+            result.push_back({region.start, startTime, region.takeIndex});
+        }
+        if (region.end > endTime) {
+            result.push_back({endTime, region.end, region.takeIndex});
+        }
+    }
+    result.push_back({startTime, endTime, takeIndex});
+    
+    regions = std::move(result);
+    NormalizeCompRegions();
     return true;
 }
 
+void MediaItem::ClearComp() {
+    ++m_revision;
+    m_state.compRegions.clear();
+}
+
+int MediaItem::GetCompTakeAt(double itemTime) const {
+    const auto& regions = m_state.compRegions;
+    if (regions.empty()) {
+        return m_state.activeTake;
+    }
+    
+    auto next = std::upper_bound(regions.begin(), regions.end(), itemTime,
+                                 [](double time, const CompRegion& r) { return time < r.start; });
+    return next == regions.begin() ? regions.front().takeIndex : (next - 1)->takeIndex;
+}
+
+void MediaItem::SetCompCrossfadeLength(double seconds) {
+    ++m_revision;
+    m_state.compCrossfadeLength = std::max(0.0, std::min(seconds, 1.0));
+}
+
+void MediaItem::NormalizeCompRegions() {
+    auto& regions = m_state.compRegions;
+    std::sort(regions.begin(), regions.end(),
+              [](const CompRegion& a, const CompRegion& b) { return a.start < b.start; });
+    
+    // Merge neighbours on the same lane - no boundary, no crossfade
+    std::vector<CompRegion> merged;
+    merged.reserve(regions.size());
+    for (const auto& region : regions) {
+        if (region.end - region.start < 1e-9) continue;
+        if (!merged.empty() && merged.back().takeIndex == region.takeIndex) {
+            merged.back().end = std::max(merged.back().end, region.end);
+        } else {
+            merged.push_back(region);
+        }
+    }
+    regions = std::move(merged);
+}
+
+void MediaItem::ClipCompRegions(double offset, double length) {
+    if (m_state.compRegions.empty()) return;
+    
+    // Shift into the new item time base and drop what falls outside
+    for (auto& region : m_state.compRegions) {
+        region.start = std::max(0.0, region.start - offset);
+        region.end = std::min(length, region.end - offset);
+    }
+    NormalizeCompRegions();
+    
+    if (m_state.compRegions.empty()) return;
+    m_state.compRegions.front().start = 0.0;
+    m_state.compRegions.back().end = length;
+}
+
 void MediaItem::ProcessAudio(AudioBuffer& buffer, double startTime, double length) {
+    // Seconds-based entry point - rounds once onto the sample timeline
+    double sampleRate = buffer.GetSampleRate();
+    ProcessAudio(buffer, std::llround(startTime * sampleRate), static_cast<int>(std::llround(length * sampleRate)));
+}
+
+void MediaItem::ProcessAudio(AudioBuffer& buffer, int64_t blockStartSample, int numSamples) {
     if (m_state.mute || m_state.volume <= 0.0) {
         return; // Muted or zero volume
     }
     
     const auto* activeTake = GetActiveTakePtr();
-    if (!activeTake || !activeTake->source || !activeTake->source->IsValid()) {
+    if (!IsComped() && (!activeTake || !activeTake->source || !activeTake->source->IsValid() || activeTake->mute)) {
         return; // No valid take
     }
     
-    // Check if we need to process any audio in this time range
-    double itemStart = m_state.position;
-    double itemEnd = itemStart + m_state.length;
+    const double sampleRate = buffer.GetSampleRate();
+    UpdateTimelineCache(sampleRate);
     
-    if (startTime >= itemEnd || (startTime + length) <= itemStart) {
+    // Overlap of this block with the item, in project samples
+    int64_t blockEndSample = blockStartSample + std::min(numSamples, buffer.GetSampleCount());
+    int64_t overlapStart = std::max(blockStartSample, m_timeline.startSample);
+    int64_t overlapEnd = std::min(blockEndSample, m_timeline.endSample);
+    
+    if (overlapEnd <= overlapStart) {
         return; // No overlap
     }
     
-    // Calculate overlap region
-    double overlapStart = std::max(startTime, itemStart);
-    double overlapEnd = std::min(startTime + length, itemEnd);
-    double overlapLength = overlapEnd - overlapStart;
+    const int destStart = static_cast<int>(overlapStart - blockStartSample);
+    const int numFrames = static_cast<int>(overlapEnd - overlapStart);
+    const int64_t itemFrame = overlapStart - m_timeline.startSample;
+    
+    if (!m_processBuffer) {
+        m_processBuffer = std::make_unique<AudioBuffer>();
+    }
+    m_processBuffer->SetSampleRate(sampleRate);
+    
+    // Comped items assemble the lanes first; take gains apply per region
+    if (IsComped()) {
+        m_processBuffer->SetSize(buffer.GetChannelCount(), numFrames);
+        m_processBuffer->Clear();
+        ProcessComp(*m_processBuffer, itemFrame, numFrames);
+        ApplyFades(*m_processBuffer, itemFrame, numFrames);
+        MixToBuffer(*m_processBuffer, buffer, destStart, numFrames, static_cast<float>(m_state.volume));
+        return;
+    }
+    
+    // Item volume, take volume and phase fold into one mix gain
+    float gain = static_cast<float>(m_state.volume * activeTake->volume);
+    if (activeTake->phase) {
+        gain = -gain;
+    }
+    
+    // Unity-rate native audio outside the fades mixes straight from the source
+    if (CanMixDirect(*activeTake, itemFrame, numFrames, sampleRate)) {
+        int64_t sourceFrame = AdvanceSourceCursor(*activeTake, itemFrame, numFrames, sampleRate);
+        if (activeTake->source->MixAudioFrames(buffer, destStart, sourceFrame, numFrames, sampleRate, gain)) {
+            return;
+        }
+    }
+    m_sourceCursor.nextItemFrame = -1;
+    
+    // Everything else renders into the preallocated process buffer first
+    ProcessTake(*activeTake, *m_processBuffer, itemFrame, numFrames);
+    ApplyFades(*m_processBuffer, itemFrame, numFrames);
+    MixToBuffer(*m_processBuffer, buffer, destStart, numFrames, gain);
+}
+
+void MediaItem::PrepareForPlayback(double sampleRate, int maxBlockSize) {
+    if (sampleRate <= 0.0 || maxBlockSize <= 0) return;
     
-    if (overlapLength <= 0.0) return;
+    UpdateTimelineCache(sampleRate);
+    
+    int numChannels = 2;
+    for (const auto& take : m_state.takes) {
+        if (take.source && take.source->IsValid()) {
+            numChannels = std::max(numChannels, take.source->GetInfo().channels);
+        }
+    }
     
-    // Create process buffer if needed
+    // Reserve so per-block SetSize() calls stay within capacity
     if (!m_processBuffer) {
-        m_processBuffer = std::make_unique<AudioBuffer>(buffer.GetChannelCount(), 
-                                                      static_cast<int>(buffer.GetSampleRate() * overlapLength));
+        m_processBuffer = std::make_unique<AudioBuffer>();
+    }
+    m_processBuffer->Reserve(numChannels, maxBlockSize);
+    m_processBuffer->SetSampleRate(sampleRate);
+    
+    if (!m_stretchInput) {
+        m_stretchInput = std::make_unique<AudioBuffer>();
+    }
+    m_stretchInput->Reserve(numChannels, maxBlockSize * 4 + 8); // Varispeed up to 4x without regrowing
+    
+    if (!m_compBuffer) {
+        m_compBuffer = std::make_unique<AudioBuffer>();
+    }
+    m_compBuffer->Reserve(numChannels, maxBlockSize);
+    
+    // Bake fade shapes now rather than on the first faded block
+    UpdateFadeTable(m_compFadeInTable, FadeType::EQUAL_POWER, 0.0, FadeDirection::IN);
+    UpdateFadeTable(m_compFadeOutTable, FadeType::EQUAL_POWER, 0.0, FadeDirection::MIRRORED_OUT);
+    UpdateFadeTable(m_fadeInTable, m_state.fadeIn.type, m_state.fadeIn.curvature, FadeDirection::IN);
+    UpdateFadeTable(m_fadeOutTable, m_state.fadeOut.type, m_state.fadeOut.curvature, FadeDirection::OUT);
+    UpdateFadeTable(m_crossfadeInTable, m_crossfadeIn.type, m_crossfadeIn.curvature, FadeDirection::IN);
+    UpdateFadeTable(m_crossfadeOutTable, m_crossfadeOut.type, m_crossfadeOut.curvature, FadeDirection::MIRRORED_OUT);
+    
+    for (const auto& take : m_state.takes) {
+        if (!take.source || !take.source->IsValid()) continue;
+        
+        take.source->PrepareForPlayback(sampleRate);
+        
+        if (UsesStretchEngine(take)) {
+            GetStretchState(take, take.source->GetInfo().channels, sampleRate,
+                            take.stretchMode == StretchMode::RUBBER_BAND ? TimeStretcher::Algorithm::PHASE_VOCODER
+                                                                         : TimeStretcher::Algorithm::WSOLA);
+        }
+    }
+}
+
+void MediaItem::PrefetchSources(double projectTime) {
+    ForEachPrefetchSource(projectTime, [](AudioSource& source, int64_t sourceFrame) {
+        source.Prefetch(sourceFrame, AudioBlockCache::BLOCK_FRAMES);
+    });
+}
+
+void MediaItem::GetPrefetchBlocks(double projectTime, std::vector<AudioBlockCache::BlockRef>& blocks) const {
+    ForEachPrefetchSource(projectTime, [&blocks](AudioSource& source, int64_t sourceFrame) {
+        source.GetPrefetchBlocks(sourceFrame, AudioBlockCache::BLOCK_FRAMES, blocks);
+    });
+}
+
+void MediaItem::ForEachPrefetchSource(double projectTime,
+                                      const std::function<void(AudioSource&, int64_t)>& callback) const {
+    double itemTime = std::max(0.0, projectTime - m_state.position);
+    if (itemTime >= m_state.length) return;
+    
+    auto visitTake = [&](const Take& take) {
+        if (!take.source || !take.source->IsStreamed()) return;
+        
+        double sourceRate = take.source->GetInfo().sampleRate;
+        callback(*take.source, std::llround(MapItemToSourceTime(take, itemTime) * sourceRate));
+    };
+    
+    // Comped items may switch to any lane that has a region
+    if (IsComped()) {
+        for (size_t i = 0; i < m_state.takes.size(); ++i) {
+            bool used = std::any_of(m_state.compRegions.begin(), m_state.compRegions.end(),
+                                    [i](const CompRegion& region) { return region.takeIndex == static_cast<int>(i); });
+            if (used) {
+                visitTake(m_state.takes[i]);
+            }
+        }
+    } else if (const Take* take = GetActiveTakePtr()) {
+        visitTake(*take);
+    }
+}
+
+void MediaItem::UpdateTimelineCache(double sampleRate) {
+    if (m_timeline.sampleRate == sampleRate && m_timeline.position == m_state.position &&
+        m_timeline.length == m_state.length) {
+        return;
+    }
+    
+    // Both edges round from absolute times so adjacent items share a boundary sample
+    m_timeline.sampleRate = sampleRate;
+    m_timeline.position = m_state.position;
+    m_timeline.length = m_state.length;
+    m_timeline.startSample = GetStartSample(sampleRate);
+    m_timeline.endSample = GetEndSample(sampleRate);
+    m_sourceCursor.nextItemFrame = -1;
+}
+
+bool MediaItem::CanMixDirect(const Take& take, int64_t itemFrame, int numFrames, double sampleRate) const {
+    if (take.source->GetInfo().sampleRate != sampleRate) {
+        return false; // Needs the resampler
+    }
+    
+    if (take.playRate != 1.0 || std::abs(take.pitch) > 0.01 || !take.stretchMarkers.empty()) {
+        return false;
+    }
+    
+    // The source offset must land on a sample boundary
+    double offsetFrames = take.sourceOffset * sampleRate;
+    if (std::abs(offsetFrames - std::round(offsetFrames)) > 1e-6) {
+        return false;
+    }
+    
+    // Blocks touching a fade or crossfade need the per-sample gain
+    return !TouchesFade(itemFrame, numFrames, sampleRate);
+}
+
+int64_t MediaItem::AdvanceSourceCursor(const Take& take, int64_t itemFrame, int numFrames, double sampleRate) {
+    // Contiguous blocks continue from the cached cursor; anything else re-derives it
+    if (itemFrame != m_sourceCursor.nextItemFrame || m_sourceCursor.source != take.source.get() ||
+        m_sourceCursor.sourceOffset != take.sourceOffset || m_sourceCursor.sampleRate != sampleRate) {
+        m_sourceCursor.source = take.source.get();
+        m_sourceCursor.sourceOffset = take.sourceOffset;
+        m_sourceCursor.sampleRate = sampleRate;
+        m_sourceCursor.sourceFrame = std::llround(take.sourceOffset * sampleRate) + itemFrame;
+    }
+    
+    int64_t sourceFrame = m_sourceCursor.sourceFrame;
+    m_sourceCursor.nextItemFrame = itemFrame + numFrames;
+    m_sourceCursor.sourceFrame = sourceFrame + numFrames;
+    return sourceFrame;
+}
+
+void MediaItem::MixToBuffer(const AudioBuffer& source, AudioBuffer& dest, int destStart, int numFrames, float gain) {
+    if (source.GetChannelCount() == 0) return;
+    
+    if (source.GetChannelCount() > 1) {
+        dest.AddFromWithGain(source, 0, destStart, numFrames, gain);
+        return;
     }
     
-    // Process the take
-    ProcessTake(*activeTake, *m_processBuffer, overlapStart - itemStart, overlapLength);
+    // Mono takes play on every channel
+    int frames = std::min(numFrames, std::min(source.GetSampleCount(), dest.GetSampleCount() - destStart));
+    const float* src = source.GetChannelData(0);
+    for (int ch = 0; ch < dest.GetChannelCount(); ++ch) {
+        float* dst = dest.GetChannelData(ch) + destStart;
+        for (int i = 0; i < frames; ++i) {
+            dst[i] += src[i] * gain;
+        }
+    }
+}
+
+void MediaItem::ProcessComp(AudioBuffer& buffer, int64_t itemFrame, int numFrames) {
+    const double sampleRate = buffer.GetSampleRate();
+    const auto& regions = m_state.compRegions;
+    const int64_t itemFrames = m_timeline.endSample - m_timeline.startSample;
+    const int64_t blockEnd = itemFrame + numFrames;
     
-    // Apply fades
-    ApplyFades(*m_processBuffer, overlapStart - itemStart, overlapLength);
+    // Crossfades are centred on each boundary between lanes
+    const int64_t crossfade = std::llround(m_state.compCrossfadeLength * sampleRate);
+    const int64_t lead = crossfade / 2;
+    const auto& fadeIn = UpdateFadeTable(m_compFadeInTable, FadeType::EQUAL_POWER, 0.0, FadeDirection::IN);
+    const auto& fadeOut = UpdateFadeTable(m_compFadeOutTable, FadeType::EQUAL_POWER, 0.0, FadeDirection::MIRRORED_OUT);
     
-    // Apply item volume and mix into output buffer
-    int startSample = static_cast<int>((overlapStart - startTime) * buffer.GetSampleRate());
-    int numSamples = static_cast<int>(overlapLength * buffer.GetSampleRate());
+    if (!m_compBuffer) {
+        m_compBuffer = std::make_unique<AudioBuffer>();
+    }
+    m_compBuffer->SetSampleRate(sampleRate);
     
-    for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
-        auto* src = m_processBuffer->GetChannelData(ch);
-        auto* dst = buffer.GetChannelData(ch) + startSample;
+    const int numRegions = static_cast<int>(regions.size());
+    for (int r = 0; r < numRegions; ++r) {
+        // First and last regions always reach the item edges
+        int64_t startBoundary = r > 0 ? std::llround(regions[r].start * sampleRate) : 0;
+        int64_t endBoundary = r + 1 < numRegions ? std::llround(regions[r + 1].start * sampleRate) : itemFrames;
+        
+        int64_t renderStart = r > 0 ? std::max<int64_t>(0, startBoundary - lead) : 0;
+        int64_t renderEnd = r + 1 < numRegions ? std::min(itemFrames, endBoundary - lead + crossfade) : itemFrames;
+        
+        if (renderStart >= blockEnd) break;
+        
+        int64_t spanStart = std::max(itemFrame, renderStart);
+        int64_t spanEnd = std::min(blockEnd, renderEnd);
+        if (spanEnd <= spanStart) continue;
         
-        for (int i = 0; i < numSamples; ++i) {
-            dst[i] += src[i] * static_cast<float>(m_state.volume);
+        const Take* take = GetTake(regions[r].takeIndex);
+        if (!take || !take->source || !take->source->IsValid() || take->mute) continue;
+        
+        int spanFrames = static_cast<int>(spanEnd - spanStart);
+        ProcessTake(*take, *m_compBuffer, spanStart, spanFrames);
+        
+        if (r > 0) {
+            ApplyFadeRegion(*m_compBuffer, spanStart, spanFrames, startBoundary - lead, crossfade, fadeIn);
         }
+        if (r + 1 < numRegions) {
+            ApplyFadeRegion(*m_compBuffer, spanStart, spanFrames, endBoundary - lead, crossfade, fadeOut);
+        }
+        
+        float takeGain = static_cast<float>(take->phase ? -take->volume : take->volume);
+        MixToBuffer(*m_compBuffer, buffer, static_cast<int>(spanStart - itemFrame), spanFrames, takeGain);
     }
 }
 
-void MediaItem::ProcessTake(const Take& take, AudioBuffer& buffer, double startTime, double length) {
+void MediaItem::ProcessTake(const Take& take, AudioBuffer& buffer, int64_t itemFrame, int numFrames) {
     if (!take.source || !take.source->IsValid()) return;
     
-    // Calculate source read position
-    double sourceStartTime = take.sourceOffset + (startTime / take.playRate);
-    double sourceLength = length / take.playRate;
+    // Pitch-preserving modes run the streaming stretcher; everything else is varispeed
+    if (UsesStretchEngine(take)) {
+        if (take.stretchMode == StretchMode::RUBBER_BAND) {
+            StretchRubberBand(take, buffer, itemFrame, numFrames);
+        } else {
+            StretchElastique(take, buffer, itemFrame, numFrames);
+        }
+    } else {
+        ProcessVarispeed(take, buffer, itemFrame, numFrames);
+    }
+}
+
+double MediaItem::MapItemToSourceTime(const Take& take, double itemTime) const {
+    const auto& markers = take.stretchMarkers;
+    
+    if (markers.empty()) {
+        return take.sourceOffset + itemTime * take.playRate;
+    }
     
-    // Read audio from source
-    if (!take.source->ReadAudio(buffer, sourceStartTime, sourceLength)) {
-        buffer.Clear(); // Clear buffer if read failed
-        return;
+    // Outside the markers the source plays at the take rate
+    if (itemTime <= markers.front().itemTime) {
+        return markers.front().sourceTime - (markers.front().itemTime - itemTime) * take.playRate;
+    }
+    if (itemTime >= markers.back().itemTime) {
+        return markers.back().sourceTime + (itemTime - markers.back().itemTime) * take.playRate;
+    }
+    
+    double segmentEnd = 0.0;
+    double rate = GetSourceRate(take, itemTime, segmentEnd);
+    auto next = std::upper_bound(markers.begin(), markers.end(), itemTime,
+                                 [](double time, const Take::StretchMarker& m) { return time < m.itemTime; });
+    const auto& previous = *(next - 1);
+    
+    return previous.sourceTime + (itemTime - previous.itemTime) * rate;
+}
+
+double MediaItem::GetSourceRate(const Take& take, double itemTime, double& segmentEnd) const {
+    const auto& markers = take.stretchMarkers;
+    segmentEnd = std::numeric_limits<double>::infinity();
+    
+    if (markers.empty() || itemTime >= markers.back().itemTime) {
+        return take.playRate;
+    }
+    
+    auto next = std::upper_bound(markers.begin(), markers.end(), itemTime,
+                                 [](double time, const Take::StretchMarker& m) { return time < m.itemTime; });
+    segmentEnd = next->itemTime;
+    
+    if (next == markers.begin()) {
+        return take.playRate; // Before the first marker
     }
     
-    // Apply take volume
-    if (take.volume != 1.0f) {
-        buffer.ApplyGain(static_cast<float>(take.volume));
+    const auto& previous = *(next - 1);
+    double itemSpan = next->itemTime - previous.itemTime;
+    if (itemSpan < 1e-9) {
+        return take.playRate;
     }
     
-    // Apply phase invert
-    if (take.phase) {
-        buffer.ApplyGain(-1.0f);
+    return std::max(0.01, (next->sourceTime - previous.sourceTime) / itemSpan);
+}
+
+bool MediaItem::UsesStretchEngine(const Take& take) const {
+    if (take.stretchMode != StretchMode::ELASTIQUE && take.stretchMode != StretchMode::RUBBER_BAND) {
+        return false;
     }
     
-    // Apply pitch shift if needed
     if (std::abs(take.pitch) > 0.01) {
-        // Pitch shifting would be implemented here
-        // This is a complex operation that would require pitch shift algorithms
+        return true;
     }
     
-    // Apply time stretching if play rate != 1.0
-    if (std::abs(take.playRate - 1.0) > 0.01) {
-        // Time stretching implementation based on stretch mode
-        switch (take.stretchMode) {
-            case StretchMode::ELASTIQUE:
-                // StretchElastique(buffer, buffer, take.playRate);
-                break;
-            case StretchMode::RUBBER_BAND:
-                // StretchRubberBand(buffer, buffer, take.playRate);
-                break;
-            case StretchMode::SIMPLE:
-                StretchSimple(buffer, buffer, take.playRate);
-                break;
-            default:
-                break;
-        }
+    // Without pitch preservation a rate change is plain varispeed
+    return take.preservePitch && (std::abs(take.playRate - 1.0) > 1e-6 || !take.stretchMarkers.empty());
+}
+
+void MediaItem::ApplyFades(AudioBuffer& buffer, int64_t itemFrame, int numFrames) {
+    const double sampleRate = buffer.GetSampleRate();
+    const int64_t itemFrames = m_timeline.endSample - m_timeline.startSample;
+    numFrames = std::min(numFrames, buffer.GetSampleCount());
+    
+    // Item fades and crossfades stack; each region only touches the frames it covers
+    if (m_state.fadeIn.enabled) {
+        const auto& table = UpdateFadeTable(m_fadeInTable, m_state.fadeIn.type, m_state.fadeIn.curvature,
+                                            FadeDirection::IN);
+        ApplyFadeRegion(buffer, itemFrame, numFrames, 0,
+                        std::llround(m_state.fadeIn.length * sampleRate), table);
+    }
+    
+    if (m_state.fadeOut.enabled) {
+        const auto& table = UpdateFadeTable(m_fadeOutTable, m_state.fadeOut.type, m_state.fadeOut.curvature,
+                                            FadeDirection::OUT);
+        int64_t fadeOutSamples = std::llround(m_state.fadeOut.length * sampleRate);
+        ApplyFadeRegion(buffer, itemFrame, numFrames, itemFrames - fadeOutSamples, fadeOutSamples, table);
+    }
+    
+    if (m_crossfadeIn.enabled) {
+        const auto& table = UpdateFadeTable(m_crossfadeInTable, m_crossfadeIn.type, m_crossfadeIn.curvature,
+                                            FadeDirection::IN);
+        ApplyFadeRegion(buffer, itemFrame, numFrames, 0,
+                        std::llround(m_crossfadeIn.length * sampleRate), table);
+    }
+    
+    if (m_crossfadeOut.enabled) {
+        const auto& table = UpdateFadeTable(m_crossfadeOutTable, m_crossfadeOut.type, m_crossfadeOut.curvature,
+                                            FadeDirection::MIRRORED_OUT);
+        int64_t crossfadeSamples = std::llround(m_crossfadeOut.length * sampleRate);
+        ApplyFadeRegion(buffer, itemFrame, numFrames, itemFrames - crossfadeSamples, crossfadeSamples, table);
     }
 }
 
-void MediaItem::ApplyFades(AudioBuffer& buffer, double itemStartTime, double itemLength) {
-    int numSamples = buffer.GetSampleCount();
-    double sampleRate = buffer.GetSampleRate();
+bool MediaItem::TouchesFade(int64_t itemFrame, int numFrames, double sampleRate) const {
+    const int64_t itemFrames = m_timeline.endSample - m_timeline.startSample;
+    const int64_t blockEnd = itemFrame + numFrames;
     
-    // Apply fade in
-    if (m_state.fadeIn.enabled && itemStartTime < m_state.fadeIn.length) {
-        int fadeInSamples = static_cast<int>(m_state.fadeIn.length * sampleRate);
-        int startSample = static_cast<int>(itemStartTime * sampleRate);
-        
-        for (int i = 0; i < numSamples; ++i) {
-            int globalSample = startSample + i;
-            if (globalSample < fadeInSamples) {
-                double fadePos = static_cast<double>(globalSample) / fadeInSamples;
-                float gain = CalculateFadeGain(fadePos, m_state.fadeIn);
-                
-                for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
-                    buffer.GetChannelData(ch)[i] *= gain;
-                }
-            }
+    if (m_state.fadeIn.enabled && itemFrame < std::llround(m_state.fadeIn.length * sampleRate)) return true;
+    if (m_crossfadeIn.enabled && itemFrame < std::llround(m_crossfadeIn.length * sampleRate)) return true;
+    if (m_state.fadeOut.enabled && blockEnd > itemFrames - std::llround(m_state.fadeOut.length * sampleRate)) return true;
+    if (m_crossfadeOut.enabled && blockEnd > itemFrames - std::llround(m_crossfadeOut.length * sampleRate)) return true;
+    
+    return false;
+}
+
+void MediaItem::ApplyFadeRegion(AudioBuffer& buffer, int64_t itemFrame, int numFrames,
+                                int64_t regionStart, int64_t regionLength, const FadeTable& table) const {
+    if (regionLength <= 0) return;
+    
+    int64_t begin = std::max(itemFrame, regionStart);
+    int64_t end = std::min(itemFrame + numFrames, regionStart + regionLength);
+    if (end <= begin) return;
+    
+    // Table position advances by a fixed step per sample
+    const double step = static_cast<double>(FADE_TABLE_SIZE) / regionLength;
+    float gains[FADE_CHUNK_FRAMES];
+    
+    for (int64_t chunkStart = begin; chunkStart < end; chunkStart += FADE_CHUNK_FRAMES) {
+        int count = static_cast<int>(std::min<int64_t>(FADE_CHUNK_FRAMES, end - chunkStart));
+        double base = (chunkStart - regionStart) * step;
+        
+        for (int i = 0; i < count; ++i) {
+            double x = base + i * step;
+            int index = std::min(static_cast<int>(x), FADE_TABLE_SIZE - 1);
+            float fraction = static_cast<float>(x - index);
+            gains[i] = table.gains[index] + fraction * (table.gains[index + 1] - table.gains[index]);
         }
+        
+        buffer.ApplyGainCurve(gains, static_cast<int>(chunkStart - itemFrame), count);
+    }
+}
+
+const MediaItem::FadeTable& MediaItem::UpdateFadeTable(FadeTable& table, FadeType type, double curvature,
+                                                       FadeDirection direction) {
+    if (table.valid && table.type == type && table.curvature == curvature) {
+        return table;
     }
     
-    // Apply fade out
-    if (m_state.fadeOut.enabled) {
-        double fadeOutStart = m_state.length - m_state.fadeOut.length;
-        double fadeOutEnd = m_state.length;
+    for (int i = 0; i <= FADE_TABLE_SIZE; ++i) {
+        double position = static_cast<double>(i) / FADE_TABLE_SIZE;
+        double gain = 0.0;
         
-        if (itemStartTime + itemLength > fadeOutStart) {
-            int fadeOutSamples = static_cast<int>(m_state.fadeOut.length * sampleRate);
-            int itemEndSample = static_cast<int>(m_state.length * sampleRate);
-            int startSample = static_cast<int>(itemStartTime * sampleRate);
-            
-            for (int i = 0; i < numSamples; ++i) {
-                int globalSample = startSample + i;
-                int fadeOutSample = itemEndSample - globalSample;
-                
-                if (fadeOutSample > 0 && fadeOutSample <= fadeOutSamples) {
-                    double fadePos = 1.0 - (static_cast<double>(fadeOutSample) / fadeOutSamples);
-                    float gain = 1.0f - CalculateFadeGain(fadePos, m_state.fadeOut);
-                    
-                    for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
-                        buffer.GetChannelData(ch)[i] *= gain;
-                    }
-                }
-            }
+        switch (direction) {
+            case FadeDirection::IN:
+                gain = EvaluateFadeCurve(position, type, curvature);
+                break;
+            case FadeDirection::OUT:
+                gain = 1.0 - EvaluateFadeCurve(position, type, curvature);
+                break;
+            case FadeDirection::MIRRORED_OUT:
+                gain = EvaluateFadeCurve(1.0 - position, type, curvature);
+                break;
         }
+        
+        table.gains[i] = static_cast<float>(gain);
     }
+    
+    table.type = type;
+    table.curvature = curvature;
+    table.valid = true;
+    return table;
 }
 
-float MediaItem::CalculateFadeGain(double position, const Fade& fade) const {
-    if (position <= 0.0) return 0.0f;
-    if (position >= 1.0) return 1.0f;
+double MediaItem::EvaluateFadeCurve(double position, FadeType type, double curvature) {
+    if (position <= 0.0) return 0.0;
+    if (position >= 1.0) return 1.0;
     
     double gain = 0.0;
     
-    switch (fade.type) {
+    switch (type) {
         case FadeType::LINEAR:
             gain = position;
             break;
@@ -436,34 +993,41 @@ float MediaItem::CalculateFadeGain(double position, const Fade& fade) const {
     }
     
     // Apply curvature adjustment
-    if (std::abs(fade.curvature) > 0.01) {
-        if (fade.curvature > 0.0) {
-            gain = std::pow(gain, 1.0 + fade.curvature);
+    if (std::abs(curvature) > 0.01) {
+        if (curvature > 0.0) {
+            gain = std::pow(gain, 1.0 + curvature);
         } else {
-            gain = 1.0 - std::pow(1.0 - gain, 1.0 - fade.curvature);
+            gain = 1.0 - std::pow(1.0 - gain, 1.0 - curvature);
         }
     }
     
-    return static_cast<float>(std::max(0.0, std::min(1.0, gain)));
+    return std::max(0.0, std::min(1.0, gain));
 }
 
-void MediaItem::StretchSimple(AudioBuffer& input, AudioBuffer& output, double ratio) {
-    // Simple linear interpolation time stretching
-    // This is a basic implementation - professional time stretching is much more complex
-    
+void MediaItem::StretchElastique(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames) {
+    // Low-CPU mode: WSOLA
+    ProcessStretched(take, output, itemFrame, numFrames, TimeStretcher::Algorithm::WSOLA);
+}
+
+void MediaItem::StretchRubberBand(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames) {
+    // Quality mode: phase-locked vocoder
+    ProcessStretched(take, output, itemFrame, numFrames, TimeStretcher::Algorithm::PHASE_VOCODER);
+}
+
+void MediaItem::StretchSimple(const AudioBuffer& input, double inputPosition, double increment,
+                              AudioBuffer& output, int outputStart, int numFrames) {
+    // Simple linear interpolation (varispeed - pitch follows rate)
     int inputSamples = input.GetSampleCount();
-    int outputSamples = static_cast<int>(inputSamples * ratio);
+    int channels = std::min(input.GetChannelCount(), output.GetChannelCount());
     
-    output.SetSize(input.GetChannelCount(), outputSamples);
-    
-    for (int ch = 0; ch < input.GetChannelCount(); ++ch) {
+    for (int ch = 0; ch < channels; ++ch) {
         const float* inputData = input.GetChannelData(ch);
-        float* outputData = output.GetChannelData(ch);
+        float* outputData = output.GetChannelData(ch) + outputStart;
         
-        for (int i = 0; i < outputSamples; ++i) {
-            double sourcePos = i / ratio;
+        for (int i = 0; i < numFrames; ++i) {
+            double sourcePos = inputPosition + i * increment;
             int sourceIndex = static_cast<int>(sourcePos);
-            double fraction = sourcePos - sourceIndex;
+            float fraction = static_cast<float>(sourcePos - sourceIndex);
             
             if (sourceIndex < inputSamples - 1) {
                 // Linear interpolation
@@ -478,24 +1042,148 @@ void MediaItem::StretchSimple(AudioBuffer& input, AudioBuffer& output, double ra
     }
 }
 
-bool MediaItem::ContainsTime(double time) const {
-    return time >= m_state.position && time < GetEndPosition();
+void MediaItem::ProcessStretched(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames,
+                                 TimeStretcher::Algorithm algorithm) {
+    const double sampleRate = output.GetSampleRate();
+    const int numChannels = take.source->GetInfo().channels;
+    
+    output.SetSize(numChannels, numFrames);
+    
+    TakeStretchState* state = GetStretchState(take, numChannels, sampleRate, algorithm);
+    if (!state) {
+        output.Clear();
+        return;
+    }
+    
+    // Seeks restart the stretcher; contiguous blocks continue the stream
+    if (itemFrame != state->nextItemFrame) {
+        state->stretcher.Reset();
+        state->sourceFrame = std::llround(MapItemToSourceTime(take, itemFrame / sampleRate) * sampleRate);
+    }
+    
+    const double semitoneScale = std::pow(2.0, take.pitch / 12.0);
+    int produced = 0;
+    
+    while (produced < numFrames) {
+        // Stretch markers change the ratio at segment boundaries
+        double segmentEnd = 0.0;
+        double rate = GetSourceRate(take, (itemFrame + produced + 0.5) / sampleRate, segmentEnd);
+        int segmentFrames = numFrames - produced;
+        if (std::isfinite(segmentEnd)) {
+            int64_t remaining = std::llround(segmentEnd * sampleRate) - (itemFrame + produced);
+            segmentFrames = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(remaining, segmentFrames)));
+        }
+        
+        state->stretcher.SetTimeRatio(1.0 / rate);
+        state->stretcher.SetPitchScale(semitoneScale * (take.preservePitch ? 1.0 : rate));
+        
+        int segmentTarget = produced + segmentFrames;
+        while (produced < segmentTarget) {
+            int available = state->stretcher.GetAvailable();
+            if (available > 0) {
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    state->outputPtrs[ch] = output.GetChannelData(ch) + produced;
+                }
+                produced += state->stretcher.Retrieve(state->outputPtrs.data(),
+                                                      std::min(available, segmentTarget - produced));
+                continue;
+            }
+            
+            int required = std::max(1, std::min(state->stretcher.GetSamplesRequired(), STRETCH_CHUNK_FRAMES));
+            if (!take.source->ReadAudioFrames(*state->sourceBuffer, state->sourceFrame, required, sampleRate)) {
+                output.ClearRange(produced, numFrames - produced);
+                state->nextItemFrame = -1;
+                return;
+            }
+            
+            state->stretcher.Process(state->sourceBuffer->GetChannelPointers(), required);
+            state->sourceFrame += required;
+        }
+    }
+    
+    state->nextItemFrame = itemFrame + numFrames;
 }
 
-bool MediaItem::OverlapsTimeRange(double start, double end) const {
-    return !(end <= m_state.position || start >= GetEndPosition());
-}
+void MediaItem::ProcessVarispeed(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames) {
+    const double sampleRate = output.GetSampleRate();
+    
+    output.SetSize(take.source->GetInfo().channels, numFrames);
+    
+    if (!m_stretchInput) {
+        m_stretchInput = std::make_unique<AudioBuffer>();
+    }
+    
+    int produced = 0;
+    while (produced < numFrames) {
+        double segmentEnd = 0.0;
+        double rate = GetSourceRate(take, (itemFrame + produced + 0.5) / sampleRate, segmentEnd);
+        int segmentFrames = numFrames - produced;
+        if (std::isfinite(segmentEnd)) {
+            int64_t remaining = std::llround(segmentEnd * sampleRate) - (itemFrame + produced);
+            segmentFrames = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(remaining, segmentFrames)));
+        }
+        
+        double sourcePosition = MapItemToSourceTime(take, (itemFrame + produced) / sampleRate) * sampleRate;
+        int64_t firstFrame = static_cast<int64_t>(std::floor(sourcePosition));
+        double fraction = sourcePosition - firstFrame;
+        
+        if (std::abs(rate - 1.0) < 1e-9 && fraction < 1e-6) {
+            // Unity rate on a sample boundary: plain copy
+            if (!take.source->ReadAudioFrames(*m_stretchInput, firstFrame, segmentFrames, sampleRate)) break;
+            output.CopyFrom(*m_stretchInput, 0, produced, segmentFrames);
+        } else {
+            int span = static_cast<int>(std::ceil(fraction + rate * (segmentFrames - 1))) + 2;
+            if (!take.source->ReadAudioFrames(*m_stretchInput, firstFrame, span, sampleRate)) break;
+            StretchSimple(*m_stretchInput, fraction, rate, output, produced, segmentFrames);
+        }
+        
+        produced += segmentFrames;
+    }
+    
+    if (produced < numFrames) {
+        output.ClearRange(produced, numFrames - produced);
+    }
+}
 
-double MediaItem::GetTimeInItem(double globalTime) const {
-    return globalTime - m_state.position;
+MediaItem::TakeStretchState* MediaItem::GetStretchState(const Take& take, int numChannels, double sampleRate,
+                                                        TimeStretcher::Algorithm algorithm) {
+    auto& slot = m_stretchStates[take.guid];
+    if (!slot) {
+        slot = std::make_unique<TakeStretchState>();
+    }
+    
+    TakeStretchState& state = *slot;
+    TimeStretcher& stretcher = state.stretcher;
+    
+    if (!stretcher.IsPrepared() || stretcher.GetAlgorithm() != algorithm ||
+        stretcher.GetNumChannels() != numChannels || stretcher.GetSampleRate() != sampleRate) {
+        if (!stretcher.Prepare(sampleRate, numChannels, algorithm)) {
+            return nullptr;
+        }
+        state.sourceBuffer = std::make_unique<AudioBuffer>(numChannels, STRETCH_CHUNK_FRAMES);
+        state.outputPtrs.resize(numChannels);
+        state.nextItemFrame = -1;
+    }
+    
+    return &state;
+}
+
+bool MediaItem::ContainsTime(double time) const {
+    return time >= m_state.position && time < GetEndPosition();
 }
 
-const MediaItem::ItemState& MediaItem::GetState() const {
-    return m_state;
+bool MediaItem::OverlapsTimeRange(double start, double end) const {
+    return !(end <= m_state.position || start >= GetEndPosition());
+}
+
+double MediaItem::GetTimeInItem(double globalTime) const {
+    return globalTime - m_state.position;
 }
 
 void MediaItem::SetState(const ItemState& state) {
+    ++m_revision;
     m_state = state;
+    m_stretchStates.clear(); // Rebuilt on next playback
 }
 
 std::string MediaItem::GenerateGUID() {
@@ -517,12 +1205,7 @@ std::string MediaItem::GenerateGUID() {
 }
 
 double MediaItem::ApplyFadeCurve(double position, FadeType type, double curvature) {
-    // Static version of fade curve calculation
-    MediaItem dummy(nullptr);
-    Fade fade;
-    fade.type = type;
-    fade.curvature = curvature;
-    return dummy.CalculateFadeGain(position, fade);
+    return EvaluateFadeCurve(position, type, curvature);
 }
 
 // AudioSource Implementation
@@ -552,21 +1235,72 @@ AudioSource::AudioSource(SourceType type) {
     }
 }
 
-AudioSource::~AudioSource() = default;
+AudioSource::~AudioSource() {
+    ReleaseFileData();
+}
+
+std::shared_ptr<AudioSource> AudioSource::GetShared(const std::string& filePath) {
+    static std::mutex s_mutex;
+    static std::unordered_map<std::string, std::weak_ptr<AudioSource>> s_sources;
+    
+    std::lock_guard<std::mutex> lock(s_mutex);
+    
+    auto& slot = s_sources[filePath];
+    if (auto existing = slot.lock()) {
+        return existing;
+    }
+    
+    auto source = std::make_shared<AudioSource>(filePath);
+    slot = source;
+    return source;
+}
 
 bool AudioSource::ReadAudio(AudioBuffer& buffer, double startTime, double length) {
     if (!m_info.isValid || !m_dataLoaded) {
         return false;
     }
     
-    int startSample = static_cast<int>(startTime * m_info.sampleRate);
-    int numSamples = static_cast<int>(length * m_info.sampleRate);
+    // Deliver audio at the rate of the destination buffer (project rate)
+    double targetRate = buffer.GetSampleRate();
+    int64_t outputStart = std::llround(startTime * targetRate);
+    int numOutputFrames = static_cast<int>(std::llround(length * targetRate));
     
-    return ReadAudioSamples(buffer, startSample, numSamples);
+    return ReadAudioFrames(buffer, outputStart, numOutputFrames, targetRate);
 }
 
-bool AudioSource::ReadAudioSamples(AudioBuffer& buffer, int startSample, int numSamples) {
-    if (!m_info.isValid || !m_dataLoaded || m_audioData.empty()) {
+bool AudioSource::ReadAudioFrames(AudioBuffer& buffer, int64_t startFrame, int numFrames, double sampleRate) {
+    if (!m_info.isValid || !m_dataLoaded) {
+        return false;
+    }
+    
+    if (ResampleIfNeeded(buffer, startFrame, numFrames, sampleRate)) {
+        return true;
+    }
+    
+    return ReadAudioSamples(buffer, startFrame, numFrames);
+}
+
+bool AudioSource::ReadAudioSamples(AudioBuffer& buffer, int64_t startSample, int numSamples) {
+    if (!m_info.isValid || !m_dataLoaded) {
+        return false;
+    }
+    
+    // Recordings read their resident chunks first, then the file behind them
+    if (m_recordTable) {
+        buffer.SetSize(m_info.channels, numSamples);
+        ReadRecordedFrames(startSample, numSamples, buffer.GetChannelPointers());
+        return true;
+    }
+    
+    // Streamed sources read through the shared block cache; blocks still
+    // being decoded play as silence rather than stalling the audio thread
+    if (m_cacheHandle) {
+        buffer.SetSize(m_info.channels, numSamples);
+        AudioBlockCache::GetInstance().Read(m_cacheHandle, startSample, numSamples, buffer.GetChannelPointers());
+        return true;
+    }
+    
+    if (m_audioData.empty()) {
         return false;
     }
     
@@ -576,26 +1310,463 @@ bool AudioSource::ReadAudioSamples(AudioBuffer& buffer, int startSample, int num
         float* bufferData = buffer.GetChannelData(ch);
         const auto& channelData = m_audioData[ch];
         
-        for (int i = 0; i < numSamples; ++i) {
-            int sourceIndex = startSample + i;
-            if (sourceIndex >= 0 && sourceIndex < static_cast<int>(channelData.size())) {
-                bufferData[i] = channelData[sourceIndex];
-            } else {
-                bufferData[i] = 0.0f; // Silence for out-of-bounds
-            }
+        // Copy the in-range span, silence outside the source
+        int64_t sourceLength = static_cast<int64_t>(channelData.size());
+        int begin = static_cast<int>(std::min<int64_t>(numSamples, std::max<int64_t>(0, -startSample)));
+        int end = static_cast<int>(std::max<int64_t>(begin, std::min<int64_t>(numSamples, sourceLength - startSample)));
+        
+        std::fill(bufferData, bufferData + begin, 0.0f);
+        if (end > begin) {
+            std::copy(channelData.begin() + (startSample + begin), channelData.begin() + (startSample + end),
+                      bufferData + begin);
+        }
+        std::fill(bufferData + end, bufferData + numSamples, 0.0f);
+    }
+    
+    return true;
+}
+
+bool AudioSource::MixAudioFrames(AudioBuffer& dest, int destStart, int64_t startFrame, int numFrames,
+                                 double sampleRate, float gain) const {
+    // Recordings have no flat copy to mix from; callers fall back to ReadAudioFrames
+    if (!m_info.isValid || !m_dataLoaded || m_recordTable || sampleRate != m_info.sampleRate) {
+        return false;
+    }
+    if (!m_cacheHandle && m_audioData.empty()) {
+        return false;
+    }
+    
+    numFrames = std::min(numFrames, dest.GetSampleCount() - destStart);
+    if (destStart < 0 || numFrames <= 0) {
+        return true; // Nothing audible
+    }
+    
+    // Streamed sources mix straight out of the cache slots; blocks still
+    // being decoded add nothing, as they read as silence in ReadAudioSamples
+    if (m_cacheHandle) {
+        AudioBlockCache::GetInstance().Mix(m_cacheHandle, startFrame, numFrames, dest.GetChannelPointers(),
+                                           dest.GetChannelCount(), destStart, gain);
+        return true;
+    }
+    
+    // Only the span inside the source contributes
+    int64_t sourceLength = static_cast<int64_t>(m_audioData[0].size());
+    int begin = static_cast<int>(std::min<int64_t>(numFrames, std::max<int64_t>(0, -startFrame)));
+    int end = static_cast<int>(std::max<int64_t>(begin, std::min<int64_t>(numFrames, sourceLength - startFrame)));
+    
+    for (int ch = 0; ch < dest.GetChannelCount(); ++ch) {
+        // Mono sources play on every channel
+        int sourceChannel = m_info.channels == 1 ? 0 : ch;
+        if (sourceChannel >= static_cast<int>(m_audioData.size())) break;
+        
+        const float* src = m_audioData[sourceChannel].data();
+        float* dst = dest.GetChannelData(ch) + destStart;
+        
+        for (int i = begin; i < end; ++i) {
+            dst[i] += src[startFrame + i] * gain;
         }
     }
     
     return true;
 }
 
+void AudioSource::PrepareForPlayback(double sampleRate) {
+    if (m_info.isValid && sampleRate > 0.0 && sampleRate != m_info.sampleRate) {
+        PrepareResampler(sampleRate);
+    }
+}
+
+void AudioSource::EnableCaching(bool enable) {
+    if (enable == m_cachingEnabled) return;
+    
+    m_cachingEnabled = enable;
+    
+    // Reload so the file switches between streaming and fully decoded
+    if (m_info.type == SourceType::FILE && m_info.isValid) {
+        LoadFromFile(m_info.filePath);
+    }
+}
+
 void AudioSource::ClearCache() {
-    m_cachedBuffers.clear();
     m_peakCache.clear();
+    AudioBlockCache::GetInstance().InvalidateSource(m_cacheHandle);
+}
+
+void AudioSource::Prefetch(int64_t startFrame, int numFrames) {
+    if (m_cacheHandle) {
+        AudioBlockCache::GetInstance().Preload(m_cacheHandle, startFrame, numFrames);
+    }
+}
+
+void AudioSource::GetPrefetchBlocks(int64_t startFrame, int numFrames,
+                                    std::vector<AudioBlockCache::BlockRef>& blocks) const {
+    if (m_cacheHandle) {
+        AudioBlockCache::GetInstance().GetBlockRefs(m_cacheHandle, startFrame, numFrames, blocks);
+    }
+}
+
+bool AudioSource::DecodeFrames(int64_t startFrame, int numFrames, float* const* channels) {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    
+    if (!m_file.is_open() || numFrames <= 0) {
+        return false;
+    }
+    
+    // A recording's blocks are decoded once the writer has put them in the file
+    if (m_recording.load() && startFrame + numFrames > m_durableFrames.load(std::memory_order_acquire)) {
+        return false;
+    }
+    
+    const int numChannels = m_info.channels;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::fill(channels[ch], channels[ch] + numFrames, 0.0f);
+    }
+    
+    // Frames outside the data chunk stay silent
+    int64_t begin = std::max<int64_t>(0, startFrame);
+    int64_t end = std::min<int64_t>(startFrame + numFrames, m_fileLayout.numFrames);
+    if (end <= begin) {
+        return true;
+    }
+    
+    const int count = static_cast<int>(end - begin);
+    const int destOffset = static_cast<int>(begin - startFrame);
+    const int blockAlign = m_fileLayout.blockAlign;
+    const int bytesPerSample = m_fileLayout.bytesPerSample;
+    
+    m_decodeBytes.resize(static_cast<size_t>(count) * blockAlign);
+    m_file.clear();
+    m_file.seekg(m_fileLayout.dataOffset + begin * blockAlign);
+    m_file.read(m_decodeBytes.data(), static_cast<std::streamsize>(m_decodeBytes.size()));
+    if (m_file.gcount() != static_cast<std::streamsize>(m_decodeBytes.size())) {
+        return false;
+    }
+    
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(m_decodeBytes.data());
+    
+    if (m_fileLayout.isFloat && bytesPerSample == 4) {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) {
+                               uint32_t bits = ReadLE32(p);
+                               float value;
+                               std::memcpy(&value, &bits, sizeof(value));
+                               return value;
+                           });
+    } else if (m_fileLayout.isFloat) {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) {
+                               uint64_t bits = ReadLE64(p);
+                               double value;
+                               std::memcpy(&value, &bits, sizeof(value));
+                               return static_cast<float>(value);
+                           });
+    } else if (bytesPerSample == 1) {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) { return (static_cast<int>(p[0]) - 128) * (1.0f / 128.0f); });
+    } else if (bytesPerSample == 2) {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) {
+                               return static_cast<int16_t>(ReadLE16(p)) * (1.0f / 32768.0f);
+                           });
+    } else if (bytesPerSample == 3) {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) {
+                               // Sign-extend from the top byte
+                               int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 |
+                                                                    static_cast<uint32_t>(p[1]) << 16 |
+                                                                    static_cast<uint32_t>(p[2]) << 24) >> 8;
+                               return value * (1.0f / 8388608.0f);
+                           });
+    } else {
+        DeinterleaveFrames(bytes, count, numChannels, bytesPerSample, blockAlign, channels, destOffset,
+                           [](const unsigned char* p) {
+                               return static_cast<float>(static_cast<int32_t>(ReadLE32(p)) * (1.0 / 2147483648.0));
+                           });
+    }
+    
+    return true;
+}
+
+bool AudioSource::BeginRecording(const std::string& filePath, double sampleRate, int numChannels, int64_t dataOffset,
+                                 int bitsPerSample, bool isFloat) {
+    ReleaseFileData();
+    m_info.isValid = false;
+    
+    std::ifstream file(filePath, std::ios::binary);
+    const bool validFormat = isFloat ? bitsPerSample == 32 :
+                             (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    if (!file.is_open() || numChannels <= 0 || numChannels > 255 || sampleRate <= 0.0 || !validFormat) {
+        return false;
+    }
+    
+    m_info.type = SourceType::RECORDING;
+    m_info.filePath = filePath;
+    m_info.length = 0.0;
+    m_info.sampleRate = sampleRate;
+    m_info.channels = numChannels;
+    m_info.bitDepth = bitsPerSample;
+    m_info.format = "WAV";
+    
+    // Frames from dataOffset on; how far the file goes is tracked by
+    // m_durableFrames until the recording finishes. Resident chunks keep
+    // the float input, so only the file side sees the sample format.
+    const int64_t capacity = static_cast<int64_t>(MAX_RECORD_CHUNKS) * AudioBlockCache::BLOCK_FRAMES;
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        m_file = std::move(file);
+        m_fileLayout.dataOffset = dataOffset;
+        m_fileLayout.numFrames = capacity;
+        m_fileLayout.bytesPerSample = bitsPerSample / 8;
+        m_fileLayout.blockAlign = numChannels * m_fileLayout.bytesPerSample;
+        m_fileLayout.isFloat = isFloat;
+    }
+    
+    m_recordTable = std::make_unique<std::atomic<RecordChunk*>[]>(MAX_RECORD_CHUNKS);
+    for (int i = 0; i < MAX_RECORD_CHUNKS; ++i) {
+        m_recordTable[i].store(nullptr, std::memory_order_relaxed);
+    }
+    m_recordReadPtrs.resize(numChannels);
+    m_recordedFrames = 0;
+    m_durableFrames = 0;
+    m_cacheHandle = AudioBlockCache::GetInstance().RegisterSource(this, numChannels, capacity);
+    
+    m_recording = true;
+    m_dataLoaded = true;
+    m_info.isValid = true;
+    return true;
+}
+
+void AudioSource::AppendRecording(const float* const* channels, int numFrames) {
+    if (!m_recordTable) return;
+    
+    const int numChannels = m_info.channels;
+    int64_t frame = m_recordedFrames.load(std::memory_order_relaxed);
+    int done = 0;
+    
+    while (done < numFrames) {
+        const int64_t chunkIndex = frame / AudioBlockCache::BLOCK_FRAMES;
+        const int offset = static_cast<int>(frame % AudioBlockCache::BLOCK_FRAMES);
+        if (chunkIndex >= MAX_RECORD_CHUNKS) {
+            break; // Past the playable length; the file still gets everything
+        }
+        
+        RecordChunk* chunk = offset == 0 ? AttachRecordChunk(chunkIndex) : m_residentChunks.back();
+        const int count = std::min(numFrames - done, AudioBlockCache::BLOCK_FRAMES - offset);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::memcpy(chunk->data.get() + static_cast<size_t>(ch) * AudioBlockCache::BLOCK_FRAMES + offset,
+                        channels[ch] + done, sizeof(float) * count);
+        }
+        
+        done += count;
+        frame += count;
+        
+        // Samples become visible with the frame count that covers them
+        m_recordedFrames.store(frame, std::memory_order_release);
+    }
+}
+
+void AudioSource::SetDurableFrames(int64_t numFrames) {
+    m_durableFrames.store(numFrames, std::memory_order_release);
+}
+
+void AudioSource::FinishRecording(int64_t numFrames) {
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        m_fileLayout.numFrames = numFrames;
+    }
+    
+    m_durableFrames.store(numFrames, std::memory_order_release);
+    m_recording = false;
+    m_info.length = numFrames / m_info.sampleRate;
+}
+
+AudioSource::RecordChunk* AudioSource::AttachRecordChunk(int64_t chunkIndex) {
+    // Chunks the file already holds give up their buffers, the newest few excepted
+    const int64_t durable = m_durableFrames.load(std::memory_order_relaxed);
+    while (static_cast<int>(m_residentChunks.size()) >= RESIDENT_RECORD_CHUNKS &&
+           (m_residentChunks.front()->index.load(std::memory_order_relaxed) + 1) * AudioBlockCache::BLOCK_FRAMES <= durable) {
+        RecordChunk* oldest = m_residentChunks.front();
+        m_residentChunks.pop_front();
+        m_recordTable[oldest->index.load(std::memory_order_relaxed)].store(nullptr, std::memory_order_release);
+        m_freeChunks.push_back(oldest);
+    }
+    
+    // With the file lagging, hold more audio rather than drop any
+    RecordChunk* chunk = nullptr;
+    if (!m_freeChunks.empty()) {
+        chunk = m_freeChunks.back();
+        m_freeChunks.pop_back();
+    } else {
+        m_recordPool.push_back(std::make_unique<RecordChunk>());
+        chunk = m_recordPool.back().get();
+        chunk->data.reset(new float[static_cast<size_t>(m_info.channels) * AudioBlockCache::BLOCK_FRAMES]);
+    }
+    
+    // Seqlock write: odd version while the buffer changes hands
+    uint32_t version = chunk->version.load(std::memory_order_relaxed);
+    chunk->version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    chunk->index.store(chunkIndex, std::memory_order_relaxed);
+    chunk->version.store(version + 2, std::memory_order_release);
+    
+    m_recordTable[chunkIndex].store(chunk, std::memory_order_release);
+    m_residentChunks.push_back(chunk);
+    return chunk;
+}
+
+void AudioSource::ReadRecordedFrames(int64_t startFrame, int numFrames, float* const* channels) {
+    const int numChannels = m_info.channels;
+    const int64_t recorded = m_recordedFrames.load(std::memory_order_acquire);
+    const int64_t durable = m_durableFrames.load(std::memory_order_acquire);
+    
+    int done = 0;
+    while (done < numFrames) {
+        const int64_t frame = startFrame + done;
+        const int64_t chunkIndex = frame >= 0 ? frame / AudioBlockCache::BLOCK_FRAMES : -1;
+        const int offset = frame >= 0 ? static_cast<int>(frame % AudioBlockCache::BLOCK_FRAMES) : 0;
+        const int count = frame >= 0 ? std::min(numFrames - done, AudioBlockCache::BLOCK_FRAMES - offset)
+                                     : static_cast<int>(std::min<int64_t>(numFrames - done, -frame));
+        
+        // Only recorded frames are audible: resident chunk first, then the file
+        const int valid = frame >= 0 ? static_cast<int>(std::clamp<int64_t>(recorded - frame, 0, count)) : 0;
+        bool read = valid == 0 || CopyRecordedChunk(chunkIndex, offset, valid, channels, done);
+        if (!read && m_cacheHandle && (chunkIndex + 1) * AudioBlockCache::BLOCK_FRAMES <= durable) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                m_recordReadPtrs[ch] = channels[ch] + done;
+            }
+            AudioBlockCache::GetInstance().Read(m_cacheHandle, frame, valid, m_recordReadPtrs.data());
+            read = true;
+        }
+        
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* dest = channels[ch] + done;
+            std::fill(dest + (read ? valid : 0), dest + count, 0.0f);
+        }
+        done += count;
+    }
+}
+
+bool AudioSource::CopyRecordedChunk(int64_t chunkIndex, int offset, int count, float* const* channels,
+                                    int destOffset) const {
+    if (chunkIndex < 0 || chunkIndex >= MAX_RECORD_CHUNKS) return false;
+    
+    const RecordChunk* chunk = m_recordTable[chunkIndex].load(std::memory_order_acquire);
+    if (!chunk) return false;
+    
+    uint32_t version = chunk->version.load(std::memory_order_acquire);
+    if ((version & 1u) != 0 || chunk->index.load(std::memory_order_relaxed) != chunkIndex) {
+        return false;
+    }
+    
+    for (int ch = 0; ch < m_info.channels; ++ch) {
+        std::memcpy(channels[ch] + destOffset,
+                    chunk->data.get() + static_cast<size_t>(ch) * AudioBlockCache::BLOCK_FRAMES + offset,
+                    sizeof(float) * count);
+    }
+    
+    // A writer that recycled the buffer during the copy bumped the version
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return chunk->version.load(std::memory_order_relaxed) == version;
+}
+
+void AudioSource::SetResampleQuality(SampleRateConverter::Quality quality) {
+    // The streams are rebuilt with the new filter by the next PrepareForPlayback,
+    // never on the audio thread
+    m_resampleQuality = quality;
+}
+
+bool AudioSource::ResampleIfNeeded(AudioBuffer& buffer, int64_t outputStart, int numOutputFrames, double targetSampleRate) {
+    if (targetSampleRate <= 0.0 || targetSampleRate == m_info.sampleRate) {
+        return false; // Source already runs at the target rate
+    }
+    
+    buffer.SetSize(m_info.channels, numOutputFrames);
+    
+    // Streams are built by PrepareForPlayback; a rate it has not seen plays silence
+    if (targetSampleRate != m_resampleTargetRate || m_resampleStreams.empty()) {
+        buffer.Clear();
+        return true;
+    }
+    
+    // Seeks restart the filter; contiguous reads continue the stream
+    ResampleStream& stream = *AcquireResampleStream(outputStart);
+    if (outputStart != stream.nextOutput) {
+        stream.sourceCursor = stream.resampler->ResetForOutputFrame(outputStart);
+    }
+    
+    int produced = 0;
+    while (produced < numOutputFrames) {
+        int chunk = std::min(stream.resampler->GetInputFramesNeeded(numOutputFrames - produced), RESAMPLE_CHUNK_FRAMES);
+        
+        if (chunk > 0) {
+            ReadAudioSamples(*stream.input, stream.sourceCursor, chunk);
+        }
+        
+        for (int ch = 0; ch < m_info.channels; ++ch) {
+            stream.outputPtrs[ch] = buffer.GetChannelData(ch) + produced;
+        }
+        
+        // Frames the converter did not take are read again with the next chunk
+        int consumed = 0;
+        int written = stream.resampler->Process(stream.input->GetChannelPointers(), chunk,
+                                                stream.outputPtrs.data(), numOutputFrames - produced, &consumed);
+        stream.sourceCursor += consumed;
+        produced += written;
+        
+        if (consumed == 0 && written == 0) break;
+    }
+    
+    stream.nextOutput = outputStart + numOutputFrames;
+    return true;
+}
+
+void AudioSource::PrepareResampler(double targetSampleRate) {
+    if (targetSampleRate == m_resampleTargetRate && m_resampleQuality == m_resampleStreamQuality &&
+        !m_resampleStreams.empty()) {
+        return;
+    }
+    
+    // Every stream exists up front so a new reader on the audio thread only takes one over
+    m_resampleTargetRate = targetSampleRate;
+    m_resampleStreamQuality = m_resampleQuality;
+    m_resampleStreams.clear();
+    m_resampleStreams.reserve(MAX_RESAMPLE_STREAMS);
+    for (int i = 0; i < MAX_RESAMPLE_STREAMS; ++i) {
+        ResampleStream stream;
+        stream.resampler = std::make_unique<SampleRateConverter>();
+        stream.resampler->Prepare(m_info.sampleRate, m_resampleTargetRate, m_info.channels,
+                                  RESAMPLE_CHUNK_FRAMES, m_resampleQuality);
+        stream.input = std::make_unique<AudioBuffer>(m_info.channels, RESAMPLE_CHUNK_FRAMES);
+        stream.outputPtrs.resize(m_info.channels);
+        m_resampleStreams.push_back(std::move(stream));
+    }
+}
+
+AudioSource::ResampleStream* AudioSource::AcquireResampleStream(int64_t outputStart) {
+    ++m_resampleReadCount;
+    
+    // The reader continuing at outputStart keeps its stream
+    ResampleStream* oldest = &m_resampleStreams.front();
+    for (auto& stream : m_resampleStreams) {
+        if (stream.nextOutput == outputStart) {
+            stream.lastUsed = m_resampleReadCount;
+            return &stream;
+        }
+        if (stream.lastUsed < oldest->lastUsed) {
+            oldest = &stream;
+        }
+    }
+    
+    // A new reader takes an unused stream, else the least recently used
+    oldest->nextOutput = -1;
+    oldest->lastUsed = m_resampleReadCount;
+    return oldest;
 }
 
 bool AudioSource::LoadFromFile(const std::string& filePath) {
+    ReleaseFileData();
     m_info.filePath = filePath;
+    m_info.isValid = false;
     
     // Determine file type and load accordingly
     std::string extension = filePath.substr(filePath.find_last_of('.') + 1);
@@ -618,30 +1789,169 @@ bool AudioSource::LoadFromFile(const std::string& filePath) {
 }
 
 bool AudioSource::LoadWAVFile(const std::string& filePath) {
-    // Simplified WAV loading - in a real implementation, you'd use a proper audio library
     std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open()) {
+    if (!file.is_open() || !ParseWAVHeader(file)) {
         return false;
     }
     
-    // This is a very basic WAV reader - real implementation would be much more robust
-    // For now, just set some default values
-    m_info.sampleRate = 48000.0;
-    m_info.channels = 2;
-    m_info.bitDepth = 24;
-    m_info.format = "WAV";
-    m_info.length = 10.0; // Default length
+    m_info.length = m_fileLayout.numFrames / m_info.sampleRate;
     
-    // Initialize with silence for now
-    int totalSamples = static_cast<int>(m_info.length * m_info.sampleRate);
-    m_audioData.resize(m_info.channels);
-    for (auto& channel : m_audioData) {
-        channel.resize(totalSamples, 0.0f);
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        m_file = std::move(file);
     }
     
+    // Cached sources stream: blocks are decoded on demand into the shared cache
+    if (m_cachingEnabled) {
+        m_cacheHandle = AudioBlockCache::GetInstance().RegisterSource(this, m_info.channels, m_fileLayout.numFrames);
+        if (m_cacheHandle) {
+            return true;
+        }
+    }
+    
+    // Otherwise decode the whole file up front
+    m_audioData.assign(m_info.channels, std::vector<float>(static_cast<size_t>(m_fileLayout.numFrames)));
+    std::vector<float*> channels(m_info.channels);
+    
+    for (int64_t frame = 0; frame < m_fileLayout.numFrames; frame += AudioBlockCache::BLOCK_FRAMES) {
+        for (int ch = 0; ch < m_info.channels; ++ch) {
+            channels[ch] = m_audioData[ch].data() + frame;
+        }
+        int count = static_cast<int>(std::min<int64_t>(AudioBlockCache::BLOCK_FRAMES, m_fileLayout.numFrames - frame));
+        if (!DecodeFrames(frame, count, channels.data())) {
+            m_audioData.clear();
+            return false;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_file.close();
     return true;
 }
 
+bool AudioSource::ParseWAVHeader(std::ifstream& file) {
+    unsigned char header[12];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    
+    // RF64 moves the 64-bit sizes into a ds64 chunk ahead of fmt
+    bool isRF64 = std::memcmp(header, "RF64", 4) == 0;
+    if (!isRF64 && std::memcmp(header, "RIFF", 4) != 0) {
+        return false;
+    }
+    
+    file.seekg(0, std::ios::end);
+    const int64_t fileSize = static_cast<int64_t>(file.tellg());
+    file.seekg(sizeof(header));
+    
+    uint64_t ds64DataSize = 0;
+    bool haveFormat = false;
+    int numChannels = 0;
+    int bitsPerSample = 0;
+    
+    for (;;) {
+        unsigned char chunk[8];
+        if (!file.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+            return false; // No data chunk
+        }
+        
+        uint32_t chunkSize = ReadLE32(chunk + 4);
+        int64_t chunkStart = static_cast<int64_t>(file.tellg());
+        
+        if (std::memcmp(chunk, "ds64", 4) == 0) {
+            unsigned char ds64[24];
+            if (chunkSize < sizeof(ds64) || !file.read(reinterpret_cast<char*>(ds64), sizeof(ds64))) {
+                return false;
+            }
+            ds64DataSize = ReadLE64(ds64 + 8);
+        } else if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            unsigned char fmt[40] = {};
+            if (chunkSize < 16 || !file.read(reinterpret_cast<char*>(fmt), std::min<uint32_t>(chunkSize, sizeof(fmt)))) {
+                return false;
+            }
+            
+            uint16_t formatTag = ReadLE16(fmt);
+            numChannels = ReadLE16(fmt + 2);
+            m_info.sampleRate = static_cast<double>(ReadLE32(fmt + 4));
+            m_fileLayout.blockAlign = ReadLE16(fmt + 12);
+            bitsPerSample = ReadLE16(fmt + 14);
+            
+            // WAVE_FORMAT_EXTENSIBLE carries the real format in its subformat GUID
+            if (formatTag == 0xFFFE && chunkSize >= 40) {
+                formatTag = ReadLE16(fmt + 24);
+            }
+            if (formatTag != 1 && formatTag != 3) {
+                return false; // Compressed formats are not supported
+            }
+            
+            m_fileLayout.isFloat = formatTag == 3;
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                return false;
+            }
+            
+            // Unfinalised recordings leave the size at 0 or 0xFFFFFFFF; trust the file length
+            int64_t dataSize = isRF64 && chunkSize == 0xFFFFFFFFu ? static_cast<int64_t>(ds64DataSize) : chunkSize;
+            int64_t available = fileSize - chunkStart;
+            if (dataSize == 0 || dataSize > available) {
+                dataSize = available;
+            }
+            
+            m_fileLayout.dataOffset = chunkStart;
+            m_fileLayout.numFrames = m_fileLayout.blockAlign > 0 ? dataSize / m_fileLayout.blockAlign : 0;
+            break;
+        }
+        
+        // Chunks are word aligned
+        file.seekg(chunkStart + chunkSize + (chunkSize & 1));
+    }
+    
+    m_fileLayout.bytesPerSample = bitsPerSample / 8;
+    bool validPCM = !m_fileLayout.isFloat && (bitsPerSample == 8 || bitsPerSample == 16 ||
+                                              bitsPerSample == 24 || bitsPerSample == 32);
+    bool validFloat = m_fileLayout.isFloat && (bitsPerSample == 32 || bitsPerSample == 64);
+    if ((!validPCM && !validFloat) || numChannels <= 0 || numChannels > 255 || m_info.sampleRate <= 0.0 ||
+        m_fileLayout.blockAlign != numChannels * m_fileLayout.bytesPerSample) {
+        return false;
+    }
+    
+    m_info.channels = numChannels;
+    m_info.bitDepth = bitsPerSample;
+    m_info.format = isRF64 ? "RF64" : "WAV";
+    return true;
+}
+
+void AudioSource::ReleaseFileData() {
+    if (m_cacheHandle) {
+        AudioBlockCache::GetInstance().UnregisterSource(m_cacheHandle);
+        m_cacheHandle = nullptr;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        if (m_file.is_open()) {
+            m_file.close();
+        }
+        m_fileLayout = FileLayout();
+    }
+    
+    m_recording = false;
+    m_recordTable.reset();
+    m_residentChunks.clear();
+    m_freeChunks.clear();
+    m_recordPool.clear();
+    m_recordedFrames = 0;
+    m_durableFrames = 0;
+    
+    m_audioData.clear();
+    m_dataLoaded = false;
+    m_peakCache.clear();
+    m_resampleStreams.clear(); // Channel count may change with the next file
+    m_resampleTargetRate = 0.0;
+}
+
 bool AudioSource::LoadFLACFile(const std::string& filePath) {
     // FLAC loading would be implemented here using libFLAC
     // For now, return false as it's not implemented
@@ -660,39 +1970,73 @@ const AudioSource::PeakData& AudioSource::GetPeakData(int resolution) {
 }
 
 void AudioSource::CalculatePeakData(int resolution) {
-    if (!m_dataLoaded || m_audioData.empty()) {
+    if (!m_dataLoaded || resolution <= 0) {
+        return;
+    }
+    
+    int64_t totalSamples = m_cacheHandle ? m_fileLayout.numFrames
+                         : (m_audioData.empty() ? 0 : static_cast<int64_t>(m_audioData[0].size()));
+    if (totalSamples == 0) {
         return;
     }
     
     PeakData peakData;
     peakData.samplesPerPeak = resolution;
-    
-    int totalSamples = static_cast<int>(m_audioData[0].size());
-    peakData.numPeaks = (totalSamples + resolution - 1) / resolution;
+    peakData.numPeaks = static_cast<int>((totalSamples + resolution - 1) / resolution);
     
     peakData.minPeaks.resize(peakData.numPeaks);
     peakData.maxPeaks.resize(peakData.numPeaks);
     
-    for (int peak = 0; peak < peakData.numPeaks; ++peak) {
-        float minVal = 1.0f;
-        float maxVal = -1.0f;
+    // Streamed sources decode a chunk at a time straight from the file,
+    // leaving the playback cache untouched
+    const int chunkPeaks = std::max(1, AudioBlockCache::BLOCK_FRAMES / resolution);
+    std::vector<std::vector<float>> chunk;
+    std::vector<float*> chunkPtrs;
+    std::vector<const float*> channelData(m_info.channels);
+    
+    if (m_cacheHandle) {
+        chunk.assign(m_info.channels, std::vector<float>(static_cast<size_t>(chunkPeaks) * resolution));
+        for (int ch = 0; ch < m_info.channels; ++ch) {
+            chunkPtrs.push_back(chunk[ch].data());
+            channelData[ch] = chunk[ch].data();
+        }
+    } else {
+        for (int ch = 0; ch < m_info.channels; ++ch) {
+            channelData[ch] = m_audioData[ch].data();
+        }
+    }
+    
+    for (int firstPeak = 0; firstPeak < peakData.numPeaks; firstPeak += chunkPeaks) {
+        int64_t chunkStart = static_cast<int64_t>(firstPeak) * resolution;
+        int64_t base = 0;
         
-        int startSample = peak * resolution;
-        int endSample = std::min(startSample + resolution, totalSamples);
+        if (m_cacheHandle) {
+            int count = static_cast<int>(std::min<int64_t>(static_cast<int64_t>(chunkPeaks) * resolution,
+                                                           totalSamples - chunkStart));
+            DecodeFrames(chunkStart, count, chunkPtrs.data());
+            base = chunkStart;
+        }
         
-        // Calculate peaks across all channels
-        for (int ch = 0; ch < m_info.channels; ++ch) {
-            const auto& channelData = m_audioData[ch];
+        int lastPeak = std::min(peakData.numPeaks, firstPeak + chunkPeaks);
+        for (int peak = firstPeak; peak < lastPeak; ++peak) {
+            float minVal = 1.0f;
+            float maxVal = -1.0f;
+            
+            int64_t startSample = static_cast<int64_t>(peak) * resolution;
+            int64_t endSample = std::min<int64_t>(startSample + resolution, totalSamples);
             
-            for (int i = startSample; i < endSample; ++i) {
-                float sample = channelData[i];
-                minVal = std::min(minVal, sample);
-                maxVal = std::max(maxVal, sample);
+            // Calculate peaks across all channels
+            for (int ch = 0; ch < m_info.channels; ++ch) {
+                for (int64_t i = startSample; i < endSample; ++i) {
+                    float sample = channelData[ch][i - base];
+                    minVal = std::min(minVal, sample);
+                    maxVal = std::max(maxVal, sample);
+                }
             }
+            
+            peakData.minPeaks[peak] = minVal;
+            peakData.maxPeaks[peak] = maxVal;
         }
-        
-        peakData.minPeaks[peak] = minVal;
-        peakData.maxPeaks[peak] = maxVal;
     }
     
     m_peakCache[resolution] = std::move(peakData);
@@ -702,9 +2046,31 @@ void AudioSource::UpdatePeakCache() {
     // Clear existing cache and recalculate commonly used resolutions
     m_peakCache.clear();
     
-    std::vector<int> commonResolutions = {64, 256, 1024, 4096};
+    // One pass over the audio at the finest resolution; coarser ones fold from it
+    CalculatePeakData(64);
+    auto fine = m_peakCache.find(64);
+    if (fine == m_peakCache.end()) {
+        return;
+    }
+    
+    std::vector<int> commonResolutions = {256, 1024, 4096};
     for (int resolution : commonResolutions) {
-        CalculatePeakData(resolution);
+        const PeakData& source = fine->second;
+        int factor = resolution / source.samplesPerPeak;
+        
+        PeakData peakData;
+        peakData.samplesPerPeak = resolution;
+        peakData.numPeaks = (source.numPeaks + factor - 1) / factor;
+        peakData.minPeaks.assign(peakData.numPeaks, 1.0f);
+        peakData.maxPeaks.assign(peakData.numPeaks, -1.0f);
+        
+        for (int i = 0; i < source.numPeaks; ++i) {
+            int peak = i / factor;
+            peakData.minPeaks[peak] = std::min(peakData.minPeaks[peak], source.minPeaks[i]);
+            peakData.maxPeaks[peak] = std::max(peakData.maxPeaks[peak], source.maxPeaks[i]);
+        }
+        
+        m_peakCache[resolution] = std::move(peakData);
     }
 }
 
@@ -716,6 +2082,9 @@ MediaItemManager::~MediaItemManager() = default;
 MediaItem* MediaItemManager::CreateItem(Track* track, const std::string& sourceFile, double position) {
     auto item = std::make_unique<MediaItem>(track, sourceFile);
     item->SetPosition(position);
+    if (m_preparedBlockSize > 0) {
+        item->PrepareForPlayback(m_preparedSampleRate, m_preparedBlockSize);
+    }
     
     MediaItem* itemPtr = item.get();
     m_items.push_back(std::move(item));
@@ -728,6 +2097,9 @@ MediaItem* MediaItemManager::CreateEmptyItem(Track* track, double position, doub
     auto item = std::make_unique<MediaItem>(track);
     item->SetPosition(position);
     item->SetLength(length);
+    if (m_preparedBlockSize > 0) {
+        item->PrepareForPlayback(m_preparedSampleRate, m_preparedBlockSize);
+    }
     
     MediaItem* itemPtr = item.get();
     m_items.push_back(std::move(item));
@@ -775,6 +2147,16 @@ std::vector<MediaItem*> MediaItemManager::GetItemsOnTrack(Track* track) const {
     return result;
 }
 
+void MediaItemManager::GetItemsOnTrack(Track* track, std::vector<MediaItem*>& result) const {
+    result.clear();
+    
+    for (const auto& item : m_items) {
+        if (item->GetTrack() == track) {
+            result.push_back(item.get());
+        }
+    }
+}
+
 std::vector<MediaItem*> MediaItemManager::GetItemsInTimeRange(double start, double end) const {
     std::vector<MediaItem*> result;
     
@@ -873,6 +2255,44 @@ std::vector<MediaItem*> MediaItemManager::GetItemsAtTime(double time) const {
     return result;
 }
 
+void MediaItemManager::PrepareForPlayback(double sampleRate, int maxBlockSize) {
+    m_preparedSampleRate = sampleRate;
+    m_preparedBlockSize = maxBlockSize;
+    
+    for (const auto& item : m_items) {
+        item->PrepareForPlayback(sampleRate, maxBlockSize);
+    }
+}
+
+void MediaItemManager::Prefetch(double projectTime) {
+    // Items still ahead of the cursor get their first block now; after that
+    // the cache's read-ahead keeps pace with playback
+    for (const auto& item : m_items) {
+        if (item->GetEndPosition() > projectTime) {
+            item->PrefetchSources(projectTime);
+        }
+    }
+}
+
+void MediaItemManager::PrefetchRange(double startTime, double endTime) {
+    // A loop wraps to startTime without passing through the cache's
+    // sequential read-ahead, so its first blocks are loaded ahead of time
+    for (const auto& item : m_items) {
+        if (item->GetEndPosition() > startTime && item->GetPosition() < endTime) {
+            item->PrefetchSources(startTime);
+        }
+    }
+}
+
+void MediaItemManager::GetRangeBlocks(double startTime, double endTime,
+                                      std::vector<AudioBlockCache::BlockRef>& blocks) const {
+    for (const auto& item : m_items) {
+        if (item->GetEndPosition() > startTime && item->GetPosition() < endTime) {
+            item->GetPrefetchBlocks(startTime, blocks);
+        }
+    }
+}
+
 MediaItem* MediaItemManager::FindItemByGUID(const std::string& guid) const {
     for (const auto& item : m_items) {
         if (item->GetGUID() == guid) {
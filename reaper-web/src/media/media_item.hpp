@@ -6,10 +6,21 @@
 
 #pragma once
 
+#include "../core/sample_rate_converter.hpp"
+#include "time_stretcher.hpp"
+#include "audio_block_cache.hpp"
 #include <memory>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <string>
 #include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <fstream>
+#include <mutex>
 
 // Forward declarations
 class Track;
@@ -50,7 +61,7 @@ public:
         std::shared_ptr<AudioSource> source;
         double sourceOffset = 0.0;     // Offset into source file (seconds)
         double playRate = 1.0;          // Playback rate (1.0 = normal speed)
-        double pitch = 0.0;             // Pitch shift in semitones
+        double pitch = 0.0;             // Pitch shift in semitones (-24 to +24)
         bool preservePitch = true;      // Preserve pitch when changing rate
         StretchMode stretchMode = StretchMode::ELASTIQUE;
         double volume = 1.0;            // Take volume (linear)
@@ -59,14 +70,27 @@ public:
         bool phase = false;             // Phase invert
         std::string color = "#FFFFFF";  // Take color
         
-        // Stretch markers for advanced time stretching
+        // Stretch markers for advanced time stretching (sorted by itemTime)
+        // Between markers the source plays at the rate their spacing implies;
+        // outside them it plays at playRate
         struct StretchMarker {
-            double sourceTime = 0.0;    // Time in source
+            double sourceTime = 0.0;    // Absolute time in source
             double itemTime = 0.0;      // Time in item
         };
         std::vector<StretchMarker> stretchMarkers;
     };
 
+    /**
+     * Comp region - swipe-comp selection of one take (lane) over an item
+     * time range. Regions are sorted and together cover the whole item;
+     * boundaries between different takes get an equal-power crossfade.
+     */
+    struct CompRegion {
+        double start = 0.0;             // Item time (seconds)
+        double end = 0.0;               // Item time (seconds)
+        int takeIndex = 0;              // Take (lane) playing in this range
+    };
+
     /**
      * Fade settings for item edges
      */
@@ -106,6 +130,10 @@ public:
         // Takes
         std::vector<Take> takes;
         int activeTake = 0;             // Index of active take
+        
+        // Take comping - empty plays the active take only
+        std::vector<CompRegion> compRegions;
+        double compCrossfadeLength = 0.010; // Auto-crossfade at comp boundaries (seconds)
     };
 
 public:
@@ -158,6 +186,7 @@ public:
 
     // Takes management
     int AddTake(const std::string& sourceFile);
+    int AddTake(std::shared_ptr<AudioSource> source, double sourceOffset = 0.0);
     bool RemoveTake(int takeIndex);
     void SetActiveTake(int takeIndex);
     int GetActiveTake() const { return m_state.activeTake; }
@@ -167,6 +196,15 @@ public:
     Take* GetActiveTakePtr();
     const Take* GetActiveTakePtr() const;
 
+    // Take comping - takes are lanes; swiping a range selects that lane there
+    bool SwipeComp(int takeIndex, double startTime, double endTime);    // Item times
+    void ClearComp();
+    bool IsComped() const { return !m_state.compRegions.empty(); }
+    const std::vector<CompRegion>& GetCompRegions() const { return m_state.compRegions; }
+    int GetCompTakeAt(double itemTime) const;
+    void SetCompCrossfadeLength(double seconds);
+    double GetCompCrossfadeLength() const { return m_state.compCrossfadeLength; }
+
     // Non-destructive editing operations
     bool Split(double time);                    // Split item at time
     bool Trim(double startTime, double endTime); // Trim item to time range
@@ -175,6 +213,11 @@ public:
     bool ChangeRate(double newRate);            // Change playback rate
     bool ChangePitch(double semitones);         // Change pitch
 
+    // Stretch markers (active take)
+    bool AddStretchMarker(double itemTime, double sourceTime);
+    void ClearStretchMarkers();
+    double GetSourceTime(double itemTime) const; // Item time -> source time for the active take
+
     // Crossfade with adjacent items
     struct Crossfade {
         double length = 0.0;            // Crossfade length
@@ -184,9 +227,20 @@ public:
     };
     void SetCrossfadeIn(const Crossfade& crossfade);
     void SetCrossfadeOut(const Crossfade& crossfade);
+    const Crossfade& GetCrossfadeIn() const { return m_crossfadeIn; }
+    const Crossfade& GetCrossfadeOut() const { return m_crossfadeOut; }
 
-    // Audio processing
+    // Audio processing - the sample overload is authoritative; positions are
+    // project samples at the buffer's sample rate
+    void ProcessAudio(AudioBuffer& buffer, int64_t blockStartSample, int numSamples);
     void ProcessAudio(AudioBuffer& buffer, double startTime, double length);
+    void PrepareForPlayback(double sampleRate, int maxBlockSize);
+    void PrefetchSources(double projectTime);   // Warm the block cache from projectTime on
+    void GetPrefetchBlocks(double projectTime, std::vector<AudioBlockCache::BlockRef>& blocks) const;
+    
+    // Sample timeline
+    int64_t GetStartSample(double sampleRate) const { return std::llround(m_state.position * sampleRate); }
+    int64_t GetEndSample(double sampleRate) const { return std::llround(GetEndPosition() * sampleRate); }
     
     // Time range queries
     bool ContainsTime(double time) const;
@@ -197,6 +251,11 @@ public:
     const ItemState& GetState() const { return m_state; }
     void SetState(const ItemState& state);
     
+    // Revision - bumped by every edit (selection excepted); callers editing a
+    // take through GetTake() call MarkChanged() themselves
+    uint64_t GetRevision() const { return m_revision; }
+    void MarkChanged() { ++m_revision; }
+    
     // Track ownership
     Track* GetTrack() const { return m_track; }
     void SetTrack(Track* track) { m_track = track; }
@@ -208,32 +267,123 @@ public:
 private:
     Track* m_track;
     ItemState m_state;
+    uint64_t m_revision = 0;
     
     // Crossfades with adjacent items
     Crossfade m_crossfadeIn;
     Crossfade m_crossfadeOut;
     
+    /**
+     * Fade shape baked over normalised fade progress and linearly
+     * interpolated per sample; rebuilt only when type or curvature change
+     */
+    static constexpr int FADE_TABLE_SIZE = 512;
+    static constexpr int FADE_CHUNK_FRAMES = 256;
+    enum class FadeDirection {
+        IN,                 // curve(p)
+        OUT,                // 1 - curve(p), item fade-out
+        MIRRORED_OUT        // curve(1 - p), power-complementary to IN for crossfades
+    };
+    struct FadeTable {
+        FadeType type = FadeType::LINEAR;
+        double curvature = 0.0;
+        bool valid = false;
+        std::array<float, FADE_TABLE_SIZE + 1> gains{};
+    };
+    FadeTable m_fadeInTable;
+    FadeTable m_fadeOutTable;
+    FadeTable m_crossfadeInTable;
+    FadeTable m_crossfadeOutTable;
+    FadeTable m_compFadeInTable;
+    FadeTable m_compFadeOutTable;
+    
+    // Comp rendering scratch (one take's span before it is crossfaded in)
+    std::unique_ptr<AudioBuffer> m_compBuffer;
+    
     // Audio processing buffers
     mutable std::unique_ptr<AudioBuffer> m_processBuffer;
+    std::unique_ptr<AudioBuffer> m_stretchInput;    // Source span for varispeed reads
+    
+    /**
+     * Item bounds on the sample timeline, rebuilt when position, length or
+     * rate change so every block uses the same rounding
+     */
+    struct TimelineCache {
+        double sampleRate = 0.0;
+        double position = -1.0;
+        double length = -1.0;
+        int64_t startSample = 0;
+        int64_t endSample = 0;
+    };
+    TimelineCache m_timeline;
+    
+    /**
+     * Source read cursor for the direct path - contiguous blocks continue
+     * from here instead of re-deriving the position from seconds
+     */
+    struct SourceCursor {
+        const AudioSource* source = nullptr;
+        double sourceOffset = 0.0;
+        double sampleRate = 0.0;
+        int64_t nextItemFrame = -1;     // Item frame that continues the cursor
+        int64_t sourceFrame = 0;        // Source frame for nextItemFrame
+    };
+    SourceCursor m_sourceCursor;
+    
+    /**
+     * Streaming stretch state for one take, carried across blocks
+     */
+    struct TakeStretchState {
+        TimeStretcher stretcher;
+        std::unique_ptr<AudioBuffer> sourceBuffer;
+        std::vector<float*> outputPtrs;
+        int64_t nextItemFrame = -1;     // Item frame that continues the stream
+        int64_t sourceFrame = 0;        // Next source frame to feed (project rate)
+    };
+    static constexpr int STRETCH_CHUNK_FRAMES = 4096;
+    std::unordered_map<std::string, std::unique_ptr<TakeStretchState>> m_stretchStates; // By take GUID
     
     // Internal methods
     void UpdateLength();
-    void ProcessTake(const Take& take, AudioBuffer& buffer, double startTime, double length);
-    void ApplyFades(AudioBuffer& buffer, double itemStartTime, double itemLength);
-    void ApplyStretchMarkers(const Take& take, AudioBuffer& buffer);
-    float CalculateFadeGain(double position, const Fade& fade) const;
+    void UpdateTimelineCache(double sampleRate);
+    bool CanMixDirect(const Take& take, int64_t itemFrame, int numFrames, double sampleRate) const;
+    void ForEachPrefetchSource(double projectTime, const std::function<void(AudioSource&, int64_t)>& callback) const;
+    int64_t AdvanceSourceCursor(const Take& take, int64_t itemFrame, int numFrames, double sampleRate);
+    void ProcessTake(const Take& take, AudioBuffer& buffer, int64_t itemFrame, int numFrames);
+    void ProcessComp(AudioBuffer& buffer, int64_t itemFrame, int numFrames);
+    void NormalizeCompRegions();
+    void ClipCompRegions(double offset, double length);
+    void ApplyFades(AudioBuffer& buffer, int64_t itemFrame, int numFrames);
+    bool TouchesFade(int64_t itemFrame, int numFrames, double sampleRate) const;
+    void ApplyFadeRegion(AudioBuffer& buffer, int64_t itemFrame, int numFrames,
+                         int64_t regionStart, int64_t regionLength, const FadeTable& table) const;
+    static const FadeTable& UpdateFadeTable(FadeTable& table, FadeType type, double curvature,
+                                            FadeDirection direction);
+    static double EvaluateFadeCurve(double position, FadeType type, double curvature);
+    static void MixToBuffer(const AudioBuffer& source, AudioBuffer& dest, int destStart, int numFrames, float gain);
+    
+    // Stretch marker mapping
+    double MapItemToSourceTime(const Take& take, double itemTime) const;
+    double GetSourceRate(const Take& take, double itemTime, double& segmentEnd) const;
+    bool UsesStretchEngine(const Take& take) const;
     
     // Time stretching implementations
-    void StretchElastique(AudioBuffer& input, AudioBuffer& output, double ratio);
-    void StretchRubberBand(AudioBuffer& input, AudioBuffer& output, double ratio);
-    void StretchSimple(AudioBuffer& input, AudioBuffer& output, double ratio);
+    void StretchElastique(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames);
+    void StretchRubberBand(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames);
+    void StretchSimple(const AudioBuffer& input, double inputPosition, double increment,
+                       AudioBuffer& output, int outputStart, int numFrames);
+    void ProcessStretched(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames,
+                          TimeStretcher::Algorithm algorithm);
+    void ProcessVarispeed(const Take& take, AudioBuffer& output, int64_t itemFrame, int numFrames);
+    TakeStretchState* GetStretchState(const Take& take, int numChannels, double sampleRate,
+                                      TimeStretcher::Algorithm algorithm);
 };
 
 /**
  * Audio Source - Represents an audio file or generated audio
  * Handles loading, caching, and providing audio data
  */
-class AudioSource {
+class AudioSource : public AudioBlockCache::Provider {
 public:
     enum class SourceType {
         FILE,               // Audio file on disk
@@ -257,6 +407,9 @@ public:
     AudioSource(const std::string& filePath);
     AudioSource(SourceType type);
     ~AudioSource();
+    
+    // Shared file sources - every take of the same file reads one decoded copy
+    static std::shared_ptr<AudioSource> GetShared(const std::string& filePath);
 
     // Source information
     const SourceInfo& GetInfo() const { return m_info; }
@@ -264,11 +417,42 @@ public:
     
     // Audio data access
     bool ReadAudio(AudioBuffer& buffer, double startTime, double length);
-    bool ReadAudioSamples(AudioBuffer& buffer, int startSample, int numSamples);
+    bool ReadAudioFrames(AudioBuffer& buffer, int64_t startFrame, int numFrames, double sampleRate);
+    bool ReadAudioSamples(AudioBuffer& buffer, int64_t startSample, int numSamples);
+    
+    // Zero-copy mix straight from the source data into dest at destStart.
+    // Only at the native rate; returns false when the caller must resample.
+    bool MixAudioFrames(AudioBuffer& dest, int destStart, int64_t startFrame, int numFrames,
+                        double sampleRate, float gain) const;
+    void PrepareForPlayback(double sampleRate);
     
-    // Caching for performance
-    void EnableCaching(bool enable) { m_cachingEnabled = enable; }
+    // Caching for performance - cached file sources stream through the
+    // shared AudioBlockCache instead of holding the whole file decoded
+    void EnableCaching(bool enable);
+    bool IsCachingEnabled() const { return m_cachingEnabled; }
+    bool IsStreamed() const { return m_cacheHandle != nullptr; }
     void ClearCache();
+    void Prefetch(int64_t startFrame, int numFrames);  // Non-realtime; decodes missing blocks now
+    void GetPrefetchBlocks(int64_t startFrame, int numFrames,  // Non-realtime; the blocks Prefetch would decode,
+                           std::vector<AudioBlockCache::BlockRef>& blocks) const;   // for queueing later
+    
+    // AudioBlockCache::Provider - decodes PCM straight from the file
+    bool DecodeFrames(int64_t startFrame, int numFrames, float* const* channels) override;
+    
+    // Live recording - the recording writer thread appends frames as it
+    // writes them to the file, and takes play them back while recording
+    bool BeginRecording(const std::string& filePath, double sampleRate, int numChannels, int64_t dataOffset,
+                        int bitsPerSample = 32, bool isFloat = true);
+    void AppendRecording(const float* const* channels, int numFrames);     // Writer thread
+    void SetDurableFrames(int64_t numFrames);                             // Writer thread; frames now in the file
+    void FinishRecording(int64_t numFrames);                              // File finalised
+    bool IsRecording() const { return m_recording.load(); }
+    int64_t GetRecordedFrames() const { return m_recordedFrames.load(); }
+    
+    // Sample rate conversion quality when the project rate differs; applied by
+    // the next PrepareForPlayback
+    void SetResampleQuality(SampleRateConverter::Quality quality);
+    SampleRateConverter::Quality GetResampleQuality() const { return m_resampleQuality; }
     
     // Peak data for waveform display
     struct PeakData {
@@ -298,18 +482,81 @@ private:
     
     // Caching
     bool m_cachingEnabled = true;
-    std::vector<std::unique_ptr<AudioBuffer>> m_cachedBuffers;
+    AudioBlockCache::SourceHandle* m_cacheHandle = nullptr;
+    
+    // Streaming file state - layout of the WAV/RF64 data chunk
+    struct FileLayout {
+        int64_t dataOffset = 0;         // Byte offset of the first frame
+        int64_t numFrames = 0;
+        int bytesPerSample = 0;
+        int blockAlign = 0;             // Bytes per frame
+        bool isFloat = false;
+    };
+    FileLayout m_fileLayout;
+    std::ifstream m_file;
+    std::mutex m_fileMutex;
+    std::vector<char> m_decodeBytes;
     
     // Peak data cache
     std::unordered_map<int, PeakData> m_peakCache;
     
+    /**
+     * Live recording state. The newest BLOCK_FRAMES chunks stay resident
+     * for the audio thread; older chunks are dropped once the file holds
+     * them and read back through the block cache. A chunk buffer is reused
+     * under a seqlock (version odd while it changes hands), so a reader
+     * racing the recycle reads from the file instead of torn audio.
+     */
+    static constexpr int MAX_RECORD_CHUNKS = 16384;        // ~6 hours at 48 kHz
+    static constexpr int RESIDENT_RECORD_CHUNKS = 3;
+    struct RecordChunk {
+        std::atomic<uint32_t> version{0};
+        std::atomic<int64_t> index{-1};         // Chunk of the recording held
+        std::unique_ptr<float[]> data;          // Planar, BLOCK_FRAMES per channel
+    };
+    std::atomic<bool> m_recording{false};
+    std::atomic<int64_t> m_recordedFrames{0};  // Appended (resident)
+    std::atomic<int64_t> m_durableFrames{0};   // Readable from the file
+    std::unique_ptr<std::atomic<RecordChunk*>[]> m_recordTable;    // Chunk index -> resident buffer
+    std::vector<std::unique_ptr<RecordChunk>> m_recordPool;         // Writer thread
+    std::deque<RecordChunk*> m_residentChunks;                      // Writer thread, oldest first
+    std::vector<RecordChunk*> m_freeChunks;                         // Writer thread
+    std::vector<float*> m_recordReadPtrs;                           // Audio thread
+    
+    // Streaming resampler state (source rate -> project rate). A shared
+    // source is read by several takes at different positions, so each
+    // reader continues its own stream; the least recently used is recycled.
+    // All streams are built by PrepareForPlayback, none on the audio thread.
+    static constexpr int RESAMPLE_CHUNK_FRAMES = 4096;
+    static constexpr int MAX_RESAMPLE_STREAMS = 8;
+    struct ResampleStream {
+        std::unique_ptr<SampleRateConverter> resampler;
+        std::unique_ptr<AudioBuffer> input;
+        std::vector<float*> outputPtrs;
+        int64_t nextOutput = -1;        // Output frame that continues the stream
+        int64_t sourceCursor = 0;       // Next source frame to feed
+        uint64_t lastUsed = 0;
+    };
+    SampleRateConverter::Quality m_resampleQuality = SampleRateConverter::Quality::STANDARD;
+    SampleRateConverter::Quality m_resampleStreamQuality = SampleRateConverter::Quality::STANDARD;   // Of the built streams
+    double m_resampleTargetRate = 0.0;
+    std::vector<ResampleStream> m_resampleStreams;
+    uint64_t m_resampleReadCount = 0;
+    
     // File I/O
     bool LoadWAVFile(const std::string& filePath);
+    bool ParseWAVHeader(std::ifstream& file);
+    void ReleaseFileData();
+    void ReadRecordedFrames(int64_t startFrame, int numFrames, float* const* channels);
+    bool CopyRecordedChunk(int64_t chunkIndex, int offset, int count, float* const* channels, int destOffset) const;
+    RecordChunk* AttachRecordChunk(int64_t chunkIndex);
     bool LoadFLACFile(const std::string& filePath);
     bool SaveWAVFile(const std::string& filePath);
     
     // Audio processing
-    void ResampleIfNeeded(AudioBuffer& buffer, double targetSampleRate);
+    bool ResampleIfNeeded(AudioBuffer& buffer, int64_t outputStart, int numOutputFrames, double targetSampleRate);
+    void PrepareResampler(double targetSampleRate);
+    ResampleStream* AcquireResampleStream(int64_t outputStart);
     void ConvertToTargetFormat(AudioBuffer& buffer);
     
     // Peak calculation
@@ -334,7 +581,10 @@ public:
     bool DeleteItem(MediaItem* item);
     void DeleteAllItems();
     std::vector<MediaItem*> GetItemsOnTrack(Track* track) const;
+    void GetItemsOnTrack(Track* track, std::vector<MediaItem*>& result) const;  // Reuses result's storage
     std::vector<MediaItem*> GetItemsInTimeRange(double start, double end) const;
+    int GetItemCount() const { return static_cast<int>(m_items.size()); }
+    MediaItem* GetItem(int index) const { return m_items[index].get(); }
     
     // Selection
     void SelectItem(MediaItem* item, bool addToSelection = false);
@@ -358,6 +608,13 @@ public:
     std::vector<MediaItem*> GetItemsAtTime(double time) const;
     MediaItem* FindItemByGUID(const std::string& guid) const;
     
+    // Playback preparation - sizes render buffers off the audio thread
+    void PrepareForPlayback(double sampleRate, int maxBlockSize);
+    void Prefetch(double projectTime);   // Decode source blocks under the play cursor
+    void PrefetchRange(double startTime, double endTime);   // Items playing in [start, end) from start
+    void GetRangeBlocks(double startTime, double endTime,   // The blocks PrefetchRange would decode
+                        std::vector<AudioBlockCache::BlockRef>& blocks) const;
+    
     // Cleanup
     void RemoveInvalidItems();
     void OptimizeItems(); // Remove empty items, merge adjacent items, etc.
@@ -367,6 +624,10 @@ private:
     std::vector<MediaItem*> m_selectedItems;
     int m_nextGroupId = 1;
     
+    // Last playback configuration, applied to items created afterwards
+    double m_preparedSampleRate = 0.0;
+    int m_preparedBlockSize = 0;
+    
     // Internal helpers
     void NotifyItemAdded(MediaItem* item);
     void NotifyItemRemoved(MediaItem* item);
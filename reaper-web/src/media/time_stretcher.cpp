@@ -0,0 +1,447 @@
+/*
+ * REAPER Web - Time Stretcher Implementation
+ * WSOLA and phase-locked vocoder with a resampling pitch stage
+ */
+
+#include "time_stretcher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr double kTwoPi = 2.0 * M_PI;
+
+// Wrap a phase into [-pi, pi]
+inline float PrincipalArgument(double phase) {
+    return static_cast<float>(phase - kTwoPi * std::round(phase / kTwoPi));
+}
+
+} // namespace
+
+TimeStretcher::TimeStretcher() = default;
+
+TimeStretcher::~TimeStretcher() = default;
+
+bool TimeStretcher::Prepare(double sampleRate, int numChannels, Algorithm algorithm) {
+    if (sampleRate <= 0.0 || numChannels <= 0) {
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_numChannels = numChannels;
+    m_algorithm = algorithm;
+
+    if (algorithm == Algorithm::WSOLA) {
+        // ~20ms segments, 50% overlap, +/-5ms search
+        m_windowSize = std::clamp(FFT::NextPowerOfTwo(static_cast<int>(sampleRate * 0.02)), 256, 4096);
+        m_synthesisHop = m_windowSize / 2;
+        m_searchRange = m_windowSize / 4;
+        m_overlapGain = 1.0f;
+    } else {
+        // ~40ms frames, 75% overlap; Hann analysis and synthesis windows sum to 1.5
+        m_windowSize = std::clamp(FFT::NextPowerOfTwo(static_cast<int>(sampleRate * 0.04)), 512, 8192);
+        m_synthesisHop = m_windowSize / 4;
+        m_searchRange = 0;
+        m_overlapGain = 1.0f / 1.5f;
+    }
+
+    m_window.resize(m_windowSize);
+    for (int i = 0; i < m_windowSize; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(kTwoPi * i / m_windowSize));
+    }
+
+    // Room for a few frames at the fastest ratio; Process() grows it if fed more
+    int inputCapacity = m_windowSize * 4 + m_searchRange * 2 + static_cast<int>(m_synthesisHop / MIN_RATIO);
+    m_input.assign(numChannels, std::vector<float>(inputCapacity, 0.0f));
+    m_accumulator.assign(numChannels, std::vector<float>(m_windowSize, 0.0f));
+    m_output.assign(numChannels, std::vector<float>(m_windowSize * 8, 0.0f));
+    m_emitInputPtrs.resize(numChannels);
+    m_emitOutputPtrs.resize(numChannels);
+
+    if (algorithm == Algorithm::WSOLA) {
+        int overlap = m_windowSize - m_synthesisHop;
+        m_searchMono.assign(overlap * 2 + m_searchRange * 2 + 1, 0.0f);
+    } else {
+        int numBins = m_windowSize / 2 + 1;
+        m_fft.Prepare(m_windowSize);
+        m_frame.assign(m_windowSize, 0.0f);
+        m_spectrum.assign(numBins, std::complex<float>());
+        m_magnitude.assign(numBins, 0.0f);
+        m_phase.assign(numBins, 0.0f);
+        m_newSynthesisPhase.assign(numBins, 0.0f);
+        m_peaks.reserve(numBins);
+        m_lastAnalysisPhase.assign(numChannels, std::vector<float>(numBins, 0.0f));
+        m_synthesisPhase.assign(numChannels, std::vector<float>(numBins, 0.0f));
+    }
+
+    // Stretched audio is played back pitch times faster: treat it as recorded at rate * pitch.
+    // Filters for the whole pitch range are built now; pitch changes only retune the ratio.
+    auto quality = (algorithm == Algorithm::PHASE_VOCODER) ? SampleRateConverter::Quality::HIGH
+                                                           : SampleRateConverter::Quality::STANDARD;
+    if (!m_pitchResampler) {
+        m_pitchResampler = std::make_unique<SampleRateConverter>();
+    }
+    if (!m_pitchResampler->PrepareVariable(sampleRate * MIN_PITCH_SCALE, sampleRate * MAX_PITCH_SCALE, sampleRate,
+                                           numChannels, m_synthesisHop, quality)) {
+        return false;
+    }
+    m_pitchResampler->SetInputRate(sampleRate * m_pitchScale);
+
+    Reset();
+    return true;
+}
+
+void TimeStretcher::Reset() {
+    if (!IsPrepared()) return;
+
+    // Pad so the first window is centred on input frame 0
+    int padding = m_windowSize / 2 + m_searchRange;
+    for (auto& channel : m_input) {
+        std::fill(channel.begin(), channel.begin() + padding, 0.0f);
+    }
+    m_inputFill = padding;
+    m_analysisPosition = m_searchRange;
+
+    for (auto& channel : m_accumulator) {
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    }
+    m_outputFill = 0;
+    m_stretchDiscard = m_windowSize / 2;
+
+    m_previousSegment = 0;
+    m_lastFramePosition = 0;
+    m_firstFrame = true;
+
+    if (m_pitchResampler) {
+        m_pitchResampler->Reset();
+    }
+}
+
+bool TimeStretcher::IsPitchShifted() const {
+    return std::abs(m_pitchScale - 1.0) >= 1e-9;
+}
+
+void TimeStretcher::SetTimeRatio(double ratio) {
+    m_timeRatio = std::clamp(ratio, MIN_RATIO, MAX_RATIO);
+}
+
+void TimeStretcher::SetPitchScale(double scale) {
+    scale = std::clamp(scale, MIN_PITCH_SCALE, MAX_PITCH_SCALE);
+    if (std::abs(scale - m_pitchScale) < 1e-9) return;
+
+    // Shifting resumes from clean filter history, as the unshifted path bypassed it
+    if (m_pitchResampler && !IsPitchShifted()) {
+        m_pitchResampler->Reset();
+    }
+
+    m_pitchScale = scale;
+    if (m_pitchResampler) {
+        m_pitchResampler->SetInputRate(m_sampleRate * m_pitchScale);
+    }
+}
+
+int TimeStretcher::GetSamplesRequired() const {
+    if (!IsPrepared()) return 0;
+    return std::max(0, GetFrameInputEnd() - m_inputFill);
+}
+
+void TimeStretcher::Process(const float* const* input, int numFrames) {
+    if (!IsPrepared() || !input || numFrames <= 0) {
+        if (IsPrepared()) ProcessFrames();
+        return;
+    }
+
+    // Grow only when the caller feeds more than GetSamplesRequired() asked for
+    if (m_inputFill + numFrames > static_cast<int>(m_input[0].size())) {
+        for (auto& channel : m_input) {
+            channel.resize((m_inputFill + numFrames) * 2);
+        }
+    }
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        std::memcpy(m_input[ch].data() + m_inputFill, input[ch], numFrames * sizeof(float));
+    }
+    m_inputFill += numFrames;
+
+    ProcessFrames();
+}
+
+int TimeStretcher::Retrieve(float** output, int numFrames) {
+    int frames = std::min(numFrames, m_outputFill);
+    if (frames <= 0) return 0;
+
+    int remaining = m_outputFill - frames;
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        float* data = m_output[ch].data();
+        std::memcpy(output[ch], data, frames * sizeof(float));
+        std::memmove(data, data + frames, remaining * sizeof(float));
+    }
+
+    m_outputFill = remaining;
+    return frames;
+}
+
+double TimeStretcher::GetAnalysisHop() const {
+    // The stretch stage runs at ratio * pitch; the pitch stage resamples by 1/pitch
+    return m_synthesisHop / (m_timeRatio * m_pitchScale);
+}
+
+int TimeStretcher::GetFrameInputEnd() const {
+    return static_cast<int>(std::lround(m_analysisPosition)) + m_searchRange + m_windowSize;
+}
+
+void TimeStretcher::ProcessFrames() {
+    while (GetFrameInputEnd() <= m_inputFill) {
+        if (m_algorithm == Algorithm::WSOLA) {
+            ProcessWSOLAFrame();
+        } else {
+            ProcessVocoderFrame();
+        }
+
+        EmitSynthesisHop();
+        CompactInput();
+    }
+}
+
+void TimeStretcher::ProcessWSOLAFrame() {
+    int nominal = static_cast<int>(std::lround(m_analysisPosition));
+    int segment = nominal;
+
+    // Pick the segment that best continues the previous one's waveform
+    if (!m_firstFrame) {
+        segment = FindBestSegment(m_previousSegment + m_synthesisHop,
+                                  nominal - m_searchRange, nominal + m_searchRange);
+    }
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        const float* x = m_input[ch].data() + segment;
+        float* acc = m_accumulator[ch].data();
+        for (int i = 0; i < m_windowSize; ++i) {
+            acc[i] += x[i] * m_window[i];
+        }
+    }
+
+    m_previousSegment = segment;
+    m_firstFrame = false;
+    m_analysisPosition += GetAnalysisHop();
+}
+
+int TimeStretcher::FindBestSegment(int target, int lowest, int highest) {
+    const int overlap = m_windowSize - m_synthesisHop;
+    const int span = highest - lowest;
+    const float channelScale = 1.0f / m_numChannels;
+
+    // Mono mix of the natural continuation followed by the search region
+    float* reference = m_searchMono.data();
+    float* region = reference + overlap;
+    std::fill(m_searchMono.begin(), m_searchMono.end(), 0.0f);
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        const float* x = m_input[ch].data();
+        for (int i = 0; i < overlap; ++i) {
+            reference[i] += x[target + i] * channelScale;
+        }
+        for (int i = 0; i < span + overlap; ++i) {
+            region[i] += x[lowest + i] * channelScale;
+        }
+    }
+
+    float referenceEnergy = 0.0f;
+    for (int i = 0; i < overlap; i += 2) {
+        referenceEnergy += reference[i] * reference[i];
+    }
+    if (referenceEnergy < 1e-10f) {
+        return lowest + span / 2; // Silence: keep nominal timing
+    }
+
+    // Normalised cross-correlation; candidate energy removes the bias towards loud segments
+    auto score = [&](int offset, int stride) {
+        const float* candidate = region + offset;
+        float correlation = 0.0f;
+        float energy = 1e-9f;
+        for (int i = 0; i < overlap; i += stride) {
+            correlation += reference[i] * candidate[i];
+            energy += candidate[i] * candidate[i];
+        }
+        return correlation / std::sqrt(energy);
+    };
+
+    // Coarse search on every 4th offset (every 2nd sample), then refine
+    int best = span / 2;
+    float bestScore = score(best, 2);
+    for (int offset = 0; offset <= span; offset += 4) {
+        float s = score(offset, 2);
+        if (s > bestScore) {
+            bestScore = s;
+            best = offset;
+        }
+    }
+
+    int coarse = best;
+    bestScore = score(coarse, 1);
+    for (int offset = std::max(0, coarse - 3); offset <= std::min(span, coarse + 3); ++offset) {
+        float s = score(offset, 1);
+        if (s > bestScore) {
+            bestScore = s;
+            best = offset;
+        }
+    }
+
+    return lowest + best;
+}
+
+void TimeStretcher::ProcessVocoderFrame() {
+    int framePosition = static_cast<int>(std::lround(m_analysisPosition));
+    int analysisHop = m_firstFrame ? 0 : framePosition - m_lastFramePosition;
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        ProcessVocoderChannel(ch, framePosition, analysisHop);
+    }
+
+    m_firstFrame = false;
+    m_lastFramePosition = framePosition;
+    m_analysisPosition += GetAnalysisHop();
+}
+
+void TimeStretcher::ProcessVocoderChannel(int channel, int framePosition, int analysisHop) {
+    const int numBins = m_windowSize / 2 + 1;
+    const float* x = m_input[channel].data() + framePosition;
+
+    for (int i = 0; i < m_windowSize; ++i) {
+        m_frame[i] = x[i] * m_window[i];
+    }
+    m_fft.PerformRealForward(m_frame.data(), m_spectrum.data());
+
+    for (int k = 0; k < numBins; ++k) {
+        m_magnitude[k] = std::abs(m_spectrum[k]);
+        m_phase[k] = std::arg(m_spectrum[k]);
+    }
+
+    auto& lastPhase = m_lastAnalysisPhase[channel];
+    auto& synthesisPhase = m_synthesisPhase[channel];
+
+    if (m_firstFrame) {
+        std::copy(m_phase.begin(), m_phase.end(), m_newSynthesisPhase.begin());
+    } else {
+        // Spectral peaks carry the phase; their neighbours are locked to them
+        m_peaks.clear();
+        for (int k = 2; k < numBins - 2; ++k) {
+            float m = m_magnitude[k];
+            if (m > m_magnitude[k - 1] && m >= m_magnitude[k + 1] &&
+                m > m_magnitude[k - 2] && m >= m_magnitude[k + 2]) {
+                m_peaks.push_back(k);
+            }
+        }
+        if (m_peaks.empty()) {
+            for (int k = 0; k < numBins; ++k) m_peaks.push_back(k);
+        }
+
+        for (int p : m_peaks) {
+            double omega = kTwoPi * p / m_windowSize;
+            double frequency = omega;
+            if (analysisHop > 0) {
+                double deviation = PrincipalArgument(m_phase[p] - lastPhase[p] - omega * analysisHop);
+                frequency = omega + deviation / analysisHop;
+            }
+            m_newSynthesisPhase[p] = PrincipalArgument(synthesisPhase[p] + frequency * m_synthesisHop);
+        }
+
+        // Identity phase locking over each peak's region of influence
+        const int numPeaks = static_cast<int>(m_peaks.size());
+        for (int i = 0; i < numPeaks; ++i) {
+            int peak = m_peaks[i];
+            int regionStart = (i == 0) ? 0 : (m_peaks[i - 1] + peak) / 2 + 1;
+            int regionEnd = (i == numPeaks - 1) ? numBins - 1 : (peak + m_peaks[i + 1]) / 2;
+            float rotation = m_newSynthesisPhase[peak] - m_phase[peak];
+
+            for (int k = regionStart; k <= regionEnd; ++k) {
+                if (k != peak) {
+                    m_newSynthesisPhase[k] = m_phase[k] + rotation;
+                }
+            }
+        }
+    }
+
+    std::copy(m_phase.begin(), m_phase.end(), lastPhase.begin());
+    std::copy(m_newSynthesisPhase.begin(), m_newSynthesisPhase.end(), synthesisPhase.begin());
+
+    for (int k = 0; k < numBins; ++k) {
+        m_spectrum[k] = std::polar(m_magnitude[k], m_newSynthesisPhase[k]);
+    }
+    m_fft.PerformRealInverse(m_spectrum.data(), m_frame.data());
+
+    float* acc = m_accumulator[channel].data();
+    for (int i = 0; i < m_windowSize; ++i) {
+        acc[i] += m_frame[i] * m_window[i] * m_overlapGain;
+    }
+}
+
+void TimeStretcher::EmitSynthesisHop() {
+    // The first m_synthesisHop accumulator frames are complete
+    int skip = std::min(m_stretchDiscard, m_synthesisHop);
+    m_stretchDiscard -= skip;
+    int count = m_synthesisHop - skip;
+
+    if (count > 0) {
+        for (int ch = 0; ch < m_numChannels; ++ch) {
+            m_emitInputPtrs[ch] = m_accumulator[ch].data() + skip;
+        }
+
+        if (m_pitchResampler && IsPitchShifted()) {
+            int maxOutput = static_cast<int>(std::ceil(count / m_pitchScale)) + 4;
+            EnsureOutputCapacity(maxOutput);
+            for (int ch = 0; ch < m_numChannels; ++ch) {
+                m_emitOutputPtrs[ch] = m_output[ch].data() + m_outputFill;
+            }
+            m_outputFill += m_pitchResampler->Process(m_emitInputPtrs.data(), count,
+                                                      m_emitOutputPtrs.data(), maxOutput);
+        } else {
+            AppendOutput(m_emitInputPtrs.data(), count);
+        }
+    }
+
+    int tail = m_windowSize - m_synthesisHop;
+    for (auto& channel : m_accumulator) {
+        float* acc = channel.data();
+        std::memmove(acc, acc + m_synthesisHop, tail * sizeof(float));
+        std::fill(acc + tail, acc + m_windowSize, 0.0f);
+    }
+}
+
+void TimeStretcher::AppendOutput(const float* const* data, int numFrames) {
+    EnsureOutputCapacity(numFrames);
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        std::memcpy(m_output[ch].data() + m_outputFill, data[ch], numFrames * sizeof(float));
+    }
+    m_outputFill += numFrames;
+}
+
+void TimeStretcher::CompactInput() {
+    // Keep everything the next frame (and the WSOLA continuation) can still touch
+    int lowest = static_cast<int>(std::lround(m_analysisPosition)) - m_searchRange;
+    if (m_algorithm == Algorithm::WSOLA && !m_firstFrame) {
+        lowest = std::min(lowest, m_previousSegment + m_synthesisHop);
+    }
+
+    int shift = std::min(lowest, m_inputFill);
+    if (shift <= 0) return;
+
+    int remaining = m_inputFill - shift;
+    for (auto& channel : m_input) {
+        std::memmove(channel.data(), channel.data() + shift, remaining * sizeof(float));
+    }
+
+    m_inputFill = remaining;
+    m_analysisPosition -= shift;
+    m_lastFramePosition -= shift;
+    m_previousSegment -= shift;
+}
+
+void TimeStretcher::EnsureOutputCapacity(int numFrames) {
+    if (m_outputFill + numFrames <= static_cast<int>(m_output[0].size())) return;
+
+    for (auto& channel : m_output) {
+        channel.resize((m_outputFill + numFrames) * 2);
+    }
+}
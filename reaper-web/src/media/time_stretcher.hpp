@@ -0,0 +1,128 @@
+/*
+ * REAPER Web - Time Stretcher
+ * Streaming time stretch and pitch shift for media item takes
+ * Based on REAPER's pitch shift/time stretch modes (elastique, Rubber Band)
+ */
+
+#pragma once
+
+#include "../core/fft.hpp"
+#include "../core/sample_rate_converter.hpp"
+#include <complex>
+#include <memory>
+#include <vector>
+
+/**
+ * TimeStretcher - Streaming time stretch / pitch shift engine
+ * WSOLA (low CPU) picks the best-matching input segment within a search
+ * window and overlap-adds it; the phase vocoder (quality) resynthesises
+ * each frame with identity phase locking around spectral peaks.
+ * Pitch is shifted by stretching by ratio*pitch and resampling by 1/pitch.
+ *
+ * Push/pull API: feed GetSamplesRequired() input frames with Process(),
+ * then Retrieve() what is available. All state is carried between calls,
+ * so consecutive blocks form one continuous stream. Output frame 0 is
+ * aligned with input frame 0 (no reported latency).
+ */
+class TimeStretcher {
+public:
+    enum class Algorithm {
+        WSOLA,              // Waveform-similarity overlap-add (elastique-style, low CPU)
+        PHASE_VOCODER       // Phase-locked vocoder (Rubber Band-style, high quality)
+    };
+
+public:
+    TimeStretcher();
+    ~TimeStretcher();
+
+    // Setup - allocates all buffers; must not be called from the audio thread
+    bool Prepare(double sampleRate, int numChannels, Algorithm algorithm);
+    void Reset();
+
+    // Stretch parameters - may change between blocks
+    void SetTimeRatio(double ratio);        // Output duration / input duration
+    void SetPitchScale(double scale);       // Frequency multiplier (2.0 = octave up)
+    double GetTimeRatio() const { return m_timeRatio; }
+    double GetPitchScale() const { return m_pitchScale; }
+
+    // Streaming
+    int GetSamplesRequired() const;         // Input frames needed for the next output
+    void Process(const float* const* input, int numFrames);
+    int GetAvailable() const { return m_outputFill; }
+    int Retrieve(float** output, int numFrames);
+
+    // Properties
+    bool IsPrepared() const { return m_windowSize > 0; }
+    Algorithm GetAlgorithm() const { return m_algorithm; }
+    int GetNumChannels() const { return m_numChannels; }
+    double GetSampleRate() const { return m_sampleRate; }
+    int GetWindowSize() const { return m_windowSize; }
+
+    static constexpr double MIN_RATIO = 0.1;
+    static constexpr double MAX_RATIO = 10.0;
+    static constexpr double MIN_PITCH_SCALE = 0.25;     // -24 semitones
+    static constexpr double MAX_PITCH_SCALE = 4.0;      // +24 semitones
+
+private:
+    double m_sampleRate = 48000.0;
+    int m_numChannels = 0;
+    Algorithm m_algorithm = Algorithm::WSOLA;
+
+    double m_timeRatio = 1.0;
+    double m_pitchScale = 1.0;
+
+    // Frame geometry
+    int m_windowSize = 0;               // Analysis/synthesis window (N)
+    int m_synthesisHop = 0;             // Output hop (N/2 WSOLA, N/4 vocoder)
+    int m_searchRange = 0;              // WSOLA segment search tolerance
+    std::vector<float> m_window;        // Periodic Hann window
+    float m_overlapGain = 1.0f;         // Window-sum normalisation
+
+    // Input FIFO [channel][frame]
+    std::vector<std::vector<float>> m_input;
+    int m_inputFill = 0;
+    double m_analysisPosition = 0.0;    // Nominal start of the next frame within m_input
+
+    // Overlap-add accumulator and output FIFO [channel][frame]
+    std::vector<std::vector<float>> m_accumulator;
+    std::vector<std::vector<float>> m_output;
+    int m_outputFill = 0;
+    int m_stretchDiscard = 0;           // Leading frames before output time zero
+
+    // WSOLA state
+    int m_previousSegment = 0;          // Start of the last chosen segment within m_input
+    std::vector<float> m_searchMono;
+
+    // Phase vocoder state
+    FFT m_fft;
+    std::vector<float> m_frame;
+    std::vector<std::complex<float>> m_spectrum;
+    std::vector<float> m_magnitude;
+    std::vector<float> m_phase;
+    std::vector<float> m_newSynthesisPhase;
+    std::vector<int> m_peaks;
+    std::vector<std::vector<float>> m_lastAnalysisPhase;    // [channel][bin]
+    std::vector<std::vector<float>> m_synthesisPhase;       // [channel][bin]
+    int m_lastFramePosition = 0;
+
+    bool m_firstFrame = true;           // No previous frame since Reset()
+
+    // Pitch stage (stretched rate -> output rate); prepared for the whole pitch range
+    std::unique_ptr<SampleRateConverter> m_pitchResampler;
+    std::vector<const float*> m_emitInputPtrs;
+    std::vector<float*> m_emitOutputPtrs;
+
+    // Internal methods
+    double GetAnalysisHop() const;
+    int GetFrameInputEnd() const;
+    void ProcessFrames();
+    void ProcessWSOLAFrame();
+    void ProcessVocoderFrame();
+    void ProcessVocoderChannel(int channel, int framePosition, int analysisHop);
+    int FindBestSegment(int target, int lowest, int highest);
+    void EmitSynthesisHop();
+    void AppendOutput(const float* const* data, int numFrames);
+    void CompactInput();
+    void EnsureOutputCapacity(int numFrames);
+    bool IsPitchShifted() const;
+};
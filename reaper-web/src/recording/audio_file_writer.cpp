@@ -0,0 +1,369 @@
+/*
+ * REAPER Web - Audio File Writer Implementation
+ */
+
+#include "audio_file_writer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define REAPER_WRITER_SSE2 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define REAPER_WRITER_WASM_SIMD 1
+#endif
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(FALLOC_FL_KEEP_SIZE)
+#define REAPER_WRITER_PREALLOCATE 1
+#endif
+#endif
+
+namespace {
+
+constexpr uint32_t kDs64Size = 28;          // riff size, data size, sample count, table length
+constexpr uint32_t kFmtSize = 40;           // WAVE_FORMAT_EXTENSIBLE
+constexpr uint64_t kMaxRiffSize = 0xFFFFFFFFull;
+
+// KSDATAFORMAT_SUBTYPE_PCM / _IEEE_FLOAT after the leading format tag
+constexpr unsigned char kSubFormatTail[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+// WAV/RF64 fields are little-endian regardless of host
+inline void WriteLE16(unsigned char* p, uint16_t value) {
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+}
+
+inline void WriteLE32(unsigned char* p, uint32_t value) {
+    WriteLE16(p, static_cast<uint16_t>(value));
+    WriteLE16(p + 2, static_cast<uint16_t>(value >> 16));
+}
+
+inline void WriteLE64(unsigned char* p, uint64_t value) {
+    WriteLE32(p, static_cast<uint32_t>(value));
+    WriteLE32(p + 4, static_cast<uint32_t>(value >> 32));
+}
+
+// dest[i] = round(clamp(src[i] * scale + noise[i], -scale, maxValue)); noise may be null
+void QuantizeBlock(const float* src, const float* noise, int32_t* dest, float scale, float maxValue, int count) {
+    int i = 0;
+#if defined(REAPER_WRITER_SSE2)
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vMin = _mm_set1_ps(-scale);
+    const __m128 vMax = _mm_set1_ps(maxValue);
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), vScale);
+        if (noise) {
+            v = _mm_add_ps(v, _mm_loadu_ps(noise + i));
+        }
+        v = _mm_min_ps(_mm_max_ps(v, vMin), vMax);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_cvtps_epi32(v));
+    }
+#elif defined(REAPER_WRITER_WASM_SIMD)
+    const v128_t vScale = wasm_f32x4_splat(scale);
+    const v128_t vMin = wasm_f32x4_splat(-scale);
+    const v128_t vMax = wasm_f32x4_splat(maxValue);
+    for (; i + 4 <= count; i += 4) {
+        v128_t v = wasm_f32x4_mul(wasm_v128_load(src + i), vScale);
+        if (noise) {
+            v = wasm_f32x4_add(v, wasm_v128_load(noise + i));
+        }
+        v = wasm_f32x4_min(wasm_f32x4_max(v, vMin), vMax);
+        wasm_v128_store(dest + i, wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_nearest(v)));
+    }
+#endif
+    for (; i < count; ++i) {
+        float v = src[i] * scale + (noise ? noise[i] : 0.0f);
+        v = std::min(std::max(v, -scale), maxValue);
+        dest[i] = static_cast<int32_t>(std::lrint(v));
+    }
+}
+
+} // anonymous namespace
+
+AudioFileWriter::AudioFileWriter(size_t bufferSize)
+    : m_bufferSize(std::max<size_t>((bufferSize + WRITE_ALIGNMENT - 1) / WRITE_ALIGNMENT, 1) * WRITE_ALIGNMENT) {
+}
+
+AudioFileWriter::~AudioFileWriter() {
+    Close();
+}
+
+int AudioFileWriter::GetBytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::PCM_16: return 2;
+        case SampleFormat::PCM_24: return 3;
+        case SampleFormat::PCM_32: return 4;
+        case SampleFormat::FLOAT_32: return 4;
+    }
+    return 4;
+}
+
+bool AudioFileWriter::Open(const std::string& filePath, double sampleRate, int numChannels,
+                           SampleFormat format, bool dither) {
+    Close();
+
+    if (numChannels <= 0 || numChannels > 255 || sampleRate <= 0.0) {
+        return false;
+    }
+
+    m_file = std::fopen(filePath.c_str(), "wb");
+    if (!m_file) {
+        return false;
+    }
+
+    // Writes are already batched here
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    m_sampleRate = sampleRate;
+    m_numChannels = numChannels;
+    m_format = format;
+    m_dither = dither && (format == SampleFormat::PCM_16 || format == SampleFormat::PCM_24);
+    m_bytesPerSample = GetBytesPerSample(format);
+    m_blockAlign = numChannels * m_bytesPerSample;
+
+    // One alignment unit past the flush threshold holds what an aligned flush leaves behind
+    m_buffer.resize(m_bufferSize + WRITE_ALIGNMENT);
+    m_converted.resize(CONVERT_FRAMES);
+    m_ditherNoise.resize(m_dither ? CONVERT_FRAMES : 0);
+    m_used = 0;
+    m_error = false;
+    m_framesWritten = 0;
+    m_bytesFlushed = 0;
+    m_preallocated = 0;
+
+    return WriteHeader(false);
+}
+
+bool AudioFileWriter::Write(const float* const* channels, int numFrames) {
+    if (!m_file) {
+        return false;
+    }
+
+    int done = 0;
+    while (done < numFrames) {
+        if (m_used >= m_bufferSize) {
+            // Write up to the last aligned file offset; the tail stays staged
+            const uint64_t start = DATA_OFFSET + m_bytesFlushed;
+            const uint64_t alignedEnd = (start + m_used) & ~static_cast<uint64_t>(WRITE_ALIGNMENT - 1);
+            WriteStaged(static_cast<size_t>(alignedEnd - start));
+        }
+
+        const int space = static_cast<int>((m_buffer.size() - m_used) / m_blockAlign);
+        const int count = std::min({ space, numFrames - done, CONVERT_FRAMES });
+        unsigned char* frame = reinterpret_cast<unsigned char*>(m_buffer.data() + m_used);
+
+        // Convert a channel at a time, then scatter it into the interleaved frames
+        for (int ch = 0; ch < m_numChannels; ++ch) {
+            const float* src = channels[ch] + done;
+            unsigned char* dest = frame + ch * m_bytesPerSample;
+
+            if (m_format == SampleFormat::FLOAT_32) {
+                for (int i = 0; i < count; ++i, dest += m_blockAlign) {
+                    std::memcpy(dest, src + i, sizeof(float));
+                }
+                continue;
+            }
+
+            ConvertChannel(src, count);
+            const int32_t* converted = m_converted.data();
+            switch (m_format) {
+                case SampleFormat::PCM_16:
+                    for (int i = 0; i < count; ++i, dest += m_blockAlign) {
+                        WriteLE16(dest, static_cast<uint16_t>(converted[i]));
+                    }
+                    break;
+                case SampleFormat::PCM_24:
+                    for (int i = 0; i < count; ++i, dest += m_blockAlign) {
+                        const uint32_t value = static_cast<uint32_t>(converted[i]);
+                        dest[0] = static_cast<unsigned char>(value);
+                        dest[1] = static_cast<unsigned char>(value >> 8);
+                        dest[2] = static_cast<unsigned char>(value >> 16);
+                    }
+                    break;
+                default:
+                    for (int i = 0; i < count; ++i, dest += m_blockAlign) {
+                        WriteLE32(dest, static_cast<uint32_t>(converted[i]));
+                    }
+                    break;
+            }
+        }
+
+        m_used += static_cast<size_t>(count) * m_blockAlign;
+        done += count;
+    }
+
+    m_framesWritten += numFrames;
+    return !m_error;
+}
+
+bool AudioFileWriter::Flush() {
+    if (!m_file || m_used == 0) {
+        return !m_error;
+    }
+
+    return WriteStaged(m_used);
+}
+
+bool AudioFileWriter::Close() {
+    if (!m_file) {
+        return !m_error;
+    }
+
+    Flush();
+
+    // RIFF chunks are word aligned: an odd-sized data chunk (24-bit mono, odd
+    // frame count) is followed by a pad byte the chunk size does not include
+    const uint64_t pad = m_bytesFlushed & 1u;
+    if (pad && !m_error && std::fputc(0, m_file) == EOF) {
+        m_error = true;
+    }
+
+    if (!m_error && std::fseek(m_file, 0, SEEK_SET) == 0) {
+        WriteHeader(true);
+    } else {
+        m_error = true;
+    }
+
+#if defined(REAPER_WRITER_PREALLOCATE)
+    // Give back the reservation past the last frame
+    if (m_preallocated > DATA_OFFSET + m_bytesFlushed + pad &&
+        ftruncate(fileno(m_file), static_cast<off_t>(DATA_OFFSET + m_bytesFlushed + pad)) != 0) {
+        m_error = true;
+    }
+#endif
+
+    if (std::fclose(m_file) != 0) {
+        m_error = true;
+    }
+    m_file = nullptr;
+
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    return !m_error;
+}
+
+bool AudioFileWriter::WriteStaged(size_t bytes) {
+    if (bytes == 0) {
+        return !m_error;
+    }
+
+    Preallocate(DATA_OFFSET + m_bytesFlushed + bytes);
+    if (!m_error && std::fwrite(m_buffer.data(), 1, bytes, m_file) != bytes) {
+        m_error = true;
+    }
+
+    if (m_error) {
+        m_used = 0;
+        return false;
+    }
+
+    // A partial frame may stay behind; GetFramesFlushed() only counts whole ones
+    m_bytesFlushed += bytes;
+    m_used -= bytes;
+    std::memmove(m_buffer.data(), m_buffer.data() + bytes, m_used);
+    return true;
+}
+
+void AudioFileWriter::Preallocate(uint64_t fileEnd) {
+#if defined(REAPER_WRITER_PREALLOCATE)
+    if (fileEnd <= m_preallocated) return;
+
+    // Reserve well ahead without changing the file size readers see;
+    // filesystems that cannot do this simply allocate as the writes land
+    const uint64_t reserveEnd = fileEnd + PREALLOCATE_BYTES;
+    fallocate(fileno(m_file), FALLOC_FL_KEEP_SIZE, static_cast<off_t>(m_preallocated),
+              static_cast<off_t>(reserveEnd - m_preallocated));
+    m_preallocated = reserveEnd;
+#else
+    (void)fileEnd;
+#endif
+}
+
+void AudioFileWriter::ConvertChannel(const float* src, int count) {
+    if (m_dither) {
+        GenerateDither(count);
+    }
+
+    // Full scale is -2^(bits-1); the positive side stops one step short
+    switch (m_format) {
+        case SampleFormat::PCM_16:
+            QuantizeBlock(src, m_dither ? m_ditherNoise.data() : nullptr, m_converted.data(), 32768.0f, 32767.0f, count);
+            break;
+        case SampleFormat::PCM_24:
+            QuantizeBlock(src, m_dither ? m_ditherNoise.data() : nullptr, m_converted.data(), 8388608.0f, 8388607.0f, count);
+            break;
+        default:
+            // 2147483520 is the largest float below 2^31
+            QuantizeBlock(src, nullptr, m_converted.data(), 2147483648.0f, 2147483520.0f, count);
+            break;
+    }
+}
+
+void AudioFileWriter::GenerateDither(int count) {
+    // TPDF: the difference of two uniform values, +-1 LSB peak
+    constexpr float kScale = 1.0f / 16777216.0f;
+    uint32_t state = m_ditherState;
+    for (int i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const float a = static_cast<float>(state >> 8) * kScale;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const float b = static_cast<float>(state >> 8) * kScale;
+        m_ditherNoise[i] = a - b;
+    }
+    m_ditherState = state;
+}
+
+bool AudioFileWriter::WriteHeader(bool final) {
+    unsigned char header[DATA_OFFSET] = {};
+
+    // Sizes stay zero while recording; past 4 GB the JUNK chunk becomes ds64
+    const uint64_t dataBytes = final ? m_bytesFlushed : 0;
+    const uint64_t riffBytes = dataBytes + (dataBytes & 1u) + DATA_OFFSET - 8;   // Counts the pad byte
+    const bool rf64 = final && riffBytes > kMaxRiffSize;
+    const uint16_t bits = static_cast<uint16_t>(m_bytesPerSample * 8);
+
+    std::memcpy(header, rf64 ? "RF64" : "RIFF", 4);
+    WriteLE32(header + 4, !final ? 0 : rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riffBytes));
+    std::memcpy(header + 8, "WAVE", 4);
+
+    std::memcpy(header + 12, rf64 ? "ds64" : "JUNK", 4);
+    WriteLE32(header + 16, kDs64Size);
+    if (rf64) {
+        WriteLE64(header + 20, riffBytes);
+        WriteLE64(header + 28, dataBytes);
+        WriteLE64(header + 36, static_cast<uint64_t>(GetFramesFlushed()));
+    }
+
+    // WAVE_FORMAT_EXTENSIBLE, required for more than two channels or 24/32-bit PCM
+    std::memcpy(header + 48, "fmt ", 4);
+    WriteLE32(header + 52, kFmtSize);
+    WriteLE16(header + 56, 0xFFFE);
+    WriteLE16(header + 58, static_cast<uint16_t>(m_numChannels));
+    WriteLE32(header + 60, static_cast<uint32_t>(m_sampleRate));
+    WriteLE32(header + 64, static_cast<uint32_t>(m_sampleRate) * m_blockAlign);
+    WriteLE16(header + 68, static_cast<uint16_t>(m_blockAlign));
+    WriteLE16(header + 70, bits);
+    WriteLE16(header + 72, 22);
+    WriteLE16(header + 74, bits);
+    WriteLE32(header + 76, m_numChannels == 1 ? 0x4u : m_numChannels == 2 ? 0x3u : 0u);
+    WriteLE16(header + 80, IsFloat() ? 3 : 1);
+    std::memcpy(header + 82, kSubFormatTail, sizeof(kSubFormatTail));
+
+    std::memcpy(header + 96, "data", 4);
+    WriteLE32(header + 100, !final ? 0 : rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(dataBytes));
+
+    if (!m_error && std::fwrite(header, sizeof(header), 1, m_file) != 1) {
+        m_error = true;
+    }
+    return !m_error;
+}
@@ -0,0 +1,93 @@
+/*
+ * REAPER Web - Audio File Writer
+ * Batched WAV/RF64 writer for recorded audio
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * AudioFileWriter - Streams planar float audio into a WAV file
+ * Each channel is converted a block at a time (SIMD float -> integer,
+ * optional TPDF dither) and interleaved into a staging buffer, which
+ * reaches the file in large writes that end on WRITE_ALIGNMENT boundaries;
+ * nothing is written per sample. On Linux the file is preallocated ahead
+ * of the writes so a long take does not fragment.
+ *
+ * The header is WAVE_FORMAT_EXTENSIBLE and reserves room (a JUNK chunk)
+ * for the RF64 ds64 chunk, so a take that passes 4 GB is converted in
+ * place on Close() without moving the data. Until then the size fields
+ * are zero, which readers take to mean "data runs to the end of the
+ * file": the flushed part of an unfinished recording is always playable.
+ */
+class AudioFileWriter {
+public:
+    enum class SampleFormat {
+        PCM_16,
+        PCM_24,
+        PCM_32,
+        FLOAT_32
+    };
+
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+    static constexpr size_t WRITE_ALIGNMENT = 4096;             // File offsets flushes end on
+    static constexpr int64_t PREALLOCATE_BYTES = 64 * 1024 * 1024;
+    static constexpr int64_t DATA_OFFSET = 104;     // Header bytes before the first frame
+    static constexpr int CONVERT_FRAMES = 1024;     // Frames converted per channel pass
+
+    explicit AudioFileWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~AudioFileWriter();
+
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+    // Dither applies to the 16 and 24-bit formats only
+    bool Open(const std::string& filePath, double sampleRate, int numChannels,
+              SampleFormat format = SampleFormat::FLOAT_32, bool dither = false);
+    bool Write(const float* const* channels, int numFrames);
+    bool Flush();                       // Hands every staged frame to the file
+    bool Close();                       // Flushes and writes the final sizes; false if any write failed
+
+    bool IsOpen() const { return m_file != nullptr; }
+    bool HasError() const { return m_error; }
+    int GetNumChannels() const { return m_numChannels; }
+    SampleFormat GetFormat() const { return m_format; }
+    int GetBitsPerSample() const { return m_bytesPerSample * 8; }
+    bool IsFloat() const { return m_format == SampleFormat::FLOAT_32; }
+    int64_t GetFramesWritten() const { return m_framesWritten; }    // Accepted by Write()
+    int64_t GetFramesFlushed() const { return m_blockAlign > 0 ? static_cast<int64_t>(m_bytesFlushed / m_blockAlign) : 0; }   // Readable by others
+
+    static int GetBytesPerSample(SampleFormat format);
+
+private:
+    FILE* m_file = nullptr;
+    std::vector<char> m_buffer;         // Staging; m_bufferSize plus one alignment unit of carry-over
+    size_t m_bufferSize = 0;            // Requested; rounded to WRITE_ALIGNMENT on construction
+    size_t m_used = 0;
+    bool m_error = false;
+
+    double m_sampleRate = 48000.0;
+    int m_numChannels = 0;
+    SampleFormat m_format = SampleFormat::FLOAT_32;
+    bool m_dither = false;
+    int m_bytesPerSample = 4;
+    int m_blockAlign = 0;               // Bytes per frame
+    int64_t m_framesWritten = 0;
+    uint64_t m_bytesFlushed = 0;        // Data bytes in the file
+    uint64_t m_preallocated = 0;        // File bytes reserved so far
+
+    // Conversion scratch (one channel, CONVERT_FRAMES)
+    std::vector<int32_t> m_converted;
+    std::vector<float> m_ditherNoise;
+    uint32_t m_ditherState = 0x12345678u;
+
+    bool WriteHeader(bool final);
+    bool WriteStaged(size_t bytes);
+    void Preallocate(uint64_t fileEnd);
+    void ConvertChannel(const float* src, int count);
+    void GenerateDither(int count);
+};
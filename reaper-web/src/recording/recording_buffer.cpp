@@ -0,0 +1,104 @@
+/*
+ * REAPER Web - Recording Buffer Implementation
+ */
+
+#include "recording_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+void RecordingBuffer::Allocate(int numChannels, int minFrames) {
+    int capacity = 1;
+    while (capacity < minFrames) {
+        capacity <<= 1;
+    }
+
+    m_numChannels = std::max(1, numChannels);
+    m_capacity = capacity;
+    m_mask = capacity - 1;
+    m_data.assign(static_cast<size_t>(m_numChannels) * capacity, 0.0f);
+    Reset();
+}
+
+void RecordingBuffer::Reset() {
+    m_producer.writePos.store(0, std::memory_order_relaxed);
+    m_producer.cachedReadPos = 0;
+    m_producer.overruns.store(0, std::memory_order_relaxed);
+    m_producer.overrunFrames.store(0, std::memory_order_relaxed);
+    m_consumer.readPos.store(0, std::memory_order_relaxed);
+    m_consumer.cachedWritePos = 0;
+    m_consumer.underruns.store(0, std::memory_order_relaxed);
+}
+
+int RecordingBuffer::GetWriteSpace() const {
+    const uint64_t write = m_producer.writePos.load(std::memory_order_relaxed);
+    const uint64_t read = m_consumer.readPos.load(std::memory_order_acquire);
+    return m_capacity - static_cast<int>(write - read);
+}
+
+bool RecordingBuffer::Write(const float* const* channels, int numFrames) {
+    if (numFrames <= 0) return true;
+
+    // Only touch the consumer's cache line when the cached view is too full
+    const uint64_t write = m_producer.writePos.load(std::memory_order_relaxed);
+    if (numFrames > m_capacity - static_cast<int>(write - m_producer.cachedReadPos)) {
+        m_producer.cachedReadPos = m_consumer.readPos.load(std::memory_order_acquire);
+        if (numFrames > m_capacity - static_cast<int>(write - m_producer.cachedReadPos)) {
+            m_producer.overruns.fetch_add(1, std::memory_order_relaxed);
+            m_producer.overrunFrames.fetch_add(numFrames, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    const int start = static_cast<int>(write & m_mask);
+    const int first = std::min(numFrames, m_capacity - start);
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        float* dest = m_data.data() + static_cast<size_t>(ch) * m_capacity;
+        const float* src = channels ? channels[ch] : nullptr;
+        if (src) {
+            std::memcpy(dest + start, src, sizeof(float) * first);
+            std::memcpy(dest, src + first, sizeof(float) * (numFrames - first));
+        } else {
+            std::fill(dest + start, dest + start + first, 0.0f);
+            std::fill(dest, dest + (numFrames - first), 0.0f);
+        }
+    }
+
+    // Publish the samples with the position
+    m_producer.writePos.store(write + numFrames, std::memory_order_release);
+    return true;
+}
+
+int RecordingBuffer::GetReadAvailable() const {
+    const uint64_t write = m_producer.writePos.load(std::memory_order_acquire);
+    const uint64_t read = m_consumer.readPos.load(std::memory_order_relaxed);
+    return static_cast<int>(write - read);
+}
+
+int RecordingBuffer::Read(float* const* channels, int maxFrames) {
+    if (maxFrames <= 0) return 0;
+
+    // Only touch the producer's cache line when the cached view is short
+    const uint64_t read = m_consumer.readPos.load(std::memory_order_relaxed);
+    if (static_cast<int>(m_consumer.cachedWritePos - read) < maxFrames) {
+        m_consumer.cachedWritePos = m_producer.writePos.load(std::memory_order_acquire);
+        if (m_consumer.cachedWritePos == read) {
+            m_consumer.underruns.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+
+    const int numFrames = std::min(maxFrames, static_cast<int>(m_consumer.cachedWritePos - read));
+    const int start = static_cast<int>(read & m_mask);
+    const int first = std::min(numFrames, m_capacity - start);
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        const float* src = m_data.data() + static_cast<size_t>(ch) * m_capacity;
+        std::memcpy(channels[ch], src + start, sizeof(float) * first);
+        std::memcpy(channels[ch] + first, src, sizeof(float) * (numFrames - first));
+    }
+
+    // The producer may reuse the space once this is visible
+    m_consumer.readPos.store(read + numFrames, std::memory_order_release);
+    return numFrames;
+}
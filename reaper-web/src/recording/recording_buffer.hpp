@@ -0,0 +1,77 @@
+/*
+ * REAPER Web - Recording Buffer
+ * Lock-free ring carrying captured input from the audio thread to the
+ * recording writer thread
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * RecordingBuffer - Single-producer single-consumer planar ring
+ * The audio thread is the only writer and the recording writer thread the
+ * only reader. Positions count frames ever written/read and are published
+ * with release stores, so the reader never sees a position ahead of the
+ * samples behind it. Capacity is a power of two; wrapping is a mask and
+ * each side copies at most two contiguous spans per channel.
+ *
+ * Each side keeps its own position, a cached copy of the other side's and
+ * its counters on a separate cache line, and reloads the shared position
+ * only when the cached one says the ring is full (or empty).
+ */
+class RecordingBuffer {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    RecordingBuffer() = default;
+
+    RecordingBuffer(const RecordingBuffer&) = delete;
+    RecordingBuffer& operator=(const RecordingBuffer&) = delete;
+
+    // Not real-time safe; capacity is rounded up to a power of two
+    void Allocate(int numChannels, int minFrames);
+    void Reset();                       // Only while neither side is running
+
+    int GetNumChannels() const { return m_numChannels; }
+    int GetCapacity() const { return m_capacity; }
+
+    // Producer (audio thread). Writes all frames or none; a null channel
+    // writes silence. A refused write counts as an overrun.
+    int GetWriteSpace() const;
+    bool Write(const float* const* channels, int numFrames);
+
+    // Consumer (writer thread). Finding the ring empty counts as an underrun.
+    int GetReadAvailable() const;
+    int Read(float* const* channels, int maxFrames);    // Frames read
+
+    // Any thread
+    uint64_t GetOverruns() const { return m_producer.overruns.load(std::memory_order_relaxed); }
+    uint64_t GetOverrunFrames() const { return m_producer.overrunFrames.load(std::memory_order_relaxed); }
+    uint64_t GetUnderruns() const { return m_consumer.underruns.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<float> m_data;          // Planar: channel c starts at c * m_capacity
+    int m_numChannels = 0;
+    int m_capacity = 0;
+    int m_mask = 0;
+
+    struct alignas(CACHE_LINE_SIZE) ProducerState {
+        std::atomic<uint64_t> writePos{0};          // Frames written
+        uint64_t cachedReadPos = 0;                 // Last readPos seen
+        std::atomic<uint64_t> overruns{0};          // Writes refused
+        std::atomic<uint64_t> overrunFrames{0};     // Frames in those writes
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerState {
+        std::atomic<uint64_t> readPos{0};           // Frames read
+        uint64_t cachedWritePos = 0;                // Last writePos seen
+        std::atomic<uint64_t> underruns{0};         // Reads that found nothing
+    };
+
+    ProducerState m_producer;
+    ConsumerState m_consumer;
+};
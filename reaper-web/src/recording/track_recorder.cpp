@@ -0,0 +1,249 @@
+/*
+ * REAPER Web - Track Recorder Implementation
+ */
+
+#include "track_recorder.hpp"
+#include "../media/media_item.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr auto kDrainInterval = std::chrono::milliseconds(5);
+
+} // anonymous namespace
+
+// TrackRecorder Implementation
+TrackRecorder::TrackRecorder(Track* track, int firstInput, int numChannels)
+    : m_track(track), m_firstInput(std::max(0, firstInput)), m_numChannels(std::clamp(numChannels, 1, 2)) {
+}
+
+TrackRecorder::~TrackRecorder() {
+    Close();
+}
+
+bool TrackRecorder::Open(const std::string& filePath, double sampleRate, int bufferFrames,
+                         AudioFileWriter::SampleFormat format, bool dither) {
+    m_filePath = filePath;
+    if (!m_writer.Open(filePath, sampleRate, m_numChannels, format, dither)) {
+        return false;
+    }
+
+    // The source reads back whatever the writer has put in the file
+    m_source = std::make_shared<AudioSource>(AudioSource::SourceType::RECORDING);
+    if (!m_source->BeginRecording(filePath, sampleRate, m_numChannels, AudioFileWriter::DATA_OFFSET,
+                                  m_writer.GetBitsPerSample(), m_writer.IsFloat())) {
+        m_writer.Close();
+        m_source.reset();
+        return false;
+    }
+
+    m_buffer.Allocate(m_numChannels, bufferFrames);
+    m_drainData.assign(static_cast<size_t>(m_numChannels) * DRAIN_FRAMES, 0.0f);
+    m_drainPtrs.resize(m_numChannels);
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        m_drainPtrs[ch] = m_drainData.data() + static_cast<size_t>(ch) * DRAIN_FRAMES;
+    }
+    m_captureInputs.resize(m_numChannels);
+    m_pendingSilence = 0;
+    m_droppedFrames = 0;
+    return true;
+}
+
+void TrackRecorder::Capture(float** inputs, int numInputs, int offset, int numSamples) {
+    // Inputs the device does not have record silence
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        const int input = m_firstInput + ch;
+        m_captureInputs[ch] = input < numInputs && inputs[input] ? inputs[input] + offset : nullptr;
+    }
+
+    // After an overrun the lost frames go in as silence before anything
+    // newer, so the rest of the take stays on the timeline
+    while (m_pendingSilence > 0) {
+        const int gap = static_cast<int>(std::min<int64_t>(m_pendingSilence, m_buffer.GetWriteSpace()));
+        if (gap <= 0 || !m_buffer.Write(nullptr, gap)) break;
+        m_pendingSilence -= gap;
+    }
+
+    if (m_pendingSilence > 0 || !m_buffer.Write(m_captureInputs.data(), numSamples)) {
+        m_pendingSilence += numSamples;
+        m_droppedFrames.fetch_add(numSamples, std::memory_order_relaxed);
+    }
+}
+
+int TrackRecorder::Drain() {
+    if (!m_writer.IsOpen()) return 0;
+
+    // A short read means the ring is empty; stop there rather than count an underrun
+    int total = 0;
+    int frames = 0;
+    do {
+        frames = m_buffer.Read(m_drainPtrs.data(), DRAIN_FRAMES);
+        if (frames > 0) {
+            m_writer.Write(m_drainPtrs.data(), frames);
+            m_source->SetDurableFrames(m_writer.GetFramesFlushed());
+            m_source->AppendRecording(m_drainPtrs.data(), frames);
+            total += frames;
+        }
+    } while (frames == DRAIN_FRAMES);
+    return total;
+}
+
+bool TrackRecorder::Close() {
+    if (!m_writer.IsOpen()) {
+        return !m_writer.HasError();
+    }
+
+    Drain();
+    bool written = m_writer.Close();
+    m_source->FinishRecording(m_writer.GetFramesFlushed());
+    return written;
+}
+
+int64_t TrackRecorder::GetRecordedFrames() const {
+    return m_source ? m_source->GetRecordedFrames() : 0;
+}
+
+// RecordingEngine Implementation
+RecordingEngine::RecordingEngine() {
+}
+
+RecordingEngine::~RecordingEngine() {
+    Stop();
+}
+
+bool RecordingEngine::Start(const std::vector<TrackInput>& inputs, double sampleRate,
+                            AudioFileWriter::SampleFormat format, bool dither) {
+    if (m_capturing.load() || inputs.empty()) {
+        return false;
+    }
+
+    // The last pass's sources are no longer played from anywhere
+    m_recorders.clear();
+    m_segments = std::make_unique<Segment[]>(MAX_SEGMENTS);
+    m_segmentCount = 0;
+    m_nextSample = 0;
+    m_capturedFrames = 0;
+
+    int ringFrames = static_cast<int>(std::ceil(RING_SECONDS * sampleRate));
+    for (const TrackInput& input : inputs) {
+        auto recorder = std::make_unique<TrackRecorder>(input.track, input.firstInput, input.numChannels);
+        if (!recorder->Open(input.filePath, sampleRate, ringFrames, format, dither)) {
+            m_recorders.clear();
+            return false;
+        }
+        m_recorders.push_back(std::move(recorder));
+    }
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    m_writerRunning = true;
+    m_writerThread = std::thread(&RecordingEngine::WriterThreadMain, this);
+#endif
+
+    m_capturing = true;
+    return true;
+}
+
+bool RecordingEngine::Stop() {
+    if (!m_capturing.exchange(false)) {
+        return true;
+    }
+
+    // A block already inside Capture() finishes with the recorders intact
+    while (m_captureUsers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    if (m_writerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_writerRunning = false;
+        }
+        m_wakeCondition.notify_one();
+        m_writerThread.join();
+    }
+
+    bool written = true;
+    for (auto& recorder : m_recorders) {
+        written = recorder->Close() && written;
+    }
+    return written;
+}
+
+void RecordingEngine::SetPunchRange(int64_t punchIn, int64_t punchOut) {
+    m_punchIn = punchIn;
+    m_punchOut = punchOut;
+}
+
+void RecordingEngine::Capture(float** inputs, int numInputs, int numSamples, int64_t startSample) {
+    m_captureUsers.fetch_add(1);
+    if (m_capturing.load()) {
+        // Slice the block to the punch range on the exact sample
+        int64_t begin = startSample;
+        int64_t end = startSample + numSamples;
+        const int64_t punchIn = m_punchIn.load(std::memory_order_relaxed);
+        if (punchIn >= 0) {
+            begin = std::max(begin, punchIn);
+            end = std::min(end, m_punchOut.load(std::memory_order_relaxed));
+        }
+
+        if (end > begin) {
+            // A jump in project position (loop wrap, punch-in) starts a new pass
+            int count = m_segmentCount.load(std::memory_order_relaxed);
+            if ((count == 0 || begin != m_nextSample) && count < MAX_SEGMENTS) {
+                m_segments[count] = { begin, m_capturedFrames };
+                m_segmentCount.store(count + 1, std::memory_order_release);
+            }
+
+            const int offset = static_cast<int>(begin - startSample);
+            const int frames = static_cast<int>(end - begin);
+            for (auto& recorder : m_recorders) {
+                recorder->Capture(inputs, numInputs, offset, frames);
+            }
+            m_nextSample = end;
+            m_capturedFrames += frames;
+        }
+    }
+    m_captureUsers.fetch_sub(1);
+}
+
+int64_t RecordingEngine::GetStartSample() const {
+    return m_segmentCount.load(std::memory_order_acquire) > 0 ? m_segments[0].projectStart : -1;
+}
+
+std::vector<RecordingEngine::Segment> RecordingEngine::GetSegments() const {
+    const int count = m_segmentCount.load(std::memory_order_acquire);
+    return std::vector<Segment>(m_segments.get(), m_segments.get() + count);
+}
+
+void RecordingEngine::Service() {
+    if (m_capturing.load() && !m_writerThread.joinable()) {
+        DrainAll();
+    }
+}
+
+uint64_t RecordingEngine::GetDroppedFrames() const {
+    uint64_t dropped = 0;
+    for (const auto& recorder : m_recorders) {
+        dropped += recorder->GetDroppedFrames();
+    }
+    return dropped;
+}
+
+void RecordingEngine::WriterThreadMain() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (m_writerRunning.load()) {
+        lock.unlock();
+        DrainAll();
+        lock.lock();
+
+        // The audio thread never signals; poll well inside the ring's capacity
+        m_wakeCondition.wait_for(lock, kDrainInterval, [this] { return !m_writerRunning.load(); });
+    }
+}
+
+void RecordingEngine::DrainAll() {
+    for (auto& recorder : m_recorders) {
+        recorder->Drain();
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * REAPER Web - Track Recorder
+ * Captures record-armed track inputs on the audio thread and writes them
+ * to disk from a background writer thread
+ * Based on REAPER's recording path (input -> ring -> disk, item grows live)
+ */
+
+#pragma once
+
+#include "recording_buffer.hpp"
+#include "audio_file_writer.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Forward declarations
+class Track;
+class AudioSource;
+
+/**
+ * TrackRecorder - One armed track's recording
+ * Capture() copies the track's input channels into a lock-free ring and
+ * nothing else. If the writer falls so far behind that the ring is full,
+ * the block is counted as dropped and replaced by the same length of
+ * silence once there is room: a take never loses its place silently. Drain() runs on the writer thread: it empties the ring
+ * into the file writer's staging buffer and appends the same frames to a
+ * RECORDING AudioSource, which the track's new item plays back from while
+ * the take is still growing.
+ */
+class TrackRecorder {
+public:
+    static constexpr int DRAIN_FRAMES = 4096;      // Frames moved per ring read
+
+    TrackRecorder(Track* track, int firstInput, int numChannels);
+    ~TrackRecorder();
+
+    TrackRecorder(const TrackRecorder&) = delete;
+    TrackRecorder& operator=(const TrackRecorder&) = delete;
+
+    // Not real-time safe; creates the file and the growing source
+    bool Open(const std::string& filePath, double sampleRate, int bufferFrames,
+              AudioFileWriter::SampleFormat format = AudioFileWriter::SampleFormat::FLOAT_32, bool dither = false);
+
+    // Audio thread - records frames [offset, offset + numSamples) of the block
+    void Capture(float** inputs, int numInputs, int offset, int numSamples);
+
+    // Writer thread (or the thread that owns the recorder once capture has stopped)
+    int Drain();                        // Frames written this pass
+    bool Close();                       // Drains what is left and finalises the file
+
+    Track* GetTrack() const { return m_track; }
+    const std::string& GetFilePath() const { return m_filePath; }
+    std::shared_ptr<AudioSource> GetSource() const { return m_source; }
+    int GetNumChannels() const { return m_numChannels; }
+    int64_t GetRecordedFrames() const;
+    uint64_t GetDroppedFrames() const { return m_droppedFrames.load(); }    // Recorded as silence
+    const RecordingBuffer& GetBuffer() const { return m_buffer; }
+    bool HasError() const { return m_writer.HasError(); }
+
+private:
+    Track* m_track;
+    int m_firstInput;
+    int m_numChannels;
+    std::string m_filePath;
+
+    RecordingBuffer m_buffer;
+    AudioFileWriter m_writer;
+    std::shared_ptr<AudioSource> m_source;
+
+    std::vector<float> m_drainData;     // Planar DRAIN_FRAMES per channel (writer thread)
+    std::vector<float*> m_drainPtrs;
+    std::vector<const float*> m_captureInputs;     // Audio thread
+    int64_t m_pendingSilence = 0;                   // Lost frames not yet replaced (audio thread)
+    std::atomic<uint64_t> m_droppedFrames{0};       // Ring full; the writer fell behind
+};
+
+/**
+ * RecordingEngine - Recorders for one recording pass and their writer thread
+ * Start() opens every file before the audio thread sees the session;
+ * Capture() (audio thread) feeds each recorder; a writer thread drains
+ * all rings every few milliseconds so writes are large and sequential.
+ * Stop() waits out any capture in flight, then drains and finalises.
+ *
+ * Capture is sliced to the punch range on the exact sample. Every run of
+ * contiguous project samples starts a Segment: with loop recording each
+ * pass is one segment, and all passes go into the same files, one after
+ * another, so a pass is just an offset into each track's take source.
+ *
+ * Recorders (and their sources) live until the next Start() so takes can
+ * move to the finished files while the audio thread may still be reading.
+ */
+class RecordingEngine {
+public:
+    struct TrackInput {
+        Track* track = nullptr;
+        int firstInput = 0;             // First device input channel
+        int numChannels = 1;            // 1 = mono, 2 = stereo pair
+        std::string filePath;
+    };
+
+    // A contiguous run of captured project samples and where it starts in the files
+    struct Segment {
+        int64_t projectStart = 0;       // Project sample of the first frame
+        int64_t fileFrame = 0;          // Frame offset into every recorder's file
+    };
+
+    static constexpr double RING_SECONDS = 2.0;    // Disk stall the rings absorb
+    static constexpr int MAX_SEGMENTS = 4096;      // Later passes extend the last segment
+
+    RecordingEngine();
+    ~RecordingEngine();
+
+    // Not real-time safe
+    bool Start(const std::vector<TrackInput>& inputs, double sampleRate,
+               AudioFileWriter::SampleFormat format = AudioFileWriter::SampleFormat::FLOAT_32, bool dither = false);
+    bool Stop();                        // False if any file failed to write
+    bool IsRecording() const { return m_capturing.load(); }
+
+    // Project samples [punchIn, punchOut) only; punchIn < 0 records everything
+    void SetPunchRange(int64_t punchIn, int64_t punchOut);
+    void ClearPunchRange() { SetPunchRange(-1, -1); }
+
+    // Audio thread - startSample is the block's project position
+    void Capture(float** inputs, int numInputs, int numSamples, int64_t startSample);
+
+    // Drains on the calling thread when there is no writer thread (single-threaded builds)
+    void Service();
+
+    // Recorders of the current or last pass (not real-time safe)
+    const std::vector<std::unique_ptr<TrackRecorder>>& GetRecorders() const { return m_recorders; }
+    int64_t GetStartSample() const;     // First captured sample, -1 before
+    std::vector<Segment> GetSegments() const;
+    uint64_t GetDroppedFrames() const;
+
+private:
+    std::vector<std::unique_ptr<TrackRecorder>> m_recorders;
+
+    // Audio thread handshake: Stop() clears m_capturing, then waits for
+    // m_captureUsers to drain before touching the recorders
+    std::atomic<bool> m_capturing{false};
+    std::atomic<int> m_captureUsers{0};
+    std::atomic<int64_t> m_punchIn{-1};
+    std::atomic<int64_t> m_punchOut{-1};
+
+    // Written by the audio thread, published through m_segmentCount
+    std::unique_ptr<Segment[]> m_segments;
+    std::atomic<int> m_segmentCount{0};
+    int64_t m_nextSample = 0;           // Where the current segment continues (audio thread)
+    int64_t m_capturedFrames = 0;       // Frames given to each recorder (audio thread)
+
+    // Writer thread
+    std::thread m_writerThread;
+    std::atomic<bool> m_writerRunning{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    void WriterThreadMain();
+    void DrainAll();
+};
@@ -346,15 +346,13 @@ std::string TimelineView::FormatMinutesSecondsTime(double time) const {
 std::string TimelineView::FormatMeasuresBeatsTime(double time) const {
     if (!m_engine) return "1:1.000";
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beats = SecondsToBeats(time, tempo);
-    int timeSigNum = m_engine->GetTransportState().timeSigNumerator.load();
-    
-    int measure = static_cast<int>(beats / timeSigNum) + 1;
-    double beat = fmod(beats, timeSigNum) + 1.0;
+    auto tempoMap = m_engine->GetTempoMap();
+    int measure = 0;
+    double beat = 0.0;
+    tempoMap->BeatsToMeasure(tempoMap->TimeToBeats(time), measure, beat);
     
     std::ostringstream oss;
-    oss << measure << ":" << std::fixed << std::setprecision(3) << beat;
+    oss << (measure + 1) << ":" << std::fixed << std::setprecision(3) << (beat + 1.0);
     return oss.str();
 }
 
@@ -402,20 +400,33 @@ void TimelineView::CalculateBeatsGrid(std::vector<GridLine>& lines) const {
         return;
     }
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beatLength = 60.0 / tempo; // Length of one beat in seconds
+    // Walk bar by bar so every bar line follows the tempo map and the
+    // beats follow each bar's time signature
+    auto tempoMap = m_engine->GetTempoMap();
+    TempoMap::Cursor cursor(tempoMap.get());
     
-    double startBeat = floor(m_viewState.timeStart / beatLength);
-    double endBeat = ceil(m_viewState.timeEnd / beatLength);
+    int measure = 0;
+    double beatInBar = 0.0;
+    tempoMap->BeatsToMeasure(cursor.TimeToBeats(m_viewState.timeStart), measure, beatInBar);
     
-    for (double beat = startBeat; beat <= endBeat; beat += 1.0) {
-        double time = beat * beatLength;
-        if (time >= m_viewState.timeStart && time <= m_viewState.timeEnd) {
-            GridLine line;
-            line.time = time;
-            line.type = (fmod(beat, 4.0) < 0.001) ? 1 : 0; // Major every 4 beats (measure)
-            line.label = FormatTime(time);
-            lines.push_back(line);
+    for (; ; ++measure) {
+        double barStart = tempoMap->MeasureToBeats(measure);
+        double barEnd = tempoMap->MeasureToBeats(measure + 1);
+        TimeSignature timeSig = tempoMap->GetTimeSignatureAtMeasure(measure);
+        double beatLength = 4.0 / timeSig.denominator; // Quarter notes per time signature beat
+        
+        for (int beat = 0; beat < timeSig.numerator && barStart + beat * beatLength < barEnd - 1e-9; ++beat) {
+            double time = cursor.BeatsToTime(barStart + beat * beatLength);
+            if (time > m_viewState.timeEnd) {
+                return;
+            }
+            if (time >= m_viewState.timeStart) {
+                GridLine line;
+                line.time = time;
+                line.type = (beat == 0) ? 1 : 0; // Major at each bar line
+                line.label = FormatTime(time);
+                lines.push_back(line);
+            }
         }
     }
 }
@@ -471,9 +482,8 @@ double TimelineView::SnapToSeconds(double time) const {
 double TimelineView::SnapToBeats(double time) const {
     if (!m_engine) return time;
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beatLength = 60.0 / tempo;
-    return round(time / beatLength) * beatLength;
+    auto tempoMap = m_engine->GetTempoMap();
+    return tempoMap->BeatsToTime(round(tempoMap->TimeToBeats(time)));
 }
 
 double TimelineView::ClampZoom(double zoom) const {
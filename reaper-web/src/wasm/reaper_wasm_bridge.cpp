@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <sstream>
 
 using namespace emscripten;
 
@@ -27,6 +28,45 @@ float* g_outputBuffer = nullptr;
 int g_bufferSize = 512;
 int g_sampleRate = 44100;
 
+// Deadline-miss snapshot for support diagnostics: counts, the block
+// timings leading up to the last miss and each track's share of it
+static std::string GetDropoutReportJSON() {
+    std::ostringstream json;
+    AudioEngine* audioEngine = g_reaperEngine ? g_reaperEngine->GetAudioEngine() : nullptr;
+    if (!audioEngine) {
+        return "{}";
+    }
+    
+    const AudioEngine::PerformanceStats& stats = audioEngine->GetPerformanceStats();
+    json << "{\"dropouts\":" << stats.dropouts.load() << ",\"deadlineMisses\":" << stats.deadlineMisses.load();
+    
+    AudioEngine::DropoutReport report;
+    if (audioEngine->GetLastDropoutReport(report)) {
+        json << ",\"lastMiss\":{\"sequence\":" << report.sequence << ",\"blocks\":[";
+        for (int i = 0; i < report.numBlocks; ++i) {
+            const AudioEngine::BlockTiming& block = report.blocks[i];
+            json << (i ? "," : "") << "{\"startSample\":" << block.startSample << ",\"samples\":" << block.numSamples
+                 << ",\"ms\":" << block.processingMs << ",\"deadlineMs\":" << block.deadlineMs << "}";
+        }
+        
+        json << "],\"tracks\":[";
+        TrackManager* trackManager = g_reaperEngine->GetTrackManager();
+        for (int i = 0; i < report.numTracks; ++i) {
+            const AudioEngine::TrackTiming& timing = report.tracks[i];
+            Track* track = trackManager ? trackManager->GetTrack(timing.trackIndex) : nullptr;
+            std::string name = track ? track->GetName() : "";
+            for (char& c : name) {
+                if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) c = '_';
+            }
+            json << (i ? "," : "") << "{\"index\":" << timing.trackIndex << ",\"name\":\"" << name
+                 << "\",\"ms\":" << timing.processingMs << "}";
+        }
+        json << "]}";
+    }
+    json << "}";
+    return json.str();
+}
+
 extern "C" {
 
 // Engine Initialization
@@ -496,15 +536,23 @@ float reaper_get_cpu_usage() {
 EMSCRIPTEN_KEEPALIVE
 int reaper_get_audio_dropouts() {
     if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
-        return g_reaperEngine->GetAudioEngine()->GetDropoutCount();
+        return g_reaperEngine->GetAudioEngine()->GetPerformanceStats().dropouts.load();
     }
     return 0;
 }
 
+// Latest deadline miss as JSON; the string is valid until the next call
+EMSCRIPTEN_KEEPALIVE
+const char* reaper_get_dropout_report() {
+    static std::string report;
+    report = GetDropoutReportJSON();
+    return report.c_str();
+}
+
 EMSCRIPTEN_KEEPALIVE
 void reaper_reset_performance_counters() {
     if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
-        g_reaperEngine->GetAudioEngine()->ResetPerformanceCounters();
+        g_reaperEngine->GetAudioEngine()->ResetPerformanceStats();
     }
 }
 
@@ -574,5 +622,6 @@ EMSCRIPTEN_BINDINGS(reaper_engine) {
     // Performance monitoring
     function("getCPUUsage", &reaper_get_cpu_usage);
     function("getAudioDropouts", &reaper_get_audio_dropouts);
+    function("getDropoutReport", &GetDropoutReportJSON);
     function("resetPerformanceCounters", &reaper_reset_performance_counters);
 }
\ No newline at end of file
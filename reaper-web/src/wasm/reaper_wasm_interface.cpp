@@ -14,7 +14,9 @@
 #include "reaper_engine.hpp"
 #include "audio_engine.hpp"
 #include "track_manager.hpp"
+#include "../effects/effect_chain.hpp"
 #include "project_manager.hpp"
+#include "profiler.hpp"
 
 using namespace emscripten;
 
@@ -105,6 +107,12 @@ void reaper_engine_toggle_play_pause() {
     if (g_engine) g_engine->TogglePlayPause();
 }
 
+// Called from the UI timer while recording
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_update_recording() {
+    if (g_engine) g_engine->UpdateRecording();
+}
+
 // Position and timing
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_set_position(double seconds) {
@@ -133,15 +141,36 @@ void reaper_engine_set_loop_points(double start, double end) {
     if (g_engine) g_engine->SetLoopPoints(start, end);
 }
 
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_loop(int enabled) {
+    if (g_engine) g_engine->SetLoop(enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_punch_range(double punchIn, double punchOut) {
+    if (g_engine) g_engine->SetPunchRange(punchIn, punchOut);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_auto_punch(int enabled) {
+    if (g_engine) g_engine->SetAutoPunch(enabled != 0);
+}
+
 // Master controls
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_set_master_volume(double volume) {
-    if (g_engine) g_engine->SetMasterVolume(volume);
+    if (!g_engine) return;
+    
+    g_engine->SetMasterVolume(volume);
+    g_engine->AddUndoPoint("Master volume", "master-volume");
 }
 
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_set_master_pan(double pan) {
-    if (g_engine) g_engine->SetMasterPan(pan);
+    if (!g_engine) return;
+    
+    g_engine->SetMasterPan(pan);
+    g_engine->AddUndoPoint("Master pan", "master-pan");
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -154,6 +183,16 @@ void reaper_engine_set_metronome(int enabled) {
     if (g_engine) g_engine->SetMetronome(enabled != 0);
 }
 
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_click_volume(int volume) {
+    if (g_engine) g_engine->SetClickVolume(volume);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_count_in(int enabled, int bars) {
+    if (g_engine) g_engine->SetCountIn(enabled != 0, bars);
+}
+
 // Audio settings
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_set_sample_rate(double rate) {
@@ -165,6 +204,11 @@ void reaper_engine_set_buffer_size(int size) {
     if (g_engine) g_engine->SetBufferSize(size);
 }
 
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_device_sample_rate(double rate) {
+    if (g_engine) g_engine->SetDeviceSampleRate(rate);
+}
+
 // Performance monitoring
 EMSCRIPTEN_KEEPALIVE
 double reaper_engine_get_cpu_usage() {
@@ -172,6 +216,30 @@ double reaper_engine_get_cpu_usage() {
     return g_engine->GetCpuUsage();
 }
 
+EMSCRIPTEN_KEEPALIVE
+double reaper_engine_get_latency_ms() {
+    if (!g_engine || !g_engine->GetAudioEngine()) return 0.0;
+    return g_engine->GetAudioEngine()->GetPerformanceStats().latencyMs.load();
+}
+
+// Profiling - the trace is written to the virtual file system for the UI to fetch
+EMSCRIPTEN_KEEPALIVE
+int reaper_profiler_start(const char* filePath) {
+    if (!filePath) return 0;
+    return Profiler::GetInstance().StartCapture(filePath) ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int reaper_profiler_stop() {
+    return Profiler::GetInstance().StopCapture() ? 1 : 0;
+}
+
+// Called from the UI timer while profiling (drains the event rings without pthreads)
+EMSCRIPTEN_KEEPALIVE
+void reaper_profiler_service() {
+    Profiler::GetInstance().Service();
+}
+
 // Track management
 EMSCRIPTEN_KEEPALIVE
 int track_manager_create_track(const char* name) {
@@ -212,6 +280,8 @@ void track_manager_set_track_volume(int trackIndex, double volume) {
     Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
     if (track) {
         track->SetVolume(volume);
+        // A fader drag sends many values; they merge into one undo point
+        g_engine->AddUndoPoint("Track volume", "track-volume:" + track->GetGUID());
     }
 }
 
@@ -223,6 +293,7 @@ void track_manager_set_track_pan(int trackIndex, double pan) {
     Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
     if (track) {
         track->SetPan(pan);
+        g_engine->AddUndoPoint("Track pan", "track-pan:" + track->GetGUID());
     }
 }
 
@@ -234,6 +305,7 @@ void track_manager_set_track_mute(int trackIndex, int mute) {
     Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
     if (track) {
         track->SetMute(mute != 0);
+        g_engine->AddUndoPoint("Track mute");
     }
 }
 
@@ -245,6 +317,7 @@ void track_manager_set_track_solo(int trackIndex, int solo) {
     Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
     if (track) {
         track->SetSolo(solo != 0);
+        g_engine->AddUndoPoint("Track solo");
     }
 }
 
@@ -259,6 +332,58 @@ void track_manager_set_track_record_arm(int trackIndex, int armed) {
     }
 }
 
+EMSCRIPTEN_KEEPALIVE
+void track_manager_set_track_input(int trackIndex, int input) {
+    if (!g_engine) return;
+    
+    TrackManager* trackManager = g_engine->GetTrackManager();
+    Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
+    if (track) {
+        track->SetInputChannel(input);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void track_manager_set_track_input_monitor(int trackIndex, int monitor) {
+    if (!g_engine) return;
+    
+    TrackManager* trackManager = g_engine->GetTrackManager();
+    Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
+    if (track) {
+        track->SetInputMonitor(monitor != 0);
+    }
+}
+
+// CPU load in percent of real time: decayed average and held peak
+EMSCRIPTEN_KEEPALIVE
+double track_manager_get_track_cpu_usage(int trackIndex) {
+    if (!g_engine) return 0.0;
+    
+    TrackManager* trackManager = g_engine->GetTrackManager();
+    Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
+    return track ? track->GetCpuMeter().GetAverage() * 100.0 : 0.0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+double track_manager_get_track_peak_cpu_usage(int trackIndex) {
+    if (!g_engine) return 0.0;
+    
+    TrackManager* trackManager = g_engine->GetTrackManager();
+    Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
+    return track ? track->GetCpuMeter().GetPeak() * 100.0 : 0.0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+double track_manager_get_effect_cpu_usage(int trackIndex, int effectIndex) {
+    if (!g_engine || effectIndex < 0) return 0.0;
+    
+    TrackManager* trackManager = g_engine->GetTrackManager();
+    Track* track = trackManager ? trackManager->GetTrack(trackIndex) : nullptr;
+    EffectChain* chain = track ? track->GetEffectsChain() : nullptr;
+    const JSFXEffect* effect = chain ? chain->GetEffect(static_cast<size_t>(effectIndex)) : nullptr;
+    return effect ? effect->GetCpuUsage() : 0.0;
+}
+
 // Project management
 EMSCRIPTEN_KEEPALIVE
 int project_manager_new_project() {
@@ -278,6 +403,14 @@ int project_manager_save_project(const char* filePath) {
     return g_engine->SaveProject(filePath ? filePath : "") ? 1 : 0;
 }
 
+// Called from the UI timer; writes a binary snapshot when the interval has passed
+EMSCRIPTEN_KEEPALIVE
+void project_manager_auto_save() {
+    if (g_engine && g_engine->GetProjectManager()) {
+        g_engine->GetProjectManager()->AutoSave();
+    }
+}
+
 // Undo/Redo
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_begin_undo_block(const char* description) {
@@ -303,6 +436,12 @@ int reaper_engine_redo() {
     return g_engine->Redo() ? 1 : 0;
 }
 
+EMSCRIPTEN_KEEPALIVE
+double reaper_engine_get_undo_memory_usage() {
+    if (!g_engine) return 0.0;
+    return static_cast<double>(g_engine->GetUndoMemoryUsage());
+}
+
 } // extern "C"
 
 // Embind bindings for more complex C++ objects
@@ -0,0 +1,330 @@
+/*
+ * REAPER Web - Audio Block Cache Test Application
+ * Verifies hits and misses, mixing with gain, blocks queued by id, per-channel
+ * eviction under a small budget and a reader and mixer racing the decoder
+ * thread for slots
+ */
+
+#include "src/media/audio_block_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * Pattern provider - every sample is a function of its frame and channel,
+ * so any read can be checked without keeping the source around
+ */
+class PatternProvider : public AudioBlockCache::Provider {
+public:
+    explicit PatternProvider(int numChannels) : m_numChannels(numChannels) {}
+
+    static float Sample(int64_t frame, int channel) {
+        return static_cast<float>((frame % 9973) + 1) * (channel == 0 ? 1.0f : -1.0f) + channel * 0.25f;
+    }
+
+    bool DecodeFrames(int64_t startFrame, int numFrames, float* const* channels) override {
+        for (int ch = 0; ch < m_numChannels; ++ch) {
+            for (int i = 0; i < numFrames; ++i) {
+                channels[ch][i] = Sample(startFrame + i, ch);
+            }
+        }
+        m_decodeCalls.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    int GetDecodeCalls() const { return m_decodeCalls.load(std::memory_order_relaxed); }
+
+private:
+    int m_numChannels;
+    std::atomic<int> m_decodeCalls{0};
+};
+
+/**
+ * Audio block cache test - drives the process-wide cache with small
+ * budgets so eviction happens within a few blocks
+ */
+class AudioBlockCacheTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Audio Block Cache Test ===\n";
+
+        TestHitAndMiss();
+        TestMix();
+        TestRequestBlocks();
+        TestChannelEviction();
+        TestConcurrentReader();
+
+        AudioBlockCache::GetInstance().SetMemoryBudget(AudioBlockCache::DEFAULT_MEMORY_BUDGET);
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr int kBlock = AudioBlockCache::BLOCK_FRAMES;
+    static constexpr size_t kSlotBytes = sizeof(float) * AudioBlockCache::BLOCK_FRAMES;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static bool Matches(const std::vector<float>& data, int64_t startFrame, int channel) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (data[i] != PatternProvider::Sample(startFrame + static_cast<int64_t>(i), channel)) return false;
+        }
+        return true;
+    }
+
+    static bool IsSilent(const std::vector<float>& data) {
+        for (float sample : data) {
+            if (sample != 0.0f) return false;
+        }
+        return true;
+    }
+
+    // Every frame of a stereo mix into silence is either both channels of the source or neither
+    static bool MixedInStep(const std::vector<float>& left, const std::vector<float>& right, int64_t startFrame) {
+        for (size_t i = 0; i < left.size(); ++i) {
+            const int64_t frame = startFrame + static_cast<int64_t>(i);
+            const bool mixed = left[i] == PatternProvider::Sample(frame, 0) &&
+                               right[i] == PatternProvider::Sample(frame, 1);
+            if (!mixed && (left[i] != 0.0f || right[i] != 0.0f)) return false;
+        }
+        return true;
+    }
+
+    // Reads until the decoder thread has filled the range or the timeout passes
+    static bool ReadWhenResident(AudioBlockCache::SourceHandle* handle, int64_t startFrame, float* const* channels,
+                                 int numFrames) {
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (cache.Read(handle, startFrame, numFrames, channels)) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return false;
+    }
+
+    void TestHitAndMiss() {
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        cache.SetMemoryBudget(AudioBlockCache::DEFAULT_MEMORY_BUDGET);
+        cache.ResetStats();
+
+        PatternProvider provider(2);
+        const int64_t numFrames = kBlock + kBlock / 2;
+        AudioBlockCache::SourceHandle* handle = cache.RegisterSource(&provider, 2, numFrames);
+        Check(handle != nullptr, "Source registers");
+
+        constexpr int kFrames = 512;
+        std::vector<float> left(kFrames), right(kFrames);
+        float* channels[2] = {left.data(), right.data()};
+
+        Check(!cache.Read(handle, 1000, kFrames, channels) && IsSilent(left) && IsSilent(right),
+              "A cold block misses and reads as silence");
+        Check(cache.GetStats().misses == 1, "The miss is counted");
+
+        Check(ReadWhenResident(handle, 1000, channels, kFrames) && Matches(left, 1000, 0) && Matches(right, 1000, 1),
+              "The decoder thread fills the missed block");
+        Check(cache.GetStats().hits >= 1, "The refilled block is a hit");
+
+        // A read across the block boundary, with the second block read ahead from the first
+        const int64_t boundary = kBlock - kFrames / 2;
+        Check(ReadWhenResident(handle, boundary, channels, kFrames) && Matches(left, boundary, 0) &&
+              Matches(right, boundary, 1), "Reads span the block boundary");
+
+        const int decodes = provider.GetDecodeCalls();
+        cache.Preload(handle, 0, static_cast<int>(numFrames));
+        Check(provider.GetDecodeCalls() == decodes, "Preloading resident blocks decodes nothing");
+
+        const uint64_t missesBefore = cache.GetStats().misses;
+        cache.Read(handle, numFrames - 100, kFrames, channels);
+        Check(Matches(std::vector<float>(left.begin(), left.begin() + 100), numFrames - 100, 0) &&
+              IsSilent(std::vector<float>(left.begin() + 100, left.end())) &&
+              cache.GetStats().misses == missesBefore, "Past the end reads as silence without a miss");
+
+        cache.InvalidateSource(handle);
+        Check(!cache.Read(handle, 1000, kFrames, channels), "Invalidated blocks miss");
+
+        cache.UnregisterSource(handle);
+    }
+
+    void TestMix() {
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        cache.ResetStats();
+
+        PatternProvider provider(1);
+        AudioBlockCache::SourceHandle* handle = cache.RegisterSource(&provider, 1, 2 * kBlock);
+
+        constexpr int kFrames = 1024;
+        constexpr int kOffset = 64;
+        const int64_t start = kBlock - 300;
+        std::vector<float> left(kOffset + kFrames, 1.0f), right(kOffset + kFrames, 1.0f);
+        float* dest[2] = {left.data(), right.data()};
+
+        Check(!cache.Mix(handle, start, kFrames, dest, 2, kOffset, 0.5f) && left[kOffset] == 1.0f,
+              "A cold mix misses and adds nothing");
+
+        cache.Preload(handle, 0, 2 * kBlock);
+        Check(cache.Mix(handle, start, kFrames, dest, 2, kOffset, 0.5f), "A resident range mixes as a hit");
+
+        bool mixed = left[kOffset - 1] == 1.0f && right[kOffset - 1] == 1.0f;
+        for (int i = 0; i < kFrames; ++i) {
+            float expected = 1.0f + PatternProvider::Sample(start + i, 0) * 0.5f;
+            mixed = mixed && left[kOffset + i] == expected && right[kOffset + i] == expected;
+        }
+        Check(mixed, "Mono audio is added with gain at the offset on every channel, across blocks");
+
+        std::fill(left.begin(), left.end(), 0.0f);
+        cache.Mix(handle, 2 * kBlock - 100, kFrames, dest, 1, 0, 1.0f);
+        Check(left[99] == PatternProvider::Sample(2 * kBlock - 1, 0) && left[100] == 0.0f,
+              "Past the end adds nothing");
+
+        cache.UnregisterSource(handle);
+    }
+
+    void TestRequestBlocks() {
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        cache.ResetStats();
+
+        PatternProvider provider(2);
+        AudioBlockCache::SourceHandle* handle = cache.RegisterSource(&provider, 2, 3 * kBlock);
+
+        // A range starting mid-block covers two blocks; nothing past the end
+        std::vector<AudioBlockCache::BlockRef> refs;
+        cache.GetBlockRefs(handle, 3 * kBlock - 10, kBlock, refs);
+        Check(refs.size() == 1 && refs[0].block == 2, "Block refs stop at the end of the source");
+        refs.clear();
+        cache.GetBlockRefs(handle, kBlock / 2, kBlock, refs);
+        Check(refs.size() == 2 && refs[0].block == 0 && refs[1].block == 1 && provider.GetDecodeCalls() == 0,
+              "Block refs cover the range without decoding");
+
+        // Queued by id, then decoded on the decoder thread
+        cache.RequestBlocks(refs);
+        constexpr int kFrames = 512;
+        std::vector<float> left(kFrames), right(kFrames);
+        float* channels[2] = {left.data(), right.data()};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (provider.GetDecodeCalls() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        Check(provider.GetDecodeCalls() == 2, "Requested blocks are decoded without a read");
+
+        // Decoding finishes before the slots are published, so the read may still miss briefly
+        Check(ReadWhenResident(handle, kBlock - kFrames / 2, channels, kFrames) &&
+              Matches(left, kBlock - kFrames / 2, 0), "Requested blocks become resident");
+
+        // Refs outliving their source are dropped by the decoder thread
+        cache.UnregisterSource(handle);
+        const uint64_t decoded = cache.GetStats().decodedBlocks;
+        cache.RequestBlocks(refs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        Check(cache.GetStats().decodedBlocks == decoded, "Blocks of an unregistered source are skipped");
+    }
+
+    void TestChannelEviction() {
+        // Three slots for a stereo source of two blocks: at most one block is ever whole
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        cache.SetMemoryBudget(3 * kSlotBytes);
+        cache.ResetStats();
+
+        PatternProvider provider(2);
+        AudioBlockCache::SourceHandle* handle = cache.RegisterSource(&provider, 2, 2 * kBlock);
+
+        // Slots age equally without reads, so the lowest index goes first: loading block 1
+        // evicts block 0's left channel, and reloading block 0 evicts block 1's right channel
+        cache.Preload(handle, 0, kBlock);
+        cache.Preload(handle, kBlock, kBlock);
+        cache.Preload(handle, 0, kBlock);
+        Check(cache.GetStats().evictions == 2, "A full budget evicts single channel slots");
+
+        AudioBlockCache::Stats stats = cache.GetStats();
+        Check(stats.memoryUsed <= stats.memoryBudget, "Resident audio stays within the budget");
+
+        constexpr int kFrames = 1024;
+        std::vector<float> left(kFrames), right(kFrames);
+        float* channels[2] = {left.data(), right.data()};
+        const int64_t start = kBlock + 4096;
+
+        Check(!cache.Read(handle, start, kFrames, channels), "A block missing one channel misses");
+        Check(ReadWhenResident(handle, start, channels, kFrames) && Matches(left, start, 0) &&
+              Matches(right, start, 1), "The block comes back in both channels after eviction");
+
+        cache.UnregisterSource(handle);
+    }
+
+    void TestConcurrentReader() {
+        // A reader at audio-block size against the decoder thread and a preloading
+        // thread fighting over four slots; every read is whole or silent, never torn,
+        // and every mix adds both channels of a frame or neither
+        AudioBlockCache& cache = AudioBlockCache::GetInstance();
+        cache.SetMemoryBudget(4 * kSlotBytes);
+        cache.ResetStats();
+
+        PatternProvider provider(2);
+        constexpr int kBlocks = 6;
+        AudioBlockCache::SourceHandle* handle = cache.RegisterSource(&provider, 2, kBlocks * kBlock);
+
+        std::atomic<bool> running{true};
+        std::thread preloader([&] {
+            std::mt19937 rng(7);
+            while (running.load()) {
+                cache.Preload(handle, static_cast<int64_t>(rng() % kBlocks) * kBlock, 1);
+            }
+        });
+
+        constexpr int kFrames = 512;
+        constexpr int kReads = 200000;
+        std::vector<float> left(kFrames), right(kFrames);
+        float* channels[2] = {left.data(), right.data()};
+        int hits = 0;
+        int torn = 0;
+        int lopsided = 0;
+
+        std::mt19937 rng(11);
+        for (int i = 0; i < kReads; ++i) {
+            const int64_t start = static_cast<int64_t>(rng() % (kBlocks * kBlock / kFrames)) * kFrames;
+            if (i % 2 == 1) {
+                std::fill(left.begin(), left.end(), 0.0f);
+                std::fill(right.begin(), right.end(), 0.0f);
+                const bool hit = cache.Mix(handle, start, kFrames, channels, 2, 0, 1.0f);
+                if (hit ? !Matches(left, start, 0) || !Matches(right, start, 1) : !MixedInStep(left, right, start)) {
+                    ++lopsided;
+                }
+                continue;
+            }
+            if (cache.Read(handle, start, kFrames, channels)) {
+                ++hits;
+                if (!Matches(left, start, 0) || !Matches(right, start, 1)) ++torn;
+            } else if (!IsSilent(left) || !IsSilent(right)) {
+                ++torn;
+            }
+        }
+
+        running = false;
+        preloader.join();
+
+        std::cout << "  " << hits << " of " << kReads / 2 << " reads hit, " << cache.GetStats().evictions
+                  << " evictions\n";
+        Check(torn == 0, "No read returns torn or mixed audio while slots are recycled");
+        Check(lopsided == 0, "No mix adds one channel of a frame without the other");
+        Check(hits > 0 && cache.GetStats().evictions > 0, "Reads hit while the budget forces eviction");
+
+        cache.UnregisterSource(handle);
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Audio Block Cache Test\n";
+    std::cout << "===================================\n";
+
+    AudioBlockCacheTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+/*
+ * REAPER Web - Audio Engine Test Application
+ * Verifies that blocks processed slower than they play for are counted as
+ * deadline misses and reported with the block history and per-track times,
+ * that monitored input comes out through its track's FX in the same block,
+ * and that per-track and per-effect CPU meters account for where time goes
+ */
+
+#include "src/core/audio_engine.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/media/media_item.hpp"
+#include "src/effects/effect_chain.hpp"
+#include "src/jsfx/jsfx_interpreter.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Audio engine test - drives ProcessBlock directly with tracks whose FX cost
+ * is set per block, the way a device callback would
+ */
+class AudioEngineTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Audio Engine Test ===\n";
+
+        TestDeadlineMisses();
+        TestInputMonitoring();
+        TestCpuAccounting();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    static constexpr double SAMPLE_RATE = 48000.0;
+    static constexpr int BLOCK_SIZE = 64;
+    static constexpr int NUM_CHANNELS = 2;
+
+    // Spins slider1 times per sample, so one block can be made to take far
+    // longer than the 1.3 ms it plays for in any build
+    static constexpr const char* SLOW_EFFECT =
+        "desc:Slow\n"
+        "slider1:0<0,10000,1>Spins per sample\n"
+        "@sample\n"
+        "i = 0;\n"
+        "while (i < slider1) i += 1;\n";
+
+    static constexpr const char* GAIN_EFFECT =
+        "desc:Double\n"
+        "@sample\n"
+        "spl0 *= 2;\n"
+        "spl1 *= 2;\n";
+
+    // Output scratch for one device callback
+    struct Block {
+        std::vector<float> left = std::vector<float>(BLOCK_SIZE);
+        std::vector<float> right = std::vector<float>(BLOCK_SIZE);
+        float* outputs[NUM_CHANNELS] = { left.data(), right.data() };
+    };
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static JSFXEffect* AddEffect(Track* track, const char* source) {
+        auto effect = std::make_unique<JSFXEffect>();
+        effect->LoadEffect(source);
+        effect->Initialize(SAMPLE_RATE, BLOCK_SIZE);
+        JSFXEffect* raw = effect.get();
+        track->GetEffectsChain()->AddEffect(std::move(effect));
+        return raw;
+    }
+
+    void TestDeadlineMisses() {
+        std::cout << "\n--- Deadline Misses and Dropout Reports ---\n";
+
+        AudioEngine engine;
+        engine.Initialize(SAMPLE_RATE, BLOCK_SIZE, NUM_CHANNELS);
+        TrackManager tracks;
+        tracks.Initialize(&engine);
+        MediaItemManager items;
+        tracks.CreateTrack("Fast");
+        JSFXEffect* slow = AddEffect(tracks.CreateTrack("Slow"), SLOW_EFFECT);
+        Block block;
+
+        AudioEngine::DropoutReport report;
+        Check(!engine.GetLastDropoutReport(report), "No report before any block");
+
+        // Cheap blocks first; a sanitizer build may miss one of these, so the
+        // counts below are taken relative to them
+        int64_t position = 0;
+        for (int i = 0; i < 40; ++i, position += BLOCK_SIZE) {
+            engine.ProcessBlock(nullptr, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, position);
+        }
+        const int missesBefore = engine.GetPerformanceStats().deadlineMisses.load();
+
+        // One block that takes many times its own length
+        slow->SetParameter(0, 1000);
+        const int64_t slowStart = position;
+        engine.ProcessBlock(nullptr, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, slowStart);
+        position += BLOCK_SIZE;
+        slow->SetParameter(0, 0);
+
+        const AudioEngine::PerformanceStats& stats = engine.GetPerformanceStats();
+        Check(stats.deadlineMisses.load() == missesBefore + 1, "The over-budget block is counted as a deadline miss");
+        Check(stats.dropouts.load() == 0, "A deadline miss is not counted as a dropout");
+
+        Check(engine.GetLastDropoutReport(report), "The miss leaves a report");
+        Check(report.sequence == static_cast<uint64_t>(missesBefore + 1), "The report carries the miss number");
+        Check(report.numBlocks == AudioEngine::HISTORY_BLOCKS, "The report holds the last HISTORY_BLOCKS blocks");
+
+        const AudioEngine::BlockTiming& missed = report.blocks[report.numBlocks - 1];
+        const double deadlineMs = BLOCK_SIZE * 1000.0 / SAMPLE_RATE;
+        std::cout << "  missed block took " << missed.processingMs << " ms of " << missed.deadlineMs << " ms\n";
+        Check(missed.startSample == slowStart && missed.numSamples == BLOCK_SIZE,
+              "The last block in the report is the one that missed");
+        Check(std::abs(missed.deadlineMs - deadlineMs) < 1e-3 && missed.processingMs > missed.deadlineMs,
+              "The missed block's time exceeds its deadline");
+        Check(report.blocks[0].startSample == slowStart - (AudioEngine::HISTORY_BLOCKS - 1) * BLOCK_SIZE &&
+                  report.blocks[1].startSample == report.blocks[0].startSample + BLOCK_SIZE,
+              "The history runs oldest first");
+
+        // Both tracks ran in the missed block; the slow one accounts for it
+        bool tracksListed = report.numTracks == 2;
+        float fastMs = 0.0f;
+        float slowMs = 0.0f;
+        for (int t = 0; tracksListed && t < report.numTracks; ++t) {
+            if (report.tracks[t].trackIndex == 0) fastMs = report.tracks[t].processingMs;
+            if (report.tracks[t].trackIndex == 1) slowMs = report.tracks[t].processingMs;
+        }
+        Check(tracksListed, "The report lists every processed track");
+        Check(slowMs > deadlineMs && slowMs > fastMs, "The slow track's time is in the report");
+
+        // More misses than the ring holds: the newest is always the one returned
+        slow->SetParameter(0, 1000);
+        for (int i = 0; i < 6; ++i, position += BLOCK_SIZE) {
+            engine.ProcessBlock(nullptr, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, position);
+        }
+        slow->SetParameter(0, 0);
+        const int misses = stats.deadlineMisses.load();
+        Check(misses == missesBefore + 7, "Every over-budget block is counted");
+        Check(engine.GetLastDropoutReport(report) && report.sequence == static_cast<uint64_t>(misses) &&
+                  report.blocks[report.numBlocks - 1].startSample == position - BLOCK_SIZE,
+              "After the ring wraps the newest miss is reported");
+
+        engine.ResetPerformanceStats();
+        Check(stats.deadlineMisses.load() == 0 && !engine.GetLastDropoutReport(report),
+              "A reset clears the count and hides earlier reports");
+    }
+
+    void TestInputMonitoring() {
+        std::cout << "\n--- Input Monitoring Through Track FX ---\n";
+
+        AudioEngine engine;
+        engine.Initialize(SAMPLE_RATE, BLOCK_SIZE, NUM_CHANNELS);
+        TrackManager tracks;
+        tracks.Initialize(&engine);
+        MediaItemManager items;
+        JSFXEffect* slow = AddEffect(tracks.CreateTrack("Slow"), SLOW_EFFECT);
+        tracks.CreateTrack("Plain");
+        Track* monitored = tracks.CreateTrack("Input");
+        monitored->SetInputMonitor(true);
+        AddEffect(monitored, GAIN_EFFECT);
+        engine.PrepareForTracks(tracks.GetTrackCount());
+        Block block;
+
+        // Each block's input is a ramp that starts where the block does
+        std::vector<float> input(BLOCK_SIZE);
+        float* inputs[NUM_CHANNELS] = { input.data(), input.data() };
+        bool sameBlock = true;
+        int64_t position = 0;
+        for (int b = 0; b < 16; ++b, position += BLOCK_SIZE) {
+            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                input[i] = static_cast<float>(b * BLOCK_SIZE + i) / (16 * BLOCK_SIZE);
+            }
+            engine.ProcessBlock(inputs, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, position);
+            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                sameBlock = sameBlock && std::abs(block.left[i] - 2.0f * input[i]) < 1e-5f &&
+                            std::abs(block.right[i] - 2.0f * input[i]) < 1e-5f;
+            }
+        }
+        Check(sameBlock, "Monitored input leaves through the track's FX in the block it arrived in");
+
+        // The order the tracks ran in is in the report of a missed block
+        slow->SetParameter(0, 1000);
+        engine.ProcessBlock(inputs, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, position);
+        slow->SetParameter(0, 0);
+
+        AudioEngine::DropoutReport report;
+        Check(engine.GetLastDropoutReport(report) && report.numTracks == 3 && report.tracks[0].trackIndex == 2 &&
+                  report.tracks[1].trackIndex == 0 && report.tracks[2].trackIndex == 1,
+              "The monitored track runs first and the rest keep their order");
+
+        // Stopped (no media manager) only the monitored track runs
+        engine.ProcessBlock(inputs, block.outputs, NUM_CHANNELS, BLOCK_SIZE, nullptr, &tracks, position);
+        bool monitoredOnly = true;
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            monitoredOnly = monitoredOnly && std::abs(block.left[i] - 2.0f * input[i]) < 1e-5f;
+        }
+        Check(monitoredOnly, "While stopped the monitored track still plays its input");
+    }
+    void TestCpuAccounting() {
+        std::cout << "\n--- Per-Track and Per-Effect CPU ---\n";
+
+        AudioEngine engine;
+        engine.Initialize(SAMPLE_RATE, BLOCK_SIZE, NUM_CHANNELS);
+        TrackManager tracks;
+        tracks.Initialize(&engine);
+        MediaItemManager items;
+        Track* heavy = tracks.CreateTrack("Heavy");
+        JSFXEffect* slow = AddEffect(heavy, SLOW_EFFECT);
+        JSFXEffect* heavyGain = AddEffect(heavy, GAIN_EFFECT);
+        Track* light = tracks.CreateTrack("Light");
+        JSFXEffect* lightGain = AddEffect(light, GAIN_EFFECT);
+        engine.PrepareForTracks(tracks.GetTrackCount());
+        Block block;
+
+        // Seven time constants of the average, timed against the wall clock
+        const int numBlocks = static_cast<int>(7 * CpuMeter::AVERAGE_SECONDS * SAMPLE_RATE / BLOCK_SIZE);
+        auto run = [&](int64_t& position) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < numBlocks; ++i, position += BLOCK_SIZE) {
+                engine.ProcessBlock(nullptr, block.outputs, NUM_CHANNELS, BLOCK_SIZE, &items, &tracks, position);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() / (numBlocks * BLOCK_SIZE / SAMPLE_RATE);
+        };
+
+        int64_t position = 0;
+        slow->SetParameter(0, 20);
+        const double wallLoad = run(position);
+
+        const TrackManager::TrackStats heavyStats = tracks.GetTrackStats(heavy);
+        const TrackManager::TrackStats lightStats = tracks.GetTrackStats(light);
+        std::cout << "  wall clock " << wallLoad * 100.0 << "%, heavy track " << heavyStats.cpuUsage
+                  << "% (slow FX " << slow->GetCpuUsage() << "%, gain FX " << heavyGain->GetCpuUsage()
+                  << "%), light track " << lightStats.cpuUsage << "%\n";
+
+        Check(heavyStats.cpuUsage > 0.5 * wallLoad * 100.0 && heavyStats.cpuUsage < 1.2 * wallLoad * 100.0,
+              "The heavy track's load matches the wall-clock time it takes");
+        Check(heavyStats.cpuUsage > 4.0 * lightStats.cpuUsage && lightStats.cpuUsage > 0.0,
+              "The heavy track is metered well above the light one");
+        Check(heavyStats.peakCpuUsage >= heavyStats.cpuUsage && heavyStats.activePlugins == 2,
+              "The peak holds at least the average and both plugins count as active");
+        Check(slow->GetCpuUsage() > 4.0 * heavyGain->GetCpuUsage() && heavyGain->GetCpuUsage() > 0.0,
+              "Within the track, the slow effect is metered above the cheap one");
+        Check(slow->GetCpuUsage() + heavyGain->GetCpuUsage() <= heavyStats.cpuUsage * 1.001,
+              "A track's effects never add up to more than the track");
+        Check(std::abs(tracks.GetTotalCpuUsage() - heavyStats.cpuUsage - lightStats.cpuUsage) < 1e-3 * heavyStats.cpuUsage,
+              "The total is the sum of the tracks");
+
+        std::vector<TrackManager::EffectStats> effects = tracks.GetEffectStats();
+        Check(effects.size() == 3 && effects[0].trackIndex == 0 && effects[0].effectIndex == 0 &&
+                  effects[0].cpuUsage >= effects[1].cpuUsage && effects[1].cpuUsage >= effects[2].cpuUsage,
+              "Effect stats list every effect, the slow one first");
+
+        // Bypassed, the slow effect's meter falls while the rest keep running
+        const double slowBefore = slow->GetCpuUsage();
+        slow->SetBypassed(true);
+        run(position);
+        Check(slow->GetCpuUsage() < 0.01 * slowBefore && lightGain->GetCpuUsage() > 0.0,
+              "A bypassed effect's meter decays to nothing");
+
+        // Stopped with nothing monitored, every track is idle and falls
+        for (int i = 0; i < numBlocks; ++i, position += BLOCK_SIZE) {
+            engine.ProcessBlock(nullptr, block.outputs, NUM_CHANNELS, BLOCK_SIZE, nullptr, &tracks, position);
+        }
+        Check(tracks.GetTrackStats(heavy).cpuUsage < 0.01 * heavyStats.cpuUsage &&
+                  tracks.GetTrackStats(light).cpuUsage < 0.01 * heavyStats.cpuUsage,
+              "Idle tracks' meters decay to nothing");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Audio Engine Test\n";
+    std::cout << "==============================\n";
+
+    AudioEngineTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
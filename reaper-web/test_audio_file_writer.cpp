@@ -0,0 +1,246 @@
+/*
+ * REAPER Web - Audio File Writer Test Application
+ * Verifies the WAV layout and sample conversion of recorded files and
+ * measures 64-channel write throughput per format
+ */
+
+#include "src/recording/audio_file_writer.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+/**
+ * Audio file writer test - writes known signals and reads the bytes back
+ */
+class AudioFileWriterTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Audio File Writer Test ===\n";
+
+        TestHeader();
+        TestOddDataPad();
+        TestConversion();
+        TestDither();
+        TestFlushedFrames();
+        BenchmarkThroughput();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr double kSampleRate = 48000.0;
+    const std::string m_path = "test_audio_file_writer.wav";
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static uint32_t ReadLE32(const unsigned char* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    static int32_t ReadSample(const unsigned char* p, int bytes) {
+        if (bytes == 2) return static_cast<int16_t>(p[0] | (p[1] << 8));
+        if (bytes == 3) return static_cast<int32_t>(ReadLE32(p) << 8 & 0xFFFFFF00u) >> 8;
+        return static_cast<int32_t>(ReadLE32(p));
+    }
+
+    std::vector<unsigned char> ReadFile() const {
+        std::ifstream file(m_path, std::ios::binary);
+        return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Writes numFrames of a per-channel sine in uneven blocks
+    void WriteSignal(AudioFileWriter& writer, int numChannels, int numFrames, float amplitude) {
+        std::vector<std::vector<float>> data(numChannels, std::vector<float>(numFrames));
+        std::vector<const float*> channels(numChannels);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            for (int i = 0; i < numFrames; ++i) {
+                data[ch][i] = amplitude * static_cast<float>(std::sin(0.01 * (ch + 1) * i));
+            }
+        }
+
+        for (int done = 0; done < numFrames;) {
+            int count = std::min(numFrames - done, 333 + done % 700);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                channels[ch] = data[ch].data() + done;
+            }
+            writer.Write(channels.data(), count);
+            done += count;
+        }
+    }
+
+    void TestHeader() {
+        AudioFileWriter writer;
+        writer.Open(m_path, kSampleRate, 3, AudioFileWriter::SampleFormat::PCM_24);
+        WriteSignal(writer, 3, 10000, 0.5f);
+        Check(writer.Close() && writer.GetFramesFlushed() == 10000, "Close() flushes every frame");
+
+        std::vector<unsigned char> bytes = ReadFile();
+        bool layout = bytes.size() == static_cast<size_t>(AudioFileWriter::DATA_OFFSET) + 10000 * 9 &&
+                      std::memcmp(bytes.data(), "RIFF", 4) == 0 && std::memcmp(bytes.data() + 12, "JUNK", 4) == 0 &&
+                      std::memcmp(bytes.data() + 48, "fmt ", 4) == 0 && std::memcmp(bytes.data() + 96, "data", 4) == 0;
+        Check(layout, "RIFF, JUNK (room for ds64), fmt and data in place");
+        Check(ReadLE32(bytes.data() + 4) == bytes.size() - 8 && ReadLE32(bytes.data() + 100) == 10000 * 9,
+              "Final RIFF and data sizes");
+        Check((bytes[56] | bytes[57] << 8) == 0xFFFE && (bytes[68] | bytes[69] << 8) == 9 &&
+              (bytes[70] | bytes[71] << 8) == 24 && (bytes[80] | bytes[81] << 8) == 1,
+              "Extensible PCM format, 24 bits, 9-byte frames");
+    }
+
+    void TestOddDataPad() {
+        AudioFileWriter writer;
+        writer.Open(m_path, kSampleRate, 1, AudioFileWriter::SampleFormat::PCM_24);
+        WriteSignal(writer, 1, 1001, 0.5f);
+        Check(writer.Close(), "Close() succeeds on an odd-sized data chunk");
+
+        // 1001 mono 24-bit frames are 3003 bytes; the chunk is padded to a word
+        // boundary, the data size is not, and the RIFF size counts the pad
+        std::vector<unsigned char> bytes = ReadFile();
+        Check(bytes.size() == static_cast<size_t>(AudioFileWriter::DATA_OFFSET) + 3003 + 1 && bytes.back() == 0,
+              "An odd data chunk is followed by a zero pad byte");
+        Check(ReadLE32(bytes.data() + 100) == 3003 && ReadLE32(bytes.data() + 4) == bytes.size() - 8,
+              "The data size excludes the pad and the RIFF size includes it");
+    }
+
+    void TestConversion() {
+        struct Case { AudioFileWriter::SampleFormat format; int bytes; double scale; const char* name; };
+        const Case cases[] = {
+            { AudioFileWriter::SampleFormat::PCM_16, 2, 32768.0, "16-bit" },
+            { AudioFileWriter::SampleFormat::PCM_24, 3, 8388608.0, "24-bit" },
+            { AudioFileWriter::SampleFormat::PCM_32, 4, 2147483648.0, "32-bit" },
+        };
+
+        for (const Case& c : cases) {
+            AudioFileWriter writer;
+            writer.Open(m_path, kSampleRate, 2, c.format);
+            WriteSignal(writer, 2, 5000, 0.9f);
+            writer.Close();
+
+            // Rounded to the nearest step (float input limits 32-bit accuracy)
+            std::vector<unsigned char> bytes = ReadFile();
+            const double tolerance = c.bytes == 4 ? 256.0 : 0.5;
+            double maxError = 0.0;
+            for (int i = 0; i < 5000; ++i) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    const unsigned char* p = bytes.data() + AudioFileWriter::DATA_OFFSET + (i * 2 + ch) * c.bytes;
+                    double expected = static_cast<double>(0.9f * static_cast<float>(std::sin(0.01 * (ch + 1) * i))) * c.scale;
+                    maxError = std::max(maxError, std::fabs(ReadSample(p, c.bytes) - expected));
+                }
+            }
+            Check(maxError <= tolerance, std::string(c.name) + " samples round to the nearest step");
+        }
+
+        // Full scale clips instead of wrapping
+        AudioFileWriter writer;
+        writer.Open(m_path, kSampleRate, 1, AudioFileWriter::SampleFormat::PCM_16);
+        const float loud[4] = { 1.0f, -1.0f, 2.0f, -2.0f };
+        const float* channels[1] = { loud };
+        writer.Write(channels, 4);
+        writer.Close();
+        std::vector<unsigned char> bytes = ReadFile();
+        const unsigned char* p = bytes.data() + AudioFileWriter::DATA_OFFSET;
+        Check(ReadSample(p, 2) == 32767 && ReadSample(p + 2, 2) == -32768 &&
+              ReadSample(p + 4, 2) == 32767 && ReadSample(p + 6, 2) == -32768, "Out-of-range samples clip");
+    }
+
+    void TestDither() {
+        AudioFileWriter writer;
+        writer.Open(m_path, kSampleRate, 1, AudioFileWriter::SampleFormat::PCM_16, true);
+        std::vector<float> quiet(48000, 0.25f / 32768.0f);
+        const float* channels[1] = { quiet.data() };
+        writer.Write(channels, 48000);
+        writer.Close();
+
+        // A quarter step becomes noise of at most one step either way whose mean is the input
+        std::vector<unsigned char> bytes = ReadFile();
+        double sum = 0.0;
+        int minValue = 0;
+        int maxValue = 0;
+        for (int i = 0; i < 48000; ++i) {
+            int value = ReadSample(bytes.data() + AudioFileWriter::DATA_OFFSET + i * 2, 2);
+            sum += value;
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
+        Check(minValue >= -1 && maxValue <= 1 && maxValue > minValue, "TPDF dither stays within one step");
+        Check(std::fabs(sum / 48000.0 - 0.25) < 0.02, "Dithered level averages to the input");
+    }
+
+    void TestFlushedFrames() {
+        // Frames only count as flushed once they are in the file
+        AudioFileWriter writer(64 * 1024);
+        writer.Open(m_path, kSampleRate, 2, AudioFileWriter::SampleFormat::FLOAT_32);
+        WriteSignal(writer, 2, 4000, 0.5f);
+        Check(writer.GetFramesWritten() == 4000 && writer.GetFramesFlushed() == 0, "Small writes stay staged");
+
+        WriteSignal(writer, 2, 40000, 0.5f);
+        const int64_t flushed = writer.GetFramesFlushed();
+        const int64_t fileBytes = static_cast<int64_t>(ReadFile().size());
+        Check(flushed > 0 && fileBytes % AudioFileWriter::WRITE_ALIGNMENT == 0 &&
+              fileBytes >= AudioFileWriter::DATA_OFFSET + flushed * 8,
+              "Full staging buffers reach the file ending on aligned offsets");
+        writer.Close();
+    }
+
+    void BenchmarkThroughput() {
+        // 64 tracks, 10 s each, in 512-frame blocks like the recording writer drains them
+        constexpr int kChannels = 64;
+        constexpr int kBlock = 512;
+        constexpr int kFrames = 48000 * 10;
+        std::vector<std::vector<float>> data(kChannels, std::vector<float>(kBlock));
+        std::vector<const float*> channels(kChannels);
+        for (int ch = 0; ch < kChannels; ++ch) {
+            for (int i = 0; i < kBlock; ++i) {
+                data[ch][i] = 0.5f * static_cast<float>(std::sin(0.01 * (ch + 1) * i));
+            }
+            channels[ch] = data[ch].data();
+        }
+
+        struct Case { AudioFileWriter::SampleFormat format; bool dither; const char* name; };
+        const Case cases[] = {
+            { AudioFileWriter::SampleFormat::FLOAT_32, false, "32-bit float" },
+            { AudioFileWriter::SampleFormat::PCM_24, false, "24-bit" },
+            { AudioFileWriter::SampleFormat::PCM_24, true, "24-bit dithered" },
+            { AudioFileWriter::SampleFormat::PCM_16, true, "16-bit dithered" },
+        };
+
+        std::cout << "\n64-channel throughput (10 s at 48 kHz):\n";
+        for (const Case& c : cases) {
+            AudioFileWriter writer;
+            writer.Open(m_path, kSampleRate, kChannels, c.format, c.dither);
+            auto start = std::chrono::steady_clock::now();
+            for (int done = 0; done < kFrames; done += kBlock) {
+                writer.Write(channels.data(), kBlock);
+            }
+            bool written = writer.Close();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double megabytes = static_cast<double>(kFrames) * kChannels * AudioFileWriter::GetBytesPerSample(c.format) / 1e6;
+            std::cout << "  " << std::setw(16) << std::left << c.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << megabytes / seconds << " MB/s  " << std::setw(6) << 10.0 / seconds << "x realtime\n";
+            Check(written && seconds < 10.0, std::string(c.name) + " keeps up with 64 live channels");
+        }
+
+        std::remove(m_path.c_str());
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Audio File Writer Test\n";
+    std::cout << "===================================\n";
+
+    AudioFileWriterTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
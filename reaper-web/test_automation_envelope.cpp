@@ -0,0 +1,201 @@
+/*
+ * REAPER Web - Automation Envelope Test Application
+ * Verifies block rendering against point lookups, flat-block skipping and cursor seeks
+ */
+
+#include "src/core/automation_envelope.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+/**
+ * Envelope test - renders blocks of awkward sizes and compares every sample
+ */
+class AutomationEnvelopeTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Automation Envelope Test ===\n";
+
+        TestShapes();
+        TestFlatBlocks();
+        TestSeeking();
+        TestThroughput();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr double kSampleRate = 48000.0;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static EnvelopePoint Point(double time, double value, EnvelopeShape shape = EnvelopeShape::LINEAR,
+                               double tension = 0.0) {
+        EnvelopePoint point;
+        point.time = time;
+        point.value = value;
+        point.shape = shape;
+        point.tension = tension;
+        return point;
+    }
+
+    static AutomationEnvelope MixedEnvelope() {
+        AutomationEnvelope envelope;
+        envelope.SetPoints({
+            Point(0.10, 0.0),
+            Point(0.35, 1.0, EnvelopeShape::BEZIER, 0.7),
+            Point(0.60, 0.2, EnvelopeShape::SQUARE),
+            Point(0.80, 0.9, EnvelopeShape::BEZIER, -0.5),
+            Point(1.00, 0.4),
+            Point(1.00, 0.6),
+            Point(1.25, 0.6)
+        });
+        return envelope;
+    }
+
+    // Renders [startSample, endSample) in blocks and returns the worst error against Evaluate()
+    static double RenderError(AutomationEnvelope& envelope, int64_t startSample, int64_t endSample,
+                              const std::vector<int>& blockSizes) {
+        std::vector<float> ramp(4096);
+        double worst = 0.0;
+        int64_t position = startSample;
+        size_t blockIndex = 0;
+
+        while (position < endSample) {
+            int numSamples = static_cast<int>(std::min<int64_t>(blockSizes[blockIndex++ % blockSizes.size()],
+                                                                endSample - position));
+            double time = position / kSampleRate;
+            double value = 0.0;
+            bool ramping = envelope.RenderBlock(time, kSampleRate, numSamples, ramp.data(), value);
+
+            for (int i = 0; i < numSamples; ++i) {
+                double expected = envelope.Evaluate((position + i) / kSampleRate);
+                double actual = ramping ? ramp[i] : value;
+                worst = std::max(worst, std::abs(expected - actual));
+            }
+            position += numSamples;
+        }
+        return worst;
+    }
+
+    void TestShapes() {
+        std::cout << "\n--- Linear / Bezier / Square ---\n";
+
+        AutomationEnvelope envelope = MixedEnvelope();
+        double error = RenderError(envelope, 0, static_cast<int64_t>(1.5 * kSampleRate), {512, 1, 97, 4096, 33});
+        Check(error < 1e-5, "Block rendering matches per-sample lookups (max error " + std::to_string(error) + ")");
+
+        Check(std::abs(envelope.Evaluate(0.05) - 0.0) < 1e-12, "Value before the first point holds");
+        Check(std::abs(envelope.Evaluate(0.225) - 0.5) < 1e-12, "Linear midpoint");
+        Check(envelope.Evaluate(0.475) < 0.6 - 0.1, "Positive bezier tension bows towards the target early");
+        Check(std::abs(envelope.Evaluate(0.79) - 0.2) < 1e-12, "Square segment holds until the next point");
+        Check(std::abs(envelope.Evaluate(1.0) - 0.6) < 1e-12, "Coincident points jump to the later value");
+        Check(std::abs(envelope.Evaluate(5.0) - 0.6) < 1e-12, "Value after the last point holds");
+    }
+
+    void TestFlatBlocks() {
+        std::cout << "\n--- Flat Block Skipping ---\n";
+
+        AutomationEnvelope envelope = MixedEnvelope();
+        std::vector<float> ramp(512, -1.0f);
+        double value = -1.0;
+
+        bool ramping = envelope.RenderBlock(0.0, kSampleRate, 512, ramp.data(), value);
+        Check(!ramping && value == 0.0 && ramp[0] == -1.0f, "Block before the first point is flat and untouched");
+
+        ramping = envelope.RenderBlock(0.65, kSampleRate, 512, ramp.data(), value);
+        Check(!ramping && std::abs(value - 0.2) < 1e-12, "Block inside a square segment is flat");
+
+        ramping = envelope.RenderBlock(1.05, kSampleRate, 512, ramp.data(), value);
+        Check(!ramping && std::abs(value - 0.6) < 1e-12, "Block inside an equal-valued segment is flat");
+
+        ramping = envelope.RenderBlock(2.0, kSampleRate, 512, ramp.data(), value);
+        Check(!ramping && std::abs(value - 0.6) < 1e-12, "Block after the last point is flat");
+
+        ramping = envelope.RenderBlock(0.2, kSampleRate, 512, ramp.data(), value);
+        Check(ramping && ramp[511] > ramp[0], "Block on a linear ramp renders per sample");
+
+        // A square step inside the block must land on the right sample
+        AutomationEnvelope step;
+        step.SetPoints({Point(0.0, 0.0, EnvelopeShape::SQUARE), Point(100.0 / kSampleRate, 1.0, EnvelopeShape::SQUARE)});
+        ramping = step.RenderBlock(0.0, kSampleRate, 256, ramp.data(), value);
+        Check(ramping && ramp[99] == 0.0f && ramp[100] == 1.0f, "Square step lands on its exact sample");
+    }
+
+    void TestSeeking() {
+        std::cout << "\n--- Cursor Seeks ---\n";
+
+        AutomationEnvelope envelope = MixedEnvelope();
+        std::vector<float> ramp(256);
+        double value = 0.0;
+
+        // Play forward, then jump back as a loop would, then forward past several points
+        double worst = RenderError(envelope, 0, 48000, {256});
+        worst = std::max(worst, RenderError(envelope, 4800, 9600, {256}));
+        worst = std::max(worst, RenderError(envelope, 50000, 70000, {256}));
+        worst = std::max(worst, RenderError(envelope, 10000, 12000, {256}));
+        Check(worst < 1e-5, "Backward and forward jumps resync the cursor");
+
+        envelope.AddPoint(Point(0.2, 0.9));
+        bool ramping = envelope.RenderBlock(0.2, kSampleRate, 256, ramp.data(), value);
+        Check(ramping && std::abs(ramp[0] - 0.9f) < 1e-6f, "Editing points resets the cursor");
+    }
+
+    void TestThroughput() {
+        std::cout << "\n--- Throughput (10000 points, 512-sample blocks, 60 s) ---\n";
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<double> valueDist(0.0, 1.0);
+        std::vector<EnvelopePoint> points;
+        for (int i = 0; i < 10000; ++i) {
+            EnvelopeShape shape = (i % 3 == 0) ? EnvelopeShape::BEZIER : EnvelopeShape::LINEAR;
+            points.push_back(Point(i * 0.006, valueDist(rng), shape, 0.3));
+        }
+        AutomationEnvelope envelope;
+        envelope.SetPoints(points);
+
+        const int blockSize = 512;
+        const int64_t totalSamples = static_cast<int64_t>(60.0 * kSampleRate);
+        std::vector<float> ramp(blockSize);
+        double value = 0.0;
+        double checksum = 0.0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int64_t position = 0; position < totalSamples; position += blockSize) {
+            if (envelope.RenderBlock(position / kSampleRate, kSampleRate, blockSize, ramp.data(), value)) {
+                checksum += ramp[blockSize - 1];
+            }
+        }
+        double cursorMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int64_t position = 0; position < totalSamples; ++position) {
+            checksum += envelope.Evaluate(position / kSampleRate);
+        }
+        double lookupMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Cursor blocks: " << cursorMs << " ms, per-sample lookups: " << lookupMs
+                  << " ms (checksum " << checksum << ")\n";
+        Check(cursorMs < lookupMs, "Cursor rendering beats a binary search per sample");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Automation Envelope Test\n";
+    std::cout << "=====================================\n";
+
+    AutomationEnvelopeTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
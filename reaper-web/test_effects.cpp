@@ -5,7 +5,7 @@
 
 #include "src/effects/reaper_effects.hpp"
 #include "src/effects/effect_chain.hpp"
-#include "src/audio/audio_buffer.hpp"
+#include "src/core/audio_buffer.hpp"
 #include <iostream>
 #include <memory>
 #include <cmath>
@@ -102,13 +102,14 @@ private:
         const int bufferSize = 512;
         const double frequency = 440.0; // A4
         
-        AudioBuffer testBuffer(2, bufferSize, sampleRate);
+        AudioBuffer testBuffer(2, bufferSize);
+        testBuffer.SetSampleRate(sampleRate);
         
         // Generate sine wave test signal
         for (int i = 0; i < bufferSize; ++i) {
             double sample = std::sin(2.0 * M_PI * frequency * i / sampleRate) * 0.5;
-            testBuffer.channels[0][i] = static_cast<float>(sample);
-            testBuffer.channels[1][i] = static_cast<float>(sample);
+            testBuffer.GetChannelData(0)[i] = static_cast<float>(sample);
+            testBuffer.GetChannelData(1)[i] = static_cast<float>(sample);
         }
         
         std::cout << "Generated 440Hz sine wave test signal\n";
@@ -144,7 +145,7 @@ private:
             // Check that audio was modified (simple peak check)
             float peak = 0.0f;
             for (int i = 0; i < bufferSize; ++i) {
-                peak = std::max(peak, std::abs(testBuffer.channels[0][i]));
+                peak = std::max(peak, std::abs(testBuffer.GetChannelData(0)[i]));
             }
             std::cout << "Processed audio peak level: " << peak << "\n";
         }
@@ -161,7 +162,7 @@ private:
         
         // Test automation updates at different time positions
         for (double time = 0.0; time <= 2.0; time += 0.5) {
-            chain->UpdateAutomation(time);
+            chain->UpdateAutomation(time, 512);
             std::cout << "Updated automation at time: " << time << "s\n";
         }
         
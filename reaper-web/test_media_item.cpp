@@ -0,0 +1,312 @@
+/*
+ * REAPER Web - Media Item Test Application
+ * Verifies that items start and end on the exact project sample their
+ * times round to, whatever the block size, that fades and crossfades
+ * follow their curves and sum to unity gain or power, and that comped
+ * takes switch lanes through centred equal-power crossfades
+ */
+
+#include "src/core/audio_buffer.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/media/media_item.hpp"
+#include "src/recording/audio_file_writer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Media item test - plays items over ramp sources, whose every sample is
+ * distinct, and compares the rendered timeline sample by sample
+ */
+class MediaItemTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Media Item Test ===\n";
+
+        TestSampleExactBoundaries();
+        TestFadeShapes();
+        TestCrossfadeSum();
+        TestCompCrossfades();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    static constexpr double SAMPLE_RATE = 48000.0;
+    static constexpr int SOURCE_FRAMES = 48000;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    // Exactly representable, non-zero and different at every frame
+    static float Ramp(int64_t frame) {
+        return static_cast<float>(frame + 1) / 65536.0f;
+    }
+
+    static float Unity(int64_t) {
+        return 1.0f;
+    }
+
+    // A mono float WAV at the project rate, decoded into the block cache up front
+    static std::shared_ptr<AudioSource> MakeSource(const std::string& name, float (*sample)(int64_t)) {
+        const std::string path = (std::filesystem::temp_directory_path() / name).string();
+        std::vector<float> data(SOURCE_FRAMES);
+        for (int i = 0; i < SOURCE_FRAMES; ++i) {
+            data[i] = sample(i);
+        }
+        const float* channels[1] = { data.data() };
+        AudioFileWriter writer;
+        writer.Open(path, SAMPLE_RATE, 1, AudioFileWriter::SampleFormat::FLOAT_32, false);
+        writer.Write(const_cast<float* const*>(channels), SOURCE_FRAMES);
+        writer.Close();
+        auto source = std::make_shared<AudioSource>(path);
+        source->Prefetch(0, SOURCE_FRAMES);
+        return source;
+    }
+
+    static MediaItem* AddItem(MediaItemManager& items, Track* track, std::shared_ptr<AudioSource> source,
+                              double position, double length, double sourceOffset) {
+        MediaItem* item = items.CreateEmptyItem(track, position, length);
+        item->AddTake(std::move(source), sourceOffset);
+        item->SetLength(length);
+        return item;
+    }
+
+    // Left channel of every item on the track mixed over [0, numFrames) in blocks of blockSize
+    static std::vector<float> Render(MediaItemManager& items, Track* track, int numFrames, int blockSize) {
+        items.PrepareForPlayback(SAMPLE_RATE, blockSize);
+        AudioBuffer buffer(2, blockSize);
+        buffer.SetSampleRate(SAMPLE_RATE);
+        std::vector<float> output;
+        output.reserve(numFrames);
+
+        for (int64_t start = 0; start < numFrames; start += blockSize) {
+            int count = static_cast<int>(std::min<int64_t>(blockSize, numFrames - start));
+            buffer.Clear();
+            for (MediaItem* item : items.GetItemsOnTrack(track)) {
+                item->ProcessAudio(buffer, start, count);
+            }
+            output.insert(output.end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + count);
+        }
+        return output;
+    }
+
+    void TestSampleExactBoundaries() {
+        std::cout << "\n--- Sample-Exact Item Edges ---\n";
+
+        TrackManager tracks;
+        tracks.Initialize(nullptr);
+        Track* track = tracks.CreateTrack("Items");
+        MediaItemManager items;
+        std::shared_ptr<AudioSource> source = MakeSource("reaper_test_media_item_ramp.wav", Ramp);
+
+        // Two butted items whose edges fall between samples; the second
+        // continues the source where the first stops
+        const double start = 1000.4 / SAMPLE_RATE;
+        const double split = 5000.6 / SAMPLE_RATE;
+        const double end = 9000.3 / SAMPLE_RATE;
+        MediaItem* first = AddItem(items, track, source, start, split - start, 0.0);
+        MediaItem* second = AddItem(items, track, source, split, end - split, 4001.0 / SAMPLE_RATE);
+
+        Check(first->GetStartSample(SAMPLE_RATE) == 1000 && first->GetEndSample(SAMPLE_RATE) == 5001 &&
+                  second->GetStartSample(SAMPLE_RATE) == 5001 && second->GetEndSample(SAMPLE_RATE) == 9000,
+              "Item edges round to the nearest project sample");
+
+        // Expected timeline: silence, then the ramp from frame 0 without a gap or a repeat
+        const int numFrames = 10240;
+        std::vector<float> expected(numFrames, 0.0f);
+        for (int n = 1000; n < 9000; ++n) {
+            expected[n] = Ramp(n - 1000);
+        }
+
+        for (int blockSize : { 64, 100, 37, 4096 }) {
+            std::vector<float> output = Render(items, track, numFrames, blockSize);
+            int mismatch = -1;
+            for (int n = 0; n < numFrames && mismatch < 0; ++n) {
+                if (output[n] != expected[n]) mismatch = n;
+            }
+            Check(mismatch < 0, "Blocks of " + std::to_string(blockSize) +
+                  ": every sample from the first to the last of both items is exact" +
+                  (mismatch < 0 ? std::string() : " (first difference at " + std::to_string(mismatch) + ")"));
+        }
+
+        // A seek into the middle of an item starts on the matching source frame
+        items.PrepareForPlayback(SAMPLE_RATE, 256);
+        AudioBuffer buffer(2, 256);
+        buffer.SetSampleRate(SAMPLE_RATE);
+        buffer.Clear();
+        first->ProcessAudio(buffer, 3333, 256);
+        second->ProcessAudio(buffer, 3333, 256);
+        Check(buffer.GetChannelData(0)[0] == Ramp(2333) && buffer.GetChannelData(1)[255] == Ramp(2588),
+              "A block after a seek reads the source frame its project sample maps to");
+
+        // The seconds entry point lands on the same samples
+        buffer.Clear();
+        first->ProcessAudio(buffer, 990.0 / SAMPLE_RATE, 256.0 / SAMPLE_RATE);
+        Check(buffer.GetChannelData(0)[9] == 0.0f && buffer.GetChannelData(0)[10] == Ramp(0),
+              "The seconds overload starts the item on the same sample");
+    }
+    void TestFadeShapes() {
+        std::cout << "\n--- Fade Shapes ---\n";
+
+        TrackManager tracks;
+        tracks.Initialize(nullptr);
+        Track* track = tracks.CreateTrack("Fades");
+        MediaItemManager items;
+        MediaItem* item = AddItem(items, track, MakeSource("reaper_test_media_item_unity.wav", Unity), 0.0, 0.5, 0.0);
+
+        // Over a unity source the output is the fade gain itself; the baked
+        // table is interpolated, so it follows the curve to within 1e-4
+        struct Shape { MediaItem::FadeType type; const char* name; };
+        const Shape shapes[] = {
+            { MediaItem::FadeType::LINEAR, "Linear" },
+            { MediaItem::FadeType::LOGARITHMIC, "Logarithmic" },
+            { MediaItem::FadeType::EXPONENTIAL, "Exponential" },
+            { MediaItem::FadeType::EQUAL_POWER, "Equal power" },
+            { MediaItem::FadeType::FAST_START, "Fast start" },
+            { MediaItem::FadeType::FAST_END, "Fast end" },
+            { MediaItem::FadeType::SLOW_START_END, "Slow start/end" },
+        };
+        const int fadeFrames = 1000;
+        const int itemFrames = 24000;
+
+        for (const Shape& shape : shapes) {
+            // Changing only the type rebuilds the table for the next block
+            item->SetFadeIn(fadeFrames / SAMPLE_RATE, shape.type);
+            item->SetFadeOut(fadeFrames / SAMPLE_RATE, shape.type);
+            std::vector<float> output = Render(items, track, itemFrames, 128);
+
+            double inError = 0.0;
+            double outError = 0.0;
+            for (int i = 0; i < fadeFrames; ++i) {
+                double curve = MediaItem::ApplyFadeCurve(static_cast<double>(i) / fadeFrames, shape.type);
+                inError = std::max(inError, std::abs(output[i] - curve));
+                outError = std::max(outError, std::abs(output[itemFrames - fadeFrames + i] - (1.0 - curve)));
+            }
+            bool body = std::all_of(output.begin() + fadeFrames, output.end() - fadeFrames,
+                                    [](float gain) { return gain == 1.0f; });
+            Check(inError < 1e-4 && outError < 1e-4 && body && output[0] == 0.0f,
+                  std::string(shape.name) + ": fade-in follows the curve, fade-out its complement, unity between");
+        }
+    }
+
+    void TestCrossfadeSum() {
+        std::cout << "\n--- Crossfades ---\n";
+
+        TrackManager tracks;
+        tracks.Initialize(nullptr);
+        Track* outgoing = tracks.CreateTrack("Outgoing");
+        Track* incoming = tracks.CreateTrack("Incoming");
+        MediaItemManager items;
+        std::shared_ptr<AudioSource> source = MakeSource("reaper_test_media_item_unity.wav", Unity);
+
+        // The second item starts where the first one's last 2400 samples begin
+        const int overlapStart = 21600;
+        const int overlapFrames = 2400;
+        MediaItem* first = AddItem(items, outgoing, source, 0.0, 0.5, 0.0);
+        MediaItem* second = AddItem(items, incoming, source, overlapStart / SAMPLE_RATE, 0.25, 0.0);
+
+        struct Case { MediaItem::FadeType type; int power; const char* name; };
+        const Case cases[] = {
+            { MediaItem::FadeType::LINEAR, 1, "Linear crossfade sums to unity gain" },
+            { MediaItem::FadeType::EQUAL_POWER, 2, "Equal-power crossfade sums to unity power" },
+        };
+
+        for (const Case& c : cases) {
+            MediaItem::Crossfade crossfade;
+            crossfade.length = overlapFrames / SAMPLE_RATE;
+            crossfade.type = c.type;
+            crossfade.enabled = true;
+            first->SetCrossfadeOut(crossfade);
+            second->SetCrossfadeIn(crossfade);
+
+            const int numFrames = overlapStart + overlapFrames;
+            std::vector<float> out = Render(items, outgoing, numFrames, 256);
+            std::vector<float> in = Render(items, incoming, numFrames, 256);
+
+            double maxError = 0.0;
+            for (int i = overlapStart; i < numFrames; ++i) {
+                maxError = std::max(maxError, std::abs(std::pow(out[i], c.power) + std::pow(in[i], c.power) - 1.0));
+            }
+            std::cout << "  " << c.name << ": worst error " << maxError << "\n";
+            Check(maxError < 1e-4 && out[overlapStart] == 1.0f && in[overlapStart] == 0.0f &&
+                      out[overlapStart - 1] == 1.0f && in[overlapStart - 1] == 0.0f,
+                  c.name);
+        }
+    }
+    void TestCompCrossfades() {
+        std::cout << "\n--- Comp Region Crossfades ---\n";
+
+        TrackManager tracks;
+        tracks.Initialize(nullptr);
+        Track* track = tracks.CreateTrack("Comp");
+        MediaItemManager items;
+        std::shared_ptr<AudioSource> source = MakeSource("reaper_test_media_item_ramp.wav", Ramp);
+
+        // Two lanes on one recording, the second half a second further in at half volume
+        const int itemFrames = 19200;
+        const int laneOffset = 24000;
+        MediaItem* item = AddItem(items, track, source, 0.0, itemFrames / SAMPLE_RATE, 0.0);
+        item->AddTake(source, laneOffset / SAMPLE_RATE);
+        item->GetTake(1)->volume = 0.5;
+        Check(item->GetTake(0)->source == item->GetTake(1)->source, "Both lanes read one shared source");
+
+        Check(item->SwipeComp(1, 4800 / SAMPLE_RATE, 9600 / SAMPLE_RATE) && item->GetCompRegions().size() == 3 &&
+                  item->GetCompTakeAt(0.15) == 1 && item->GetCompTakeAt(0.3) == 0,
+              "A swipe over the middle selects the second lane there");
+
+        // 10 ms crossfades centred on 4800 and 9600: how far each sample has moved to the second lane
+        const int crossfade = 480;
+        auto toSecond = [crossfade](int n) {
+            if (n < 4800 - crossfade / 2) return 0.0;
+            if (n < 4800 + crossfade / 2) return static_cast<double>(n - (4800 - crossfade / 2)) / crossfade;
+            if (n < 9600 - crossfade / 2) return 1.0;
+            if (n < 9600 + crossfade / 2) return 1.0 - static_cast<double>(n - (9600 - crossfade / 2)) / crossfade;
+            return 0.0;
+        };
+        std::vector<double> expected(itemFrames);
+        for (int n = 0; n < itemFrames; ++n) {
+            expected[n] = Ramp(n) * std::sin((1.0 - toSecond(n)) * M_PI * 0.5) +
+                          0.5 * Ramp(n + laneOffset) * std::sin(toSecond(n) * M_PI * 0.5);
+        }
+
+        for (int blockSize : { 64, 333 }) {
+            std::vector<float> output = Render(items, track, itemFrames, blockSize);
+            double maxError = 0.0;
+            for (int n = 0; n < itemFrames; ++n) {
+                maxError = std::max(maxError, std::abs(output[n] - expected[n]));
+            }
+            bool exactOutside = output[4559] == Ramp(4559) && output[5040] == 0.5f * Ramp(5040 + laneOffset) &&
+                                output[9359] == 0.5f * Ramp(9359 + laneOffset) && output[9840] == Ramp(9840);
+            Check(maxError < 1e-5 && exactOutside, "Blocks of " + std::to_string(blockSize) +
+                  ": each lane plays alone outside the crossfades and equal-power crossfades join them");
+        }
+
+        // Without a crossfade the lanes switch on the boundary sample
+        item->SetCompCrossfadeLength(0.0);
+        std::vector<float> output = Render(items, track, itemFrames, 128);
+        Check(output[4799] == Ramp(4799) && output[4800] == 0.5f * Ramp(4800 + laneOffset) &&
+                  output[9599] == 0.5f * Ramp(9599 + laneOffset) && output[9600] == Ramp(9600),
+              "A zero crossfade switches lanes exactly on the boundary");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Media Item Test\n";
+    std::cout << "============================\n";
+
+    MediaItemTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+/*
+ * REAPER Web - Metronome Test Application
+ * Verifies click placement against the tempo map, block independence and count-in length
+ */
+
+#include "src/core/metronome.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+/**
+ * Metronome test - renders clicks in blocks and finds their onsets
+ */
+class MetronomeTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Metronome Test ===\n";
+
+        TestConstantTempo();
+        TestBlockSizes();
+        TestTempoChanges();
+        TestCountIn();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr double kSampleRate = 48000.0;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    // Renders totalSamples of playback in blocks of the given sizes; returns the left channel
+    static std::vector<float> RenderPlayback(Metronome& metronome, const TempoMap& map, int totalSamples,
+                                             const std::vector<int>& blockSizes) {
+        std::vector<float> left(totalSamples, 0.0f);
+        std::vector<float> right(totalSamples, 0.0f);
+        int position = 0;
+        size_t blockIndex = 0;
+
+        while (position < totalSamples) {
+            int numSamples = std::min(blockSizes[blockIndex++ % blockSizes.size()], totalSamples - position);
+            float* outputs[2] = { left.data() + position, right.data() + position };
+            metronome.Render(&map, position, numSamples, outputs, 2);
+            position += numSamples;
+        }
+        return left;
+    }
+
+    // Click onsets: the first sample after silence (the attack starts from exactly 0)
+    static std::vector<int> FindOnsets(const std::vector<float>& signal, int clickLength) {
+        std::vector<int> onsets;
+        for (int i = 1; i < static_cast<int>(signal.size()); ++i) {
+            if (signal[i] != 0.0f && (onsets.empty() || i - onsets.back() >= clickLength)) {
+                onsets.push_back(i - 1);
+            }
+        }
+        return onsets;
+    }
+
+    void TestConstantTempo() {
+        std::cout << "\n--- 120 BPM 4/4 ---\n";
+
+        Metronome metronome;
+        metronome.Prepare(kSampleRate);
+        TempoMap map(120.0, 4, 4);
+
+        std::vector<float> left = RenderPlayback(metronome, map, 48000 * 4, {512});
+        std::vector<int> onsets = FindOnsets(left, metronome.GetClickLength());
+
+        bool exact = onsets.size() == 8;
+        for (size_t i = 0; i < onsets.size() && exact; ++i) {
+            exact = onsets[i] == static_cast<int>(i) * 24000;
+        }
+        Check(exact, "A click every 24000 samples, starting on sample 0");
+
+        float accentPeak = 0.0f;
+        float beatPeak = 0.0f;
+        for (int i = 0; i < 2000; ++i) {
+            accentPeak = std::max(accentPeak, std::abs(left[i]));
+            beatPeak = std::max(beatPeak, std::abs(left[24000 + i]));
+        }
+        Check(accentPeak > beatPeak, "First beat of the bar is accented");
+    }
+
+    void TestBlockSizes() {
+        std::cout << "\n--- Block independence ---\n";
+
+        TempoMap map(133.0, 4, 4);
+        Metronome a;
+        Metronome b;
+        a.Prepare(kSampleRate);
+        b.Prepare(kSampleRate);
+
+        std::vector<float> reference = RenderPlayback(a, map, 48000 * 3, {48000 * 3});
+        std::vector<float> blocked = RenderPlayback(b, map, 48000 * 3, {512, 1, 97, 2048, 33});
+        Check(reference == blocked, "Odd block sizes render the same samples, tails carried across blocks");
+    }
+
+    void TestTempoChanges() {
+        std::cout << "\n--- Ramps and 7/8 ---\n";
+
+        // 4/4 for one bar at 120, then 7/8 ramping to 180 over 4 s
+        TempoMarker first;
+        first.bpm = 120.0;
+        TempoMarker second;
+        second.time = 2.0;
+        second.bpm = 120.0;
+        second.timeSigNumerator = 7;
+        second.timeSigDenominator = 8;
+        second.ramp = true;
+        TempoMarker third;
+        third.time = 6.0;
+        third.bpm = 180.0;
+        TempoMap map({first, second, third});
+
+        Metronome metronome;
+        metronome.Prepare(kSampleRate);
+        std::vector<float> left = RenderPlayback(metronome, map, 48000 * 6, {480});
+        std::vector<int> onsets = FindOnsets(left, metronome.GetClickLength());
+
+        bool exact = onsets.size() > 10;
+        for (size_t i = 0; i < onsets.size() && exact; ++i) {
+            // Beats 0-3 are quarters, then eighths
+            double beats = i < 4 ? i : 4.0 + (i - 4) * 0.5;
+            int expected = static_cast<int>(std::llround(map.BeatsToTime(beats) * kSampleRate));
+            exact = onsets[i] == expected;
+        }
+        Check(exact, "Clicks land on the sample the tempo map puts each beat on");
+        // An eighth at 120 is 12000 samples; the ramp is already speeding up
+        Check(onsets.size() > 5 && onsets[5] - onsets[4] < 12000 && onsets[5] - onsets[4] > 11500,
+              "7/8 clicks eighth notes");
+    }
+
+    void TestCountIn() {
+        std::cout << "\n--- Count-in ---\n";
+
+        Metronome metronome;
+        metronome.Prepare(kSampleRate);
+        metronome.StartCountIn(TempoMap(120.0, 3, 4), 0.0, 2);
+
+        // Two bars of 3/4 at 120 is 3 s; rendered in 1000-sample blocks
+        std::vector<float> left(48000 * 4, 0.0f);
+        std::vector<float> right(48000 * 4, 0.0f);
+        int total = 0;
+        int lastUsed = 0;
+        while (metronome.IsCountingIn()) {
+            float* outputs[2] = { left.data() + total, right.data() + total };
+            lastUsed = metronome.RenderCountIn(outputs, 2, 1000);
+            total += lastUsed;
+        }
+        Check(total == 144000 && lastUsed == 1000, "Count-in lasts exactly two bars");
+
+        std::vector<int> onsets = FindOnsets(left, metronome.GetClickLength());
+        Check(onsets.size() == 6 && onsets[3] == 72000, "Three clicks a bar, the second bar starting at 1.5 s");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Metronome Test\n";
+    std::cout << "===========================\n";
+
+    MetronomeTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
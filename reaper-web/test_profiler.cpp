@@ -0,0 +1,152 @@
+/*
+ * REAPER Web - Profiler Test Application
+ * Verifies trace export from several threads, event accounting under
+ * overflow and the cost of a scope while profiling is off
+ */
+
+#include "src/core/profiler.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scope cost is only asserted where timing means something: optimized and
+// without sanitizer instrumentation, which alone adds tens of nanoseconds
+#if defined(NDEBUG) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define PROFILER_TEST_TIMED 1
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#undef PROFILER_TEST_TIMED
+#endif
+#endif
+#endif
+
+/**
+ * Profiler test - records scopes, then reads the trace file back
+ */
+class ProfilerTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Profiler Test ===\n";
+
+        TestDisabledCost();
+        TestCapture();
+        TestOverflow();
+
+        std::remove(m_path.c_str());
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    const std::string m_path = "test_profiler_trace.json";
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    std::string ReadTrace() const {
+        std::ifstream file(m_path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static int CountOccurrences(const std::string& text, const std::string& pattern) {
+        int count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    void TestDisabledCost() {
+        Profiler& profiler = Profiler::GetInstance();
+        constexpr int kScopes = 10000000;
+        volatile int sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kScopes; ++i) {
+            ProfileScope scope(Profiler::Category::EFFECT, "Disabled", i);
+            sink = sink + 1;
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kScopes;
+
+        std::cout << "  Disabled scope: " << ns << " ns\n";
+#if defined(PROFILER_TEST_TIMED)
+        // Loose enough for a loaded CI machine; a lock or allocation per scope still fails it
+        Check(ns < 1000.0, "A scope costs next to nothing while profiling is off");
+#endif
+        Check(profiler.GetExportedEvents() == 0 && profiler.GetDroppedEvents() == 0, "Nothing is recorded while off");
+    }
+
+    void TestCapture() {
+        Profiler& profiler = Profiler::GetInstance();
+        Check(profiler.StartCapture(m_path), "Capture starts");
+        Check(!profiler.StartCapture(m_path), "A second capture is refused while one runs");
+
+        // Three threads of nested block/track/effect scopes, like the audio path
+        constexpr int kBlocks = 200;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([] {
+                for (int block = 0; block < kBlocks; ++block) {
+                    ProfileScope blockScope(Profiler::Category::BLOCK, "Audio block");
+                    for (int track = 0; track < 4; ++track) {
+                        ProfileScope trackScope(Profiler::Category::TRACK, "Track \"Gtr\"", track);
+                        ProfileScope effectScope(Profiler::Category::EFFECT, "A very long effect name that does not fit", 0);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        Check(profiler.StopCapture(), "Capture stops and the trace is written");
+        const std::string trace = ReadTrace();
+        const int expected = 3 * kBlocks * (1 + 4 * 2);
+        Check(CountOccurrences(trace, "\"ph\":\"X\"") == expected &&
+              profiler.GetExportedEvents() == static_cast<uint64_t>(expected), "Every scope becomes one complete event");
+        Check(CountOccurrences(trace, "\"ph\":\"M\"") >= 3, "Each recording thread is named");
+        Check(trace.find("Track \\\"Gtr\\\"") != std::string::npos, "Names are JSON-escaped");
+        Check(trace.find("A very long effect name that does not f\"") != std::string::npos, "Long names are cut");
+        Check(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 &&
+              trace.compare(trace.size() - 3, 3, "]}\n") == 0, "Trace is a closed JSON object");
+    }
+
+    void TestOverflow() {
+        // A burst far larger than one ring: every event is either exported or counted
+        Profiler& profiler = Profiler::GetInstance();
+        profiler.StartCapture(m_path);
+        constexpr int kEvents = Profiler::RING_EVENTS * 8;
+        std::thread producer([] {
+            for (int i = 0; i < kEvents; ++i) {
+                ProfileScope scope(Profiler::Category::MIX, "Mix", i);
+            }
+        });
+        producer.join();
+        profiler.StopCapture();
+
+        const std::string trace = ReadTrace();
+        Check(profiler.GetExportedEvents() + profiler.GetDroppedEvents() == static_cast<uint64_t>(kEvents) &&
+              CountOccurrences(trace, "\"ph\":\"X\"") == static_cast<int>(profiler.GetExportedEvents()),
+              "Overflowing events are dropped and counted, never torn");
+        std::cout << "  Burst of " << kEvents << ": " << profiler.GetDroppedEvents() << " dropped\n";
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Profiler Test\n";
+    std::cout << "==========================\n";
+
+    ProfilerTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
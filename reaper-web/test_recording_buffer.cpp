@@ -0,0 +1,212 @@
+/*
+ * REAPER Web - Recording Buffer Test Application
+ * Verifies ring wrapping, overrun/underrun accounting and a producer at
+ * audio-callback cadence against a slow consumer
+ */
+
+#include "src/recording/recording_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Recording buffer test - every frame carries its own index so loss,
+ * duplication and reordering all show up as a broken sequence
+ */
+class RecordingBufferTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Recording Buffer Test ===\n";
+
+        TestCapacity();
+        TestWrapping();
+        TestOverrunAndUnderrun();
+        TestCallbackCadence();
+        TestStalledConsumer();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 128;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    // Writes frames [first, first + numFrames) as their own index; the right channel is negated
+    static bool WriteSequence(RecordingBuffer& ring, std::vector<float>& left, std::vector<float>& right,
+                              int64_t first, int numFrames) {
+        for (int i = 0; i < numFrames; ++i) {
+            left[i] = static_cast<float>(first + i);
+            right[i] = -static_cast<float>(first + i);
+        }
+        const float* channels[2] = { left.data(), right.data() };
+        return ring.Write(channels, numFrames);
+    }
+
+    void TestCapacity() {
+        RecordingBuffer ring;
+        ring.Allocate(2, 1000);
+        Check(ring.GetCapacity() == 1024 && ring.GetWriteSpace() == 1024, "Capacity rounds up to a power of two");
+
+        ring.Allocate(1, 4096);
+        Check(ring.GetCapacity() == 4096, "A power of two is kept as is");
+    }
+
+    void TestWrapping() {
+        RecordingBuffer ring;
+        ring.Allocate(2, 256);
+
+        // Odd sizes so writes and reads straddle the wrap point at every offset
+        std::vector<float> left(256), right(256), outLeft(256), outRight(256);
+        float* out[2] = { outLeft.data(), outRight.data() };
+        int64_t written = 0;
+        int64_t expected = 0;
+        bool ordered = true;
+        for (int pass = 0; pass < 2000; ++pass) {
+            int count = 1 + (pass * 37) % 97;
+            if (WriteSequence(ring, left, right, written, count)) {
+                written += count;
+            }
+
+            int got = ring.Read(out, count + pass % 7 - 2);
+            for (int i = 0; i < got; ++i, ++expected) {
+                ordered = ordered && outLeft[i] == expected && outRight[i] == -expected;
+            }
+        }
+        while (int got = ring.Read(out, 256)) {
+            for (int i = 0; i < got; ++i, ++expected) {
+                ordered = ordered && outLeft[i] == expected && outRight[i] == -expected;
+            }
+        }
+
+        Check(ordered && expected == written, "Frames come out whole and in order across wraps");
+        Check(ring.GetOverruns() == 0, "No overruns while the reader keeps up");
+    }
+
+    void TestOverrunAndUnderrun() {
+        RecordingBuffer ring;
+        ring.Allocate(2, 256);
+        std::vector<float> left(256), right(256), outLeft(256), outRight(256);
+        float* out[2] = { outLeft.data(), outRight.data() };
+
+        Check(ring.Read(out, 64) == 0 && ring.GetUnderruns() == 1, "Reading an empty ring counts an underrun");
+
+        WriteSequence(ring, left, right, 0, 200);
+        bool accepted = WriteSequence(ring, left, right, 200, 100);
+        Check(!accepted && ring.GetOverruns() == 1 && ring.GetOverrunFrames() == 100,
+              "A write that does not fit is refused whole and counted");
+        Check(ring.GetReadAvailable() == 200, "A refused write leaves the ring untouched");
+
+        const float* silence[2] = { nullptr, nullptr };
+        ring.Write(silence, 56);
+        ring.Read(out, 200);
+        int got = ring.Read(out, 256);
+        bool silent = got == 56;
+        for (int i = 0; i < got; ++i) {
+            silent = silent && outLeft[i] == 0.0f && outRight[i] == 0.0f;
+        }
+        Check(silent, "Null channels write silence");
+    }
+
+    // Producer thread at callback cadence; the consumer sleeps between reads
+    // the way the recording writer does. Returns the frames produced.
+    int64_t RunProducerConsumer(RecordingBuffer& ring, int numBlocks, int consumerSleepMs, int stallMs,
+                                int64_t& framesRead, bool& ordered, int64_t& gaps) {
+        std::atomic<bool> producing{true};
+        int64_t produced = 0;
+
+        std::thread producer([&] {
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            auto period = std::chrono::duration<double>(kBlockSize / kSampleRate);
+            auto next = std::chrono::steady_clock::now();
+            for (int block = 0; block < numBlocks; ++block) {
+                WriteSequence(ring, left, right, produced, kBlockSize);
+                produced += kBlockSize;
+                next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+                std::this_thread::sleep_until(next);
+            }
+            producing = false;
+        });
+
+        std::vector<float> outLeft(4096), outRight(4096);
+        float* out[2] = { outLeft.data(), outRight.data() };
+        int64_t expected = 0;
+        framesRead = 0;
+        ordered = true;
+        gaps = 0;
+        bool stalled = false;
+        while (producing.load() || ring.GetReadAvailable() > 0) {
+            if (!stalled && stallMs > 0 && framesRead > kSampleRate / 4) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(stallMs));
+                stalled = true;
+            }
+
+            int got = ring.Read(out, 4096);
+            for (int i = 0; i < got; ++i) {
+                // A dropped block skips ahead by whole blocks and never goes back
+                int64_t value = static_cast<int64_t>(outLeft[i]);
+                if (value != expected) {
+                    ordered = ordered && value > expected && (value - expected) % kBlockSize == 0;
+                    gaps += value - expected;
+                }
+                ordered = ordered && outRight[i] == -outLeft[i];
+                expected = value + 1;
+            }
+            framesRead += got;
+            std::this_thread::sleep_for(std::chrono::milliseconds(consumerSleepMs));
+        }
+
+        producer.join();
+        return produced;
+    }
+
+    void TestCallbackCadence() {
+        // Half a second of ring against a writer that wakes every 20 ms
+        RecordingBuffer ring;
+        ring.Allocate(2, static_cast<int>(kSampleRate / 2));
+
+        int64_t framesRead = 0;
+        int64_t gaps = 0;
+        bool ordered = false;
+        int64_t produced = RunProducerConsumer(ring, 375, 20, 0, framesRead, ordered, gaps);
+
+        Check(ordered && gaps == 0 && framesRead == produced, "Slow consumer receives every frame in order");
+        Check(ring.GetOverruns() == 0, "No overruns while the ring absorbs the consumer's latency");
+    }
+
+    void TestStalledConsumer() {
+        // A stall longer than the ring forces overruns, which must all be accounted for
+        RecordingBuffer ring;
+        ring.Allocate(2, 4096);
+
+        int64_t framesRead = 0;
+        int64_t gaps = 0;
+        bool ordered = false;
+        int64_t produced = RunProducerConsumer(ring, 375, 2, 300, framesRead, ordered, gaps);
+
+        Check(ring.GetOverruns() > 0, "A stalled consumer causes overruns");
+        Check(ordered, "Frames that do arrive are whole blocks, in order");
+        Check(framesRead + static_cast<int64_t>(ring.GetOverrunFrames()) == produced &&
+              gaps == static_cast<int64_t>(ring.GetOverrunFrames()),
+              "Every frame is either delivered or counted as an overrun");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Recording Buffer Test\n";
+    std::cout << "==================================\n";
+
+    RecordingBufferTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
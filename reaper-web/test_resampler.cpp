@@ -0,0 +1,467 @@
+/*
+ * REAPER Web - Sample Rate Converter Test Application
+ * Verifies streaming continuity, aliasing rejection and throughput per quality tier,
+ * that sources read by many takes at once resample without allocating, and that
+ * live input from a device at another rate reaches the project rate intact
+ */
+
+#include "src/core/audio_buffer.hpp"
+#include "src/core/reaper_engine.hpp"
+#include "src/core/sample_rate_converter.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/media/media_item.hpp"
+#include "src/recording/audio_file_writer.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <vector>
+#include <complex>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// Counts heap allocations so the audio-thread reads can be checked for none
+static std::atomic<long> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+// std::stable_sort takes its scratch through this one and frees it with plain delete
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+/**
+ * Resampler test - measures each quality tier with an in-test FFT
+ */
+class ResamplerTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Resampler Test ===\n";
+
+        TestStreamingContinuity();
+        TestPassbandAndAliasing();
+        TestSourceReaders();
+        TestDeviceInput();
+        TestThroughput();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    static const char* QualityName(SampleRateConverter::Quality quality) {
+        switch (quality) {
+            case SampleRateConverter::Quality::DRAFT: return "Draft";
+            case SampleRateConverter::Quality::STANDARD: return "Standard";
+            case SampleRateConverter::Quality::HIGH: return "High";
+            case SampleRateConverter::Quality::MASTERING: return "Mastering";
+        }
+        return "Unknown";
+    }
+
+    static std::vector<SampleRateConverter::Quality> AllQualities() {
+        return {
+            SampleRateConverter::Quality::DRAFT,
+            SampleRateConverter::Quality::STANDARD,
+            SampleRateConverter::Quality::HIGH,
+            SampleRateConverter::Quality::MASTERING
+        };
+    }
+
+    // Stopband rejection just above the new Nyquist, a few dB under what each tier
+    // measures (-24, -49, -53, -111 dB) so a weaker filter design fails
+    static double AliasLimitDB(SampleRateConverter::Quality quality) {
+        switch (quality) {
+            case SampleRateConverter::Quality::DRAFT: return -22.0;
+            case SampleRateConverter::Quality::STANDARD: return -46.0;
+            case SampleRateConverter::Quality::HIGH: return -50.0;
+            case SampleRateConverter::Quality::MASTERING: return -107.0;
+        }
+        return 0.0;
+    }
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static std::vector<float> GenerateSine(double frequency, double sampleRate, int numSamples, double amplitude = 0.5) {
+        std::vector<float> signal(numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            signal[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / sampleRate));
+        }
+        return signal;
+    }
+
+    // Convert a mono signal in fixed-size blocks, as the audio thread would
+    static std::vector<float> ConvertInBlocks(SampleRateConverter& converter, const std::vector<float>& input,
+                                              const std::vector<int>& blockSizes) {
+        std::vector<float> output;
+        std::vector<float> block(16384);
+        size_t position = 0;
+        size_t blockIndex = 0;
+
+        while (position < input.size()) {
+            int frames = std::min<int>(blockSizes[blockIndex++ % blockSizes.size()],
+                                       static_cast<int>(input.size() - position));
+            const float* in[1] = { input.data() + position };
+            float* out[1] = { block.data() };
+
+            int produced = converter.Process(in, frames, out, static_cast<int>(block.size()));
+            output.insert(output.end(), block.begin(), block.begin() + produced);
+            position += frames;
+        }
+
+        return output;
+    }
+
+    // Radix-2 FFT magnitude spectrum with a Blackman-Harris window
+    static std::vector<double> MagnitudeSpectrum(const float* data, int size) {
+        std::vector<std::complex<double>> bins(size);
+        double windowSum = 0.0;
+
+        for (int i = 0; i < size; ++i) {
+            double x = 2.0 * M_PI * i / (size - 1);
+            double w = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+            bins[i] = data[i] * w;
+            windowSum += w;
+        }
+
+        for (int i = 1, j = 0; i < size; ++i) {
+            int bit = size >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(bins[i], bins[j]);
+        }
+
+        for (int len = 2; len <= size; len <<= 1) {
+            std::complex<double> step = std::polar(1.0, -2.0 * M_PI / len);
+            for (int i = 0; i < size; i += len) {
+                std::complex<double> w(1.0, 0.0);
+                for (int k = 0; k < len / 2; ++k) {
+                    std::complex<double> u = bins[i + k];
+                    std::complex<double> v = bins[i + k + len / 2] * w;
+                    bins[i + k] = u + v;
+                    bins[i + k + len / 2] = u - v;
+                    w *= step;
+                }
+            }
+        }
+
+        std::vector<double> magnitude(size / 2);
+        for (int i = 0; i < size / 2; ++i) {
+            magnitude[i] = 2.0 * std::abs(bins[i]) / windowSum;
+        }
+        return magnitude;
+    }
+
+    static double ToDB(double value) {
+        return 20.0 * std::log10(std::max(value, 1e-12));
+    }
+
+    void TestStreamingContinuity() {
+        std::cout << "\n--- Streaming Continuity (44.1k -> 48k) ---\n";
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        std::vector<float> input(44100);
+        for (auto& sample : input) sample = noise(rng);
+
+        for (auto quality : AllQualities()) {
+            SampleRateConverter single;
+            SampleRateConverter streamed;
+            single.Prepare(44100.0, 48000.0, 1, 16384, quality);
+            streamed.Prepare(44100.0, 48000.0, 1, 16384, quality);
+
+            auto reference = ConvertInBlocks(single, input, {16384});
+            auto blocks = ConvertInBlocks(streamed, input, {64, 511, 1, 2048, 300});
+
+            bool identical = reference.size() == blocks.size();
+            for (size_t i = 0; identical && i < reference.size(); ++i) {
+                identical = std::abs(reference[i] - blocks[i]) < 1e-6f;
+            }
+
+            Check(identical, std::string(QualityName(quality)) + ": odd block sizes match single-block output ("
+                  + std::to_string(blocks.size()) + " frames)");
+        }
+
+        // Input past the prepared block size with too small an output leaves
+        // the rest unread, and feeding it again continues the stream without a gap
+        SampleRateConverter whole;
+        SampleRateConverter limited;
+        whole.Prepare(44100.0, 48000.0, 1, 4096, SampleRateConverter::Quality::STANDARD);
+        limited.Prepare(44100.0, 48000.0, 1, 512, SampleRateConverter::Quality::STANDARD);
+        std::vector<float> chunk(input.begin(), input.begin() + 4096);
+        auto reference = ConvertInBlocks(whole, chunk, {4096});
+
+        std::vector<float> pieces;
+        std::vector<float> small(256);
+        int position = 0;
+        int firstConsumed = -1;
+        bool stalled = false;
+        while (position < 4096 && !stalled) {
+            const float* in[1] = { chunk.data() + position };
+            float* out[1] = { small.data() };
+            int consumed = 0;
+            int produced = limited.Process(in, 4096 - position, out, static_cast<int>(small.size()), &consumed);
+            if (firstConsumed < 0) firstConsumed = consumed;
+            pieces.insert(pieces.end(), small.begin(), small.begin() + produced);
+            position += consumed;
+            stalled = consumed == 0 && produced == 0;
+        }
+        // Drain what the history still holds
+        for (int produced = 1; produced > 0;) {
+            const float* in[1] = { chunk.data() };
+            float* out[1] = { small.data() };
+            produced = limited.Process(in, 0, out, static_cast<int>(small.size()));
+            pieces.insert(pieces.end(), small.begin(), small.begin() + produced);
+        }
+
+        bool continued = !stalled && pieces.size() == reference.size();
+        for (size_t i = 0; continued && i < reference.size(); ++i) {
+            continued = std::abs(reference[i] - pieces[i]) < 1e-6f;
+        }
+        Check(firstConsumed > 0 && firstConsumed < 4096, "A full output stops the converter taking input ("
+              + std::to_string(firstConsumed) + " of 4096 frames taken)");
+        Check(continued, "Feeding the untaken input again matches the unlimited output");
+
+        // Seeking must land exactly on the rational output position
+        SampleRateConverter seeker;
+        seeker.Prepare(44100.0, 48000.0, 1, 4096, SampleRateConverter::Quality::STANDARD);
+        int64_t firstInput = seeker.ResetForOutputFrame(48000 * 3600);
+        int halfWindow = SampleRateConverter::GetQualitySettings(SampleRateConverter::Quality::STANDARD).taps / 2 - 1;
+        Check(firstInput == 44100LL * 3600 - halfWindow, "One hour seek maps to exact source frame");
+    }
+
+    void TestPassbandAndAliasing() {
+        std::cout << "\n--- Passband & Aliasing (48k -> 44.1k) ---\n";
+
+        const int fftSize = 16384;
+        const double inputRate = 48000.0;
+        const double outputRate = 44100.0;
+
+        for (auto quality : AllQualities()) {
+            SampleRateConverter converter;
+
+            // Passband: 1 kHz keeps its level
+            converter.Prepare(inputRate, outputRate, 1, 16384, quality);
+            auto passOut = ConvertInBlocks(converter, GenerateSine(1000.0, inputRate, fftSize * 2), {512});
+            double sumSquares = 0.0;
+            for (int i = 1024; i < 1024 + fftSize; ++i) sumSquares += passOut[i] * passOut[i];
+            double passLevel = std::sqrt(2.0 * sumSquares / fftSize);
+
+            // Stopband: 23.9 kHz is above the output Nyquist and would alias to 20.2 kHz
+            converter.Prepare(inputRate, outputRate, 1, 16384, quality);
+            auto stopOut = ConvertInBlocks(converter, GenerateSine(23920.0, inputRate, fftSize * 2), {512});
+            auto stopSpectrum = MagnitudeSpectrum(stopOut.data() + 1024, fftSize);
+            double aliasLevel = 0.0;
+            for (double value : stopSpectrum) aliasLevel = std::max(aliasLevel, value);
+
+            double passDB = ToDB(passLevel / 0.5);
+            double aliasDB = ToDB(aliasLevel / 0.5);
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  " << std::setw(10) << QualityName(quality)
+                      << "  passband " << std::setw(7) << passDB << " dB"
+                      << "  alias " << std::setw(8) << aliasDB << " dB\n";
+
+            Check(std::abs(passDB) < 0.1, std::string(QualityName(quality)) + ": 1 kHz passband within 0.1 dB");
+            double limit = AliasLimitDB(quality);
+            Check(aliasDB < limit, std::string(QualityName(quality)) + ": aliasing below "
+                  + std::to_string(static_cast<int>(limit)) + " dB");
+        }
+    }
+
+    void TestSourceReaders() {
+        std::cout << "\n--- Source Read by Many Takes (44.1k file in a 48k project) ---\n";
+
+        // A 44.1k file, decoded into the block cache up front
+        const std::string path = (std::filesystem::temp_directory_path() / "reaper_test_resampler.wav").string();
+        const int sourceFrames = 44100 * 2;
+        {
+            std::vector<float> sine(sourceFrames);
+            for (int i = 0; i < sourceFrames; ++i) {
+                sine[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * 1000.0 * i / 44100.0));
+            }
+            AudioFileWriter writer;
+            const float* channels[1] = { sine.data() };
+            writer.Open(path, 44100.0, 1, AudioFileWriter::SampleFormat::FLOAT_32, false);
+            writer.Write(const_cast<float* const*>(channels), sourceFrames);
+            writer.Close();
+        }
+
+        AudioSource source(path);
+        source.Prefetch(0, sourceFrames);
+        source.PrepareForPlayback(48000.0);
+
+        constexpr int kBlock = 512;
+        constexpr int kBlocks = 40;
+        constexpr int kReaders = 6;     // More than any two-stream setup would hold
+
+        // One reader alone is the reference every interleaved reader must match
+        std::vector<float> reference;
+        AudioBuffer buffer(1, kBlock);
+        for (int b = 0; b < kBlocks + kReaders * 10; ++b) {
+            source.ReadAudioFrames(buffer, static_cast<int64_t>(b) * kBlock, kBlock, 48000.0);
+            reference.insert(reference.end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlock);
+        }
+
+        // Takes reading the same source at different positions, block by block
+        std::vector<std::unique_ptr<AudioBuffer>> buffers;
+        for (int r = 0; r < kReaders; ++r) {
+            buffers.push_back(std::make_unique<AudioBuffer>(1, kBlock));
+        }
+        std::vector<std::vector<float>> outputs(kReaders, std::vector<float>(kBlocks * kBlock));
+        source.SetResampleQuality(SampleRateConverter::Quality::HIGH);     // Applied at the next prepare only
+
+        long allocations = g_allocations.load();
+        for (int b = 0; b < kBlocks; ++b) {
+            for (int r = 0; r < kReaders; ++r) {
+                const int64_t start = static_cast<int64_t>(r * 10 + b) * kBlock;
+                source.ReadAudioFrames(*buffers[r], start, kBlock, 48000.0);
+                std::copy(buffers[r]->GetChannelData(0), buffers[r]->GetChannelData(0) + kBlock,
+                          outputs[r].begin() + b * kBlock);
+            }
+        }
+        allocations = g_allocations.load() - allocations;
+
+        // Every reader keeps its own stream, so its output is the single-reader output
+        bool matches = true;
+        for (int r = 0; r < kReaders; ++r) {
+            for (int i = 0; i < kBlocks * kBlock; ++i) {
+                matches = matches && std::abs(outputs[r][i] - reference[r * 10 * kBlock + i]) < 1e-6f;
+            }
+        }
+
+        Check(allocations == 0, std::to_string(kReaders) + " readers at once allocate nothing (" +
+              std::to_string(allocations) + ")");
+        Check(matches, "Each reader continues its own stream sample-exactly");
+
+        // The reads above still matched the Standard reference; the High filter arrives with the prepare
+        source.PrepareForPlayback(48000.0);
+        source.ReadAudioFrames(buffer, 0, kBlock, 48000.0);
+        bool rebuilt = false;
+        for (int i = 0; i < kBlock; ++i) {
+            rebuilt = rebuilt || std::abs(buffer.GetChannelData(0)[i] - reference[i]) > 1e-6f;
+        }
+        Check(rebuilt, "A quality change is applied by the next prepare, not by a read");
+
+        std::remove(path.c_str());
+    }
+
+    void TestDeviceInput() {
+        std::cout << "\n--- Monitored Input from a 44.1k Device (48k project) ---\n";
+
+        ReaperEngine engine;
+        ReaperEngine::GlobalSettings settings;
+        settings.sampleRate = 48000.0;
+        settings.deviceSampleRate = 44100.0;
+        settings.bufferSize = 256;
+        settings.autoSave = false;
+        engine.Initialize(settings);
+        engine.GetTrackManager()->CreateTrack("Input")->SetInputMonitor(true);
+
+        // A 1 kHz sine in device blocks; stopped, the monitored track alone plays it back
+        constexpr int kBlock = 256;
+        constexpr int kBlocks = 400;
+        std::vector<float> inLeft(kBlock), inRight(kBlock), outLeft(kBlock), outRight(kBlock);
+        float* inputs[2] = { inLeft.data(), inRight.data() };
+        float* outputs[2] = { outLeft.data(), outRight.data() };
+        std::vector<float> played;
+        for (int b = 0; b < kBlocks; ++b) {
+            for (int i = 0; i < kBlock; ++i) {
+                const double phase = 2.0 * M_PI * 1000.0 * (b * kBlock + i) / 44100.0;
+                inLeft[i] = inRight[i] = static_cast<float>(0.5 * std::sin(phase));
+            }
+            engine.ProcessAudioBlock(inputs, outputs, 2, kBlock);
+            if (b >= kBlocks / 2) {
+                played.insert(played.end(), outLeft.begin(), outLeft.end());
+            }
+        }
+
+        // Fit a 1 kHz sine at the device rate; what is left over is what conversion broke
+        double sinSum = 0.0;
+        double cosSum = 0.0;
+        for (size_t i = 0; i < played.size(); ++i) {
+            const double phase = 2.0 * M_PI * 1000.0 * i / 44100.0;
+            sinSum += played[i] * std::sin(phase);
+            cosSum += played[i] * std::cos(phase);
+        }
+        const double a = 2.0 * sinSum / played.size();
+        const double b = 2.0 * cosSum / played.size();
+        double residual = 0.0;
+        for (size_t i = 0; i < played.size(); ++i) {
+            const double phase = 2.0 * M_PI * 1000.0 * i / 44100.0;
+            const double fitted = a * std::sin(phase) + b * std::cos(phase);
+            residual += (played[i] - fitted) * (played[i] - fitted);
+        }
+        const double amplitude = std::sqrt(a * a + b * b);
+        const double residualRms = std::sqrt(residual / played.size());
+        const double residualDB = 20.0 * std::log10(residualRms / (amplitude / std::sqrt(2.0)) + 1e-12);
+        std::cout << "  amplitude " << std::fixed << std::setprecision(3) << amplitude << ", residual "
+                  << std::setprecision(1) << residualDB << " dB\n";
+
+        Check(std::abs(amplitude - 0.5) < 0.01, "Monitored input plays back at its own level");
+        Check(residualDB < -40.0, "The converted input is the same sine without gaps or repeats");
+    }
+
+    void TestThroughput() {
+        std::cout << "\n--- Throughput (stereo 44.1k -> 48k, 512-frame blocks) ---\n";
+
+        const double seconds = 20.0;
+        const int numFrames = static_cast<int>(44100.0 * seconds);
+        auto left = GenerateSine(440.0, 44100.0, numFrames);
+        auto right = GenerateSine(660.0, 44100.0, numFrames);
+        std::vector<float> outLeft(1024), outRight(1024);
+
+        for (auto quality : AllQualities()) {
+            SampleRateConverter converter;
+            converter.Prepare(44100.0, 48000.0, 2, 512, quality);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int pos = 0; pos + 512 <= numFrames; pos += 512) {
+                const float* in[2] = { left.data() + pos, right.data() + pos };
+                float* out[2] = { outLeft.data(), outRight.data() };
+                converter.Process(in, 512, out, 1024);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double elapsed = std::chrono::duration<double>(end - start).count();
+            std::cout << std::fixed << std::setprecision(1)
+                      << "  " << std::setw(10) << QualityName(quality)
+                      << "  " << std::setw(8) << (seconds / elapsed) << "x realtime"
+                      << "  (" << (elapsed * 1e9 / (numFrames * 2.0)) << " ns/sample)\n";
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Sample Rate Converter Test\n";
+    std::cout << "=======================================\n";
+
+    ResamplerTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
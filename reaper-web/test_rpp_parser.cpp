@@ -0,0 +1,646 @@
+/*
+ * REAPER Web - RPP Parser Test Application
+ * Verifies tokenizing, quoting and save/load round trips (text and binary
+ * snapshots, incremental autosave), and benchmarks loading a generated
+ * 50 MB project
+ */
+
+#include "src/core/project_manager.hpp"
+#include "src/core/rpp_parser.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/**
+ * RPP parser test - generated projects with known contents
+ */
+class RPPParserTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web RPP Parser Test ===\n";
+
+        TestNumberParsing();
+        TestTokenizer();
+        TestRoundTrip();
+        TestBinarySnapshot();
+        TestIncrementalAutoSave();
+        TestLargeProject();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    // Generated project shape
+    static constexpr int kTracks = 200;
+    static constexpr int kItemsPerTrack = 250;
+    static constexpr int kEnvelopePointsPerTrack = 4000;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static std::string TempPath(const char* name) {
+        return std::string("/tmp/reaper_web_") + name;
+    }
+
+    // Peak resident set size in bytes (0 where unavailable)
+    static size_t PeakMemory() {
+#if defined(__unix__) || defined(__APPLE__)
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    void TestNumberParsing() {
+        std::cout << "\n--- Number parsing ---\n";
+
+        // The fast path must agree with strtod bit for bit
+        std::mt19937_64 rng(1234);
+        std::uniform_real_distribution<double> seconds(0.0, 3600.0);
+        std::uniform_real_distribution<double> gains(-4.0, 4.0);
+        int mismatches = 0;
+        char text[64];
+
+        for (int i = 0; i < 200000; ++i) {
+            const double value = (i & 1) ? seconds(rng) : gains(rng);
+            const char* format = (i % 3 == 0) ? "%.14f" : (i % 3 == 1) ? "%.14g" : "%.17g";
+            int length = std::snprintf(text, sizeof(text), format, value);
+            double expected = std::strtod(text, nullptr);
+            double parsed = RPPTokenizer::ParseDouble(std::string_view(text, length));
+            if (parsed != expected) mismatches++;
+        }
+        Check(mismatches == 0, "ParseDouble matches strtod on 200k values (" + std::to_string(mismatches) + " mismatches)");
+
+        Check(RPPTokenizer::ParseDouble("1e-5") == 1e-5 && RPPTokenizer::ParseDouble("-0.5") == -0.5 &&
+              RPPTokenizer::ParseDouble("12345678901234567890123") == 12345678901234567890123.0,
+              "Exponents, signs and long mantissas");
+        Check(RPPTokenizer::ParseDouble("abc", 7.0) == 7.0 && RPPTokenizer::ParseInt("x", -3) == -3,
+              "Non-numbers return the default");
+        Check(RPPTokenizer::ParseInt("-1024") == -1024 && RPPTokenizer::ParseInt("42:U") == 42, "Integers");
+    }
+
+    void TestTokenizer() {
+        std::cout << "\n--- Tokenizer ---\n";
+
+        const std::string text =
+            "<REAPER_PROJECT 0.1 \"7.0/linux\" 1700000000\r\n"
+            "  NAME \"Lead vocal\" 'it\"s' `a 'b' \"c\"` bare\n"
+            "\n"
+            "  <VST \"VST: ReaEQ (Cockos)\" reaeq.so 0\n"
+            "    ZXE2ZQ==\n"
+            "    <nested\n"
+            "    >\n"
+            "  >\n"
+            "  PT 1.5 0.25\n"
+            ">\n";
+
+        RPPTokenizer tokenizer(text.data(), text.size());
+        RPPLine line;
+
+        bool ok = tokenizer.Next(line) && line.type == RPPLine::Type::BLOCK_START && line.Is("REAPER_PROJECT") &&
+                  line.GetToken(2) == "7.0/linux" && line.GetDouble(1) == 0.1;
+        Check(ok, "Block start with quoted token");
+
+        ok = tokenizer.Next(line) && line.Is("NAME") && line.GetToken(1) == "Lead vocal" &&
+             line.GetToken(2) == "it\"s" && line.GetToken(3) == "a 'b' \"c\"" && line.GetToken(4) == "bare";
+        Check(ok, "All three quote styles");
+
+        ok = tokenizer.Next(line) && line.Is("VST") && tokenizer.SkipBlock() && tokenizer.GetDepth() == 1;
+        Check(ok, "SkipBlock passes over nested plugin state");
+
+        ok = tokenizer.Next(line) && line.Is("PT") && line.GetDouble(2) == 0.25 &&
+             tokenizer.Next(line) && line.type == RPPLine::Type::BLOCK_END && !tokenizer.Next(line);
+        Check(ok, "Attributes after a skipped block, then end of input");
+    }
+
+    void TestRoundTrip() {
+        std::cout << "\n--- Save/load round trip ---\n";
+
+        ProjectManager project;
+        project.Initialize();
+
+        ProjectManager::ProjectInfo info = project.GetProjectInfo();
+        info.title = "Round trip";
+        info.notes = "First line\n  indented line";
+        info.tempo = 97.5;
+        info.timeSigNumerator = 7;
+        info.timeSigDenominator = 8;
+        info.tempoMarkers = TestTempoMarkers();
+        project.SetProjectInfo(info);
+
+        project.AddTrack("Drums \"overheads\"");
+        project.AddTrack("Bass");
+        auto* drums = project.GetTrack(0);
+        auto* bass = project.GetTrack(1);
+        drums->volume = 0.5;
+        drums->pan = -0.25;
+        drums->mute = true;
+        drums->effects = { "JS: utility/volume", "VST: ReaEQ (Cockos)" };
+
+        ProjectManager::ProjectTrack::Envelope volume;
+        volume.parameter = "volume";
+        volume.visible = true;
+        volume.points = { { 0.0, 1.0 }, { 1.5, 0.25 }, { 3.0, 0.75 } };
+        drums->envelopes.push_back(volume);
+
+        ProjectManager::ProjectTrack::Envelope eqGain;
+        eqGain.parameter = "fx1:3";
+        eqGain.points = { { 0.5, 0.1 }, { 2.5, 0.9 } };
+        drums->envelopes.push_back(eqGain);
+
+        bass->isFolder = true;
+        bass->folderDepth = 1;
+
+        auto* item = project.AddMediaItem(0, "audio/kick 01.wav", 1.25);
+        item->length = 2.5;
+        item->fadeIn = 0.01;
+        item->volume = 0.8;
+        ProjectManager::MediaItem::Take second;
+        second.name = "Take 2";
+        second.sourceFile = "audio/kick 02.wav";
+        second.playRate = 1.5;
+        second.pitch = -2.0;
+        item->takes.push_back(second);
+        item->activeTake = 1;
+
+        ProjectManager::ProjectTrack::Send send;
+        send.destTrack = 1;
+        send.volume = 0.3;
+        drums->sends.push_back(send);
+
+        const std::string path = TempPath("roundtrip.rpp");
+        Check(project.SaveProject(path), "Project saved");
+
+        ProjectManager loaded;
+        loaded.Initialize();
+        Check(loaded.LoadProject(path), "Project reloaded");
+
+        const auto& tracks = loaded.GetTracks();
+        const auto& loadedInfo = loaded.GetProjectInfo();
+        Check(loadedInfo.title == "Round trip" && loadedInfo.notes == info.notes && loadedInfo.tempo == 97.5 &&
+              loadedInfo.timeSigNumerator == 7 && loadedInfo.timeSigDenominator == 8, "Project info and notes");
+        Check(SameTempoMarkers(loadedInfo.tempoMarkers, info.tempoMarkers), "Tempo markers, ramps and time signatures");
+
+        bool ok = tracks.size() == 2 && tracks[0].name == "Drums \"overheads\"" && tracks[0].volume == 0.5 &&
+                  tracks[0].pan == -0.25 && tracks[0].mute && tracks[0].guid == drums->guid &&
+                  tracks[1].isFolder && tracks[1].folderDepth == 1;
+        Check(ok, "Track properties");
+
+        ok = tracks.size() == 2 && tracks[0].effects == drums->effects && tracks[0].envelopes.size() == 2 &&
+             tracks[0].envelopes[0].parameter == "volume" && tracks[0].envelopes[0].points == volume.points &&
+             tracks[0].envelopes[0].visible && tracks[0].envelopes[1].parameter == "fx1:3" &&
+             tracks[0].envelopes[1].points == eqGain.points;
+        Check(ok, "Effects and track/FX envelopes");
+
+        ok = tracks.size() == 2 && tracks[0].sends.size() == 1 && tracks[0].sends[0].destTrack == 1 &&
+             tracks[0].sends[0].volume == 0.3;
+        Check(ok, "Sends");
+
+        ok = tracks.size() == 2 && tracks[0].items.size() == 1;
+        if (ok) {
+            const auto& loadedItem = tracks[0].items[0];
+            ok = loadedItem.guid == item->guid && loadedItem.position == 1.25 && loadedItem.length == 2.5 &&
+                 loadedItem.fadeIn == 0.01 && loadedItem.volume == 0.8 && loadedItem.takes.size() == 2 &&
+                 loadedItem.activeTake == 1 && loadedItem.sourceFile == "audio/kick 02.wav" &&
+                 loadedItem.takes[0].sourceFile == "audio/kick 01.wav" && loadedItem.takes[1].playRate == 1.5 &&
+                 loadedItem.takes[1].pitch == -2.0;
+        }
+        Check(ok, "Items and takes");
+
+        // A damaged file must not replace the open project
+        FILE* file = std::fopen(TempPath("truncated.rpp").c_str(), "wb");
+        std::fputs("<REAPER_PROJECT 0.1\n  <TRACK\n    NAME x\n", file);
+        std::fclose(file);
+        Check(!loaded.LoadProject(TempPath("truncated.rpp")) && loaded.GetTracks().size() == 2,
+              "Truncated file rejected, project kept");
+
+        std::remove(path.c_str());
+        std::remove(TempPath("truncated.rpp").c_str());
+    }
+
+    static std::vector<TempoMarker> TestTempoMarkers() {
+        std::vector<TempoMarker> markers(3);
+        markers[0].bpm = 97.5;
+        markers[0].timeSigNumerator = 7;
+        markers[0].timeSigDenominator = 8;
+        markers[1].time = 4.0;
+        markers[1].bpm = 97.5;
+        markers[1].ramp = true;
+        markers[2].time = 8.25;
+        markers[2].bpm = 140.0;
+        markers[2].timeSigNumerator = 3;
+        markers[2].timeSigDenominator = 4;
+        return markers;
+    }
+
+    static bool SameTempoMarkers(const std::vector<TempoMarker>& a, const std::vector<TempoMarker>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].time != b[i].time || a[i].bpm != b[i].bpm || a[i].ramp != b[i].ramp ||
+                a[i].timeSigNumerator != b[i].timeSigNumerator || a[i].timeSigDenominator != b[i].timeSigDenominator) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool SameTracks(const std::vector<ProjectManager::ProjectTrack>& a,
+                           const std::vector<ProjectManager::ProjectTrack>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t t = 0; t < a.size(); ++t) {
+            const auto& x = a[t];
+            const auto& y = b[t];
+            if (x.guid != y.guid || x.name != y.name || x.volume != y.volume || x.pan != y.pan ||
+                x.mute != y.mute || x.solo != y.solo || x.inputChannel != y.inputChannel ||
+                x.isFolder != y.isFolder || x.folderDepth != y.folderDepth || x.effects != y.effects ||
+                x.envelopes.size() != y.envelopes.size() || x.items.size() != y.items.size() ||
+                x.sends.size() != y.sends.size()) {
+                return false;
+            }
+            for (size_t e = 0; e < x.envelopes.size(); ++e) {
+                if (x.envelopes[e].parameter != y.envelopes[e].parameter ||
+                    x.envelopes[e].visible != y.envelopes[e].visible ||
+                    x.envelopes[e].points != y.envelopes[e].points) {
+                    return false;
+                }
+            }
+            for (size_t i = 0; i < x.items.size(); ++i) {
+                const auto& p = x.items[i];
+                const auto& q = y.items[i];
+                if (p.guid != q.guid || p.name != q.name || p.position != q.position || p.length != q.length ||
+                    p.fadeIn != q.fadeIn || p.volume != q.volume || p.sourceFile != q.sourceFile ||
+                    p.sourceOffset != q.sourceOffset || p.activeTake != q.activeTake ||
+                    p.takes.size() != q.takes.size() || p.trackIndex != q.trackIndex) {
+                    return false;
+                }
+                for (size_t k = 0; k < p.takes.size(); ++k) {
+                    if (p.takes[k].sourceFile != q.takes[k].sourceFile || p.takes[k].playRate != q.takes[k].playRate ||
+                        p.takes[k].pitch != q.takes[k].pitch || p.takes[k].name != q.takes[k].name) {
+                        return false;
+                    }
+                }
+            }
+            for (size_t i = 0; i < x.sends.size(); ++i) {
+                if (x.sends[i].destTrack != y.sends[i].destTrack || x.sends[i].volume != y.sends[i].volume) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void TestBinarySnapshot() {
+        std::cout << "\n--- Binary snapshot ---\n";
+
+        ProjectManager project;
+        project.Initialize();
+        ProjectManager::ProjectInfo info = project.GetProjectInfo();
+        info.title = "Snapshot";
+        info.notes = "Line one\nLine two";
+        info.tempo = 133.0;
+        info.tempoMarkers = TestTempoMarkers();
+        project.SetProjectInfo(info);
+
+        for (int t = 0; t < 4; ++t) {
+            project.AddTrack("Track " + std::to_string(t));
+        }
+        for (int t = 0; t < 4; ++t) {
+            auto* track = project.GetTrack(t);
+            track->volume = 0.25 * (t + 1);
+            track->effects = { "JS: utility/volume" };
+            ProjectManager::ProjectTrack::Envelope envelope;
+            envelope.parameter = t == 0 ? "volume" : "fx0:1";
+            for (int p = 0; p < 1000; ++p) envelope.points.emplace_back(p * 0.01, std::sin(p * 0.1));
+            track->envelopes.push_back(envelope);
+            for (int i = 0; i < 3; ++i) {
+                auto* item = project.AddMediaItem(t, "audio/take " + std::to_string(i) + ".wav", i * 2.0);
+                item->length = 1.5;
+            }
+        }
+        project.GetTrack(0)->sends.push_back(ProjectManager::ProjectTrack::Send());
+        project.GetTrack(0)->sends.back().destTrack = 2;
+
+        const std::string path = TempPath("snapshot.rpb");
+        Check(project.SaveBinarySnapshot(path) && ProjectManager::IsBinaryProjectFile(path), "Binary snapshot written");
+
+        ProjectManager loaded;
+        loaded.Initialize();
+        Check(loaded.LoadProject(path), "Binary snapshot loaded");
+        Check(loaded.GetProjectInfo().title == "Snapshot" && loaded.GetProjectInfo().notes == info.notes &&
+              loaded.GetProjectInfo().tempo == 133.0 &&
+              SameTempoMarkers(loaded.GetProjectInfo().tempoMarkers, info.tempoMarkers), "Project info restored");
+        Check(SameTracks(project.GetTracks(), loaded.GetTracks()), "Tracks, envelopes, items and sends identical");
+
+        // Background write of a captured state; later edits do not leak into it
+        const std::string asyncPath = TempPath("snapshot_async.rpb");
+        Check(project.SaveBinarySnapshotAsync(asyncPath), "Snapshot queued");
+        project.GetTrack(0)->name = "Edited after capture";
+        project.WaitForPendingSaves();
+        ProjectManager async;
+        async.Initialize();
+        Check(async.LoadProject(asyncPath) && async.GetTracks().size() == 4 && async.GetTrack(0)->name == "Track 0",
+              "Background snapshot holds the captured state");
+        Check(project.GetAutoSaveStats().completedWrites == 1, "Writer thread reports the write");
+
+        // Cut-short and foreign files are rejected without touching the open project
+        std::error_code error;
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2, error);
+        Check(!loaded.LoadProject(path) && loaded.GetTracks().size() == 4, "Truncated snapshot rejected");
+
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        std::fputs("XXXX", file);
+        std::fclose(file);
+        Check(!ProjectManager::IsBinaryProjectFile(path) && !loaded.LoadProject(path), "Bad magic rejected");
+
+        std::remove(path.c_str());
+        std::remove(asyncPath.c_str());
+    }
+
+    void TestIncrementalAutoSave() {
+        std::cout << "\n--- Incremental autosave ---\n";
+
+        const std::string directory = TempPath("autosave");
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::create_directories(directory, error);
+
+        ProjectManager project;
+        project.Initialize();
+        ProjectManager::ProjectInfo info = project.GetProjectInfo();
+        info.projectPath = directory + "/session.rpp";
+        project.SetProjectInfo(info);
+
+        for (int t = 0; t < 3; ++t) {
+            project.AddTrack("Track " + std::to_string(t));
+            ProjectManager::ProjectTrack::Envelope envelope;
+            envelope.parameter = "volume";
+            for (int p = 0; p < 2000; ++p) envelope.points.emplace_back(p * 0.01, 0.5);
+            project.GetTrack(t)->envelopes.push_back(envelope);
+            for (int i = 0; i < 20; ++i) {
+                project.AddMediaItem(t, "audio/t" + std::to_string(t) + "_" + std::to_string(i) + ".wav", i * 2.0);
+            }
+        }
+
+        // First autosave is a full checkpoint
+        Check(project.WriteAutoSave(), "Checkpoint queued");
+        project.WaitForPendingSaves();
+        auto stats = project.GetAutoSaveStats();
+        Check(stats.checkpoints == 1 && stats.logBatches == 0, "First autosave writes a checkpoint");
+
+        // One item edit: only that item goes to the log
+        auto& tracks = project.GetTracks();
+        tracks[1].items[5].position = 123.5;
+        project.MarkItemDirty(tracks[1].items[5].guid);
+        project.WriteAutoSave();
+        project.WaitForPendingSaves();
+        stats = project.GetAutoSaveStats();
+        Check(stats.logBatches == 1 && stats.bytesWritten < 512, "Single item edit logs " +
+              std::to_string(stats.bytesWritten) + " bytes (checkpoint " + std::to_string(stats.checkpointBytes) + ")");
+
+        // Structural edits: new track, reorder, removed item, moved item, envelope and info changes
+        project.AddTrack("Added");
+        project.MoveTrack(3, 0);
+        project.RemoveMediaItem(1, tracks[1].items[0].guid);
+        ProjectManager::MediaItem moved = tracks[2].items[3];
+        tracks[2].items.erase(tracks[2].items.begin() + 3);
+        moved.trackIndex = 3;
+        tracks[3].items.push_back(moved);
+        project.MarkTrackDirty(2);
+        project.MarkTrackDirty(3);
+        tracks[1].envelopes[0].points[10].second = 0.9;
+        project.MarkEnvelopeDirty(1, "volume");
+        tracks[0].volume = 0.5;
+        project.MarkTrackDirty(0);
+        info = project.GetProjectInfo();
+        info.tempo = 140.0;
+        project.SetProjectInfo(info);
+        project.WriteAutoSave();
+
+        // A later edit whose batch is torn mid-write must not be applied
+        tracks[1].name = "Torn";
+        project.MarkTrackDirty(1);
+        project.WriteAutoSave();
+        project.WaitForPendingSaves();
+        stats = project.GetAutoSaveStats();
+        Check(stats.checkpoints == 1 && stats.logBatches == 3, "Edits appended as log batches");
+
+        const std::string checkpoint = project.GetAutoSavePath();
+        const std::string log = checkpoint + ".wal";
+        std::filesystem::resize_file(log, std::filesystem::file_size(log) - 8, error);
+        tracks[1].name = "Track 0";
+
+        ProjectManager restored;
+        restored.Initialize();
+        Check(restored.RestoreFromBackup(checkpoint), "Checkpoint restored");
+        Check(SameTracks(project.GetTracks(), restored.GetTracks()), "Log replay reproduces every committed edit");
+        Check(restored.GetProjectInfo().tempo == 140.0, "Project info change replayed");
+
+        // A log left over from an older checkpoint is ignored
+        std::filesystem::copy_file(log, log + ".old", std::filesystem::copy_options::overwrite_existing, error);
+        ProjectManager other;
+        other.Initialize();
+        other.SetProjectInfo(info);
+        other.AddTrack("Fresh");
+        other.WriteAutoSave();
+        other.WaitForPendingSaves();
+        std::filesystem::copy_file(log + ".old", log, std::filesystem::copy_options::overwrite_existing, error);
+        Check(restored.RestoreFromBackup(checkpoint) && restored.GetTracks().size() == 1,
+              "New checkpoint starts a new log");
+
+        std::filesystem::remove_all(directory, error);
+    }
+
+    // Writes a project shaped like a large REAPER session: many items,
+    // long automation envelopes and base64 plugin state
+    static size_t GenerateProject(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return 0;
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::fprintf(file, "<REAPER_PROJECT 0.1 \"7.0/linux-x86_64\" 1700000000\n");
+        std::fprintf(file, "  TEMPO 120 4 4\n  SAMPLERATE 48000 0 0\n");
+
+        for (int t = 0; t < kTracks; ++t) {
+            std::fprintf(file, "  <TRACK {%08X-0000-4000-8000-%012X}\n", t, t);
+            std::fprintf(file, "    NAME \"Track %d\"\n    VOLPAN %.14f 0 -1 -1 1\n    MUTESOLO 0 0 0\n", t, unit(rng));
+            std::fprintf(file, "    REC 0 1024 0 0 0 0 0\n    ISBUS 0 0\n");
+
+            std::fprintf(file, "    <VOLENV2\n      ACT 1 -1\n      VIS 1 1 1\n      ARM 0\n");
+            for (int p = 0; p < kEnvelopePointsPerTrack; ++p) {
+                std::fprintf(file, "      PT %.14f %.14f 0\n", p * 0.05, unit(rng));
+            }
+            std::fprintf(file, "    >\n");
+
+            std::fprintf(file, "    <FXCHAIN\n      SHOW 0\n      <VST \"VST: ReaComp (Cockos)\" reacomp.so 0 \"\" 0<56535463>\n");
+            for (int line = 0; line < 40; ++line) {
+                std::fprintf(file, "        bW9jawAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\n");
+            }
+            std::fprintf(file, "      >\n      FXID {0}\n    >\n");
+
+            for (int i = 0; i < kItemsPerTrack; ++i) {
+                std::fprintf(file, "    <ITEM\n      POSITION %.14f\n      SNAPOFFS 0\n      LENGTH %.14f\n", i * 4.0, 3.5 + unit(rng));
+                std::fprintf(file, "      LOOP 1\n      ALLTAKES 0\n      FADEIN 1 0.01 0 1 0 0 0\n      FADEOUT 1 0.01 0 1 0 0 0\n");
+                std::fprintf(file, "      MUTE 0 0\n      SEL 0\n      IGUID {%08X-%04X-4000-8000-000000000000}\n", t, i);
+                std::fprintf(file, "      IID %d\n      NAME \"Take %d-%d.wav\"\n      VOLPAN 1 0 1 -1\n", t * kItemsPerTrack + i, t, i);
+                std::fprintf(file, "      SOFFS %.14f\n      PLAYRATE 1 1 0 -1 0 0.0025\n      CHANMODE 0\n", unit(rng));
+                std::fprintf(file, "      <SOURCE WAVE\n        FILE \"Audio/Take %d-%d.wav\"\n      >\n    >\n", t, i);
+            }
+            std::fprintf(file, "  >\n");
+        }
+        std::fprintf(file, ">\n");
+
+        long size = std::ftell(file);
+        std::fclose(file);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    void TestLargeProject() {
+        std::cout << "\n--- Large project (generated) ---\n";
+
+        const std::string path = TempPath("large.rpp");
+        const size_t fileSize = GenerateProject(path);
+        const double megabytes = fileSize / (1024.0 * 1024.0);
+        std::cout << std::fixed << std::setprecision(1) << "  File: " << megabytes << " MB\n";
+
+        const size_t memoryBefore = PeakMemory();
+
+        ProjectManager project;
+        project.Initialize();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        bool loaded = project.LoadProject(path);
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double>(end - start).count();
+
+        const size_t memoryAfter = PeakMemory();
+        Check(loaded, "Large project loaded");
+
+        size_t items = 0, points = 0, effects = 0;
+        for (const auto& track : project.GetTracks()) {
+            items += track.items.size();
+            effects += track.effects.size();
+            for (const auto& envelope : track.envelopes) points += envelope.points.size();
+        }
+        Check(project.GetTracks().size() == kTracks && items == static_cast<size_t>(kTracks) * kItemsPerTrack &&
+              points == static_cast<size_t>(kTracks) * (kEnvelopePointsPerTrack) && effects == kTracks,
+              "All tracks, items, envelope points and plugins parsed");
+
+        std::cout << std::setprecision(1)
+                  << "  Parse: " << elapsed * 1000.0 << " ms (" << megabytes / elapsed << " MB/s)\n"
+                  << "  Peak memory: " << memoryAfter / (1024.0 * 1024.0) << " MB (+"
+                  << (memoryAfter - memoryBefore) / (1024.0 * 1024.0) << " MB during parse, file mapping included)\n";
+
+        const std::string savePath = TempPath("large_saved.rpp");
+        start = std::chrono::high_resolution_clock::now();
+        bool saved = project.SaveProject(savePath);
+        end = std::chrono::high_resolution_clock::now();
+        elapsed = std::chrono::duration<double>(end - start).count();
+        Check(saved, "Large project saved");
+        std::cout << "  Write: " << elapsed * 1000.0 << " ms\n";
+
+        ProjectManager reloaded;
+        reloaded.Initialize();
+        Check(reloaded.LoadProject(savePath) && reloaded.GetMediaItemCount() == project.GetMediaItemCount(),
+              "Saved project reloads");
+
+        // Binary snapshot of the same project
+        const std::string binaryPath = TempPath("large.rpb");
+        start = std::chrono::high_resolution_clock::now();
+        bool binarySaved = project.SaveBinarySnapshot(binaryPath);
+        end = std::chrono::high_resolution_clock::now();
+        double binaryWrite = std::chrono::duration<double>(end - start).count();
+        Check(binarySaved, "Binary snapshot saved");
+
+        ProjectManager binary;
+        binary.Initialize();
+        start = std::chrono::high_resolution_clock::now();
+        bool binaryLoaded = binary.LoadProject(binaryPath);
+        end = std::chrono::high_resolution_clock::now();
+        double binaryLoad = std::chrono::duration<double>(end - start).count();
+        Check(binaryLoaded && SameTracks(project.GetTracks(), binary.GetTracks()), "Binary snapshot reloads identically");
+
+        // Autosave path: the caller only pays for the state copy
+        start = std::chrono::high_resolution_clock::now();
+        project.SaveBinarySnapshotAsync(TempPath("large_autosave.rpb"));
+        end = std::chrono::high_resolution_clock::now();
+        double queueTime = std::chrono::duration<double>(end - start).count();
+        project.WaitForPendingSaves();
+        auto stats = project.GetAutoSaveStats();
+        Check(stats.completedWrites == 1 && stats.failedWrites == 0, "Background snapshot written");
+
+        std::cout << std::setprecision(1)
+                  << "  Binary: " << std::filesystem::file_size(binaryPath) / (1024.0 * 1024.0) << " MB, write "
+                  << binaryWrite * 1000.0 << " ms, load " << binaryLoad * 1000.0 << " ms\n"
+                  << "  Autosave: " << queueTime * 1000.0 << " ms on the caller (capture "
+                  << stats.captureMs << " ms), " << stats.writeMs << " ms on the writer thread\n";
+
+        // Incremental autosave: one checkpoint, then a single-item edit
+        const std::string directory = TempPath("large_autosave");
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        ProjectManager::ProjectInfo info = project.GetProjectInfo();
+        info.projectPath = directory + "/large.rpp";
+        project.SetProjectInfo(info);
+        project.WriteAutoSave();
+        project.WaitForPendingSaves();
+
+        auto& item = project.GetTracks()[17].items[42];
+        item.position += 0.5;
+        project.MarkItemDirty(item.guid);
+        start = std::chrono::high_resolution_clock::now();
+        project.WriteAutoSave();
+        end = std::chrono::high_resolution_clock::now();
+        double logQueue = std::chrono::duration<double>(end - start).count();
+        project.WaitForPendingSaves();
+        stats = project.GetAutoSaveStats();
+        Check(stats.checkpoints == 1 && stats.logBatches == 1, "Edit after checkpoint goes to the log");
+
+        ProjectManager restored;
+        restored.Initialize();
+        Check(restored.RestoreFromBackup(project.GetAutoSavePath()) &&
+              restored.GetTracks()[17].items[42].position == item.position, "Checkpoint + log restore the edit");
+        std::cout << std::setprecision(2) << "  Incremental autosave: " << stats.bytesWritten << " bytes, "
+                  << logQueue * 1000.0 << " ms on the caller, " << stats.writeMs << " ms on the writer thread\n";
+        std::filesystem::remove_all(directory, error);
+
+        std::remove(path.c_str());
+        std::remove(savePath.c_str());
+        std::remove(binaryPath.c_str());
+        std::remove(TempPath("large_autosave.rpb").c_str());
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - RPP Parser Test\n";
+    std::cout << "============================\n";
+
+    RPPParserTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
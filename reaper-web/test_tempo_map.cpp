@@ -0,0 +1,173 @@
+/*
+ * REAPER Web - Tempo Map Test Application
+ * Verifies beat/time conversion across ramps and meter changes, and the cursor fast path
+ */
+
+#include "src/core/tempo_map.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+/**
+ * Tempo map test - closed-form checks plus a large randomized map
+ */
+class TempoMapTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Tempo Map Test ===\n";
+
+        TestConstantTempo();
+        TestRamps();
+        TestTimeSignatures();
+        TestLargeMap();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static TempoMarker Marker(double time, double bpm, int numerator = 0, int denominator = 0, bool ramp = false) {
+        TempoMarker marker;
+        marker.time = time;
+        marker.bpm = bpm;
+        marker.timeSigNumerator = numerator;
+        marker.timeSigDenominator = denominator;
+        marker.ramp = ramp;
+        return marker;
+    }
+
+    void TestConstantTempo() {
+        std::cout << "\n--- Constant tempo ---\n";
+
+        TempoMap map(120.0, 4, 4);
+        Check(map.TimeToBeats(30.0) == 60.0 && map.BeatsToTime(60.0) == 30.0, "120 BPM: 30 s is 60 beats");
+
+        int measure = 0;
+        double beat = 0.0;
+        map.BeatsToMeasure(map.TimeToBeats(9.0), measure, beat);
+        Check(measure == 4 && std::abs(beat - 2.0) < 1e-9, "9 s is bar 5 beat 3 in 4/4");
+        Check(map.MeasureToBeats(10) == 40.0, "Bar 11 starts at beat 40");
+    }
+
+    void TestRamps() {
+        std::cout << "\n--- Linear tempo ramps ---\n";
+
+        // 120 -> 180 over 10 s, then steady
+        TempoMap map({Marker(0.0, 120.0, 4, 4, true), Marker(10.0, 180.0)});
+        Check(std::abs(map.TimeToBeats(10.0) - 25.0) < 1e-12, "Ramp covers the average tempo's beats");
+        Check(std::abs(map.GetTempoAt(5.0) - 150.0) < 1e-12, "Tempo halfway through the ramp");
+        Check(std::abs(map.TimeToBeats(12.0) - 31.0) < 1e-12, "Steady tempo after the ramp");
+
+        double worst = 0.0;
+        for (double t = 0.0; t < 20.0; t += 0.0137) {
+            worst = std::max(worst, std::abs(map.BeatsToTime(map.TimeToBeats(t)) - t));
+        }
+        Check(worst < 1e-9, "Time -> beats -> time round trip through the ramp");
+
+        // A ramp down to a slow tempo
+        TempoMap down({Marker(0.0, 200.0, 4, 4, true), Marker(8.0, 40.0)});
+        worst = 0.0;
+        for (double t = 0.0; t < 10.0; t += 0.011) {
+            worst = std::max(worst, std::abs(down.BeatsToTime(down.TimeToBeats(t)) - t));
+        }
+        Check(worst < 1e-9 && std::abs(down.TimeToBeats(8.0) - 16.0) < 1e-12, "Decelerating ramp round trip");
+    }
+
+    void TestTimeSignatures() {
+        std::cout << "\n--- Time signature changes ---\n";
+
+        // Two bars of 4/4 at 120 (4 s), then 7/8; then 3/4 arriving mid-bar
+        TempoMap map({Marker(0.0, 120.0, 4, 4), Marker(4.0, 120.0, 7, 8), Marker(8.5, 120.0, 3, 4)});
+
+        int measure = 0;
+        double beat = 0.0;
+        TimeSignature timeSig;
+        map.BeatsToMeasure(map.TimeToBeats(4.0), measure, beat, &timeSig);
+        Check(measure == 2 && beat < 1e-9 && timeSig.numerator == 7 && timeSig.denominator == 8,
+              "7/8 starts bar 3");
+
+        map.BeatsToMeasure(map.TimeToBeats(4.0 + 1.75), measure, beat);
+        Check(measure == 3 && beat < 1e-9, "A 7/8 bar lasts 3.5 quarter notes");
+
+        // 8.5 s is beat 17, 1.5 quarter notes into the third 7/8 bar; 3/4 starts the next bar
+        Check(map.MeasureToBeats(5) == 17.0 && map.GetTimeSignatureAtMeasure(5).numerator == 3,
+              "A mid-bar change ends the short bar and starts a new one");
+        Check(map.GetTimeSignatureAtMeasure(4).numerator == 7 && map.MeasureToBeats(4) == 15.0,
+              "Bars before the change keep their signature");
+
+        TempoPosition position = map.GetPosition(9.0);
+        Check(position.timeSigNumerator == 3 && position.timeSigDenominator == 4 && position.beats == 18.0,
+              "Plugin position carries tempo, beats and time signature");
+    }
+
+    void TestLargeMap() {
+        std::cout << "\n--- 1000 markers, sequential playback queries ---\n";
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> bpmDist(60.0, 180.0);
+        std::uniform_int_distribution<int> numDist(2, 9);
+        std::vector<TempoMarker> markers;
+        for (int i = 0; i < 1000; ++i) {
+            bool meter = (i % 7) == 0;
+            markers.push_back(Marker(i * 3.6, bpmDist(rng), meter ? numDist(rng) : 0, meter ? 8 : 0, (i % 3) == 0));
+        }
+        TempoMap map(markers);
+
+        // A cursor following playback must agree with the searching path
+        TempoMap::Cursor cursor(&map);
+        const double blockSeconds = 512.0 / 48000.0;
+        const int blocks = static_cast<int>(3600.0 / blockSeconds);
+        double worst = 0.0;
+        for (int b = 0; b < blocks; ++b) {
+            double t = b * blockSeconds;
+            double beats = cursor.TimeToBeats(t);
+            worst = std::max(worst, std::abs(beats - map.TimeToBeats(t)));
+            worst = std::max(worst, std::abs(cursor.BeatsToTime(beats) - t));
+        }
+        Check(worst < 1e-7, "Cursor matches binary search over an hour of blocks");
+
+        // Throughput: cursor vs search for the same sequential queries
+        const int queries = 5000000;
+        const double step = 3600.0 / queries;
+        double checksum = 0.0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        TempoMap::Cursor timed(&map);
+        for (int i = 0; i < queries; ++i) {
+            checksum += timed.TimeToBeats(i * step);
+        }
+        double cursorMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            checksum -= map.TimeToBeats(i * step);
+        }
+        double searchMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Cursor: " << cursorMs << " ms, binary search: " << searchMs << " ms for " << queries
+                  << " queries (checksum " << checksum << ")\n";
+        Check(cursorMs < searchMs, "Cursor beats a search per query");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Tempo Map Test\n";
+    std::cout << "===========================\n";
+
+    TempoMapTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
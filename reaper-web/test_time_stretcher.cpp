@@ -0,0 +1,273 @@
+/*
+ * REAPER Web - Time Stretcher Test Application
+ * Verifies output length against the stretch ratio, block-size independence,
+ * phase continuity on a sine and pitch changes without allocation
+ */
+
+#include "src/media/time_stretcher.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Counts heap allocations so the realtime calls can be checked for none
+static std::atomic<long> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+/**
+ * Time stretcher test - streams sines through both algorithms
+ */
+class TimeStretcherTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Time Stretcher Test ===\n";
+
+        TestOutputLength();
+        TestBlockIndependence();
+        TestPhaseContinuity();
+        TestPitchShift();
+        TestRealtimePitchChanges();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+    static constexpr double kSampleRate = 48000.0;
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    static const char* AlgorithmName(TimeStretcher::Algorithm algorithm) {
+        return algorithm == TimeStretcher::Algorithm::WSOLA ? "WSOLA" : "Vocoder";
+    }
+
+    static std::vector<TimeStretcher::Algorithm> AllAlgorithms() {
+        return { TimeStretcher::Algorithm::WSOLA, TimeStretcher::Algorithm::PHASE_VOCODER };
+    }
+
+    static std::vector<float> GenerateSine(double frequency, int numSamples, double amplitude = 0.5) {
+        std::vector<float> signal(numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            signal[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+        }
+        return signal;
+    }
+
+    // Feed a mono signal in cycling block sizes, draining the output after each block
+    static std::vector<float> StretchInBlocks(TimeStretcher& stretcher, const std::vector<float>& input,
+                                              const std::vector<int>& blockSizes) {
+        std::vector<float> output;
+        std::vector<float> block(65536);
+        size_t position = 0;
+        size_t blockIndex = 0;
+
+        while (position < input.size()) {
+            int frames = std::min<int>(blockSizes[blockIndex++ % blockSizes.size()],
+                                       static_cast<int>(input.size() - position));
+            const float* in[1] = { input.data() + position };
+            stretcher.Process(in, frames);
+            position += frames;
+
+            float* out[1] = { block.data() };
+            while (stretcher.GetAvailable() > 0) {
+                int retrieved = stretcher.Retrieve(out, std::min(stretcher.GetAvailable(), static_cast<int>(block.size())));
+                output.insert(output.end(), block.begin(), block.begin() + retrieved);
+            }
+        }
+
+        return output;
+    }
+
+    // Largest deviation from the two-term sine recurrence y[n] = 2cos(w)y[n-1] - y[n-2],
+    // relative to the amplitude; a phase jump or a click shows up as a spike
+    static double MaxSineResidual(const std::vector<float>& signal, double frequency, size_t begin, size_t end) {
+        const double coefficient = 2.0 * std::cos(2.0 * M_PI * frequency / kSampleRate);
+        double residual = 0.0;
+        double peak = 1e-9;
+        for (size_t i = begin + 2; i < end; ++i) {
+            residual = std::max(residual, std::abs(signal[i] - coefficient * signal[i - 1] + signal[i - 2]));
+            peak = std::max(peak, static_cast<double>(std::abs(signal[i])));
+        }
+        return residual / peak;
+    }
+
+    // Frequency from the mean distance between rising zero crossings
+    static double MeasureFrequency(const std::vector<float>& signal, size_t begin, size_t end) {
+        double first = -1.0;
+        double last = -1.0;
+        int crossings = 0;
+        for (size_t i = begin + 1; i < end; ++i) {
+            if (signal[i - 1] < 0.0f && signal[i] >= 0.0f) {
+                double position = (i - 1) + signal[i - 1] / (signal[i - 1] - signal[i]);
+                if (first < 0.0) first = position;
+                last = position;
+                ++crossings;
+            }
+        }
+        return crossings > 1 ? (crossings - 1) * kSampleRate / (last - first) : 0.0;
+    }
+
+    void TestOutputLength() {
+        std::cout << "\n--- Output Length vs Ratio ---\n";
+
+        const int inputFrames = static_cast<int>(kSampleRate * 2);
+        const auto input = GenerateSine(440.0, inputFrames);
+
+        for (auto algorithm : AllAlgorithms()) {
+            for (double ratio : {0.5, 0.8, 1.0, 1.25, 2.0}) {
+                TimeStretcher stretcher;
+                stretcher.Prepare(kSampleRate, 1, algorithm);
+                stretcher.SetTimeRatio(ratio);
+
+                auto output = StretchInBlocks(stretcher, input, {512});
+                const double expected = inputFrames * ratio;
+
+                // The last window is still in flight when the input ends
+                const int tolerance = stretcher.GetWindowSize() * 2;
+                std::cout << std::setw(9) << AlgorithmName(algorithm) << "  ratio " << std::setw(4) << ratio
+                          << "  " << output.size() << " frames (expected " << expected << ")\n";
+                Check(output.size() <= expected + 1 && output.size() + tolerance >= expected,
+                      std::string(AlgorithmName(algorithm)) + ": output length follows ratio " + std::to_string(ratio));
+            }
+        }
+    }
+
+    void TestBlockIndependence() {
+        std::cout << "\n--- Block Size Independence ---\n";
+
+        const auto input = GenerateSine(440.0, static_cast<int>(kSampleRate));
+
+        for (auto algorithm : AllAlgorithms()) {
+            TimeStretcher single;
+            TimeStretcher streamed;
+            single.Prepare(kSampleRate, 1, algorithm);
+            streamed.Prepare(kSampleRate, 1, algorithm);
+            single.SetTimeRatio(1.3);
+            streamed.SetTimeRatio(1.3);
+
+            auto reference = StretchInBlocks(single, input, {48000});
+            auto blocks = StretchInBlocks(streamed, input, {64, 511, 1, 2048, 300});
+
+            bool identical = reference.size() == blocks.size();
+            for (size_t i = 0; identical && i < reference.size(); ++i) {
+                identical = std::abs(reference[i] - blocks[i]) < 1e-6f;
+            }
+            Check(identical, std::string(AlgorithmName(algorithm)) + ": odd block sizes match single-block output");
+        }
+    }
+
+    void TestPhaseContinuity() {
+        std::cout << "\n--- Phase Continuity (440 Hz sine) ---\n";
+
+        const double frequency = 440.0;
+        const auto input = GenerateSine(frequency, static_cast<int>(kSampleRate * 2));
+        const double inputResidual = MaxSineResidual(input, frequency, 0, input.size());
+
+        for (auto algorithm : AllAlgorithms()) {
+            for (double ratio : {0.75, 1.5}) {
+                TimeStretcher stretcher;
+                stretcher.Prepare(kSampleRate, 1, algorithm);
+                stretcher.SetTimeRatio(ratio);
+
+                auto output = StretchInBlocks(stretcher, input, {128, 480, 1000});
+
+                // Skip the fade-in of the first window
+                const size_t begin = stretcher.GetWindowSize() * 2;
+                const double residual = MaxSineResidual(output, frequency, begin, output.size());
+                const double measured = MeasureFrequency(output, begin, output.size());
+
+                std::cout << std::setw(9) << AlgorithmName(algorithm) << "  ratio " << std::setw(4) << ratio
+                          << "  residual " << std::scientific << std::setprecision(2) << residual << " (input "
+                          << inputResidual << ")  " << std::fixed << std::setprecision(2) << measured << " Hz\n"
+                          << std::defaultfloat;
+                Check(residual < 1e-3, std::string(AlgorithmName(algorithm)) +
+                      ": no phase jumps between synthesis frames at ratio " + std::to_string(ratio));
+                Check(std::abs(measured - frequency) < 0.5, std::string(AlgorithmName(algorithm)) +
+                      ": pitch is kept at ratio " + std::to_string(ratio));
+            }
+        }
+    }
+
+    void TestPitchShift() {
+        std::cout << "\n--- Pitch Shift ---\n";
+
+        const auto input = GenerateSine(440.0, static_cast<int>(kSampleRate * 2));
+
+        for (auto algorithm : AllAlgorithms()) {
+            for (double scale : {0.5, std::pow(2.0, 7.0 / 12.0), 2.0}) {
+                TimeStretcher stretcher;
+                stretcher.Prepare(kSampleRate, 1, algorithm);
+                stretcher.SetPitchScale(scale);
+
+                auto output = StretchInBlocks(stretcher, input, {512});
+                const size_t begin = stretcher.GetWindowSize() * 2;
+                const double measured = MeasureFrequency(output, begin, output.size());
+
+                Check(std::abs(measured - 440.0 * scale) < 440.0 * scale * 0.002 &&
+                      std::abs(static_cast<double>(output.size()) - input.size()) < stretcher.GetWindowSize() * 2,
+                      std::string(AlgorithmName(algorithm)) + ": pitch x" + std::to_string(scale) + " gives " +
+                      std::to_string(measured) + " Hz at the original length");
+            }
+        }
+    }
+
+    void TestRealtimePitchChanges() {
+        std::cout << "\n--- Realtime Pitch Changes ---\n";
+
+        const auto input = GenerateSine(440.0, 4096);
+        std::vector<float> block(8192);
+        const float* in[1] = { input.data() };
+        float* out[1] = { block.data() };
+
+        for (auto algorithm : AllAlgorithms()) {
+            TimeStretcher stretcher;
+            stretcher.Prepare(kSampleRate, 1, algorithm);
+
+            // Every block at a new pitch, through unity and back, as pitch automation would
+            const double scales[] = {1.0, 1.5, 0.7, 1.0, 3.9, 0.26, 1.01, 2.0};
+            long allocations = g_allocations.load();
+            int produced = 0;
+            for (int block = 0; block < 64; ++block) {
+                stretcher.SetPitchScale(scales[block % 8]);
+                stretcher.Process(in, 512);
+                produced += stretcher.Retrieve(out, stretcher.GetAvailable());
+            }
+            allocations = g_allocations.load() - allocations;
+
+            Check(allocations == 0 && produced > 0, std::string(AlgorithmName(algorithm)) +
+                  ": pitch changes between blocks allocate nothing (" + std::to_string(allocations) + ")");
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Time Stretcher Test\n";
+    std::cout << "================================\n";
+
+    TimeStretcherTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
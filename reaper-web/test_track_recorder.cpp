@@ -0,0 +1,234 @@
+/*
+ * REAPER Web - Track Recorder Test Application
+ * Verifies that armed tracks record their device inputs to WAV files
+ * sample for sample, that the growing take plays back the same audio, and
+ * that punch ranges and loop passes become takes on the exact sample
+ */
+
+#include "src/core/audio_buffer.hpp"
+#include "src/core/reaper_engine.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/media/media_item.hpp"
+#include "src/recording/track_recorder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Track recorder test - every input sample carries the project sample it
+ * was captured at, so a lost, repeated or shifted frame breaks the sequence
+ */
+class TrackRecorderTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Track Recorder Test ===\n";
+
+        TestRecordedFiles();
+        TestLoopPasses(false);
+        TestLoopPasses(true);
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    static constexpr double SAMPLE_RATE = 48000.0;
+    static constexpr int BLOCK_SIZE = 128;
+    static constexpr int NUM_INPUTS = 3;
+
+    // Device input scratch for one callback
+    struct Inputs {
+        std::vector<float> data = std::vector<float>(NUM_INPUTS * BLOCK_SIZE);
+        float* channels[NUM_INPUTS] = { data.data(), data.data() + BLOCK_SIZE, data.data() + 2 * BLOCK_SIZE };
+    };
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    // Input channel values at a project sample; exact in float up to 2^24 samples
+    static float InputSample(int channel, int64_t projectSample) {
+        const float value = static_cast<float>(projectSample + 1) / 65536.0f;
+        return channel == 0 ? value : channel == 1 ? -value : 0.5f * value;
+    }
+
+    static std::string TempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // Feeds blocks covering project samples [start, end) to the engine
+    static void CaptureRange(RecordingEngine& engine, Inputs& inputs, int64_t start, int64_t end) {
+        for (int64_t position = start; position < end; position += BLOCK_SIZE) {
+            const int count = static_cast<int>(std::min<int64_t>(BLOCK_SIZE, end - position));
+            for (int ch = 0; ch < NUM_INPUTS; ++ch) {
+                for (int i = 0; i < count; ++i) {
+                    inputs.channels[ch][i] = InputSample(ch, position + i);
+                }
+            }
+            engine.Capture(inputs.channels, NUM_INPUTS, count, position);
+        }
+    }
+
+    // Interleaved float samples of a recorded file, after the writer's fixed header
+    static std::vector<float> ReadSamples(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() < static_cast<size_t>(AudioFileWriter::DATA_OFFSET)) return {};
+
+        std::vector<float> samples((bytes.size() - AudioFileWriter::DATA_OFFSET) / sizeof(float));
+        std::memcpy(samples.data(), bytes.data() + AudioFileWriter::DATA_OFFSET, samples.size() * sizeof(float));
+        return samples;
+    }
+
+    void TestRecordedFiles() {
+        std::cout << "\n--- Recorded Files Match the Input ---\n";
+
+        // A stereo track on inputs 1-2 and a mono track on input 3
+        std::vector<RecordingEngine::TrackInput> tracks(2);
+        tracks[0].firstInput = 0;
+        tracks[0].numChannels = 2;
+        tracks[0].filePath = TempPath("reaper_test_track_recorder_stereo.wav");
+        tracks[1].firstInput = 2;
+        tracks[1].numChannels = 1;
+        tracks[1].filePath = TempPath("reaper_test_track_recorder_mono.wav");
+
+        RecordingEngine engine;
+        Check(engine.Start(tracks, SAMPLE_RATE) && engine.IsRecording(), "Recording starts with both files open");
+
+        // One and a half seconds from a non-zero project position, in callback-sized blocks
+        const int64_t start = 4800;
+        const int numFrames = 72000 + 37;
+        Inputs inputs;
+        CaptureRange(engine, inputs, start, start + numFrames);
+        Check(engine.Stop() && !engine.IsRecording(), "Stop() drains and finalises every file");
+        Check(engine.GetDroppedFrames() == 0 && engine.GetStartSample() == start,
+              "No frame is dropped and the take starts on the first captured sample");
+
+        std::vector<float> stereo = ReadSamples(tracks[0].filePath);
+        bool stereoExact = stereo.size() == static_cast<size_t>(numFrames) * 2;
+        for (int i = 0; stereoExact && i < numFrames; ++i) {
+            stereoExact = stereo[2 * i] == InputSample(0, start + i) && stereo[2 * i + 1] == InputSample(1, start + i);
+        }
+        Check(stereoExact, "The stereo file holds inputs 1 and 2 interleaved, sample for sample");
+
+        std::vector<float> mono = ReadSamples(tracks[1].filePath);
+        bool monoExact = mono.size() == static_cast<size_t>(numFrames);
+        for (int i = 0; monoExact && i < numFrames; ++i) {
+            monoExact = mono[i] == InputSample(2, start + i);
+        }
+        Check(monoExact, "The mono file holds input 3, sample for sample");
+
+        // The take source the new item plays from reads back the same frames
+        const auto& recorders = engine.GetRecorders();
+        std::shared_ptr<AudioSource> source = recorders[0]->GetSource();
+        AudioBuffer buffer(2, 1000);
+        bool playback = source && recorders[0]->GetRecordedFrames() == numFrames &&
+                        source->ReadAudioSamples(buffer, 50000, 1000);
+        for (int i = 0; playback && i < 1000; ++i) {
+            playback = buffer.GetChannelData(0)[i] == InputSample(0, start + 50000 + i) &&
+                       buffer.GetChannelData(1)[i] == InputSample(1, start + 50000 + i);
+        }
+        Check(playback, "The take source plays back what was recorded");
+    }
+    // Plays take takeIndex of the item over its whole length, left channel;
+    // the finished file is decoded into the block cache first
+    static std::vector<float> RenderTake(MediaItem* item, int takeIndex, int numFrames) {
+        item->SetActiveTake(takeIndex);
+        const MediaItem::Take* take = item->GetTake(takeIndex);
+        take->source->Prefetch(std::llround(take->sourceOffset * SAMPLE_RATE), numFrames);
+        item->PrepareForPlayback(SAMPLE_RATE, numFrames);
+        AudioBuffer buffer(2, numFrames);
+        buffer.SetSampleRate(SAMPLE_RATE);
+        buffer.Clear();
+        item->ProcessAudio(buffer, item->GetStartSample(SAMPLE_RATE), numFrames);
+        return std::vector<float>(buffer.GetChannelData(0), buffer.GetChannelData(0) + numFrames);
+    }
+
+    void TestLoopPasses(bool punch) {
+        std::cout << "\n--- Loop Recording" << (punch ? " Inside a Punch Range" : "") << " ---\n";
+
+        const std::filesystem::path directory = TempPath(punch ? "reaper_test_punch" : "reaper_test_loop");
+        std::filesystem::remove_all(directory);
+
+        ReaperEngine engine;
+        ReaperEngine::GlobalSettings settings;
+        settings.sampleRate = SAMPLE_RATE;
+        settings.bufferSize = BLOCK_SIZE;
+        settings.autoSave = false;
+        settings.recordPath = directory.string();
+        engine.Initialize(settings);
+        Track* track = engine.GetTrackManager()->CreateTrack("Loop");
+        track->SetRecordArm(true);
+
+        // A 4800-sample loop that no block boundary lands on; the punch range sits inside it
+        const int64_t loopStart = 4800;
+        const int64_t loopFrames = 4800;
+        const int64_t takeStart = punch ? 6000 : loopStart;
+        const int64_t takeFrames = punch ? 1200 : loopFrames;
+        engine.SetLoopPoints(loopStart / SAMPLE_RATE, (loopStart + loopFrames) / SAMPLE_RATE);
+        engine.SetLoop(true);
+        if (punch) {
+            engine.SetPunchRange(takeStart / SAMPLE_RATE, (takeStart + takeFrames) / SAMPLE_RATE);
+            engine.SetAutoPunch(true);
+        }
+        engine.SetPlayPosition(loopStart / SAMPLE_RATE);
+        engine.Record();
+
+        // Three whole passes and part of a fourth; each device sample carries its own index
+        const int64_t deviceFrames = 3 * loopFrames + 1000;
+        Inputs inputs;
+        std::vector<float> outLeft(BLOCK_SIZE), outRight(BLOCK_SIZE);
+        float* outputs[2] = { outLeft.data(), outRight.data() };
+        for (int64_t frame = 0, block = 0; frame < deviceFrames; frame += BLOCK_SIZE, ++block) {
+            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                inputs.channels[0][i] = InputSample(0, frame + i);
+            }
+            engine.ProcessAudioBlock(inputs.channels, outputs, 2, BLOCK_SIZE);
+            if (block % 16 == 0) {
+                engine.UpdateRecording();   // UI timer
+            }
+        }
+        engine.Stop();
+
+        std::vector<MediaItem*> items = engine.GetMediaItemManager()->GetItemsOnTrack(track);
+        MediaItem* item = items.size() == 1 ? items[0] : nullptr;
+        Check(item && item->GetStartSample(SAMPLE_RATE) == takeStart &&
+                  item->GetEndSample(SAMPLE_RATE) == takeStart + takeFrames,
+              punch ? "One item spans exactly the punch range" : "One item spans exactly the loop");
+        if (!item) return;
+
+        // Pass p starts p loops after the first captured device sample
+        const int64_t firstDevice = takeStart - loopStart;
+        bool takesPlaced = item->GetTakeCount() == 3;
+        bool takesExact = takesPlaced;
+        for (int t = 0; takesPlaced && t < 3; ++t) {
+            takesPlaced = std::llround(item->GetTake(t)->sourceOffset * SAMPLE_RATE) == t * takeFrames;
+            std::vector<float> played = RenderTake(item, t, static_cast<int>(takeFrames));
+            for (int64_t n = 0; takesExact && n < takeFrames; ++n) {
+                takesExact = played[n] == InputSample(0, firstDevice + t * loopFrames + n);
+            }
+        }
+        Check(takesPlaced, "Each complete pass is a take at its own offset; the cut-short pass is dropped");
+        Check(takesExact, "Every take plays its own pass from the first to the last sample");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Track Recorder Test\n";
+    std::cout << "================================\n";
+
+    TrackRecorderTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
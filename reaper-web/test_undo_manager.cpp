@@ -0,0 +1,263 @@
+/*
+ * REAPER Web - Undo Manager Test Application
+ * Verifies that undo and redo restore the exact project state, that merge
+ * keys fold repeated edits into one undo point, and that delta-compressed
+ * history under a memory budget rebuilds every entry exactly
+ */
+
+#include "src/core/undo_manager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Undo manager test - edits a live project of tracks and empty items and
+ * compares it against descriptions recorded after each edit
+ */
+class UndoManagerTestApp {
+public:
+    int RunTests() {
+        std::cout << "\n=== REAPER Web Undo Manager Test ===\n";
+
+        TestRoundTrip();
+        TestMergeKeys();
+        TestMemoryBudget();
+
+        return m_failures;
+    }
+
+private:
+    int m_failures = 0;
+
+    // A live project the undo manager captures from and restores into
+    struct Project {
+        TrackManager tracks;
+        MediaItemManager items;
+        UndoManager undo;
+
+        Project() {
+            tracks.Initialize(nullptr);
+            undo.Initialize(&tracks, &items);
+        }
+    };
+
+    void Check(bool condition, const std::string& message) {
+        std::cout << (condition ? "✓ " : "✗ ") << message << "\n";
+        if (!condition) m_failures++;
+    }
+
+    // Everything undoable about the live project, in track order; items by GUID
+    // because restore may recreate them in a different manager order
+    static std::string Describe(const Project& project) {
+        std::ostringstream out;
+        for (int t = 0; t < project.tracks.GetTrackCount(); ++t) {
+            Track* track = project.tracks.GetTrack(t);
+            out << "track " << track->GetGUID() << " '" << track->GetName() << "' vol " << track->GetVolume()
+                << " pan " << track->GetPan() << " mute " << track->IsMuted() << "\n";
+
+            std::vector<MediaItem*> items = project.items.GetItemsOnTrack(track);
+            std::sort(items.begin(), items.end(), [](MediaItem* a, MediaItem* b) {
+                return a->GetGUID() < b->GetGUID();
+            });
+            for (MediaItem* item : items) {
+                const MediaItem::ItemState& state = item->GetState();
+                out << "  item " << state.guid << " '" << state.name << "' at " << state.position << " len "
+                    << state.length << " vol " << state.volume << " mute " << state.mute << " color "
+                    << state.color << "\n";
+            }
+        }
+        return out.str();
+    }
+
+    static void AddTracks(Project& project, int numTracks, int itemsPerTrack) {
+        for (int t = 0; t < numTracks; ++t) {
+            Track* track = project.tracks.CreateTrack("Track " + std::to_string(t + 1));
+            for (int i = 0; i < itemsPerTrack; ++i) {
+                MediaItem* item = project.items.CreateEmptyItem(track, i * 2.0, 1.5);
+                item->SetName("Item " + std::to_string(t + 1) + "." + std::to_string(i + 1));
+            }
+        }
+    }
+
+    void TestRoundTrip() {
+        std::cout << "\n--- Edit, Undo, Redo ---\n";
+
+        Project project;
+        AddTracks(project, 3, 4);
+        ProjectSnapshot::MasterState master;
+        project.undo.Reset(master);
+        const std::string baseline = Describe(project);
+
+        // Track state, item moves, a deleted item and a new track with an item
+        Track* second = project.tracks.GetTrack(1);
+        second->SetName("Vocals");
+        second->SetVolume(0.5);
+        second->SetPan(-0.25);
+        std::vector<MediaItem*> secondItems = project.items.GetItemsOnTrack(second);
+        secondItems[0]->SetPosition(7.25);
+        secondItems[1]->SetVolume(0.3);
+        project.items.DeleteItem(secondItems[2]);
+        Track* added = project.tracks.CreateTrack("Added");
+        project.items.CreateEmptyItem(added, 1.0, 3.0)->SetName("New");
+        master.volume = 0.8;
+        project.undo.Commit("Edit", master);
+        const std::string edited = Describe(project);
+
+        // A second edit that removes a track and mutes an item elsewhere
+        project.tracks.DeleteTrack(project.tracks.GetTrack(0));
+        project.items.GetItemsOnTrack(project.tracks.GetTrack(1))[0]->SetMute(true);
+        project.undo.Commit("Delete track", master);
+        const std::string deleted = Describe(project);
+
+        Check(project.undo.GetHistorySize() == 3 && edited != baseline && deleted != edited,
+              "Each edit adds an undo point");
+
+        const ProjectSnapshot* snapshot = project.undo.Undo();
+        Check(snapshot && Describe(project) == edited, "Undo restores the deleted track and its items");
+        snapshot = project.undo.Undo();
+        Check(snapshot && Describe(project) == baseline && snapshot->master.volume == 1.0,
+              "Undo to the baseline restores every track and item exactly");
+        Check(!project.undo.CanUndo() && project.undo.Undo() == nullptr, "Nothing to undo past the baseline");
+
+        snapshot = project.undo.Redo();
+        Check(snapshot && Describe(project) == edited && snapshot->master.volume == 0.8,
+              "Redo reapplies the first edit exactly");
+        project.undo.Redo();
+        Check(Describe(project) == deleted && !project.undo.CanRedo(), "Redo reapplies the second edit exactly");
+
+        // A new edit after undo drops the redo branch
+        project.undo.Undo();
+        project.tracks.GetTrack(0)->SetMute(true);
+        project.undo.Commit("Mute", master);
+        Check(!project.undo.CanRedo() && project.undo.GetHistorySize() == 3, "A new edit discards the redo branch");
+
+        project.undo.Commit("No change", master);
+        Check(project.undo.GetHistorySize() == 3, "A commit without changes adds nothing");
+    }
+
+    void TestMergeKeys() {
+        std::cout << "\n--- Merge Keys ---\n";
+
+        Project project;
+        AddTracks(project, 2, 1);
+        ProjectSnapshot::MasterState master;
+        project.undo.Reset(master);
+        project.undo.SetMergeWindow(60000.0);
+        const std::string baseline = Describe(project);
+
+        // A fader drag: many commits with one key
+        Track* first = project.tracks.GetTrack(0);
+        for (int step = 1; step <= 10; ++step) {
+            first->SetVolume(1.0 - step * 0.05);
+            project.undo.Commit("Track volume", master, "volume:" + first->GetGUID());
+        }
+        const std::string dragged = Describe(project);
+        Check(project.undo.GetHistorySize() == 2, "A run of one merge key is one undo point");
+
+        // Another target's key starts a new point, and the first key does not merge across it
+        Track* second = project.tracks.GetTrack(1);
+        second->SetPan(0.5);
+        project.undo.Commit("Track pan", master, "pan:" + second->GetGUID());
+        first->SetVolume(0.9);
+        project.undo.Commit("Track volume", master, "volume:" + first->GetGUID());
+        Check(project.undo.GetHistorySize() == 4, "A different key breaks the run");
+
+        // The same key after the merge window has passed
+        project.undo.SetMergeWindow(20.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        first->SetVolume(0.7);
+        project.undo.Commit("Track volume", master, "volume:" + first->GetGUID());
+        Check(project.undo.GetHistorySize() == 5, "An expired merge window breaks the run");
+
+        // Unkeyed commits never merge
+        first->SetMute(true);
+        project.undo.Commit("Mute", master);
+        first->SetMute(false);
+        project.undo.Commit("Unmute", master);
+        Check(project.undo.GetHistorySize() == 7, "Commits without a key are never merged");
+
+        for (int i = 0; i < 5; ++i) {
+            project.undo.Undo();
+        }
+        Check(Describe(project) == dragged, "Undo lands on the end of the merged run");
+        project.undo.Undo();
+        Check(Describe(project) == baseline && !project.undo.CanUndo(),
+              "One undo takes back the whole merged run");
+
+        // Merging only extends the newest point: after an undo the same key adds one
+        project.undo.Redo();
+        first->SetVolume(0.1);
+        project.undo.Commit("Track volume", master, "volume:" + first->GetGUID());
+        Check(project.undo.GetHistorySize() == 3, "A keyed edit after undo starts a new point");
+    }
+
+    void TestMemoryBudget() {
+        std::cout << "\n--- Memory Budget and Delta Compression ---\n";
+
+        Project project;
+        AddTracks(project, 16, 16);
+        ProjectSnapshot::MasterState master;
+        project.undo.Reset(master);
+
+        // One item edit per commit, walking across tracks, recording every state
+        std::vector<std::string> states = { Describe(project) };
+        for (int edit = 0; edit < 96; ++edit) {
+            Track* track = project.tracks.GetTrack(edit % 16);
+            std::vector<MediaItem*> items = project.items.GetItemsOnTrack(track);
+            MediaItem* item = items[(edit / 16) % items.size()];
+            item->SetPosition(item->GetState().position + 0.125);
+            item->SetName(item->GetState().name + "'");
+            if (edit % 7 == 0) {
+                track->SetVolume(0.5 + edit * 0.001);
+            }
+            master.volume = 1.0 - edit * 0.001;
+            project.undo.Commit("Edit " + std::to_string(edit + 1), master);
+            states.push_back(Describe(project));
+        }
+
+        const UndoManager::MemoryUsage whole = project.undo.GetMemoryUsage();
+        Check(whole.compressedEntries == 0 && whole.entries == 97, "The default budget keeps every entry whole");
+
+        // Item nodes are shared by whole and compressed entries alike; roots and track nodes are what compress
+        const size_t budget = whole.totalBytes * 4 / 5;
+        project.undo.SetMemoryBudget(budget);
+        const UndoManager::MemoryUsage compressed = project.undo.GetMemoryUsage();
+        std::cout << "  " << whole.totalBytes << " bytes whole, " << compressed.totalBytes << " bytes with "
+                  << compressed.compressedEntries << " of " << compressed.entries << " entries compressed (budget "
+                  << budget << ")\n";
+        Check(compressed.compressedEntries > 0 && compressed.totalBytes <= budget,
+              "Compressing old entries brings the history under its budget");
+        Check(project.undo.GetHistorySize() == 97, "Compression drops no entries");
+
+        // Every undo rebuilds its entry, down to the oldest
+        bool exact = true;
+        for (int index = static_cast<int>(states.size()) - 2; index >= 0; --index) {
+            const ProjectSnapshot* snapshot = project.undo.Undo();
+            exact = exact && snapshot && Describe(project) == states[index] &&
+                    snapshot->master.volume == (index == 0 ? 1.0 : 1.0 - (index - 1) * 0.001);
+        }
+        Check(exact && !project.undo.CanUndo(), "Undo through compressed entries reconstructs each one exactly");
+
+        bool redone = true;
+        for (size_t index = 1; index < states.size(); ++index) {
+            redone = redone && project.undo.Redo() && Describe(project) == states[index];
+        }
+        Check(redone, "Redo back to the newest entry matches every recorded state");
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Undo Manager Test\n";
+    std::cout << "==============================\n";
+
+    UndoManagerTestApp app;
+    int failures = app.RunTests();
+
+    std::cout << "\n=== Test Complete: " << (failures == 0 ? "PASSED" : "FAILED") << " ===\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/*
+ * REAPER Web - Headless Renderer
+ * Bounces a project to a WAV file with no audio device or browser
+ *
+ * Usage: reaper_render PROJECT.rpp OUTPUT.wav [--sample-rate HZ] [--block-size N]
+ *                      [--channels N] [--start SECONDS] [--end SECONDS] [--tail SECONDS]
+ *                      [--format f32|i16|i24|i32] [--dither] [--quiet]
+ */
+
+#include "../src/core/offline_renderer.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void PrintUsage() {
+    std::cerr << "Usage: reaper_render PROJECT.rpp OUTPUT.wav [--sample-rate HZ] [--block-size N]\n"
+                 "                     [--channels N] [--start SECONDS] [--end SECONDS] [--tail SECONDS]\n"
+                 "                     [--format f32|i16|i24|i32] [--dither] [--quiet]\n"
+                 "Renders the project from --start to --end (default: its last item) as fast as\n"
+                 "the machine allows. Exits non-zero if the render fails.\n";
+}
+
+bool ParseFormat(const std::string& name, AudioFileWriter::SampleFormat& format) {
+    if (name == "f32") format = AudioFileWriter::SampleFormat::FLOAT_32;
+    else if (name == "i16") format = AudioFileWriter::SampleFormat::PCM_16;
+    else if (name == "i24") format = AudioFileWriter::SampleFormat::PCM_24;
+    else if (name == "i32") format = AudioFileWriter::SampleFormat::PCM_32;
+    else return false;
+    return true;
+}
+
+} // anonymous namespace
+
+// Main renderer function
+int main(int argc, char** argv) {
+    OfflineRenderer::Options options;
+    std::string projectPath;
+    std::string outputPath;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        }
+        if (arg == "--dither") {
+            options.dither = true;
+            continue;
+        }
+        if (arg == "--quiet") {
+            quiet = true;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            if (projectPath.empty()) {
+                projectPath = arg;
+            } else if (outputPath.empty()) {
+                outputPath = arg;
+            } else {
+                PrintUsage();
+                return 1;
+            }
+            continue;
+        }
+
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            PrintUsage();
+            return 1;
+        }
+
+        if (arg == "--sample-rate") {
+            options.sampleRate = std::atof(value);
+        } else if (arg == "--block-size") {
+            options.blockSize = std::atoi(value);
+        } else if (arg == "--channels") {
+            options.channels = std::atoi(value);
+        } else if (arg == "--start") {
+            options.startTime = std::atof(value);
+        } else if (arg == "--end") {
+            options.endTime = std::atof(value);
+        } else if (arg == "--tail") {
+            options.tailTime = std::atof(value);
+        } else if (arg == "--format") {
+            if (!ParseFormat(value, options.format)) {
+                PrintUsage();
+                return 1;
+            }
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        ++i;
+    }
+
+    if (projectPath.empty() || outputPath.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Progress in whole percent, rewritten in place
+    int lastPercent = -1;
+    OfflineRenderer::ProgressCallback progress = [&](double fraction) {
+        int percent = static_cast<int>(fraction * 100.0);
+        if (!quiet && percent != lastPercent) {
+            std::cerr << "\rRendering " << std::setw(3) << percent << "%" << std::flush;
+            lastPercent = percent;
+        }
+        return true;
+    };
+
+    OfflineRenderer renderer;
+    OfflineRenderer::Result result = renderer.Render(projectPath, outputPath, options, progress);
+    if (!quiet && lastPercent >= 0) {
+        std::cerr << "\n";
+    }
+
+    for (const auto& warning : result.warnings) {
+        std::cerr << "Warning: " << warning << "\n";
+    }
+    if (!result.success) {
+        std::cerr << "Render failed: " << result.error << "\n";
+        return 1;
+    }
+
+    if (!quiet) {
+        std::cerr << std::fixed << std::setprecision(2)
+                  << "Rendered " << result.tracks << " tracks, " << result.items << " items: "
+                  << result.frames / options.sampleRate << " s in " << result.renderSeconds << " s ("
+                  << result.realtimeFactor << "x realtime) to " << outputPath << "\n";
+    }
+    return 0;
+}